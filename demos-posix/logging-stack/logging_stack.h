@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 
 
 /* Check if LIBRARY_LOG_NAME macro has been defined. */
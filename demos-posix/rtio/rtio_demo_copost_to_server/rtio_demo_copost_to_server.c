@@ -30,7 +30,7 @@ RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
 static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
 
 /* Information about the RTIO server. */
-static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT };
+static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT, 0U };
 
 /* Buffer receive data for application */
 static uint8_t appBuffer[ RTIO_TRANSFER_FRAME_BUF_SIZE ];
@@ -116,6 +116,8 @@ int main()
     transport.connect = Plaintext_ConnectWithOption;
     transport.disconnect = Plaintext_Disconnect;
     transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.waitReadable = Plaintext_WaitReadable;
     transport.recv = Plaintext_Recv;
 
     /* Device infomation connect to RTIO server */
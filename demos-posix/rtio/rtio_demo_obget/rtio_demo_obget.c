@@ -32,7 +32,7 @@ RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
 static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
 
 /* Information about the RTIO server. */
-static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT };
+static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT, 0U };
 
 /* Observer List Init. */
 #define RAINBOW_OBSERVER_NUM_MAX    ( 5U ) /* MAX 5 Observers. */
@@ -136,6 +136,8 @@ int main()
     transport.connect = Plaintext_ConnectWithOption;
     transport.disconnect = Plaintext_Disconnect;
     transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.waitReadable = Plaintext_WaitReadable;
     transport.recv = Plaintext_Recv;
 
     /* Device infomation connect to RTIO server */
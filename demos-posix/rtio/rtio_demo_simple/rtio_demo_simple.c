@@ -29,7 +29,7 @@ RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
 static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
 
 /* Information about the RTIO server. */
-static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT };
+static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT, 0U };
 
 /* URI handler. */
 static RTIOStatus_t uriRainbow( uint8_t* pReqData, uint16_t reqLength,
@@ -60,6 +60,8 @@ int main()
     transport.connect = Plaintext_ConnectWithOption;
     transport.disconnect = Plaintext_Disconnect;
     transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.waitReadable = Plaintext_WaitReadable;
     transport.recv = Plaintext_Recv;
 
     /* Device infomation connect to RTIO server */
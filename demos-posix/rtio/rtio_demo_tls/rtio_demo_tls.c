@@ -28,7 +28,7 @@ RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
 static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
 
 /* Information about the RTIO server. */
-static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT };
+static ServerInfo_t serverInfo = { SERVER_HOST, SERVER_HOST_LENGTH, SERVER_PORT, 0U };
 
 /* URI handler. */
 static RTIOStatus_t uriRainbow( uint8_t* pReqData, uint16_t reqLength,
@@ -66,6 +66,8 @@ int main()
     transport.connect = Openssl_ConnectWithOption;
     transport.disconnect = Openssl_Disconnect;
     transport.send = Openssl_Send;
+    transport.sendv = Openssl_Sendv;
+    transport.waitReadable = Openssl_WaitReadable;
     transport.recv = Openssl_Recv;
 
     /* Device infomation connect to RTIO server */
@@ -124,6 +126,9 @@ int main()
         exitCode = EXIT_FAILURE;
     }
 
+    /* Free the SSL context and session kept for reconnects. */
+    (void)Openssl_FreeCache( &networkContext );
+
     LogInfo( ( "RTIO Demo exit exitCode=%d.", exitCode ) );
     return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Producers post bursts of small requests concurrently, the writer thread must pack several
+ * frames into each write without losing or reordering any, within the byte threshold. A lone
+ * request must still go out within the flush deadline. */
+
+#define TEST_PRODUCER_NUM        ( 4U )
+#define TEST_BURST_NUM           ( 8U )
+#define TEST_ROUND_NUM           ( 25U )
+#define TEST_REQUEST_NUM         ( TEST_PRODUCER_NUM * TEST_BURST_NUM * TEST_ROUND_NUM )
+#define TEST_TIMEOUT_MS          ( 2000U )
+#define TEST_LONE_MS_MAX         ( 20U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+static RTIOContext_t rtioContext = { 0 };
+
+static FakeServer_t server;
+static uint32_t uri = 0;
+static volatile uint32_t producersDone = 0;
+
+typedef struct TestRequest
+{
+    volatile uint32_t calls;
+    volatile RTIOStatus_t status;
+    char payload[ 16 ];
+    uint8_t respData[ 8 ];
+    RTIOFixedBuffer_t respBuffer;
+} TestRequest_t;
+
+static TestRequest_t requests[ TEST_PRODUCER_NUM ][ TEST_BURST_NUM * TEST_ROUND_NUM ];
+
+/*-----------------------------------------------------------*/
+
+static void requestDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    TestRequest_t* pRequest = (TestRequest_t*)pUserData;
+
+    (void)pRespData;
+    (void)respLength;
+    pRequest->status = status;
+    pRequest->calls++;
+}
+
+static void postAsync( TestRequest_t* pRequest, uint32_t id )
+{
+    (void)snprintf( pRequest->payload, sizeof( pRequest->payload ), "World! %u", (unsigned)id );
+    pRequest->respBuffer.pBuffer = pRequest->respData;
+    pRequest->respBuffer.size = sizeof( pRequest->respData );
+    assert( RTIO_CoPostAsync( &rtioContext, uri, (uint8_t*)pRequest->payload, (uint16_t)strlen( pRequest->payload ),
+                              &( pRequest->respBuffer ), TEST_TIMEOUT_MS, requestDone, pRequest ) == RTIOSuccess );
+}
+
+/* Posts a burst, waits for its responses, and again for every round. */
+static void producerThread( void* pParam )
+{
+    uint32_t producer = (uint32_t)(uintptr_t)pParam;
+    TestRequest_t* pRequests = requests[ producer ];
+    uint32_t round = 0, i = 0, startMs = 0;
+
+    for( round = 0; round < TEST_ROUND_NUM; round++ )
+    {
+        for( i = 0; i < TEST_BURST_NUM; i++ )
+        {
+            postAsync( &pRequests[ round * TEST_BURST_NUM + i ], producer * 10000U + round * TEST_BURST_NUM + i );
+        }
+        startMs = OS_ClockGetTimeMs();
+        while( ( pRequests[ round * TEST_BURST_NUM + TEST_BURST_NUM - 1U ].calls == 0U ) &&
+               ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS + 100U ) )
+        {
+            OS_ClockSleepMs( 1U );
+        }
+    }
+    (void)__sync_fetch_and_add( &producersDone, 1U );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    OSThreadHandle_t producerHandles[ TEST_PRODUCER_NUM ];
+    RTIOSendStats_t stats = { 0 };
+    TestRequest_t lone = { 0 };
+    uint32_t answered = 0, startMs = 0, loneMs = 0;
+    uint32_t i = 0, j = 0;
+
+    serverInfo.port = FakeServer_Start( &server, NULL );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_Serve( &rtioContext ) == RTIOSuccess );
+    assert( RTIO_URIHash( "/coalesce", &uri ) == RTIOSuccess );
+
+    for( i = 0; i < TEST_PRODUCER_NUM; i++ )
+    {
+        assert( OS_ThreadCreate( &producerHandles[ i ], producerThread, (void*)(uintptr_t)i,
+                                 "producer", 0 ) == OSSuccess );
+    }
+    startMs = OS_ClockGetTimeMs();
+    while( ( producersDone < TEST_PRODUCER_NUM ) && ( ( OS_ClockGetTimeMs() - startMs ) < 30000U ) )
+    {
+        OS_ClockSleepMs( 10U );
+    }
+
+    for( i = 0; i < TEST_PRODUCER_NUM; i++ )
+    {
+        for( j = 0; j < TEST_BURST_NUM * TEST_ROUND_NUM; j++ )
+        {
+            answered += ( ( requests[ i ][ j ].calls == 1U ) && ( requests[ i ][ j ].status == RTIOSuccess ) ) ? 1U : 0U;
+        }
+    }
+
+    /* Nothing else to pack, it waits the flush deadline at most. */
+    startMs = OS_ClockGetTimeMs();
+    postAsync( &lone, 99999U );
+    while( ( lone.calls == 0U ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepUs( 100U );
+    }
+    loneMs = OS_ClockGetTimeMs() - startMs;
+
+    assert( RTIO_GetSendStats( &rtioContext, &stats ) == RTIOSuccess );
+    printf( "Answered %u/%u, server frames=%u, writes=%u, frames=%u, bytes=%u, frames per write=%.2f, max=%u, lone=%ums.\n",
+            (unsigned)answered, TEST_REQUEST_NUM, (unsigned)server.requests, (unsigned)stats.writes,
+            (unsigned)stats.frames, (unsigned)stats.bytes,
+            ( stats.writes > 0U ) ? (double)stats.frames / (double)stats.writes : 0.0,
+            (unsigned)stats.framesPerWriteMax, (unsigned)loneMs );
+
+    (void)RTIO_Disconnect( &rtioContext );
+    FakeServer_Stop( &server );
+
+    if( ( answered != TEST_REQUEST_NUM ) || ( lone.calls != 1U ) || ( lone.status != RTIOSuccess ) ||
+        ( loneMs > TEST_LONE_MS_MAX ) || ( stats.frames != TEST_REQUEST_NUM + 1U ) ||
+        ( stats.frames < 2U * stats.writes ) || ( stats.framesPerWriteMax > RTIO_SEND_COALESCE_FRAMES_MAX ) ||
+        ( stats.bytes > stats.writes * RTIO_SEND_COALESCE_BYTES ) )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
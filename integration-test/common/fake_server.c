@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "fake_server.h"
+
+/*-----------------------------------------------------------*/
+
+static bool recvAll( int fd, uint8_t* pBuffer, size_t length )
+{
+    ssize_t n = 0;
+    size_t got = 0;
+
+    while( got < length )
+    {
+        n = recv( fd, &pBuffer[ got ], length - got, 0 );
+        if( n <= 0 )
+        {
+            return false;
+        }
+        got += (size_t)n;
+    }
+    return true;
+}
+
+uint16_t FakeServer_Listen( int* pListenFd, int backlog )
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof( addr );
+
+    *pListenFd = socket( AF_INET, SOCK_STREAM, 0 );
+    assert( *pListenFd >= 0 );
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    addr.sin_port = 0;
+    assert( bind( *pListenFd, (struct sockaddr*)&addr, sizeof( addr ) ) == 0 );
+    assert( listen( *pListenFd, backlog ) == 0 );
+    assert( getsockname( *pListenFd, (struct sockaddr*)&addr, &addrLen ) == 0 );
+
+    return ntohs( addr.sin_port );
+}
+
+bool FakeServer_RecvFrame( int fd, FakeServerFrame_t* pFrame )
+{
+    uint8_t header[ FAKE_SERVER_HEADER_LEN ] = { 0 };
+
+    if( !recvAll( fd, header, FAKE_SERVER_HEADER_LEN ) )
+    {
+        return false;
+    }
+    pFrame->type = header[ 0 ] >> 4;
+    pFrame->headerId = (uint16_t)( ( header[ 1 ] << 8 ) | header[ 2 ] );
+    pFrame->bodyLen = (uint16_t)( ( header[ 3 ] << 8 ) | header[ 4 ] );
+    return ( pFrame->bodyLen <= sizeof( pFrame->body ) ) && recvAll( fd, pFrame->body, pFrame->bodyLen );
+}
+
+bool FakeServer_IsNotify( const FakeServerFrame_t* pFrame )
+{
+    return ( pFrame->type == FAKE_SERVER_TYPE_SEND_REQ ) && ( pFrame->bodyLen > 0U ) &&
+           ( ( pFrame->body[ 0 ] >> 4 ) == FAKE_SERVER_REST_OBGET );
+}
+
+const uint8_t* FakeServer_Payload( const FakeServerFrame_t* pFrame )
+{
+    uint16_t headerLen = FakeServer_IsNotify( pFrame ) ? FAKE_SERVER_NOTIFY_HEADER_LEN : FAKE_SERVER_CO_REQ_HEADER_LEN;
+
+    if( ( pFrame->type != FAKE_SERVER_TYPE_SEND_REQ ) || ( pFrame->bodyLen <= headerLen ) )
+    {
+        return NULL;
+    }
+    return &( pFrame->body[ headerLen ] );
+}
+
+void FakeServer_Answer( int fd, const FakeServerFrame_t* pFrame )
+{
+    uint8_t resp[ FAKE_SERVER_HEADER_LEN + 3U ] = { 0 };
+    uint8_t type = 0;
+    uint8_t bodyLen = 0;
+
+    switch( pFrame->type )
+    {
+    case FAKE_SERVER_TYPE_VERIFY_REQ:
+        type = FAKE_SERVER_TYPE_VERIFY_RESP;
+        break;
+    case FAKE_SERVER_TYPE_PING_REQ:
+        type = FAKE_SERVER_TYPE_PING_RESP;
+        break;
+    case FAKE_SERVER_TYPE_SEND_REQ:
+        type = FAKE_SERVER_TYPE_SEND_RESP;
+        if( FakeServer_IsNotify( pFrame ) && ( pFrame->bodyLen >= FAKE_SERVER_NOTIFY_HEADER_LEN ) )
+        {
+            bodyLen = 3;
+            resp[ 5 ] = (uint8_t)( ( FAKE_SERVER_REST_OBGET << 4 ) | FAKE_SERVER_STATUS_CONTINUE );
+            resp[ 6 ] = pFrame->body[ 1 ];
+            resp[ 7 ] = pFrame->body[ 2 ];
+        }
+        else
+        {
+            bodyLen = 1;
+            resp[ 5 ] = (uint8_t)( ( FAKE_SERVER_REST_COPOST << 4 ) | FAKE_SERVER_STATUS_OK );
+        }
+        break;
+    default:
+        /* Responses of the device are not answered. */
+        return;
+    }
+
+    resp[ 0 ] = (uint8_t)( ( type << 4 ) | FAKE_SERVER_CODE_SUCCESS );
+    resp[ 1 ] = (uint8_t)( pFrame->headerId >> 8 );
+    resp[ 2 ] = (uint8_t)( pFrame->headerId & 0xFF );
+    resp[ 4 ] = bodyLen;
+    (void)send( fd, resp, FAKE_SERVER_HEADER_LEN + bodyLen, 0 );
+}
+
+bool FakeServer_Post( int fd, uint16_t headerId, uint32_t digest )
+{
+    uint8_t req[ FAKE_SERVER_HEADER_LEN + 5U ] = { 0 };
+
+    req[ 0 ] = (uint8_t)( FAKE_SERVER_TYPE_SERVER_REQ << 4 );
+    req[ 1 ] = (uint8_t)( headerId >> 8 );
+    req[ 2 ] = (uint8_t)( headerId & 0xFF );
+    req[ 3 ] = 0;
+    req[ 4 ] = 5;
+    req[ 5 ] = (uint8_t)( FAKE_SERVER_REST_COPOST << 4 );
+    req[ 6 ] = (uint8_t)( digest >> 24 );
+    req[ 7 ] = (uint8_t)( digest >> 16 );
+    req[ 8 ] = (uint8_t)( digest >> 8 );
+    req[ 9 ] = (uint8_t)( digest & 0xFF );
+    return send( fd, req, sizeof( req ), 0 ) == (ssize_t)sizeof( req );
+}
+
+/*-----------------------------------------------------------*/
+
+static void serverServe( FakeServer_t* pServer, int fd )
+{
+    FakeServerFrame_t frame;
+
+    while( FakeServer_RecvFrame( fd, &frame ) )
+    {
+        if( frame.type == FAKE_SERVER_TYPE_PING_REQ )
+        {
+            pServer->pings++;
+        }
+        else if( frame.type == FAKE_SERVER_TYPE_SEND_REQ )
+        {
+            pServer->requests++;
+        }
+        else
+        {
+            /* MISRA else. */
+        }
+
+        if( ( ( pServer->hook == NULL ) || pServer->hook( fd, &frame ) ) && !pServer->silent )
+        {
+            if( frame.type == FAKE_SERVER_TYPE_SEND_REQ )
+            {
+                OS_ClockSleepMs( pServer->delayMs );
+            }
+            FakeServer_Answer( fd, &frame );
+        }
+    }
+}
+
+/* Serves one session after the other until stopped. */
+static void serverThread( void* pParam )
+{
+    FakeServer_t* pServer = (FakeServer_t*)pParam;
+    int noDelay = 1;
+    int fd = -1;
+
+    while( ( fd = accept( pServer->listenFd, NULL, NULL ) ) >= 0 )
+    {
+        (void)setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof( noDelay ) );
+        pServer->silent = false;
+        pServer->sessionMs = OS_ClockGetTimeMs();
+        pServer->fd = fd;
+        pServer->sessions++;
+        serverServe( pServer, fd );
+        pServer->fd = -1;
+        close( fd );
+    }
+}
+
+uint16_t FakeServer_Start( FakeServer_t* pServer, FakeServerHook_t hook )
+{
+    uint16_t port = 0;
+
+    memset( pServer, 0, sizeof( *pServer ) );
+    pServer->fd = -1;
+    pServer->hook = hook;
+    port = FakeServer_Listen( &( pServer->listenFd ), 1 );
+    assert( OS_ThreadCreate( &( pServer->thread ), serverThread, pServer, "server", 0 ) == OSSuccess );
+    return port;
+}
+
+void FakeServer_Stop( FakeServer_t* pServer )
+{
+    (void)OS_ThreadDestroy( &( pServer->thread ) );
+    if( pServer->fd >= 0 )
+    {
+        close( pServer->fd );
+        pServer->fd = -1;
+    }
+    close( pServer->listenFd );
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef FAKE_SERVER_H_
+#define FAKE_SERVER_H_
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* OS header. */
+#include "os_posix.h"
+
+/* A fake RTIO server on the loopback interface for the integration tests. It serves the
+ * sessions one after the other on its own thread and answers every frame as a server
+ * would, a hook lets a test record, drop or answer frames itself. The frame helpers
+ * are also used on their own by tests driving the socket themselves. */
+
+#define FAKE_SERVER_HEADER_LEN           ( 5U )
+#define FAKE_SERVER_BODY_MAX             ( 4096U )
+#define FAKE_SERVER_CO_REQ_HEADER_LEN    ( 5U )
+#define FAKE_SERVER_NOTIFY_HEADER_LEN    ( 3U )
+
+#define FAKE_SERVER_TYPE_VERIFY_REQ      ( 1U )
+#define FAKE_SERVER_TYPE_VERIFY_RESP     ( 2U )
+#define FAKE_SERVER_TYPE_PING_REQ        ( 3U )
+#define FAKE_SERVER_TYPE_PING_RESP       ( 4U )
+#define FAKE_SERVER_TYPE_SEND_REQ        ( 5U )
+#define FAKE_SERVER_TYPE_SEND_RESP       ( 6U )
+#define FAKE_SERVER_TYPE_SERVER_REQ      ( 7U )
+#define FAKE_SERVER_TYPE_SERVER_RESP     ( 8U )
+#define FAKE_SERVER_CODE_SUCCESS         ( 1U )
+
+#define FAKE_SERVER_REST_COPOST          ( 2U )
+#define FAKE_SERVER_REST_OBGET           ( 3U )
+#define FAKE_SERVER_STATUS_OK            ( 2U )
+#define FAKE_SERVER_STATUS_CONTINUE      ( 3U )
+#define FAKE_SERVER_STATUS_NOT_FOUND     ( 5U )
+
+typedef struct FakeServerFrame
+{
+    uint8_t type;
+    uint16_t headerId;
+    uint16_t bodyLen;
+    uint8_t body[ FAKE_SERVER_BODY_MAX ];
+} FakeServerFrame_t;
+
+/* Called for each frame received on fd, returns whether the server answers it. */
+typedef bool ( * FakeServerHook_t )( int fd, const FakeServerFrame_t* pFrame );
+
+typedef struct FakeServer
+{
+    int listenFd;
+    volatile int fd;                /* Session being served, -1 between sessions. */
+    FakeServerHook_t hook;          /* NULL answers every frame. */
+    volatile bool silent;           /* Reads frames but answers none, until the next session. */
+    volatile uint32_t delayMs;      /* Before answering a request. */
+    volatile uint32_t sessions;
+    volatile uint32_t sessionMs;    /* When the last session was accepted. */
+    volatile uint32_t pings;
+    volatile uint32_t requests;     /* CoPost requests and notifications. */
+    OSThreadHandle_t thread;
+} FakeServer_t;
+
+/* Listens on a free loopback port, returns the port. */
+uint16_t FakeServer_Listen( int* pListenFd, int backlog );
+
+/* Receives one frame, false once the peer closed or the frame is too long. */
+bool FakeServer_RecvFrame( int fd, FakeServerFrame_t* pFrame );
+
+/* Whether a send request is a notification, otherwise it is a CoPost request. */
+bool FakeServer_IsNotify( const FakeServerFrame_t* pFrame );
+
+/* Data of a CoPost request or a notification, NULL if it has none. */
+const uint8_t* FakeServer_Payload( const FakeServerFrame_t* pFrame );
+
+/* Answers a frame with success: a CoPost request with OK, a notification with continue. */
+void FakeServer_Answer( int fd, const FakeServerFrame_t* pFrame );
+
+/* Sends a CoPost request to the device for the URI digest. */
+bool FakeServer_Post( int fd, uint16_t headerId, uint32_t digest );
+
+/* Listens and serves on a new thread, returns the port. */
+uint16_t FakeServer_Start( FakeServer_t* pServer, FakeServerHook_t hook );
+
+void FakeServer_Stop( FakeServer_t* pServer );
+
+#endif /* ifndef FAKE_SERVER_H_ */
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef TEST_CONFIG_H
+#define TEST_CONFIG_H
+
+/* Config shared by the tests added with rtio_add_integration_test(), which defines TEST_LOG_NAME
+ * from the test name. A test changes the log level with TEST_LOG_LEVEL and the RTIO sizes below
+ * with DEFINITIONS, those are seen by the RTIO sources too. */
+
+/**************************************************/
+/******* DO NOT CHANGE the following order ********/
+/**************************************************/
+
+/* Include logging header files and define logging macros in the following order:
+ * 1. Include the header file "logging_levels.h".
+ * 2. Define the LIBRARY_LOG_NAME and LIBRARY_LOG_LEVEL macros depending on
+ * the logging configuration for TEST.
+ * 3. Include the header file "logging_stack.h", if logging is enabled for TEST.
+ */
+
+#include "logging_levels.h"
+
+/* Logging configuration for the test. */
+#define LIBRARY_LOG_NAME    TEST_LOG_NAME
+#ifdef TEST_LOG_LEVEL
+    #define LIBRARY_LOG_LEVEL    TEST_LOG_LEVEL
+#else
+    #define LIBRARY_LOG_LEVEL    LOG_INFO
+#endif
+#include "logging_stack.h"
+
+/******** End of logging configuration ************/
+
+#ifndef RTIO_COPOST_URI_NUM_MAX
+    #define RTIO_COPOST_URI_NUM_MAX    ( 5U )
+#endif
+#ifndef RTIO_OBGET_URI_NUM_MAX
+    #define RTIO_OBGET_URI_NUM_MAX    ( 5U )
+#endif
+#ifndef RTIO_DEVICE_SEND_RESP_NUM_MAX
+    #define RTIO_DEVICE_SEND_RESP_NUM_MAX    ( 5U )
+#endif
+
+#endif /* ifndef TEST_CONFIG_H */
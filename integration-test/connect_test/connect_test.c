@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Connects to a listening server by name, to a closed port, and to a server whose accept
+ * queue is full, which drops the SYNs as a blackholed address does. The last one must give
+ * up after the attempt timeout instead of the kernel's SYN retries. */
+
+#define TEST_TIMEOUT_MS          ( 300U )
+#define TEST_REFUSED_MS_MAX      ( 100U )
+#define TEST_BLACKHOLE_MS_MAX    ( TEST_TIMEOUT_MS + 200U )
+
+/* Connects and returns the elapsed time, pStatus gets the transport status. */
+static uint32_t connectTimed( NetworkContext_t* pNetworkContext, const char* pHostName, uint16_t port,
+                              TransportStatus_t* pStatus )
+{
+    ServerInfo_t serverInfo = { 0 };
+    uint32_t startMs = 0;
+
+    serverInfo.pHostName = pHostName;
+    serverInfo.hostNameLength = strlen( pHostName );
+    serverInfo.port = port;
+    serverInfo.connectTimeoutMs = TEST_TIMEOUT_MS;
+
+    startMs = OS_ClockGetTimeMs();
+    *pStatus = Plaintext_Connect( pNetworkContext, &serverInfo );
+    return OS_ClockGetTimeMs() - startMs;
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportStatus_t connectedStatus = TransportUnknown;
+    TransportStatus_t refusedStatus = TransportUnknown;
+    TransportStatus_t blackholeStatus = TransportUnknown;
+    uint32_t connectedMs = 0, refusedMs = 0, blackholeMs = 0;
+    int listenFd = -1, closedFd = -1, connectedFd = -1;
+    uint16_t port = 0, closedPort = 0;
+    bool blocking = false;
+
+    networkContext.pParams = &plaintextParams;
+    port = FakeServer_Listen( &listenFd, 0 );
+    closedPort = FakeServer_Listen( &closedFd, 0 );
+    close( closedFd );
+
+    /* Fills the accept queue, the socket is left in blocking mode for send and receive. */
+    connectedMs = connectTimed( &networkContext, "localhost", port, &connectedStatus );
+    if( connectedStatus == TransportSuccess )
+    {
+        connectedFd = plaintextParams.socketDescriptor;
+        blocking = ( fcntl( connectedFd, F_GETFL, 0 ) & O_NONBLOCK ) == 0;
+    }
+
+    refusedMs = connectTimed( &networkContext, "127.0.0.1", closedPort, &refusedStatus );
+    blackholeMs = connectTimed( &networkContext, "127.0.0.1", port, &blackholeStatus );
+
+    printf( "Connected status=%d in %ums blocking=%d, refused status=%d in %ums, blackhole status=%d in %ums.\n",
+            (int)connectedStatus, (unsigned)connectedMs, (int)blocking, (int)refusedStatus, (unsigned)refusedMs,
+            (int)blackholeStatus, (unsigned)blackholeMs );
+
+    if( connectedFd >= 0 )
+    {
+        close( connectedFd );
+    }
+    close( listenFd );
+
+    if( ( connectedStatus != TransportSuccess ) || !blocking ||
+        ( refusedStatus != TransportConnectFailure ) || ( refusedMs > TEST_REFUSED_MS_MAX ) ||
+        ( blackholeStatus != TransportConnectFailure ) || ( blackholeMs < TEST_TIMEOUT_MS ) ||
+        ( blackholeMs > TEST_BLACKHOLE_MS_MAX ) )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+#include "core_rtio_crc32.h"
+
+/* Compares the bitwise, slicing-by-8 and PCLMULQDQ digests of URIs of typical lengths. */
+
+#define BENCH_ROUNDS           ( 1000000U )
+#define BENCH_URI_LENGTH_MAX   ( 128U )
+
+typedef uint32_t ( * benchCrc32_t )( const uint8_t* data, size_t length );
+
+static volatile uint32_t benchSink = 0;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t timeNs( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static void benchCrc32( const char* pName, benchCrc32_t crc32, const uint8_t* pUri, size_t length )
+{
+    uint64_t startNs = 0, usedNs = 0;
+    uint32_t i = 0;
+
+    /* Bit-exact with the reference before it is timed. */
+    assert( crc32( pUri, length ) == crc32IeeeBitwise( pUri, length ) );
+
+    startNs = timeNs();
+    for( i = 0; i < BENCH_ROUNDS; i++ )
+    {
+        benchSink ^= crc32( pUri, length );
+    }
+    usedNs = timeNs() - startNs;
+
+    printf( "%-12s length=%3u ns/digest=%7.2f MB/s=%8.1f\n", pName, (unsigned)length,
+            (double)usedNs / BENCH_ROUNDS, (double)length * BENCH_ROUNDS * 1000.0 / (double)usedNs );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    static const size_t lengths[] = { 8U, 32U, 64U, 128U };
+    uint8_t uri[ BENCH_URI_LENGTH_MAX ];
+    size_t i = 0;
+
+    uri[ 0 ] = '/';
+    for( i = 1; i < sizeof( uri ); i++ )
+    {
+        uri[ i ] = (uint8_t)( 'a' + ( i * 7U ) % 26U );
+    }
+
+    for( i = 0; i < sizeof( lengths ) / sizeof( lengths[ 0 ] ); i++ )
+    {
+        benchCrc32( "bitwise", crc32IeeeBitwise, uri, lengths[ i ] );
+#if ( RTIO_CRC32_SLICING_BY_8 != 0 )
+        benchCrc32( "slicing-by-8", crc32IeeeSlicingBy8, uri, lengths[ i ] );
+#endif
+#ifdef RTIO_CRC32_CLMUL_ENABLED
+        if( crc32IeeeClmulSupported() )
+        {
+            benchCrc32( "pclmulqdq", crc32IeeeClmul, uri, lengths[ i ] );
+        }
+#endif
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -21,6 +21,7 @@
 
 /* RTIO API header. */
 #include "core_rtio.h"
+#include "core_rtio_crc32.h"
 
 
 
@@ -96,6 +97,18 @@ int main()
         strLength = 5 + rand() % 123; /* rand 5-128 */
         randomStr = generateRandomString( strLength );
         digest = crc32Ieee( randomStr, strLength );
+
+        /* Every implementation must give the same digest as the bitwise one. */
+        assert( digest == crc32IeeeBitwise( (uint8_t*)randomStr, strLength ) );
+#if ( RTIO_CRC32_SLICING_BY_8 != 0 )
+        assert( digest == crc32IeeeSlicingBy8( (uint8_t*)randomStr, strLength ) );
+#endif
+#ifdef RTIO_CRC32_CLMUL_ENABLED
+        if( crc32IeeeClmulSupported() )
+        {
+            assert( digest == crc32IeeeClmul( (uint8_t*)randomStr, strLength ) );
+        }
+#endif
         printf( "{\"uri\":\"%s\", \"digest\":\"%u\"}\n", randomStr, digest );
         free( randomStr );
     }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <sys/resource.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* The connection stays idle for this long while CPU time is measured. */
+#define TEST_IDLE_MS           ( 3000U )
+
+/* The incomming thread must not use more than this share of the idle time. */
+#define TEST_CPU_PERCENT_MAX   ( 5U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+
+static FakeServer_t server;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t processCpuTimeUs( void )
+{
+    struct rusage usage;
+
+    getrusage( RUSAGE_SELF, &usage );
+    return (uint64_t)( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000U +
+           (uint64_t)( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    RTIOStatus_t rtioStatus = RTIOUnknown;
+    RTIOContext_t rtioContext = { 0 };
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    uint64_t cpuStartUs = 0, cpuUsedUs = 0;
+    uint32_t percent = 0;
+
+    serverInfo.port = FakeServer_Start( &server, NULL );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    rtioStatus = RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                               NULL, &serverInfo, &deviceInfo );
+    assert( rtioStatus == RTIOSuccess );
+    rtioStatus = RTIO_Serve( &rtioContext );
+    assert( rtioStatus == RTIOSuccess );
+
+    /* Let the threads settle before measuring. */
+    OS_ClockSleepMs( 500U );
+
+    cpuStartUs = processCpuTimeUs();
+    OS_ClockSleepMs( TEST_IDLE_MS );
+    cpuUsedUs = processCpuTimeUs() - cpuStartUs;
+    percent = (uint32_t)( cpuUsedUs / ( TEST_IDLE_MS * 10U ) );
+
+    printf( "Idle for %u ms, cpu used %u us (%u%%).\n",
+            TEST_IDLE_MS, (unsigned)cpuUsedUs, (unsigned)percent );
+
+    RTIO_Disconnect( &rtioContext );
+    FakeServer_Stop( &server );
+
+    if( percent > TEST_CPU_PERCENT_MAX )
+    {
+        printf( "FAILED: the connection is idle but the cpu is busy.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <unistd.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS, Transport and Storage header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+#include "storage_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+#include "core_rtio_journal.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Records are appended while offline and the journal is reopened after a torn append, as
+ * after a power loss. Once connected the backlog is replayed in order at the configured
+ * rate: the server leaves one record unanswered, it is sent again with the ones behind it,
+ * and a live request made meanwhile is not held up by the backlog. Reopened, the journal
+ * has nothing left to send. At last more records than the storage holds are appended and
+ * the oldest are dropped. */
+
+#define TEST_TIMEOUT_MS          ( 10000U )
+#define TEST_SEGMENT_SIZE        ( 4096U )
+#define TEST_SEGMENT_NUM         ( 4U )
+#define TEST_RECORD_NUM          ( 45U ) /* Appended offline, one more after reopening. */
+#define TEST_DATA_LEN            ( 100U )
+#define TEST_RATE                ( 50U )
+#define TEST_UNANSWERED          ( 10U ) /* The server does not answer it the first time. */
+#define TEST_LIVE_AFTER          ( 20U ) /* Records received before the live request. */
+#define TEST_LIVE_MS_MAX         ( 200U )
+#define TEST_LIVE_TAG            ( 0xFFFFU )
+#define TEST_OVERFLOW_NUM        ( 150U )
+#define TEST_OBID                ( 7U )
+#define TEST_FRAMES_MAX          ( 256U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+static RTIOContext_t rtioContext = { 0 };
+
+RTIOJournalRamAllocationGlobal_t journalFixedRAM = { 0 };
+static RTIOJournalFixedResource_t journalFixedResource = RTIO_JournalResourceBuild( journalFixedRAM );
+static RTIOJournal_t journal = { 0 };
+static StorageContext_t storageContext = { 0 };
+static StorageInterface_t storage = { 0 };
+static char storageDir[] = "/tmp/journal_test_XXXXXX";
+static char storagePrefix[ 64 ];
+
+static FakeServer_t server;
+static volatile uint16_t serverTags[ TEST_FRAMES_MAX ];
+static volatile uint32_t serverTimesMs[ TEST_FRAMES_MAX ];
+static volatile uint32_t serverFrames = 0;
+static volatile bool unansweredOnce = false;
+
+/*-----------------------------------------------------------*/
+
+/* Records the tag of a request, returns whether to answer it. */
+static bool serverRecord( int fd, const FakeServerFrame_t* pFrame )
+{
+    const uint8_t* pData = FakeServer_Payload( pFrame );
+    uint16_t tag = 0;
+
+    (void)fd;
+    if( pData == NULL )
+    {
+        return true;
+    }
+    tag = (uint16_t)( ( pData[ 0 ] << 8 ) | pData[ 1 ] );
+    if( serverFrames < TEST_FRAMES_MAX )
+    {
+        serverTags[ serverFrames ] = tag;
+        serverTimesMs[ serverFrames ] = OS_ClockGetTimeMs();
+    }
+    serverFrames++;
+    if( ( tag == TEST_UNANSWERED ) && !unansweredOnce )
+    {
+        unansweredOnce = true;
+        return false;
+    }
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+static void journalOpen( void )
+{
+    assert( StoragePosix_Open( &storageContext, &storage, storagePrefix, TEST_SEGMENT_SIZE, TEST_SEGMENT_NUM ) == StorageSuccess );
+    assert( RTIO_JournalOpen( &journal, &journalFixedResource, &storage ) == RTIOSuccess );
+}
+
+static void journalClose( void )
+{
+    assert( RTIO_JournalClose( &journal ) == RTIOSuccess );
+    assert( StoragePosix_Close( &storageContext ) == StorageSuccess );
+}
+
+static RTIOJournalStats_t journalStats( void )
+{
+    RTIOJournalStats_t stats = { 0 };
+
+    assert( RTIO_JournalGetStats( &journal, &stats ) == RTIOSuccess );
+    return stats;
+}
+
+/* Every tenth record is a notification, the first two data bytes are the tag. */
+static void append( uint16_t tag )
+{
+    uint8_t data[ TEST_DATA_LEN ];
+
+    memset( data, (int)tag, sizeof( data ) );
+    data[ 0 ] = (uint8_t)( tag >> 8 );
+    data[ 1 ] = (uint8_t)tag;
+    if( ( tag % 10U ) == 9U )
+    {
+        assert( RTIO_JournalObNotify( &journal, TEST_OBID, data, sizeof( data ) ) == RTIOSuccess );
+    }
+    else
+    {
+        assert( RTIO_JournalCoPost( &journal, 1U, data, sizeof( data ) ) == RTIOSuccess );
+    }
+}
+
+/* A crash in the middle of an append leaves a record header without the rest. */
+static void closeTorn( void )
+{
+    uint8_t torn[ 12 ] = { 0x4A, 0x52, 1, 0, 0, TEST_DATA_LEN + 4U, 0, 0, 0, 99, 0x12, 0x34 };
+
+    assert( RTIO_JournalClose( &journal ) == RTIOSuccess );
+    assert( storage.write( storage.pStorageContext, (uint16_t)( journal.activeGeneration % TEST_SEGMENT_NUM ),
+                           journal.writeOffset, torn, sizeof( torn ) ) == StorageSuccess );
+    assert( StoragePosix_Close( &storageContext ) == StorageSuccess );
+}
+
+/* Tags of the records must first arrive in order, resends only go back. */
+static bool replayedInOrder( uint32_t frames, uint16_t recordNum, uint32_t* pFirstMs, uint32_t* pLastMs )
+{
+    uint16_t expected = 0;
+    uint32_t i = 0;
+
+    for( i = 0; ( i < frames ) && ( i < TEST_FRAMES_MAX ); i++ )
+    {
+        if( serverTags[ i ] == TEST_LIVE_TAG )
+        {
+            continue;
+        }
+        if( serverTags[ i ] > expected )
+        {
+            printf( "Gap at frame %u: tag %u, expected %u.\n", (unsigned)i, serverTags[ i ], expected );
+            return false;
+        }
+        if( serverTags[ i ] == expected )
+        {
+            if( expected == 0U )
+            {
+                *pFirstMs = serverTimesMs[ i ];
+            }
+            *pLastMs = serverTimesMs[ i ];
+            expected++;
+        }
+    }
+    return expected == recordNum;
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    RTIOJournalStats_t stats = { 0 };
+    uint8_t liveData[ 2 ] = { (uint8_t)( TEST_LIVE_TAG >> 8 ), (uint8_t)TEST_LIVE_TAG };
+    uint8_t liveResp[ 8 ] = { 0 };
+    RTIOFixedBuffer_t liveBuffer = { liveResp, sizeof( liveResp ) };
+    uint16_t liveLength = 0;
+    RTIOStatus_t liveStatus = RTIOUnknown;
+    uint32_t liveMs = 0, firstMs = 0, lastMs = 0, startMs = 0, generation = 0;
+    bool passed = true, torn = false, inOrder = false;
+    uint16_t i = 0;
+    char path[ 96 ];
+
+    assert( mkdtemp( storageDir ) != NULL );
+    (void)snprintf( storagePrefix, sizeof( storagePrefix ), "%s/journal", storageDir );
+
+    /* Offline: records go to the journal, the last append is torn. */
+    journalOpen();
+    for( i = 0; i < TEST_RECORD_NUM; i++ )
+    {
+        append( i );
+    }
+    closeTorn();
+
+    journalOpen();
+    stats = journalStats();
+    torn = ( journal.writeOffset == TEST_SEGMENT_SIZE );
+    generation = journal.activeGeneration;
+    append( TEST_RECORD_NUM );
+    printf( "Reopened: backlog=%u, torn tail=%d, appended in generation %u after %u.\n",
+            (unsigned)stats.backlog, (int)torn, (unsigned)journal.activeGeneration, (unsigned)generation );
+    passed = ( stats.backlog == TEST_RECORD_NUM ) && torn && ( journal.activeGeneration == generation + 1U ) &&
+             ( journalStats().backlog == TEST_RECORD_NUM + 1U );
+
+    /* Online: the backlog is replayed at TEST_RATE records per second. */
+    serverInfo.port = FakeServer_Start( &server, serverRecord );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_Serve( &rtioContext ) == RTIOSuccess );
+    assert( RTIO_JournalStartReplay( &journal, &rtioContext, TEST_RATE ) == RTIOSuccess );
+
+    startMs = OS_ClockGetTimeMs();
+    while( ( serverFrames < TEST_LIVE_AFTER ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    liveMs = OS_ClockGetTimeMs();
+    liveStatus = RTIO_CoPost( &rtioContext, "/journal/live", liveData, sizeof( liveData ),
+                              &liveBuffer, &liveLength, TEST_TIMEOUT_MS );
+    liveMs = OS_ClockGetTimeMs() - liveMs;
+
+    while( ( journalStats().backlog > 0U ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    assert( RTIO_JournalStopReplay( &journal ) == RTIOSuccess );
+    stats = journalStats();
+    inOrder = replayedInOrder( serverFrames, TEST_RECORD_NUM + 1U, &firstMs, &lastMs );
+    printf( "Replayed=%u retries=%u backlog=%u in %ums over %u frames, in order=%d, live status=%d in %ums.\n",
+            (unsigned)stats.replayed, (unsigned)stats.retries, (unsigned)stats.backlog, (unsigned)( lastMs - firstMs ),
+            (unsigned)serverFrames, (int)inOrder, (int)liveStatus, (unsigned)liveMs );
+    passed = passed && inOrder && ( stats.replayed == TEST_RECORD_NUM + 1U ) && ( stats.backlog == 0U ) &&
+             ( stats.retries >= 1U ) && ( lastMs - firstMs >= TEST_RECORD_NUM * 1000U / TEST_RATE - 20U ) &&
+             ( liveStatus == RTIOSuccess ) && ( liveMs < TEST_LIVE_MS_MAX );
+    journalClose();
+
+    journalOpen();
+    stats = journalStats();
+    printf( "Reopened after the replay: backlog=%u.\n", (unsigned)stats.backlog );
+    passed = passed && ( stats.backlog == 0U );
+
+    /* Overflow: the oldest segment is erased with its records. */
+    for( i = 0; i < TEST_OVERFLOW_NUM; i++ )
+    {
+        append( i );
+    }
+    stats = journalStats();
+    journalClose();
+    journalOpen();
+    printf( "Overflow: appended=%u dropped=%u backlog=%u, reopened backlog=%u.\n", (unsigned)stats.appended,
+            (unsigned)stats.dropped, (unsigned)stats.backlog, (unsigned)journalStats().backlog );
+    passed = passed && ( stats.dropped > 0U ) && ( stats.dropped + stats.backlog == TEST_OVERFLOW_NUM ) &&
+             ( journalStats().backlog == stats.backlog );
+    journalClose();
+
+    (void)RTIO_Disconnect( &rtioContext );
+    FakeServer_Stop( &server );
+    for( i = 0; i < TEST_SEGMENT_NUM; i++ )
+    {
+        (void)snprintf( path, sizeof( path ), "%s.%u", storagePrefix, (unsigned)i );
+        (void)unlink( path );
+    }
+    (void)rmdir( storageDir );
+
+    if( !passed )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* While requests are answered, frames go both ways and no ping is sent. On a quiet session
+ * pings go out every heartbeat and the session stays up. Then the server reads everything
+ * but answers nothing: requests still go out, pings follow as nothing comes back, and the
+ * device reconnects once nothing was received for RTIO_RX_IDLE_TIMEOUT_MS. */
+
+#define TEST_PHASE_MS            ( 3500U )
+#define TEST_POST_INTERVAL_MS    ( 50U )
+#define TEST_POST_TIMEOUT_MS     ( 100U )
+#define TEST_WAIT_MS             ( 8000U )
+#define TEST_SLACK_MS            ( 500U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+static RTIOContext_t rtioContext = { 0 };
+
+static FakeServer_t server;
+
+/*-----------------------------------------------------------*/
+
+/* Posts every TEST_POST_INTERVAL_MS for durationMs or until a reconnect, returns the successes. */
+static uint32_t postFor( uint32_t durationMs )
+{
+    uint8_t data[ 4 ] = { 1, 2, 3, 4 };
+    uint8_t respData[ 8 ] = { 0 };
+    RTIOFixedBuffer_t respBuffer = { respData, sizeof( respData ) };
+    uint16_t respLength = 0;
+    uint32_t startMs = OS_ClockGetTimeMs(), connected = server.sessions, succeeded = 0;
+
+    while( ( ( OS_ClockGetTimeMs() - startMs ) < durationMs ) && ( server.sessions == connected ) )
+    {
+        if( RTIO_CoPost( &rtioContext, "/keepalive", data, sizeof( data ), &respBuffer, &respLength,
+                         TEST_POST_TIMEOUT_MS ) == RTIOSuccess )
+        {
+            succeeded++;
+        }
+        OS_ClockSleepMs( TEST_POST_INTERVAL_MS );
+    }
+    return succeeded;
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    uint32_t posted = 0, pingsBefore = 0, silentMs = 0, reconnectMs = 0;
+    bool passed = true;
+
+    serverInfo.port = FakeServer_Start( &server, NULL );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_Serve( &rtioContext ) == RTIOSuccess );
+
+    /* Busy: requests answered both ways, no ping needed. */
+    posted = postFor( TEST_PHASE_MS );
+    printf( "Busy: posted=%u, requests=%u, pings=%u, connects=%u.\n",
+            (unsigned)posted, (unsigned)server.requests, (unsigned)server.pings, (unsigned)server.sessions );
+    passed = ( posted == server.requests ) && ( posted > 10U ) && ( server.pings == 0U ) && ( server.sessions == 1U );
+
+    /* Quiet: pings every heartbeat keep the session up. */
+    pingsBefore = server.pings;
+    OS_ClockSleepMs( TEST_PHASE_MS );
+    printf( "Quiet: pings=%u, connects=%u.\n", (unsigned)( server.pings - pingsBefore ), (unsigned)server.sessions );
+    passed = passed && ( server.pings - pingsBefore >= 3U ) && ( server.sessions == 1U );
+
+    /* Dead: requests still go out, nothing comes back, the device pings and reconnects. */
+    /* An answered request first, so nothing was received since the server went silent. */
+    (void)postFor( TEST_POST_INTERVAL_MS );
+    pingsBefore = server.pings;
+    server.silent = true;
+    silentMs = OS_ClockGetTimeMs();
+    posted = postFor( TEST_WAIT_MS );
+    reconnectMs = server.sessionMs - silentMs;
+    printf( "Dead: posted=%u, pings=%u, connects=%u, reconnected after %ums.\n", (unsigned)posted,
+            (unsigned)( server.pings - pingsBefore ), (unsigned)server.sessions, (unsigned)reconnectMs );
+    passed = passed && ( posted == 0U ) && ( server.pings - pingsBefore >= 1U ) && ( server.sessions == 2U ) &&
+             ( reconnectMs >= RTIO_RX_IDLE_TIMEOUT_MS - TEST_SLACK_MS ) &&
+             ( reconnectMs <= RTIO_RX_IDLE_TIMEOUT_MS + TEST_SLACK_MS );
+
+    /* Reconnected: answered again. */
+    OS_ClockSleepMs( TEST_SLACK_MS );
+    posted = postFor( TEST_PHASE_MS / 4U );
+    printf( "Reconnected: posted=%u, connects=%u.\n", (unsigned)posted, (unsigned)server.sessions );
+    passed = passed && ( posted > 0U ) && ( server.sessions == 2U );
+
+    (void)RTIO_Disconnect( &rtioContext );
+    FakeServer_Stop( &server );
+
+    if( !passed )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* The transport is stalled while a producer floods notifications, which may only take the
+ * frames above the reserve of the urgent lanes. A request posted and a server request
+ * answered meanwhile must still get frames and go out ahead of the queued notifications. */
+
+#define TEST_BULK_NUM            ( 20U )
+#define TEST_BULK_QUEUED         ( RTIO_SEND_QUEUE_FRAME_NUM - ( RTIO_SEND_LANE_NUM - 1U ) * RTIO_SEND_QUEUE_LANE_RESERVE )
+#define TEST_FRAME_NUM           ( TEST_BULK_NUM + 2U )
+#define TEST_TIMEOUT_MS          ( 5000U )
+#define TEST_SETTLE_MS           ( 50U )
+
+/* Kinds of the frames the server received, in order. */
+#define TEST_KIND_NOTIFY         ( 1U )
+#define TEST_KIND_REQUEST        ( 2U )
+#define TEST_KIND_RESPONSE       ( 3U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+static RTIOContext_t rtioContext = { 0 };
+
+static FakeServer_t server;
+static volatile bool gateClosed = false;
+static volatile uint32_t bulkPosted = 0;
+static volatile uint32_t bulkContinued = 0;
+static volatile uint32_t handlerCalls = 0;
+static volatile uint32_t postCalls = 0;
+static volatile RTIOStatus_t postStatus = RTIOUnknown;
+static volatile uint8_t serverKinds[ TEST_FRAME_NUM ];
+static volatile uint32_t serverFrames = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Holds every write while the gate is closed, as a congested link would. */
+static int32_t gatedSend( NetworkContext_t* pNetworkContext, const void* pBuffer, size_t bytesToSend )
+{
+    while( gateClosed )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    return Plaintext_Send( pNetworkContext, pBuffer, bytesToSend );
+}
+
+static int32_t gatedSendv( NetworkContext_t* pNetworkContext, const TransportIoVector_t* pIoVec, size_t ioVecCount )
+{
+    while( gateClosed )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    return Plaintext_Sendv( pNetworkContext, pIoVec, ioVecCount );
+}
+
+/*-----------------------------------------------------------*/
+
+static void notifyDone( void* pUserData, RTIOStatus_t status, uint16_t obId )
+{
+    (void)pUserData;
+    (void)obId;
+    if( status == RTIOContinue )
+    {
+        (void)__sync_fetch_and_add( &bulkContinued, 1U );
+    }
+}
+
+static void postDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    (void)pUserData;
+    (void)pRespData;
+    (void)respLength;
+    postStatus = status;
+    postCalls++;
+}
+
+static RTIOStatus_t laneHandler( uint8_t* pReqData, uint16_t reqLength,
+                                 RTIOFixedBuffer_t* pRespBuffer, uint16_t* pRespLength )
+{
+    (void)pReqData;
+    (void)reqLength;
+    (void)pRespBuffer;
+    *pRespLength = 0;
+    handlerCalls++;
+    return RTIOSuccess;
+}
+
+/* Blocks in the send queue once the bulk lane is used up, until the gate opens. */
+static void floodThread( void* pParam )
+{
+    static uint8_t payload[ 32 ] = { 0 };
+    uint32_t i = 0;
+
+    (void)pParam;
+    for( i = 0; i < TEST_BULK_NUM; i++ )
+    {
+        assert( RTIO_ObNotifyAsync( &rtioContext, payload, sizeof( payload ), (uint16_t)( i + 1U ),
+                                    TEST_TIMEOUT_MS, notifyDone, NULL ) == RTIOSuccess );
+        bulkPosted++;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Records the order of notifications, requests and responses, answers every frame. */
+static bool serverRecord( int fd, const FakeServerFrame_t* pFrame )
+{
+    uint8_t kind = 0;
+
+    (void)fd;
+    if( FakeServer_IsNotify( pFrame ) )
+    {
+        kind = TEST_KIND_NOTIFY;
+    }
+    else if( pFrame->type == FAKE_SERVER_TYPE_SEND_REQ )
+    {
+        kind = TEST_KIND_REQUEST;
+    }
+    else if( pFrame->type == FAKE_SERVER_TYPE_SERVER_RESP )
+    {
+        kind = TEST_KIND_RESPONSE;
+    }
+    else
+    {
+        return true;
+    }
+
+    if( serverFrames < TEST_FRAME_NUM )
+    {
+        serverKinds[ serverFrames ] = kind;
+    }
+    serverFrames++;
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    OSThreadHandle_t floodHandle = { 0 };
+    char postPayload[] = "urgent";
+    uint8_t respData[ 8 ] = { 0 };
+    RTIOFixedBuffer_t respBuffer = { respData, sizeof( respData ) };
+    uint32_t digest = 0, startMs = 0, stalled = 0, postMs = 0;
+    bool ordered = false;
+    uint32_t i = 0;
+
+    serverInfo.port = FakeServer_Start( &server, serverRecord );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = gatedSend;
+    transport.sendv = gatedSendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_RegisterCoPostHandler( &rtioContext, "/lane", laneHandler ) == RTIOSuccess );
+    assert( RTIO_Serve( &rtioContext ) == RTIOSuccess );
+    assert( RTIO_URIHash( "/lane", &digest ) == RTIOSuccess );
+
+    /* The writer takes the first notification and stalls, the others fill the bulk lane. */
+    gateClosed = true;
+    assert( OS_ThreadCreate( &floodHandle, floodThread, NULL, "flood", 0 ) == OSSuccess );
+    startMs = OS_ClockGetTimeMs();
+    while( ( stalled < TEST_SETTLE_MS ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        stalled = ( bulkPosted == TEST_BULK_QUEUED ) ? stalled + 1U : 0U;
+        OS_ClockSleepMs( 1U );
+    }
+
+    /* The reserve lets the urgent lanes in although the producer is blocked. */
+    startMs = OS_ClockGetTimeMs();
+    assert( RTIO_CoPostAsync( &rtioContext, digest, (uint8_t*)postPayload, (uint16_t)strlen( postPayload ),
+                              &respBuffer, TEST_TIMEOUT_MS, postDone, NULL ) == RTIOSuccess );
+    postMs = OS_ClockGetTimeMs() - startMs;
+    /* Posts to the device, whose response then needs a frame of the response lane. */
+    assert( FakeServer_Post( server.fd, 1U, digest ) );
+    startMs = OS_ClockGetTimeMs();
+    while( ( handlerCalls == 0U ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    OS_ClockSleepMs( TEST_SETTLE_MS );
+    printf( "Bulk posted %u/%u while stalled, request posted in %ums, handler calls=%u.\n",
+            (unsigned)bulkPosted, (unsigned)TEST_BULK_NUM, (unsigned)postMs, (unsigned)handlerCalls );
+
+    gateClosed = false;
+    startMs = OS_ClockGetTimeMs();
+    while( ( ( serverFrames < TEST_FRAME_NUM ) || ( bulkContinued < TEST_BULK_NUM ) || ( postCalls == 0U ) ) &&
+           ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+
+    /* The stalled notification went first, then the urgent lanes, then the rest of the bulk. */
+    ordered = ( serverFrames == TEST_FRAME_NUM ) && ( serverKinds[ 0 ] == TEST_KIND_NOTIFY ) &&
+              ( serverKinds[ 1 ] == TEST_KIND_RESPONSE ) && ( serverKinds[ 2 ] == TEST_KIND_REQUEST );
+    for( i = 3; ordered && ( i < TEST_FRAME_NUM ); i++ )
+    {
+        ordered = ( serverKinds[ i ] == TEST_KIND_NOTIFY );
+    }
+    printf( "Server frames=%u, order:", (unsigned)serverFrames );
+    for( i = 0; ( i < serverFrames ) && ( i < TEST_FRAME_NUM ); i++ )
+    {
+        printf( " %u", (unsigned)serverKinds[ i ] );
+    }
+    printf( ", notifications continued=%u, request calls=%u status=%d.\n",
+            (unsigned)bulkContinued, (unsigned)postCalls, (int)postStatus );
+
+    (void)RTIO_Disconnect( &rtioContext );
+    OS_ThreadDestroy( &floodHandle );
+    FakeServer_Stop( &server );
+
+    if( !ordered || ( stalled < TEST_SETTLE_MS ) || ( postMs > TEST_SETTLE_MS ) || ( handlerCalls != 1U ) ||
+        ( bulkContinued != TEST_BULK_NUM ) || ( postCalls != 1U ) || ( postStatus != RTIOSuccess ) )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
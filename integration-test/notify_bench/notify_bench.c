@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Notifies 1, 16 and 256 observers with the same payload through RTIO_ObListNotifyAll
+ * and prints the CPU time the notifying thread spends per notification. */
+
+#define BENCH_OBSERVERS_MAX    ( 256U )
+#define BENCH_NOTIFY_ROUNDS    ( 100U )
+#define BENCH_PAYLOAD_LENGTH   ( 256U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+
+static FakeServer_t server;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t timeUs( clockid_t clock )
+{
+    struct timespec ts;
+
+    clock_gettime( clock, &ts );
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static void benchNotifyAll( RTIOContext_t* pContext, const char* pMode, uint16_t observers )
+{
+    static uint16_t obArray[ BENCH_OBSERVERS_MAX ];
+    static uint8_t payload[ BENCH_PAYLOAD_LENGTH ];
+    OSMutex_t obLock;
+    RTIO_ObList_t obList = { 0 };
+    uint64_t cpuStartUs = 0, wallStartUs = 0, cpuUs = 0, wallUs = 0;
+    uint32_t notifications = 0;
+    uint16_t i = 0;
+
+    memset( payload, 'x', sizeof( payload ) );
+    obList.pArray = obArray;
+    obList.arraySize = observers;
+    obList.pLock = &obLock;
+    assert( RTIO_ObListInit( &obList ) == RTIOSuccess );
+    for( i = 0; i < observers; i++ )
+    {
+        obArray[ i ] = 0;
+        assert( RTIO_ObListAdd( &obList, (uint16_t)( i + 1U ) ) == RTIOSuccess );
+    }
+
+    cpuStartUs = timeUs( CLOCK_THREAD_CPUTIME_ID );
+    wallStartUs = timeUs( CLOCK_MONOTONIC );
+    for( i = 0; i < BENCH_NOTIFY_ROUNDS; i++ )
+    {
+        (void)RTIO_ObListNotifyAll( pContext, &obList, payload, sizeof( payload ) );
+    }
+    cpuUs = timeUs( CLOCK_THREAD_CPUTIME_ID ) - cpuStartUs;
+    wallUs = timeUs( CLOCK_MONOTONIC ) - wallStartUs;
+    notifications = (uint32_t)BENCH_NOTIFY_ROUNDS * observers;
+
+    assert( RTIO_ObListGetObNumberNotRealtime( &obList ) == observers );
+    printf( "%-8s observers=%3u notifications=%6u cpu/notify=%6.2f us wall/notify=%7.2f us\n",
+            pMode, observers, (unsigned)notifications,
+            (double)cpuUs / notifications, (double)wallUs / notifications );
+    fflush( stdout );
+
+    (void)RTIO_ObListDeInit( &obList );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    RTIOStatus_t rtioStatus = RTIOUnknown;
+    RTIOContext_t rtioContext = { 0 };
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    static const uint16_t observers[] = { 1U, 16U, 256U };
+    uint16_t i = 0;
+
+    serverInfo.port = FakeServer_Start( &server, NULL );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    rtioStatus = RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                               NULL, &serverInfo, &deviceInfo );
+    assert( rtioStatus == RTIOSuccess );
+    rtioStatus = RTIO_Serve( &rtioContext );
+    assert( rtioStatus == RTIOSuccess );
+
+    for( i = 0; i < sizeof( observers ) / sizeof( observers[ 0 ] ); i++ )
+    {
+        benchNotifyAll( &rtioContext, "sendv", observers[ i ] );
+    }
+
+    /* The same connection without sendv, the payload is copied into the outgoing buffer. */
+    rtioContext.transportInterface.sendv = NULL;
+    for( i = 0; i < sizeof( observers ) / sizeof( observers[ 0 ] ); i++ )
+    {
+        benchNotifyAll( &rtioContext, "send", observers[ i ] );
+    }
+
+    FakeServer_Stop( &server );
+    return EXIT_SUCCESS;
+}
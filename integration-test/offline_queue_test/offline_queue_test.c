@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <sys/socket.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* The server drops the session and reconnects are refused for a while. Requests made
+ * meanwhile are held: one expires, the oldest ones are dropped as the queue overflows, and
+ * the rest, a synchronous notification among them, are replayed in order after the
+ * reconnect, ahead of a request made afterwards. */
+
+#define TEST_TIMEOUT_MS          ( 5000U )
+#define TEST_SHORT_TIMEOUT_MS    ( 200U )
+#define TEST_REQUEST_NUM         ( 8U ) /* A to H, tagged by their first payload byte. */
+#define TEST_SYNC_TAG            ( 'G' )
+#define TEST_OBID                ( 7U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+static RTIOContext_t rtioContext = { 0 };
+
+static FakeServer_t server;
+static volatile bool refuseConnect = false;
+static volatile uint8_t serverTags[ TEST_REQUEST_NUM ];
+static volatile uint32_t serverFrames = 0;
+static volatile RTIOStatus_t doneStatus[ TEST_REQUEST_NUM ];
+static volatile uint32_t doneCalls = 0;
+static volatile bool syncDone = false;
+
+/*-----------------------------------------------------------*/
+
+/* Refuses to connect while the server is "down". */
+static TransportStatus_t gatedConnect( NetworkContext_t* pNetworkContext,
+                                       const TransportOption_t* pTransportOption,
+                                       const ServerInfo_t* pServerInfo )
+{
+    if( refuseConnect )
+    {
+        return TransportConnectFailure;
+    }
+    return Plaintext_ConnectWithOption( pNetworkContext, pTransportOption, pServerInfo );
+}
+
+/*-----------------------------------------------------------*/
+
+static void postDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    (void)pRespData;
+    (void)respLength;
+    doneStatus[ (uintptr_t)pUserData - 'A' ] = status;
+    (void)__sync_fetch_and_add( &doneCalls, 1U );
+}
+
+static void post( uint8_t* pTag, uint32_t timeoutMs )
+{
+    static uint8_t respData[ TEST_REQUEST_NUM ][ 8 ];
+    static RTIOFixedBuffer_t respBuffers[ TEST_REQUEST_NUM ];
+    uint32_t i = *pTag - 'A';
+
+    respBuffers[ i ].pBuffer = respData[ i ];
+    respBuffers[ i ].size = sizeof( respData[ i ] );
+    assert( RTIO_CoPostAsync( &rtioContext, 1U, pTag, 1U, &respBuffers[ i ], timeoutMs,
+                              postDone, (void*)(uintptr_t)*pTag ) == RTIOSuccess );
+}
+
+/* The synchronous notification blocks until it is replayed and answered. */
+static void notifyThread( void* pParam )
+{
+    static uint8_t tag = TEST_SYNC_TAG;
+
+    (void)pParam;
+    doneStatus[ tag - 'A' ] = RTIO_ObNotify( &rtioContext, &tag, 1U, TEST_OBID, TEST_TIMEOUT_MS );
+    syncDone = true;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Records the tag of each request in the order received, answers every frame. */
+static bool serverRecord( int fd, const FakeServerFrame_t* pFrame )
+{
+    const uint8_t* pData = FakeServer_Payload( pFrame );
+
+    (void)fd;
+    if( pData != NULL )
+    {
+        if( serverFrames < TEST_REQUEST_NUM )
+        {
+            serverTags[ serverFrames ] = pData[ 0 ];
+        }
+        serverFrames++;
+    }
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Waits up to TEST_TIMEOUT_MS for pDone, returns its last value. */
+static bool waitFor( volatile bool* pDone )
+{
+    uint32_t startMs = OS_ClockGetTimeMs();
+
+    while( !*pDone && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    return *pDone;
+}
+
+static uint32_t heldRequests( void )
+{
+    RTIOOfflineStats_t stats = { 0 };
+
+    assert( RTIO_GetOfflineStats( &rtioContext, &stats ) == RTIOSuccess );
+    return stats.queued;
+}
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    OSThreadHandle_t notifyHandle = { 0 };
+    RTIOOfflineStats_t stats = { 0 };
+    static uint8_t tags[ TEST_REQUEST_NUM ] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H' };
+    static const uint8_t replayed[] = { 'D', 'E', 'F', 'G', 'H' };
+    bool passed = true;
+    uint32_t i = 0, startMs = 0;
+
+    for( i = 0; i < TEST_REQUEST_NUM; i++ )
+    {
+        doneStatus[ i ] = RTIOUnknown;
+    }
+    serverInfo.port = FakeServer_Start( &server, serverRecord );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = gatedConnect;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_Serve( &rtioContext ) == RTIOSuccess );
+    assert( server.sessions == 1U );
+
+    /* The server goes down, the device notices and keeps reconnecting. */
+    refuseConnect = true;
+    (void)shutdown( server.fd, SHUT_RDWR );
+    startMs = OS_ClockGetTimeMs();
+    while( ( rtioContext.connectStatus != RTIOConnecting ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    assert( rtioContext.connectStatus == RTIOConnecting );
+
+    /* A gives up before the reconnect, B and C are dropped for F and G as the queue holds 4. */
+    post( &tags[ 0 ], TEST_SHORT_TIMEOUT_MS );
+    OS_ClockSleepMs( TEST_SHORT_TIMEOUT_MS + 100U );
+    for( i = 1; i < 6U; i++ )
+    {
+        post( &tags[ i ], TEST_TIMEOUT_MS );
+    }
+    assert( OS_ThreadCreate( &notifyHandle, notifyThread, NULL, "notify", 0 ) == OSSuccess );
+    startMs = OS_ClockGetTimeMs();
+    while( ( heldRequests() < 7U ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    printf( "Held %u requests while reconnecting, callbacks=%u, server frames=%u.\n",
+            (unsigned)heldRequests(), (unsigned)doneCalls, (unsigned)serverFrames );
+    passed = ( heldRequests() == 7U ) && ( serverFrames == 0U ) && ( doneCalls == 3U ) &&
+             ( doneStatus[ 0 ] == RTIOTimeout ) && ( doneStatus[ 1 ] == RTIOListFull ) &&
+             ( doneStatus[ 2 ] == RTIOListFull );
+
+    /* The server is back, the held requests go first. */
+    refuseConnect = false;
+    passed = waitFor( &syncDone ) && passed;
+    post( &tags[ 7 ], TEST_TIMEOUT_MS );
+    startMs = OS_ClockGetTimeMs();
+    while( ( ( serverFrames < sizeof( replayed ) ) || ( doneCalls < 7U ) ) &&
+           ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    assert( RTIO_GetOfflineStats( &rtioContext, &stats ) == RTIOSuccess );
+
+    printf( "Sessions=%u, server frames=%u, order:", (unsigned)server.sessions, (unsigned)serverFrames );
+    for( i = 0; ( i < serverFrames ) && ( i < TEST_REQUEST_NUM ); i++ )
+    {
+        printf( " %c", serverTags[ i ] );
+    }
+    printf( ", status:" );
+    for( i = 0; i < TEST_REQUEST_NUM; i++ )
+    {
+        printf( " %d", (int)doneStatus[ i ] );
+    }
+    printf( ", queued=%u replayed=%u dropped=%u expired=%u.\n", (unsigned)stats.queued, (unsigned)stats.replayed,
+            (unsigned)stats.dropped, (unsigned)stats.expired );
+
+    passed = passed && ( server.sessions == 2U ) && ( serverFrames == sizeof( replayed ) ) &&
+             ( stats.queued == 7U ) && ( stats.replayed == 4U ) && ( stats.dropped == 2U ) && ( stats.expired == 1U ) &&
+             ( doneStatus[ TEST_SYNC_TAG - 'A' ] == RTIOContinue );
+    for( i = 0; passed && ( i < sizeof( replayed ) ); i++ )
+    {
+        passed = ( serverTags[ i ] == replayed[ i ] ) &&
+                 ( ( replayed[ i ] == TEST_SYNC_TAG ) || ( doneStatus[ replayed[ i ] - 'A' ] == RTIOSuccess ) );
+    }
+
+    (void)RTIO_Disconnect( &rtioContext );
+    OS_ThreadDestroy( &notifyHandle );
+    FakeServer_Stop( &server );
+
+    if( !passed )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
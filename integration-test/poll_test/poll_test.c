@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <dirent.h>
+#include <pthread.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Serves a context from the main thread with RTIO_Poll, no RTIO thread is created. Answered
+ * and dropped asynchronous requests and a server request must all be handled on the main
+ * thread, the dropped ones time out on time. A deadline one revolution ahead shares the cursor
+ * slot of the timer wheel and must not hide the nearer ones from RTIO_GetNextWaitMs. */
+
+#define TEST_ANSWERED_NUM        ( 4U )
+#define TEST_DROP_NUM            ( 2U )
+#define TEST_POLL_TIMEOUT_MS     ( 1000U )
+#define TEST_LATE_MS_MAX         ( 40U )
+#define TEST_DONE_WAIT_MS        ( 2000U )
+#define TEST_REVOLUTION_MS       ( RTIO_TIMER_WHEEL_SLOT_NUM * RTIO_TIMER_WHEEL_TICK_MS )
+#define TEST_REQUEST_NUM         ( TEST_ANSWERED_NUM + TEST_DROP_NUM + 1U )
+#define TEST_NEXT_REVOLUTION     ( TEST_ANSWERED_NUM + TEST_DROP_NUM )
+
+#define TEST_HANDLER_RESP        ( 0x5AU )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+
+static FakeServer_t server;
+static volatile uint32_t serverAnswered = 0;
+
+static pthread_t mainThread;
+static uint32_t offThread = 0;
+static uint32_t handled = 0;
+
+static const uint32_t dropTimeoutsMs[ TEST_DROP_NUM ] = { 400U, 150U };
+
+typedef struct TestRequest
+{
+    uint32_t startMs;
+    uint32_t timeoutMs;
+    uint32_t doneMs;
+    uint32_t calls;
+    RTIOStatus_t status;
+    uint8_t respData[ 8 ];
+    RTIOFixedBuffer_t respBuffer;
+} TestRequest_t;
+
+static TestRequest_t requests[ TEST_REQUEST_NUM ];
+
+/*-----------------------------------------------------------*/
+
+static void checkThread( void )
+{
+    offThread += pthread_equal( pthread_self(), mainThread ) ? 0U : 1U;
+}
+
+static RTIOStatus_t pollHandler( uint8_t* pReqData, uint16_t reqLength,
+                                 RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength )
+{
+    (void)pReqData;
+    (void)reqLength;
+    checkThread();
+    handled++;
+    pRespbuffer->pBuffer[ 0 ] = TEST_HANDLER_RESP;
+    *respLength = 1;
+    return RTIOSuccess;
+}
+
+static void requestDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    TestRequest_t* pRequest = (TestRequest_t*)pUserData;
+
+    (void)pRespData;
+    (void)respLength;
+    checkThread();
+    pRequest->status = status;
+    pRequest->doneMs = OS_ClockGetTimeMs();
+    pRequest->calls++;
+}
+
+static uint32_t threadCount( void )
+{
+    DIR* pDir = opendir( "/proc/self/task" );
+    struct dirent* pEntry = NULL;
+    uint32_t count = 0;
+
+    assert( pDir != NULL );
+    while( ( pEntry = readdir( pDir ) ) != NULL )
+    {
+        count += ( pEntry->d_name[ 0 ] != '.' ) ? 1U : 0U;
+    }
+    (void)closedir( pDir );
+    return count;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Answers the verify request with a server request behind it, answers pings and CoPost
+ * requests whose payload starts with 'a', drops the others. */
+static bool serverAnswer( int fd, const FakeServerFrame_t* pFrame )
+{
+    const uint8_t* pData = FakeServer_Payload( pFrame );
+    uint32_t digest = 0;
+    bool answer = true;
+
+    if( pFrame->type == FAKE_SERVER_TYPE_SEND_REQ )
+    {
+        answer = ( pData != NULL ) && ( pData[ 0 ] == 'a' );
+    }
+    else if( pFrame->type == FAKE_SERVER_TYPE_SERVER_RESP )
+    {
+        if( ( pFrame->bodyLen == 2U ) && ( ( pFrame->body[ 0 ] & 0x0F ) == FAKE_SERVER_STATUS_OK ) &&
+            ( pFrame->body[ 1 ] == TEST_HANDLER_RESP ) )
+        {
+            serverAnswered++;
+        }
+    }
+    else if( pFrame->type == FAKE_SERVER_TYPE_VERIFY_REQ )
+    {
+        FakeServer_Answer( fd, pFrame );
+        answer = false;
+
+        /* Waits in the socket until the device polls. */
+        assert( RTIO_URIHash( "/poll/handler", &digest ) == RTIOSuccess );
+        (void)FakeServer_Post( fd, 1U, digest );
+    }
+    else
+    {
+        /* MISRA else. */
+    }
+    return answer;
+}
+
+static void postAsync( RTIOContext_t* pContext, uint32_t uri, uint16_t index,
+                       const char* pPayload, uint32_t timeoutMs )
+{
+    TestRequest_t* pRequest = &requests[ index ];
+
+    pRequest->respBuffer.pBuffer = pRequest->respData;
+    pRequest->respBuffer.size = sizeof( pRequest->respData );
+    pRequest->timeoutMs = timeoutMs;
+    pRequest->startMs = OS_ClockGetTimeMs();
+    assert( RTIO_CoPostAsync( pContext, uri, (uint8_t*)pPayload, (uint16_t)strlen( pPayload ),
+                              &( pRequest->respBuffer ), timeoutMs, requestDone, pRequest ) == RTIOSuccess );
+}
+
+static bool allDone( void )
+{
+    uint16_t i = 0;
+
+    for( i = 0; i < TEST_REQUEST_NUM; i++ )
+    {
+        if( requests[ i ].calls == 0U )
+        {
+            return false;
+        }
+    }
+    return ( handled > 0U ) && ( serverAnswered > 0U );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    RTIOContext_t rtioContext = { 0 };
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    uint32_t uri = 0, startMs = 0, elapsedMs = 0, waitMs = 0, nowMs = 0;
+    uint32_t threadsBefore = 0, threadsServing = 0;
+    uint32_t late = 0, wrong = 0;
+    uint16_t i = 0;
+
+    mainThread = pthread_self();
+    serverInfo.port = FakeServer_Start( &server, serverAnswer );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_RegisterCoPostHandler( &rtioContext, "/poll/handler", pollHandler ) == RTIOSuccess );
+
+    threadsBefore = threadCount();
+    assert( RTIO_ServeEventDriven( &rtioContext, NULL, NULL ) == RTIOSuccess );
+    threadsServing = threadCount();
+
+    assert( RTIO_URIHash( "/poll/post", &uri ) == RTIOSuccess );
+
+    /* The cursor is at the current tick after the timers run, the deadline lands mid-tick in */
+    /* the cursor slot one revolution later. */
+    assert( RTIO_HandleTimers( &rtioContext, &waitMs ) == RTIOSuccess );
+    nowMs = OS_ClockGetTimeMs();
+    postAsync( &rtioContext, uri, TEST_NEXT_REVOLUTION, "drop",
+               TEST_REVOLUTION_MS + ( RTIO_TIMER_WHEEL_TICK_MS / 2U ) - ( nowMs % RTIO_TIMER_WHEEL_TICK_MS ) );
+    for( i = 0; i < TEST_ANSWERED_NUM; i++ )
+    {
+        postAsync( &rtioContext, uri, i, "answer", TEST_POLL_TIMEOUT_MS );
+    }
+    for( i = 0; i < TEST_DROP_NUM; i++ )
+    {
+        postAsync( &rtioContext, uri, TEST_ANSWERED_NUM + i, "drop", dropTimeoutsMs[ i ] );
+    }
+
+    /* The loop never waits past the earliest request deadline. */
+    assert( RTIO_GetNextWaitMs( &rtioContext, &waitMs ) == RTIOSuccess );
+    wrong += ( waitMs > dropTimeoutsMs[ 1 ] ) ? 1U : 0U;
+
+    startMs = OS_ClockGetTimeMs();
+    while( !allDone() && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_DONE_WAIT_MS ) )
+    {
+        assert( RTIO_Poll( &rtioContext, TEST_POLL_TIMEOUT_MS ) == RTIOSuccess );
+    }
+
+    for( i = 0; i < TEST_REQUEST_NUM; i++ )
+    {
+        if( ( requests[ i ].calls != 1U ) ||
+            ( requests[ i ].status != ( ( i < TEST_ANSWERED_NUM ) ? RTIOSuccess : RTIOTimeout ) ) )
+        {
+            wrong++;
+        }
+        else if( i >= TEST_ANSWERED_NUM )
+        {
+            elapsedMs = requests[ i ].doneMs - requests[ i ].startMs;
+            printf( "Timeout %ums fired after %ums.\n", (unsigned)requests[ i ].timeoutMs, (unsigned)elapsedMs );
+            late += ( ( elapsedMs < requests[ i ].timeoutMs ) ||
+                      ( elapsedMs > requests[ i ].timeoutMs + TEST_LATE_MS_MAX ) ) ? 1U : 0U;
+        }
+        else
+        {
+            /* MISRA else. */
+        }
+    }
+
+    printf( "Threads before=%u serving=%u, handled=%u, server answered=%u, late=%u, wrong=%u, off thread=%u.\n",
+            (unsigned)threadsBefore, (unsigned)threadsServing, (unsigned)handled, (unsigned)serverAnswered,
+            (unsigned)late, (unsigned)wrong, (unsigned)offThread );
+
+    (void)RTIO_Disconnect( &rtioContext );
+    FakeServer_Stop( &server );
+
+    if( ( threadsServing != threadsBefore ) || ( handled != 1U ) || ( serverAnswered != 1U ) ||
+        ( late != 0U ) || ( wrong != 0U ) || ( offThread != 0U ) )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
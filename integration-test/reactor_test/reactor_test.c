@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API and reactor header. */
+#include "core_rtio.h"
+#include "rtio_reactor_posix.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Serves TEST_CONTEXT_NUM connections with TEST_WORKER_NUM reactor workers, the thread count
+ * must not grow with the connections. Every context posts to the server and is posted to by it,
+ * unanswered asynchronous requests time out, and a connection closed by the server reconnects. */
+
+#define TEST_CONTEXT_NUM         ( 200U )
+#define TEST_WORKER_NUM          ( 2U )
+#define TEST_CLIENT_NUM_MAX      ( TEST_CONTEXT_NUM + 8U )
+#define TEST_DROP_NUM            ( 8U )
+#define TEST_DROP_TIMEOUT_MS     ( 300U )
+#define TEST_LATE_MS_MAX         ( 100U )
+#define TEST_RECONNECT_WAIT_MS   ( 5000U )
+
+#define TEST_HANDLER_RESP        ( 0x5AU )
+
+#define TEST_COMMAND_NONE        ( 0 )
+#define TEST_COMMAND_POST_ALL    ( 1 )
+#define TEST_COMMAND_CLOSE_FIRST ( 2 )
+
+static RTIORamAllocationGlobal_t rtioFixedRAM[ TEST_CONTEXT_NUM ];
+static RTIOContextFixedResource_t rtioFixedResource[ TEST_CONTEXT_NUM ];
+static RTIOContext_t rtioContext[ TEST_CONTEXT_NUM ];
+static PlaintextParams_t plaintextParams[ TEST_CONTEXT_NUM ];
+static NetworkContext_t networkContext[ TEST_CONTEXT_NUM ];
+static TransportInterface_t transport[ TEST_CONTEXT_NUM ];
+
+static RTIOReactorEntry_t reactorEntries[ TEST_CONTEXT_NUM ];
+static OSThreadHandle_t reactorWorkers[ TEST_WORKER_NUM ];
+static RTIOReactor_t reactor;
+
+static int listenFd = -1;
+static struct pollfd pollFds[ TEST_CLIENT_NUM_MAX + 1U ];
+static uint16_t clientNum = 0;
+static volatile int serverCommand = TEST_COMMAND_NONE;
+static volatile bool serverDone = false;
+static volatile uint32_t serverPosted = 0;
+static volatile uint32_t serverAnswered = 0;
+
+typedef struct TestRequest
+{
+    uint32_t startMs;
+    volatile uint32_t doneMs;
+    volatile uint32_t calls;
+    volatile RTIOStatus_t status;
+    uint8_t respData[ 8 ];
+    RTIOFixedBuffer_t respBuffer;
+} TestRequest_t;
+
+static TestRequest_t dropped[ TEST_DROP_NUM ];
+
+/*-----------------------------------------------------------*/
+
+static RTIOStatus_t reactorHandler( uint8_t* pReqData, uint16_t reqLength,
+                                    RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength )
+{
+    (void)pReqData;
+    (void)reqLength;
+    pRespbuffer->pBuffer[ 0 ] = TEST_HANDLER_RESP;
+    *respLength = 1;
+    return RTIOSuccess;
+}
+
+static void requestDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    TestRequest_t* pRequest = (TestRequest_t*)pUserData;
+
+    (void)pRespData;
+    (void)respLength;
+    pRequest->status = status;
+    pRequest->doneMs = OS_ClockGetTimeMs();
+    pRequest->calls++;
+}
+
+static uint32_t threadCount( void )
+{
+    DIR* pDir = opendir( "/proc/self/task" );
+    struct dirent* pEntry = NULL;
+    uint32_t count = 0;
+
+    assert( pDir != NULL );
+    while( ( pEntry = readdir( pDir ) ) != NULL )
+    {
+        count += ( pEntry->d_name[ 0 ] != '.' ) ? 1U : 0U;
+    }
+    (void)closedir( pDir );
+    return count;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Answers one frame of a client, devices send every frame with one write. */
+static bool serverHandleFrame( int fd )
+{
+    static FakeServerFrame_t frame;
+    const uint8_t* pData = NULL;
+
+    if( !FakeServer_RecvFrame( fd, &frame ) )
+    {
+        return false;
+    }
+
+    pData = FakeServer_Payload( &frame );
+    if( frame.type == FAKE_SERVER_TYPE_SERVER_RESP )
+    {
+        if( ( frame.bodyLen == 2U ) && ( ( frame.body[ 0 ] & 0x0F ) == FAKE_SERVER_STATUS_OK ) &&
+            ( frame.body[ 1 ] == TEST_HANDLER_RESP ) )
+        {
+            serverAnswered++;
+        }
+    }
+    else if( ( frame.type != FAKE_SERVER_TYPE_SEND_REQ ) || ( ( pData != NULL ) && ( pData[ 0 ] != 'd' ) ) )
+    {
+        /* Requests with a payload starting with 'd' are dropped. */
+        FakeServer_Answer( fd, &frame );
+    }
+    else
+    {
+        /* MISRA else. */
+    }
+    return true;
+}
+
+static void serverPostAll( void )
+{
+    uint32_t digest = 0;
+    uint16_t i = 0;
+
+    assert( RTIO_URIHash( "/reactor/handler", &digest ) == RTIOSuccess );
+    for( i = 1; i <= clientNum; i++ )
+    {
+        if( ( pollFds[ i ].fd >= 0 ) && FakeServer_Post( pollFds[ i ].fd, i, digest ) )
+        {
+            serverPosted++;
+        }
+    }
+}
+
+/* One thread polls every client, clients are numbered in the order they connect. */
+static void serverThread( void* pParam )
+{
+    uint16_t i = 0;
+    int fd = -1;
+    int noDelay = 1;
+
+    (void)pParam;
+
+    pollFds[ 0 ].fd = listenFd;
+    pollFds[ 0 ].events = POLLIN;
+    while( !serverDone )
+    {
+        if( serverCommand == TEST_COMMAND_POST_ALL )
+        {
+            serverPostAll();
+            serverCommand = TEST_COMMAND_NONE;
+        }
+        else if( serverCommand == TEST_COMMAND_CLOSE_FIRST )
+        {
+            close( pollFds[ 1 ].fd );
+            pollFds[ 1 ].fd = -1;
+            serverCommand = TEST_COMMAND_NONE;
+        }
+
+        if( poll( pollFds, clientNum + 1U, 10 ) <= 0 )
+        {
+            continue;
+        }
+        if( ( pollFds[ 0 ].revents & POLLIN ) && ( clientNum < TEST_CLIENT_NUM_MAX ) )
+        {
+            fd = accept( listenFd, NULL, NULL );
+            assert( fd >= 0 );
+            (void)setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof( noDelay ) );
+            clientNum++;
+            pollFds[ clientNum ].fd = fd;
+            pollFds[ clientNum ].events = POLLIN;
+        }
+        for( i = 1; i <= clientNum; i++ )
+        {
+            if( ( pollFds[ i ].fd >= 0 ) && ( pollFds[ i ].revents & ( POLLIN | POLLHUP | POLLERR ) ) &&
+                !serverHandleFrame( pollFds[ i ].fd ) )
+            {
+                close( pollFds[ i ].fd );
+                pollFds[ i ].fd = -1;
+            }
+        }
+    }
+
+    for( i = 1; i <= clientNum; i++ )
+    {
+        if( pollFds[ i ].fd >= 0 )
+        {
+            close( pollFds[ i ].fd );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void connectContext( uint16_t index, const ServerInfo_t* pServerInfo, const RTIODeviceInfo_t* pDeviceInfo )
+{
+    RTIOContextFixedResource_t resource = RTIO_ResourceBuild( rtioFixedRAM[ index ] );
+    TransportInterface_t* pTransport = &transport[ index ];
+
+    rtioFixedResource[ index ] = resource;
+    networkContext[ index ].pParams = &plaintextParams[ index ];
+    pTransport->pNetworkContext = &networkContext[ index ];
+    pTransport->connect = Plaintext_ConnectWithOption;
+    pTransport->disconnect = Plaintext_Disconnect;
+    pTransport->send = Plaintext_Send;
+    pTransport->sendv = Plaintext_Sendv;
+    pTransport->recv = Plaintext_Recv;
+    pTransport->waitReadable = Plaintext_WaitReadable;
+    pTransport->getDescriptor = Plaintext_GetDescriptor;
+
+    assert( RTIO_Connect( &rtioContext[ index ], &rtioFixedResource[ index ], pTransport,
+                          NULL, pServerInfo, pDeviceInfo ) == RTIOSuccess );
+    assert( RTIO_RegisterCoPostHandler( &rtioContext[ index ], "/reactor/handler", reactorHandler ) == RTIOSuccess );
+}
+
+static RTIOStatus_t postSync( RTIOContext_t* pContext )
+{
+    uint8_t respData[ 8 ] = { 0 };
+    RTIOFixedBuffer_t respBuffer = { respData, sizeof( respData ) };
+    uint16_t respLength = 0;
+
+    return RTIO_CoPost( pContext, "/reactor/post", (uint8_t*)"answer", 6U, &respBuffer, &respLength, 2000U );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    OSThreadHandle_t serverHandle = { 0 };
+    TestRequest_t* pRequest = NULL;
+    uint32_t threadsBefore = 0, threadsServing = 0;
+    uint32_t posted = 0, timedOut = 0, startMs = 0, elapsedMs = 0, uri = 0;
+    uint32_t connectCount = 0, firstCount = 0;
+    int32_t descriptor = -1;
+    bool reconnected = false;
+    uint16_t i = 0;
+
+    serverInfo.port = FakeServer_Listen( &listenFd, (int)TEST_CONTEXT_NUM );
+    assert( OS_ThreadCreate( &serverHandle, serverThread, NULL, "server", 0 ) == OSSuccess );
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    for( i = 0; i < TEST_CONTEXT_NUM; i++ )
+    {
+        connectContext( i, &serverInfo, &deviceInfo );
+    }
+
+    threadsBefore = threadCount();
+    assert( RTIOReactor_Start( &reactor, reactorEntries, TEST_CONTEXT_NUM,
+                               reactorWorkers, TEST_WORKER_NUM ) == RTIOSuccess );
+    for( i = 0; i < TEST_CONTEXT_NUM; i++ )
+    {
+        assert( RTIOReactor_Add( &reactor, &rtioContext[ i ] ) == RTIOSuccess );
+    }
+    threadsServing = threadCount();
+    printf( "Threads before=%u, serving %u contexts=%u.\n", (unsigned)threadsBefore,
+            TEST_CONTEXT_NUM, (unsigned)threadsServing );
+
+    for( i = 0; i < TEST_CONTEXT_NUM; i++ )
+    {
+        posted += ( postSync( &rtioContext[ i ] ) == RTIOSuccess ) ? 1U : 0U;
+    }
+
+    /* Dropped by the server, timed out by the reactor. */
+    assert( RTIO_URIHash( "/reactor/post", &uri ) == RTIOSuccess );
+    for( i = 0; i < TEST_DROP_NUM; i++ )
+    {
+        pRequest = &dropped[ i ];
+        pRequest->respBuffer.pBuffer = pRequest->respData;
+        pRequest->respBuffer.size = sizeof( pRequest->respData );
+        pRequest->startMs = OS_ClockGetTimeMs();
+        assert( RTIO_CoPostAsync( &rtioContext[ i * ( TEST_CONTEXT_NUM / TEST_DROP_NUM ) ], uri,
+                                  (uint8_t*)"drop", 4U, &( pRequest->respBuffer ), TEST_DROP_TIMEOUT_MS,
+                                  requestDone, pRequest ) == RTIOSuccess );
+    }
+
+    serverCommand = TEST_COMMAND_POST_ALL;
+    startMs = OS_ClockGetTimeMs();
+    while( ( ( serverCommand != TEST_COMMAND_NONE ) || ( serverAnswered < serverPosted ) ) &&
+           ( ( OS_ClockGetTimeMs() - startMs ) < 2000U ) )
+    {
+        OS_ClockSleepMs( 10U );
+    }
+    while( ( OS_ClockGetTimeMs() - startMs ) < ( TEST_DROP_TIMEOUT_MS + TEST_LATE_MS_MAX ) )
+    {
+        OS_ClockSleepMs( 10U );
+    }
+    for( i = 0; i < TEST_DROP_NUM; i++ )
+    {
+        elapsedMs = dropped[ i ].doneMs - dropped[ i ].startMs;
+        if( ( dropped[ i ].calls == 1U ) && ( dropped[ i ].status == RTIOTimeout ) &&
+            ( elapsedMs >= TEST_DROP_TIMEOUT_MS ) && ( elapsedMs <= TEST_DROP_TIMEOUT_MS + TEST_LATE_MS_MAX ) )
+        {
+            timedOut++;
+        }
+    }
+
+    /* The first client is the first context, it reconnects on a worker. */
+    assert( RTIO_GetDescriptor( &rtioContext[ 0 ], &descriptor, &firstCount ) == RTIOSuccess );
+    serverCommand = TEST_COMMAND_CLOSE_FIRST;
+    startMs = OS_ClockGetTimeMs();
+    while( !reconnected && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_RECONNECT_WAIT_MS ) )
+    {
+        OS_ClockSleepMs( 10U );
+        reconnected = ( RTIO_GetDescriptor( &rtioContext[ 0 ], &descriptor, &connectCount ) == RTIOSuccess ) &&
+                      ( connectCount != firstCount );
+    }
+    reconnected = reconnected && ( postSync( &rtioContext[ 0 ] ) == RTIOSuccess );
+
+    printf( "Posted %u/%u, server posted %u answered %u, timed out %u/%u, reconnected=%d.\n",
+            (unsigned)posted, TEST_CONTEXT_NUM, (unsigned)serverPosted, (unsigned)serverAnswered,
+            (unsigned)timedOut, TEST_DROP_NUM, (int)reconnected );
+
+    for( i = 0; i < TEST_CONTEXT_NUM; i++ )
+    {
+        assert( RTIOReactor_Remove( &reactor, &rtioContext[ i ] ) == RTIOSuccess );
+        (void)RTIO_Disconnect( &rtioContext[ i ] );
+    }
+    assert( RTIOReactor_Stop( &reactor ) == RTIOSuccess );
+
+    serverDone = true;
+    OS_ThreadDestroy( &serverHandle );
+    close( listenFd );
+
+    if( ( threadsServing != threadsBefore + TEST_WORKER_NUM ) || ( posted != TEST_CONTEXT_NUM ) ||
+        ( serverPosted != TEST_CONTEXT_NUM ) || ( serverAnswered != TEST_CONTEXT_NUM ) ||
+        ( timedOut != TEST_DROP_NUM ) || !reconnected )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
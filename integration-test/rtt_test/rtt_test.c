@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Requests are made with RTIO_TIMEOUT_AUTO while the server answers after a delay. On a fast
+ * link the timeout settles at the minimum. When the link slows down the first requests time
+ * out, each doubling the timeout, and the later ones succeed as the estimate follows. Once
+ * fast again the timeout comes back down. A ping answered far slower than the estimate must not
+ * reconnect, the automatic timeout of a ping stays at RTIO_PING_TIMEOUT_MS_MIN at least. At last
+ * an unanswered asynchronous request expires after the timeout. */
+
+#define TEST_FAST_MS             ( 20U )
+#define TEST_SLOW_MS             ( 300U )
+#define TEST_FAST_NUM            ( 20U )
+#define TEST_SLOW_NUM            ( 30U )
+#define TEST_SETTLED_NUM         ( 5U )  /* The last requests of a phase must all succeed. */
+#define TEST_WAIT_MS             ( 10000U )
+#define TEST_HEARTBEAT_MS        ( 1000U )
+#define TEST_PING_SLOW_MS        ( 2000U ) /* Far above the estimate, below RTIO_PING_TIMEOUT_MS_MIN. */
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+static RTIOContext_t rtioContext = { 0 };
+
+static FakeServer_t server;
+static volatile bool serverSilent = false;
+static volatile uint32_t pingDelayMs = 0;
+static volatile bool asyncDone = false;
+static volatile RTIOStatus_t asyncStatus = RTIOUnknown;
+
+/*-----------------------------------------------------------*/
+
+/* Requests are left unanswered while serverSilent, pings are still answered after pingDelayMs. */
+static bool serverAnswer( int fd, const FakeServerFrame_t* pFrame )
+{
+    (void)fd;
+    if( pFrame->type == FAKE_SERVER_TYPE_PING_REQ )
+    {
+        OS_ClockSleepMs( pingDelayMs );
+    }
+    return ( pFrame->type != FAKE_SERVER_TYPE_SEND_REQ ) || !serverSilent;
+}
+
+/*-----------------------------------------------------------*/
+
+static RTIORttStats_t rttStats( const char* pPhase )
+{
+    RTIORttStats_t stats = { 0 };
+
+    assert( RTIO_GetRttStats( &rtioContext, &stats ) == RTIOSuccess );
+    printf( "%s: srtt=%ums rttvar=%ums rto=%ums samples=%u timeouts=%u.\n", pPhase, (unsigned)stats.srttMs,
+            (unsigned)stats.rttvarMs, (unsigned)stats.rtoMs, (unsigned)stats.samples, (unsigned)stats.timeouts );
+    return stats;
+}
+
+/* Posts num requests in turn, returns how many of the last TEST_SETTLED_NUM succeeded. */
+static uint32_t postAll( uint32_t num, uint32_t* pTimeouts )
+{
+    uint8_t data[ 4 ] = { 1, 2, 3, 4 };
+    uint8_t respData[ 8 ] = { 0 };
+    RTIOFixedBuffer_t respBuffer = { respData, sizeof( respData ) };
+    uint16_t respLength = 0;
+    RTIOStatus_t status = RTIOUnknown;
+    uint32_t settled = 0, i = 0;
+
+    *pTimeouts = 0;
+    for( i = 0; i < num; i++ )
+    {
+        status = RTIO_CoPost( &rtioContext, "/rtt", data, sizeof( data ), &respBuffer, &respLength, RTIO_TIMEOUT_AUTO );
+        if( status == RTIOTimeout )
+        {
+            ( *pTimeouts )++;
+        }
+        if( ( i >= num - TEST_SETTLED_NUM ) && ( status == RTIOSuccess ) )
+        {
+            settled++;
+        }
+    }
+    return settled;
+}
+
+static void postDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    (void)pUserData;
+    (void)pRespData;
+    (void)respLength;
+    asyncStatus = status;
+    asyncDone = true;
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    RTIORttStats_t stats = { 0 }, slow = { 0 };
+    uint8_t data[ 4 ] = { 1, 2, 3, 4 };
+    uint8_t respData[ 8 ] = { 0 };
+    RTIOFixedBuffer_t respBuffer = { respData, sizeof( respData ) };
+    uint32_t settled = 0, timeouts = 0, startMs = 0, expiredMs = 0, pings = 0;
+    bool passed = true;
+
+    serverInfo.port = FakeServer_Start( &server, serverAnswer );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    assert( RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                          NULL, &serverInfo, &deviceInfo ) == RTIOSuccess );
+    assert( RTIO_Serve( &rtioContext ) == RTIOSuccess );
+
+    stats = rttStats( "Initial" );
+    passed = ( stats.samples == 0U ) && ( stats.rtoMs == RTIO_RTO_INITIAL_MS );
+
+    /* Fast: the timeout settles at the minimum. */
+    server.delayMs = TEST_FAST_MS;
+    settled = postAll( TEST_FAST_NUM, &timeouts );
+    stats = rttStats( "Fast" );
+    passed = passed && ( timeouts == 0U ) && ( settled == TEST_SETTLED_NUM ) && ( stats.samples == TEST_FAST_NUM ) &&
+             ( stats.srttMs >= TEST_FAST_MS ) && ( stats.srttMs < TEST_FAST_MS * 3U ) && ( stats.rtoMs < TEST_SLOW_MS );
+
+    /* Slow: requests time out until the estimate follows. */
+    server.delayMs = TEST_SLOW_MS;
+    settled = postAll( TEST_SLOW_NUM, &timeouts );
+    slow = rttStats( "Slow" );
+    printf( "Slow: timeouts=%u, settled=%u.\n", (unsigned)timeouts, (unsigned)settled );
+    passed = passed && ( timeouts > 0U ) && ( slow.timeouts == timeouts ) && ( settled == TEST_SETTLED_NUM ) &&
+             ( slow.srttMs >= TEST_SLOW_MS * 2U / 3U ) && ( slow.rtoMs > TEST_SLOW_MS );
+
+    /* Fast again: the timeout comes back down without failures. */
+    server.delayMs = TEST_FAST_MS;
+    settled = postAll( TEST_SLOW_NUM, &timeouts );
+    stats = rttStats( "Recovered" );
+    passed = passed && ( timeouts == 0U ) && ( settled == TEST_SETTLED_NUM ) && ( stats.rtoMs < slow.rtoMs ) &&
+             ( stats.srttMs < TEST_SLOW_MS / 2U );
+
+    /* Ping jump: the ping answered after a multiple of the timeout keeps the session. */
+    pings = server.pings;
+    pingDelayMs = TEST_PING_SLOW_MS;
+    assert( RTIO_SetHeartbeat( &rtioContext, TEST_HEARTBEAT_MS ) == RTIOSuccess );
+    startMs = OS_ClockGetTimeMs();
+    while( ( server.pings == pings ) && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_WAIT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    /* No other ping until the next phase is over. */
+    assert( RTIO_SetHeartbeat( &rtioContext, RTIO_PING_INTERVAL_MS_DEFAULT ) == RTIOSuccess );
+    OS_ClockSleepMs( TEST_PING_SLOW_MS + 500U );
+    pingDelayMs = 0;
+    printf( "Ping jump: pings=%u, sessions=%u.\n", (unsigned)( server.pings - pings ), (unsigned)server.sessions );
+    passed = passed && ( server.pings > pings ) && ( server.sessions == 1U );
+
+    /* Unanswered: an asynchronous request expires after the timeout, which backs off. */
+    serverSilent = true;
+    slow = rttStats( "Silent" );
+    startMs = OS_ClockGetTimeMs();
+    assert( RTIO_CoPostAsync( &rtioContext, 1U, data, sizeof( data ), &respBuffer, RTIO_TIMEOUT_AUTO,
+                              postDone, NULL ) == RTIOSuccess );
+    while( !asyncDone && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_WAIT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    expiredMs = OS_ClockGetTimeMs() - startMs;
+    stats = rttStats( "Expired" );
+    printf( "Expired: status=%d after %ums.\n", (int)asyncStatus, (unsigned)expiredMs );
+    passed = passed && asyncDone && ( asyncStatus == RTIOTimeout ) && ( expiredMs >= slow.rtoMs ) &&
+             ( expiredMs < slow.rtoMs + 200U ) && ( stats.timeouts == slow.timeouts + 1U ) &&
+             ( ( stats.rtoMs == slow.rtoMs * 2U ) || ( stats.rtoMs == RTIO_RTO_MAX_MS ) );
+
+    (void)RTIO_Disconnect( &rtioContext );
+    FakeServer_Stop( &server );
+
+    if( !passed )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
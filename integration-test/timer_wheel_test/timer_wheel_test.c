@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Posts asynchronous requests the server never answers, with deadlines out of order and beyond
+ * one revolution of the timer wheel, each must time out on time. Requests the server answers
+ * must complete once and never time out later. A request whose send blocks past its timeout
+ * and then fails is reported once, by its timer, and the post succeeds. */
+
+#define TEST_TIMEOUT_NUM         ( 8U )
+#define TEST_ANSWERED_NUM        ( 4U )
+#define TEST_ANSWERED_TIMEOUT_MS ( 200U )
+#define TEST_LATE_MS_MAX         ( 40U ) /* Scheduling slack allowed after a deadline. */
+#define TEST_UNSENT_TIMEOUT_MS   ( 100U )
+#define TEST_SEND_BLOCK_MS       ( 300U )
+#define TEST_UNSENT_INDEX        ( TEST_TIMEOUT_NUM + TEST_ANSWERED_NUM )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+
+static FakeServer_t server;
+
+/* Shuffled, 1700 and 1300 are past one revolution of the default wheel. */
+static const uint32_t timeoutsMs[ TEST_TIMEOUT_NUM ] = { 1700U, 40U, 900U, 300U, 1100U, 75U, 520U, 1300U };
+
+typedef struct TestRequest
+{
+    uint32_t startMs;
+    volatile uint32_t doneMs;
+    volatile uint32_t calls;
+    volatile RTIOStatus_t status;
+    uint8_t respData[ 8 ];
+    RTIOFixedBuffer_t respBuffer;
+} TestRequest_t;
+
+static TestRequest_t requests[ TEST_TIMEOUT_NUM + TEST_ANSWERED_NUM + 1U ];
+
+static volatile bool sendFails = false;
+
+/*-----------------------------------------------------------*/
+
+static void requestDone( void* pUserData, RTIOStatus_t status, uint8_t* pRespData, uint16_t respLength )
+{
+    TestRequest_t* pRequest = (TestRequest_t*)pUserData;
+
+    (void)pRespData;
+    (void)respLength;
+    pRequest->status = status;
+    pRequest->doneMs = OS_ClockGetTimeMs();
+    pRequest->calls++;
+}
+
+/* Answers CoPost requests whose payload starts with 'a' and drops the others. */
+static bool serverAnswer( int fd, const FakeServerFrame_t* pFrame )
+{
+    const uint8_t* pData = FakeServer_Payload( pFrame );
+
+    (void)fd;
+    return ( pFrame->type != FAKE_SERVER_TYPE_SEND_REQ ) || ( ( pData != NULL ) && ( pData[ 0 ] == 'a' ) );
+}
+
+/* Blocks past the timeout of the request and fails once sendFails is set. */
+static int32_t blockingSendv( NetworkContext_t* pNetworkContext, const TransportIoVector_t* pIoVec, size_t ioVecCount )
+{
+    if( sendFails )
+    {
+        sendFails = false;
+        OS_ClockSleepMs( TEST_SEND_BLOCK_MS );
+        return -1;
+    }
+    return Plaintext_Sendv( pNetworkContext, pIoVec, ioVecCount );
+}
+
+static RTIOStatus_t postAsync( RTIOContext_t* pContext, uint32_t uri, uint16_t index,
+                               const char* pPayload, uint32_t timeoutMs )
+{
+    TestRequest_t* pRequest = &requests[ index ];
+
+    pRequest->respBuffer.pBuffer = pRequest->respData;
+    pRequest->respBuffer.size = sizeof( pRequest->respData );
+    pRequest->startMs = OS_ClockGetTimeMs();
+    return RTIO_CoPostAsync( pContext, uri, (uint8_t*)pPayload, (uint16_t)strlen( pPayload ),
+                             &( pRequest->respBuffer ), timeoutMs, requestDone, pRequest );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    RTIOStatus_t rtioStatus = RTIOUnknown;
+    RTIOContext_t rtioContext = { 0 };
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    uint32_t uri = 0, elapsedMs = 0, startMs = 0;
+    uint16_t i = 0;
+    uint32_t late = 0, wrong = 0;
+    RTIOStatus_t unsentStatus = RTIOUnknown;
+
+    serverInfo.port = FakeServer_Start( &server, serverAnswer );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = blockingSendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    rtioStatus = RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                               NULL, &serverInfo, &deviceInfo );
+    assert( rtioStatus == RTIOSuccess );
+    rtioStatus = RTIO_Serve( &rtioContext );
+    assert( rtioStatus == RTIOSuccess );
+    assert( RTIO_URIHash( "/timer/wheel", &uri ) == RTIOSuccess );
+
+    for( i = 0; i < TEST_TIMEOUT_NUM; i++ )
+    {
+        assert( postAsync( &rtioContext, uri, i, "drop", timeoutsMs[ i ] ) == RTIOSuccess );
+    }
+
+    /* Answered while the others wait, their timers must be cancelled. */
+    for( i = TEST_TIMEOUT_NUM; i < TEST_TIMEOUT_NUM + TEST_ANSWERED_NUM; i++ )
+    {
+        assert( postAsync( &rtioContext, uri, i, "answer", TEST_ANSWERED_TIMEOUT_MS ) == RTIOSuccess );
+    }
+
+    startMs = OS_ClockGetTimeMs();
+    while( ( OS_ClockGetTimeMs() - startMs ) < ( timeoutsMs[ 0 ] + 500U ) )
+    {
+        OS_ClockSleepMs( 20U );
+    }
+
+    for( i = 0; i < TEST_TIMEOUT_NUM; i++ )
+    {
+        elapsedMs = requests[ i ].doneMs - requests[ i ].startMs;
+        printf( "Timeout %ums fired after %ums, status=%d, calls=%u.\n", (unsigned)timeoutsMs[ i ],
+                (unsigned)elapsedMs, (int)requests[ i ].status, (unsigned)requests[ i ].calls );
+        if( ( requests[ i ].calls != 1U ) || ( requests[ i ].status != RTIOTimeout ) )
+        {
+            wrong++;
+        }
+        else if( ( elapsedMs < timeoutsMs[ i ] ) || ( elapsedMs > timeoutsMs[ i ] + TEST_LATE_MS_MAX ) )
+        {
+            late++;
+        }
+    }
+    for( i = TEST_TIMEOUT_NUM; i < TEST_TIMEOUT_NUM + TEST_ANSWERED_NUM; i++ )
+    {
+        if( ( requests[ i ].calls != 1U ) || ( requests[ i ].status != RTIOSuccess ) )
+        {
+            wrong++;
+        }
+    }
+
+    /* Times out during the send, the failed send must not report it again. */
+    sendFails = true;
+    unsentStatus = postAsync( &rtioContext, uri, TEST_UNSENT_INDEX, "answer", TEST_UNSENT_TIMEOUT_MS );
+    OS_ClockSleepMs( TEST_SEND_BLOCK_MS );
+    printf( "Unsent returned %d, status=%d, calls=%u.\n", (int)unsentStatus,
+            (int)requests[ TEST_UNSENT_INDEX ].status, (unsigned)requests[ TEST_UNSENT_INDEX ].calls );
+    if( ( unsentStatus != RTIOSuccess ) || ( requests[ TEST_UNSENT_INDEX ].calls != 1U ) ||
+        ( requests[ TEST_UNSENT_INDEX ].status != RTIOTimeout ) )
+    {
+        wrong++;
+    }
+
+    printf( "Timed out %u, answered %u, late=%u, wrong=%u.\n", TEST_TIMEOUT_NUM,
+            TEST_ANSWERED_NUM, (unsigned)late, (unsigned)wrong );
+
+    FakeServer_Stop( &server );
+
+    if( ( late != 0U ) || ( wrong != 0U ) )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
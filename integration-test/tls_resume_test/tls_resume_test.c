@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <unistd.h>
+#include <sys/socket.h>
+
+/* OpenSSL includes. */
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "openssl_posix.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Reconnects to a TLS server, with TLS 1.3 tickets then with TLS 1.2 session IDs. The first
+ * connect performs a full handshake, the next ones resume the session with the SSL_CTX built
+ * once, also after the server dropped the connection without a close notify. Freeing the
+ * cache goes back to a full handshake. */
+
+#define TEST_CONNECT_NUM         ( 4U )
+#define TEST_ABRUPT_CONNECT      ( 1U )
+#define TEST_FREE_CONNECT        ( 3U )
+#define TEST_TIMEOUT_MS          ( 2000U )
+
+static int listenFd = -1;
+static uint16_t listenPort = 0;
+static EVP_PKEY* pServerKey = NULL;
+static X509* pServerCert = NULL;
+static char rootCaPath[] = "/tmp/tls_resume_test_XXXXXX";
+static volatile int serverReused[ TEST_CONNECT_NUM ];
+static volatile bool serverDone = false;
+
+/*-----------------------------------------------------------*/
+
+/* Self-signed certificate of "localhost", trusted by the client as its root CA. */
+static void createCertificate( void )
+{
+    X509_NAME* pName = NULL;
+    FILE* pFile = NULL;
+    int fd = -1;
+
+    pServerKey = EVP_EC_gen( "P-256" );
+    assert( pServerKey != NULL );
+    pServerCert = X509_new();
+    assert( pServerCert != NULL );
+    assert( X509_set_version( pServerCert, 2 ) == 1 );
+    assert( ASN1_INTEGER_set( X509_get_serialNumber( pServerCert ), 1 ) == 1 );
+    assert( X509_gmtime_adj( X509_getm_notBefore( pServerCert ), -60 ) != NULL );
+    assert( X509_gmtime_adj( X509_getm_notAfter( pServerCert ), 3600 ) != NULL );
+    assert( X509_set_pubkey( pServerCert, pServerKey ) == 1 );
+    pName = X509_get_subject_name( pServerCert );
+    assert( X509_NAME_add_entry_by_txt( pName, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0 ) == 1 );
+    assert( X509_set_issuer_name( pServerCert, pName ) == 1 );
+    assert( X509_sign( pServerCert, pServerKey, EVP_sha256() ) > 0 );
+
+    fd = mkstemp( rootCaPath );
+    assert( fd >= 0 );
+    pFile = fdopen( fd, "w" );
+    assert( pFile != NULL );
+    assert( PEM_write_X509( pFile, pServerCert ) == 1 );
+    fclose( pFile );
+}
+
+/* Accepts the connects of a round, writes one byte on each, then waits for the close notify,
+ * except on the abrupt one which is closed right away. */
+static void serverThread( void* pParam )
+{
+    SSL_CTX* pSslContext = (SSL_CTX*)pParam;
+    SSL* pSsl = NULL;
+    uint8_t byte = 'x';
+    int fd = -1;
+    uint32_t i = 0;
+
+    for( i = 0; i < TEST_CONNECT_NUM; i++ )
+    {
+        fd = accept( listenFd, NULL, NULL );
+        assert( fd >= 0 );
+        pSsl = SSL_new( pSslContext );
+        assert( pSsl != NULL );
+        assert( SSL_set_fd( pSsl, fd ) == 1 );
+        if( SSL_accept( pSsl ) == 1 )
+        {
+            serverReused[ i ] = SSL_session_reused( pSsl );
+            (void)SSL_write( pSsl, &byte, 1 );
+            if( i != TEST_ABRUPT_CONNECT )
+            {
+                while( SSL_read( pSsl, &byte, 1 ) > 0 )
+                {
+                }
+                (void)SSL_shutdown( pSsl );
+            }
+            else
+            {
+                /* Only the client sees the drop, as on a network flap; the
+                 * server would otherwise remove the session from its cache. */
+                SSL_set_shutdown( pSsl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN );
+            }
+        }
+        SSL_free( pSsl );
+        close( fd );
+    }
+    serverDone = true;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Runs a round against a server limited to maxVersion, returns whether it resumed as expected. */
+static bool runRound( int maxVersion, const char* pName )
+{
+    SSL_CTX* pServerContext = NULL;
+    OSThreadHandle_t serverHandle = { 0 };
+    OpensslCredentials_t credentials = { 0 };
+    OpensslParams_t params = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    ServerInfo_t serverInfo = { 0 };
+    TransportStatus_t status = TransportUnknown;
+    SSL_CTX* pFirstContext = NULL;
+    int clientReused[ TEST_CONNECT_NUM ] = { 0 };
+    bool sameContext = true, passed = true;
+    uint8_t byte = 0;
+    int32_t received = 0;
+    uint32_t i = 0, startMs = 0;
+
+    pServerContext = SSL_CTX_new( TLS_server_method() );
+    assert( pServerContext != NULL );
+    assert( SSL_CTX_use_certificate( pServerContext, pServerCert ) == 1 );
+    assert( SSL_CTX_use_PrivateKey( pServerContext, pServerKey ) == 1 );
+    assert( SSL_CTX_set_max_proto_version( pServerContext, maxVersion ) == 1 );
+    if( maxVersion == TLS1_2_VERSION )
+    {
+        /* Session IDs from the server cache instead of tickets. */
+        (void)SSL_CTX_set_options( pServerContext, SSL_OP_NO_TICKET );
+    }
+    memset( (void*)serverReused, 0, sizeof( serverReused ) );
+    serverDone = false;
+    assert( OS_ThreadCreate( &serverHandle, serverThread, pServerContext, "server", 0 ) == OSSuccess );
+
+    credentials.pRootCaPath = rootCaPath;
+    credentials.sniHostName = "localhost";
+    networkContext.pParams = &params;
+    serverInfo.pHostName = "localhost";
+    serverInfo.hostNameLength = strlen( serverInfo.pHostName );
+    serverInfo.port = listenPort;
+
+    for( i = 0; i < TEST_CONNECT_NUM; i++ )
+    {
+        if( i == TEST_FREE_CONNECT )
+        {
+            assert( Openssl_FreeCache( &networkContext ) == TransportSuccess );
+        }
+        status = Openssl_Connect( &networkContext, &serverInfo, &credentials, TEST_TIMEOUT_MS, TEST_TIMEOUT_MS );
+        if( status != TransportSuccess )
+        {
+            printf( "%s connect %u failed status=%d.\n", pName, (unsigned)i, (int)status );
+            passed = false;
+            break;
+        }
+        clientReused[ i ] = SSL_session_reused( params.pSsl );
+        if( i == 0U )
+        {
+            pFirstContext = params.pSslContext;
+        }
+        else if( i < TEST_FREE_CONNECT )
+        {
+            sameContext = sameContext && ( params.pSslContext == pFirstContext );
+        }
+        else
+        {
+            /* Empty else. */
+        }
+
+        /* Reads the byte, and the TLS 1.3 tickets sent before it. */
+        startMs = OS_ClockGetTimeMs();
+        while( ( ( received = Openssl_Recv( &networkContext, &byte, 1 ) ) == 0 ) &&
+               ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+        {
+            OS_ClockSleepMs( 1U );
+        }
+        passed = passed && ( received == 1 );
+        if( i == TEST_ABRUPT_CONNECT )
+        {
+            /* The unexpected EOF fails the connection. */
+            (void)Openssl_Recv( &networkContext, &byte, 1 );
+        }
+        (void)Openssl_Disconnect( &networkContext );
+    }
+    (void)Openssl_FreeCache( &networkContext );
+    startMs = OS_ClockGetTimeMs();
+    while( !serverDone && ( ( OS_ClockGetTimeMs() - startMs ) < TEST_TIMEOUT_MS ) )
+    {
+        OS_ClockSleepMs( 1U );
+    }
+    OS_ThreadDestroy( &serverHandle );
+    SSL_CTX_free( pServerContext );
+
+    printf( "%s: reused client/server", pName );
+    for( i = 0; i < TEST_CONNECT_NUM; i++ )
+    {
+        printf( " %d/%d", clientReused[ i ], serverReused[ i ] );
+    }
+    printf( ", same SSL_CTX=%d.\n", (int)sameContext );
+
+    for( i = 0; i < TEST_CONNECT_NUM; i++ )
+    {
+        passed = passed && ( clientReused[ i ] == serverReused[ i ] ) &&
+                 ( clientReused[ i ] == ( ( ( i == 0U ) || ( i == TEST_FREE_CONNECT ) ) ? 0 : 1 ) );
+    }
+    return passed && sameContext && ( params.pSslContext == NULL ) && ( params.pSession == NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    bool passed = true;
+
+    /* The close notify to a dropped connection must not kill the test. */
+    (void)signal( SIGPIPE, SIG_IGN );
+    createCertificate();
+    listenPort = FakeServer_Listen( &listenFd, 1 );
+
+    passed = runRound( TLS1_3_VERSION, "TLS 1.3 tickets" ) && passed;
+    passed = runRound( TLS1_2_VERSION, "TLS 1.2 session IDs" ) && passed;
+
+    close( listenFd );
+    unlink( rootCaPath );
+    X509_free( pServerCert );
+    EVP_PKEY_free( pServerKey );
+
+    if( !passed )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+#include "core_rtio_uri_digest.hpp"
+
+/* Generated by rtio_generate_uri_digests() in CMakeLists.txt. */
+#include "uri_digest_test_uris.h"
+
+#define TEST_URI_LONGEST    "/0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcde"
+
+/* The CMake and the constexpr digests must agree without running anything. */
+static_assert( RTIO_URI_DIGEST( "/rainbow" ) == RTIO_URI_DIGEST_RAINBOW, "constexpr and generated digests differ" );
+static_assert( RTIO_URI_DIGEST( "/uri/example1" ) == RTIO_URI_DIGEST_EXAMPLE1, "constexpr and generated digests differ" );
+static_assert( RTIO_URI_DIGEST( TEST_URI_LONGEST ) == RTIO_URI_DIGEST_LONGEST, "constexpr and generated digests differ" );
+
+/*-----------------------------------------------------------*/
+
+static RTIOStatus_t uriRainbow( uint8_t* pReqData, uint16_t reqLength,
+                                RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength )
+{
+    (void)pReqData;
+    (void)reqLength;
+    (void)pRespbuffer;
+    *respLength = 0;
+    return RTIOSuccess;
+}
+
+static RTIOStatus_t uriExample1( uint8_t* pReqData, uint16_t reqLength, uint16_t obId )
+{
+    (void)pReqData;
+    (void)reqLength;
+    (void)obId;
+    return RTIOSuccess;
+}
+
+/* Built at compile time, no hashing at startup. */
+static const RTIOCoPostUri_t coPostHandlers[] = {
+    { RTIO_URI_DIGEST( "/rainbow" ), uriRainbow },
+    { RTIO_URI_DIGEST_LONGEST, uriRainbow },
+};
+
+static const RTIOObGetUri_t obGetHandlers[] = {
+    { RTIO_URI_DIGEST_EXAMPLE1, uriExample1 },
+};
+
+/*-----------------------------------------------------------*/
+
+static void testRuntimeDigests( void )
+{
+    uint32_t digest = 0;
+
+    assert( RTIO_URIHash( "/rainbow", &digest ) == RTIOSuccess );
+    assert( digest == RTIO_URI_DIGEST_RAINBOW );
+    assert( RTIO_URIHash( "/uri/example1", &digest ) == RTIOSuccess );
+    assert( digest == RTIO_URI_DIGEST_EXAMPLE1 );
+    assert( RTIO_URIHash( TEST_URI_LONGEST, &digest ) == RTIOSuccess );
+    assert( digest == RTIO_URI_DIGEST_LONGEST );
+
+    /* The constexpr function also works at runtime. */
+    assert( rtio::uriDigest( "/rainbow" ) == RTIO_URI_DIGEST_RAINBOW );
+}
+
+/* The lists are hash tables, entries are found by digest rather than by position. */
+template< typename Entry >
+static const Entry* findEntry( const Entry* pList, uint16_t size, uint32_t uri )
+{
+    uint16_t i = 0;
+
+    for( i = 0; i < size; i++ )
+    {
+        if( pList[ i ].uri == uri )
+        {
+            return &pList[ i ];
+        }
+    }
+    return NULL;
+}
+
+static void testRegisterTables( void )
+{
+    RTIOContext_t context = RTIOContext_t();
+    RTIOCoPostUri_t coPostList[ 3 ] = { { 0, NULL }, { 0, NULL }, { 0, NULL } };
+    RTIOObGetUri_t obGetList[ 1 ] = { { 0, NULL } };
+    const RTIOCoPostUri_t* pEntry = NULL;
+
+    context.coPostInfoList.pList = coPostList;
+    context.coPostInfoList.size = 3;
+    context.obGetInfoList.pList = obGetList;
+    context.obGetInfoList.size = 1;
+
+    assert( RTIO_RegisterCoPostHandlers( &context, coPostHandlers, 2 ) == RTIOSuccess );
+    assert( findEntry( coPostList, 3, RTIO_URI_DIGEST_RAINBOW ) != NULL );
+    pEntry = findEntry( coPostList, 3, RTIO_URI_DIGEST_LONGEST );
+    assert( ( pEntry != NULL ) && ( pEntry->handler == uriRainbow ) );
+
+    /* Digest 0 marks free entries and cannot be registered. */
+    assert( RTIO_RegisterCoPostHandlerWithDigest( &context, 0, uriRainbow ) == RTIOBadParameter );
+    assert( RTIO_RegisterCoPostHandlerWithDigest( &context, RTIO_URI_DIGEST_EXAMPLE1, uriRainbow ) == RTIOSuccess );
+    assert( RTIO_RegisterCoPostHandlerWithDigest( &context, RTIO_URI_DIGEST( "/uri/example2" ), uriRainbow ) == RTIOListFull );
+
+    assert( RTIO_RegisterObGetHandlers( &context, obGetHandlers, 1 ) == RTIOSuccess );
+    assert( findEntry( obGetList, 1, RTIO_URI_DIGEST_EXAMPLE1 ) != NULL );
+    assert( RTIO_RegisterObGetHandlerWithDigest( &context, RTIO_URI_DIGEST( "/uri/example2" ), uriExample1 ) == RTIOListFull );
+    assert( RTIO_RegisterObGetHandlers( &context, NULL, 1 ) == RTIOBadParameter );
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    testRuntimeDigests();
+    testRegisterTables();
+
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
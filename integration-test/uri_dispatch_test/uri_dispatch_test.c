@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+/* Include Test Config as the first non-system header. */
+#include "test_config.h"
+
+/* OS and Transport header. */
+#include "os_posix.h"
+#include "plaintext_posix.h"
+
+/* RTIO API header. */
+#include "core_rtio.h"
+
+/* Fake server header. */
+#include "fake_server.h"
+
+/* Registers TEST_URI_NUM handlers, then the server posts to each of them and to unknown URIs,
+ * every request must reach the handler of its URI. */
+
+#define TEST_URI_NUM             ( 300U )
+#define TEST_UNKNOWN_URI_NUM     ( 20U )
+
+RTIORamAllocationGlobal_t rtioFixedRAM = { 0 };
+static RTIOContextFixedResource_t rtioFixedResource = RTIO_ResourceBuild( rtioFixedRAM );
+
+static int listenFd = -1;
+static int serverFd = -1;
+static volatile bool serverDone = false;
+static uint32_t dispatched = 0;
+static uint32_t mismatched = 0;
+static uint32_t notFound = 0;
+
+/*-----------------------------------------------------------*/
+
+static void uriString( char* pUri, size_t size, uint32_t index )
+{
+    (void)snprintf( pUri, size, "/dispatch/%u", (unsigned)index );
+}
+
+/* Each handler answers with the parity of the URI index it was registered for. */
+static RTIOStatus_t uriEven( uint8_t* pReqData, uint16_t reqLength,
+                             RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength )
+{
+    (void)pReqData;
+    (void)reqLength;
+    pRespbuffer->pBuffer[ 0 ] = 0;
+    *respLength = 1;
+    return RTIOSuccess;
+}
+
+static RTIOStatus_t uriOdd( uint8_t* pReqData, uint16_t reqLength,
+                            RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength )
+{
+    (void)pReqData;
+    (void)reqLength;
+    pRespbuffer->pBuffer[ 0 ] = 1;
+    *respLength = 1;
+    return RTIOSuccess;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Receives frames until the response of headerId, answers pings on the way. */
+static bool recvServerResp( uint16_t headerId, FakeServerFrame_t* pFrame )
+{
+    while( FakeServer_RecvFrame( serverFd, pFrame ) )
+    {
+        if( pFrame->type == FAKE_SERVER_TYPE_PING_REQ )
+        {
+            FakeServer_Answer( serverFd, pFrame );
+        }
+        else if( ( pFrame->type == FAKE_SERVER_TYPE_SERVER_RESP ) && ( pFrame->headerId == headerId ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void postToDevice( uint16_t headerId, uint32_t digest, int32_t expected )
+{
+    static FakeServerFrame_t frame;
+
+    assert( FakeServer_Post( serverFd, headerId, digest ) );
+    assert( recvServerResp( headerId, &frame ) );
+    assert( frame.bodyLen >= 1U );
+
+    if( expected < 0 )
+    {
+        notFound += ( ( frame.body[ 0 ] & 0x0F ) == FAKE_SERVER_STATUS_NOT_FOUND ) ? 1U : 0U;
+    }
+    else if( ( ( frame.body[ 0 ] & 0x0F ) == FAKE_SERVER_STATUS_OK ) && ( frame.bodyLen == 2U ) &&
+             ( frame.body[ 1 ] == expected ) )
+    {
+        dispatched++;
+    }
+    else
+    {
+        mismatched++;
+    }
+}
+
+/* Answers the verify request, then posts to every registered URI and to unknown ones. */
+static void serverThread( void* pParam )
+{
+    static FakeServerFrame_t frame;
+    char uri[ 32 ] = { 0 };
+    uint32_t digest = 0;
+    uint16_t headerId = 0;
+    uint32_t i = 0;
+    int noDelay = 1;
+
+    (void)pParam;
+
+    serverFd = accept( listenFd, NULL, NULL );
+    assert( serverFd >= 0 );
+    (void)setsockopt( serverFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof( noDelay ) );
+
+    assert( FakeServer_RecvFrame( serverFd, &frame ) );
+    FakeServer_Answer( serverFd, &frame );
+
+    for( i = 0; i < TEST_URI_NUM; i++ )
+    {
+        uriString( uri, sizeof( uri ), i );
+        assert( RTIO_URIHash( uri, &digest ) == RTIOSuccess );
+        postToDevice( ++headerId, digest, (int32_t)( i % 2U ) );
+    }
+    for( i = 0; i < TEST_UNKNOWN_URI_NUM; i++ )
+    {
+        uriString( uri, sizeof( uri ), TEST_URI_NUM + i );
+        assert( RTIO_URIHash( uri, &digest ) == RTIOSuccess );
+        postToDevice( ++headerId, digest, -1 );
+    }
+    serverDone = true;
+}
+
+/*-----------------------------------------------------------*/
+
+int main()
+{
+    RTIOStatus_t rtioStatus = RTIOUnknown;
+    RTIOContext_t rtioContext = { 0 };
+    PlaintextParams_t plaintextParams = { 0 };
+    NetworkContext_t networkContext = { 0 };
+    TransportInterface_t transport = { 0 };
+    RTIODeviceInfo_t deviceInfo = { 0 };
+    ServerInfo_t serverInfo = { "127.0.0.1", 9U, 0U, 0U };
+    OSThreadHandle_t serverHandle = { 0 };
+    char uri[ 32 ] = { 0 };
+    uint32_t i = 0;
+
+    serverInfo.port = FakeServer_Listen( &listenFd, 1 );
+    assert( OS_ThreadCreate( &serverHandle, serverThread, NULL, "server", 0 ) == OSSuccess );
+
+    networkContext.pParams = &plaintextParams;
+    transport.pNetworkContext = &networkContext;
+    transport.connect = Plaintext_ConnectWithOption;
+    transport.disconnect = Plaintext_Disconnect;
+    transport.send = Plaintext_Send;
+    transport.sendv = Plaintext_Sendv;
+    transport.recv = Plaintext_Recv;
+    transport.waitReadable = Plaintext_WaitReadable;
+
+    deviceInfo.pDeviceId = "cfa09baa-4913-4ad7-a936-3e26f9671b10";
+    deviceInfo.deviceIdLength = strlen( deviceInfo.pDeviceId );
+    deviceInfo.pDeviceSecret = "mb6bgso4EChvyzA05thF9+He";
+    deviceInfo.deviceSecretLength = strlen( deviceInfo.pDeviceSecret );
+
+    rtioStatus = RTIO_Connect( &rtioContext, &rtioFixedResource, &transport,
+                               NULL, &serverInfo, &deviceInfo );
+    assert( rtioStatus == RTIOSuccess );
+
+    for( i = 0; i < TEST_URI_NUM; i++ )
+    {
+        uriString( uri, sizeof( uri ), i );
+        rtioStatus = RTIO_RegisterCoPostHandler( &rtioContext, uri, ( i % 2U ) ? uriOdd : uriEven );
+        assert( rtioStatus == RTIOSuccess );
+    }
+
+    /* Registering a URI again replaces its handler without taking another entry. */
+    uriString( uri, sizeof( uri ), 0 );
+    assert( RTIO_RegisterCoPostHandler( &rtioContext, uri, uriOdd ) == RTIOSuccess );
+    assert( RTIO_RegisterCoPostHandler( &rtioContext, uri, uriEven ) == RTIOSuccess );
+
+    rtioStatus = RTIO_Serve( &rtioContext );
+    assert( rtioStatus == RTIOSuccess );
+
+    while( !serverDone )
+    {
+        OS_ClockSleepMs( 10U );
+    }
+    OS_ThreadDestroy( &serverHandle );
+
+    printf( "Posted to %u URIs, dispatched=%u, mismatched=%u, not found=%u/%u.\n",
+            TEST_URI_NUM, (unsigned)dispatched, (unsigned)mismatched,
+            (unsigned)notFound, TEST_UNKNOWN_URI_NUM );
+
+    shutdown( serverFd, SHUT_RDWR );
+    close( serverFd );
+    close( listenFd );
+
+    if( ( dispatched != TEST_URI_NUM ) || ( notFound != TEST_UNKNOWN_URI_NUM ) )
+    {
+        printf( "FAILED.\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "PASSED.\n" );
+    return EXIT_SUCCESS;
+}
@@ -1,10 +1,13 @@
 
 include( ${RTIO_SDK_ROOT_DIR}/libraries/standard/backoffAlgorithm/backoffAlgorithmFilePaths.cmake )
+include( ${RTIO_SDK_ROOT_DIR}/tools/cmake/rtioUriDigest.cmake )
 
 # RTIO library source files.
 set( RTIO_SOURCES
      "${CMAKE_CURRENT_LIST_DIR}/source/core_rtio.c"
      "${CMAKE_CURRENT_LIST_DIR}/source/core_rtio_serializer.c"  
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_rtio_crc32.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_rtio_journal.c"
      "${BACKOFF_ALGORITHM_SOURCES}" )
 
 # RTIO library Public Include directories.
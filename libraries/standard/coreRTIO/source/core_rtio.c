@@ -9,8 +9,9 @@
 #include "core_rtio_serializer.h"
 #include "backoff_algorithm.h"
 
-#define RTIO_PING_SERIALIZE_BUFFER_SIZE ( 7U )
 #define RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE  ( 8U )
+#define RTIO_OBLIST_NOTIFY_BATCH_MAX  ( 16U ) /* Notifications in flight in RTIO_ObListNotifyAll. */
+#define RTIO_KEEPALIVE_PING_RETRY_MS ( 100U ) /* Retry interval of a ping that failed without breaking the session. */
 
 /*-----------------------------------------------------------*/
 static uint32_t calculateElapsedTime( uint32_t later, uint32_t start )
@@ -19,20 +20,6 @@ static uint32_t calculateElapsedTime( uint32_t later, uint32_t start )
     return later - start;
 }
 
-uint32_t crc32Ieee( uint8_t* data, uint16_t length ) 
-{
-    uint32_t crc = 0xFFFFFFFF;
-    uint8_t i = 0;
-    while( length-- )
-    {
-        crc ^= *data++;
-        for( i = 0; i < 8; ++i )
-        {
-            crc = ( crc >> 1 ) ^ ( ( crc & 1 ) ? 0xEDB88320 : 0 );
-        }
-    }
-    return ~crc;
-}
 /*-----------------------------------------------------------*/
 static uint16_t getNextHeaderId( RTIOContext_t* pContext )
 {
@@ -86,6 +73,213 @@ RTIOStatus_t transRestStatus( RTIORestStatus_t restStatus )
     }
     return status;
 }
+/*-----------------------------------------------------------*/
+
+/*
+ * Hashed timer wheel of the keep-alive thread. A timer sits in the slot of its deadline tick,
+ * ( deadlineMs / RTIO_TIMER_WHEEL_TICK_MS ) % RTIO_TIMER_WHEEL_SLOT_NUM, so arming and cancelling
+ * are O(1), and expiring walks the slots from cursorTick up to the current tick. Timers of later
+ * revolutions share a slot and stay until their deadline passes.
+ */
+#define RTIO_TIMER_END ( UINT16_MAX )
+#define RTIO_TIMER_ID_PING( pContext ) ( (pContext)->deviceSendRespList.size )
+#define RTIO_TIMER_ID_RECONNECT( pContext ) ( (uint16_t)( (pContext)->deviceSendRespList.size + 1U ) )
+#define RTIO_TIMER_ID_RX_IDLE( pContext ) ( (uint16_t)( (pContext)->deviceSendRespList.size + 2U ) )
+
+static bool timerWheel_Before( uint32_t a, uint32_t b )
+{
+    return (int32_t)( a - b ) < 0;
+}
+
+static void timerWheel_Init( rtioTimerWheel_t* pWheel )
+{
+    uint16_t i = 0;
+
+    for( i = 0; i < RTIO_TIMER_WHEEL_SLOT_NUM; i++ )
+    {
+        pWheel->pSlots[ i ] = RTIO_TIMER_END;
+    }
+    for( i = 0; i < pWheel->size; i++ )
+    {
+        pWheel->pTimers[ i ].armed = false;
+        pWheel->pTimers[ i ].next = RTIO_TIMER_END;
+        pWheel->pTimers[ i ].prev = RTIO_TIMER_END;
+    }
+    pWheel->wakeMs = OS_ClockGetTimeMs();
+    pWheel->cursorTick = pWheel->wakeMs / RTIO_TIMER_WHEEL_TICK_MS;
+}
+
+/* The caller holds pWheel->pLock. */
+static void timerWheel_Unlink( rtioTimerWheel_t* pWheel, uint16_t id )
+{
+    rtioTimer_t* pTimer = &( pWheel->pTimers[ id ] );
+
+    if( pTimer->prev == RTIO_TIMER_END )
+    {
+        pWheel->pSlots[ pTimer->slot ] = pTimer->next;
+    }
+    else
+    {
+        pWheel->pTimers[ pTimer->prev ].next = pTimer->next;
+    }
+    if( pTimer->next != RTIO_TIMER_END )
+    {
+        pWheel->pTimers[ pTimer->next ].prev = pTimer->prev;
+    }
+    pTimer->armed = false;
+}
+
+/* Tells the timer runner to run the timers by deadlineMs. */
+static void timerWheel_Notify( rtioTimerWheel_t* pWheel, uint32_t deadlineMs )
+{
+    if( pWheel->wakeup != NULL )
+    {
+        pWheel->wakeup( pWheel->pWakeupArg, deadlineMs );
+    }
+    else
+    {
+        (void)OS_EventSignal( pWheel->pEvent );
+    }
+}
+
+/* Wakes the timer runner now, for work outside the wheel like collecting a ping response. */
+static void timerWheel_Wake( rtioTimerWheel_t* pWheel )
+{
+    uint32_t nowMs = OS_ClockGetTimeMs();
+
+    OS_MutexLock( pWheel->pLock );
+    pWheel->wakeMs = nowMs;
+    OS_MutexUnlock( pWheel->pLock );
+
+    timerWheel_Notify( pWheel, nowMs );
+}
+
+/* Arms or re-arms timer id, the keep-alive thread is woken up if it would sleep past deadlineMs. */
+static void timerWheel_Arm( rtioTimerWheel_t* pWheel, uint16_t id, uint16_t tag, uint32_t deadlineMs )
+{
+    rtioTimer_t* pTimer = &( pWheel->pTimers[ id ] );
+    uint32_t tick = deadlineMs / RTIO_TIMER_WHEEL_TICK_MS;
+    bool wakeUp = false;
+
+    OS_MutexLock( pWheel->pLock );
+    if( pTimer->armed )
+    {
+        timerWheel_Unlink( pWheel, id );
+    }
+    /* A deadline already passed goes to the cursor slot, which is checked next. */
+    if( timerWheel_Before( tick, pWheel->cursorTick ) )
+    {
+        tick = pWheel->cursorTick;
+    }
+    pTimer->deadlineMs = deadlineMs;
+    pTimer->tag = tag;
+    pTimer->slot = (uint16_t)( tick % RTIO_TIMER_WHEEL_SLOT_NUM );
+    pTimer->prev = RTIO_TIMER_END;
+    pTimer->next = pWheel->pSlots[ pTimer->slot ];
+    if( pTimer->next != RTIO_TIMER_END )
+    {
+        pWheel->pTimers[ pTimer->next ].prev = id;
+    }
+    pWheel->pSlots[ pTimer->slot ] = id;
+    pTimer->armed = true;
+    if( timerWheel_Before( deadlineMs, pWheel->wakeMs ) )
+    {
+        pWheel->wakeMs = deadlineMs;
+        wakeUp = true;
+    }
+    OS_MutexUnlock( pWheel->pLock );
+
+    if( wakeUp )
+    {
+        timerWheel_Notify( pWheel, deadlineMs );
+    }
+}
+
+/* Cancels timer id if it is still armed with tag, a timer re-armed by a new owner is left alone. */
+static void timerWheel_Cancel( rtioTimerWheel_t* pWheel, uint16_t id, uint16_t tag )
+{
+    OS_MutexLock( pWheel->pLock );
+    if( pWheel->pTimers[ id ].armed && ( pWheel->pTimers[ id ].tag == tag ) )
+    {
+        timerWheel_Unlink( pWheel, id );
+    }
+    OS_MutexUnlock( pWheel->pLock );
+}
+
+/* Takes one timer whose deadline is not after nowMs, returns false when there is none. */
+static bool timerWheel_PopExpired( rtioTimerWheel_t* pWheel, uint32_t nowMs, uint16_t* pId, uint16_t* pTag )
+{
+    uint32_t nowTick = nowMs / RTIO_TIMER_WHEEL_TICK_MS;
+    uint16_t id = RTIO_TIMER_END;
+    uint16_t visited = 0;
+
+    OS_MutexLock( pWheel->pLock );
+    while( 1 )
+    {
+        id = pWheel->pSlots[ pWheel->cursorTick % RTIO_TIMER_WHEEL_SLOT_NUM ];
+        while( ( id != RTIO_TIMER_END ) && timerWheel_Before( nowMs, pWheel->pTimers[ id ].deadlineMs ) )
+        {
+            id = pWheel->pTimers[ id ].next;
+        }
+        if( ( id != RTIO_TIMER_END ) || ( pWheel->cursorTick == nowTick ) )
+        {
+            break;
+        }
+        visited++;
+        /* After a whole revolution every slot has been checked. */
+        pWheel->cursorTick = ( visited < RTIO_TIMER_WHEEL_SLOT_NUM ) ? pWheel->cursorTick + 1U : nowTick;
+    }
+    if( id != RTIO_TIMER_END )
+    {
+        timerWheel_Unlink( pWheel, id );
+        *pId = id;
+        *pTag = pWheel->pTimers[ id ].tag;
+    }
+    OS_MutexUnlock( pWheel->pLock );
+
+    return id != RTIO_TIMER_END;
+}
+
+/* How long the keep-alive thread may sleep: until the earliest deadline, at most one revolution. */
+static uint32_t timerWheel_NextWaitMs( rtioTimerWheel_t* pWheel, uint32_t nowMs )
+{
+    uint32_t revolutionMs = RTIO_TIMER_WHEEL_SLOT_NUM * RTIO_TIMER_WHEEL_TICK_MS;
+    uint32_t waitMs = revolutionMs;
+    uint16_t id = RTIO_TIMER_END;
+    uint16_t i = 0;
+    bool found = false;
+
+    OS_MutexLock( pWheel->pLock );
+    /* A slot may also hold timers of later revolutions, so the scan only ends once the earliest */
+    /* deadline seen is not after the first tick of the next slot, later slots cannot beat it. */
+    for( i = 0; ( i < RTIO_TIMER_WHEEL_SLOT_NUM ) && !found; i++ )
+    {
+        id = pWheel->pSlots[ ( pWheel->cursorTick + i ) % RTIO_TIMER_WHEEL_SLOT_NUM ];
+        while( id != RTIO_TIMER_END )
+        {
+            if( !timerWheel_Before( nowMs, pWheel->pTimers[ id ].deadlineMs ) )
+            {
+                waitMs = 0;
+            }
+            else if( pWheel->pTimers[ id ].deadlineMs - nowMs < waitMs )
+            {
+                waitMs = pWheel->pTimers[ id ].deadlineMs - nowMs;
+            }
+            else
+            {
+                /* MISRA else. */
+            }
+            id = pWheel->pTimers[ id ].next;
+        }
+        found = ( waitMs == 0U ) ||
+                !timerWheel_Before( ( pWheel->cursorTick + i + 1U ) * RTIO_TIMER_WHEEL_TICK_MS, nowMs + waitMs );
+    }
+    pWheel->wakeMs = nowMs + waitMs;
+    OS_MutexUnlock( pWheel->pLock );
+
+    return waitMs;
+}
+
 /*-----------------------------------------------------------*/
 void connectStatus_ChangeWhenEventConnect( RTIOContext_t* pContext )
 {
@@ -117,6 +311,7 @@ void connectStatus_ChangeWhenEventConnectSuccess( RTIOContext_t* pContext )
     {
     case RTIOConnecting:
         pContext->connectStatus = RTIOConnected;
+        pContext->connectCount++;
         LogDebug( ( "Change status: RTIOConnecting to RTIOConnected." ) );
         break;
     case RTIOConnectInit:
@@ -142,6 +337,8 @@ void connectStatus_ChangeWhenEventReconnect( RTIOContext_t* pContext )
     case RTIOConnected:
         pContext->connectStatus = RTIOConnecting;
         LogDebug( ( "Change status: RTIOConnected to RTIOConnecting." ) );
+        /* The keep-alive thread reconnects when the timer fires. */
+        timerWheel_Arm( &( pContext->timerWheel ), RTIO_TIMER_ID_RECONNECT( pContext ), 0, OS_ClockGetTimeMs() );
         break;
     case RTIOConnectInit:
     case RTIODisconnecting:
@@ -233,6 +430,48 @@ RTIOConnectStatus_t connectStatus_GetStatus( RTIOContext_t* pContext )
 
 /*-----------------------------------------------------------*/
 
+static void serve_ThreadStarted( RTIOContext_t* pContext )
+{
+    OS_MutexLock( pContext->pConnectionStatusLock );
+    pContext->threadsRunning++;
+    OS_MutexUnlock( pContext->pConnectionStatusLock );
+}
+
+/* Called by a thread of RTIO_Serve as the last thing before it destroys itself, or when it failed to start. */
+static void serve_ThreadStopped( RTIOContext_t* pContext )
+{
+    OS_MutexLock( pContext->pConnectionStatusLock );
+    pContext->threadsRunning--;
+    OS_MutexUnlock( pContext->pConnectionStatusLock );
+    (void)OS_EventSignal( pContext->pThreadExitEvent );
+}
+
+static uint16_t serve_ThreadsRunning( RTIOContext_t* pContext )
+{
+    uint16_t running = 0;
+
+    OS_MutexLock( pContext->pConnectionStatusLock );
+    running = pContext->threadsRunning;
+    OS_MutexUnlock( pContext->pConnectionStatusLock );
+    return running;
+}
+
+/* Waits until the threads of RTIO_Serve stopped, serviceDone must be set and the threads woken up. */
+static bool serve_JoinThreads( RTIOContext_t* pContext, uint32_t timeoutMs )
+{
+    uint32_t startTimeMs = OS_ClockGetTimeMs();
+    uint32_t elapsedMs = 0;
+
+    while( ( serve_ThreadsRunning( pContext ) > 0U ) && ( elapsedMs < timeoutMs ) )
+    {
+        (void)OS_EventWait( pContext->pThreadExitEvent, timeoutMs - elapsedMs );
+        elapsedMs = calculateElapsedTime( OS_ClockGetTimeMs(), startTimeMs );
+    }
+    return serve_ThreadsRunning( pContext ) == 0U;
+}
+
+/*-----------------------------------------------------------*/
+
 static RTIOStatus_t sendMessageSafe( RTIOContext_t* pContext,
                                      const uint8_t* pBufferToSend,
                                      size_t bytesToSend )
@@ -308,6 +547,125 @@ static RTIOStatus_t sendMessageSafe( RTIOContext_t* pContext,
     return status;
 }
 
+/* Sends the segments as one message, pIoVec is consumed on partial sends. */
+static RTIOStatus_t sendMessageVectorSafe( RTIOContext_t* pContext,
+                                           TransportIoVector_t* pIoVec,
+                                           size_t ioVecCount )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    int32_t sendResult = 0;
+    uint32_t startTimeMs;
+    size_t bytesToSend = 0;
+    size_t i = 0;
+
+    if( ( pContext == NULL ) ||
+        ( pContext->transportInterface.sendv == NULL ) ||
+        ( pIoVec == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, "
+                    "pContext->transportInterface.sendv=%p, "
+                    "pIoVec=%p.",
+                    (void*)pContext,
+                    (void*)pContext->transportInterface.sendv,
+                    (void*)pIoVec ) );
+        return RTIOBadParameter;
+    }
+
+    for( i = 0; i < ioVecCount; i++ )
+    {
+        bytesToSend += pIoVec[ i ].iov_len;
+    }
+
+    startTimeMs = OS_ClockGetTimeMs();
+
+    OS_MutexLock( pContext->pSendMessageLock );
+    while( ioVecCount > 0U )
+    {
+        sendResult = pContext->transportInterface.sendv( pContext->transportInterface.pNetworkContext,
+                                                         pIoVec, ioVecCount );
+        if( sendResult > 0 )
+        {
+            if( (size_t)sendResult > bytesToSend )
+            {
+                LogError( ( "Transport Sendv implementation error,"
+                            "sendResult=%d bytesToSend=%d.",
+                            (int)sendResult, (int)bytesToSend ) );
+                status = RTIOTransportImplementError;
+                break;
+            }
+
+            bytesToSend -= (size_t)sendResult;
+            pContext->lastPacketTxTime = OS_ClockGetTimeMs(); // only for reset ping time, no mutext required
+
+            /* Skip the segments sent, then the sent part of a partially sent one. */
+            while( ( ioVecCount > 0U ) && ( (size_t)sendResult >= pIoVec->iov_len ) )
+            {
+                sendResult -= (int32_t)pIoVec->iov_len;
+                pIoVec++;
+                ioVecCount--;
+            }
+            if( ioVecCount > 0U )
+            {
+                pIoVec->iov_base = &( (const uint8_t*)pIoVec->iov_base )[ sendResult ];
+                pIoVec->iov_len -= (size_t)sendResult;
+            }
+
+            LogDebug( ( "Bytes Remaining=%d.", (int)bytesToSend ) );
+        }
+        else if( sendResult < 0 )
+        {
+            status = RTIOSendFailed;
+            LogError( ( "Unable to send packet: Network Error, sendResult=%d.", (int)sendResult ) );
+            break;
+        }
+        else
+        {
+            /* MISRA Empty body */
+        }
+
+        if( ( ioVecCount > 0U ) &&
+            ( calculateElapsedTime( OS_ClockGetTimeMs(), startTimeMs ) >= RTIO_SEND_TIMEOUT_MS ) )
+        {
+            status = RTIOTimeout;
+            LogError( ( "Unable to send packet: Timed out." ) );
+            break;
+        }
+    }
+    OS_MutexUnlock( pContext->pSendMessageLock );
+
+    return status;
+}
+
+/* A waiting recv wakes up this often to see RTIO_Disconnect. */
+#define RTIO_RECV_WAIT_SLICE_MS ( 1000U )
+
+/* Sleeps until the transport has data instead of polling recv, when it supports waiting. */
+static RTIOStatus_t recvWaitReadable( RTIOContext_t* pContext, uint32_t startTimeMs )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint32_t elapsedMs = calculateElapsedTime( OS_ClockGetTimeMs(), startTimeMs );
+    uint32_t waitMs = 0;
+    int32_t waitResult = 0;
+
+    if( ( pContext->transportInterface.waitReadable != NULL ) &&
+        ( elapsedMs < RTIO_RECV_TIMEOUT_MS ) )
+    {
+        waitMs = RTIO_RECV_TIMEOUT_MS - elapsedMs;
+        if( waitMs > RTIO_RECV_WAIT_SLICE_MS )
+        {
+            waitMs = RTIO_RECV_WAIT_SLICE_MS;
+        }
+        waitResult = pContext->transportInterface.waitReadable( pContext->transportInterface.pNetworkContext,
+                                                                waitMs );
+        if( waitResult < 0 )
+        {
+            LogError( ( "Unable to wait for packet: Network Error, waitResult=%d.", (int)waitResult ) );
+            status = RTIORecvFailed;
+        }
+    }
+    return status;
+}
+
 static RTIOStatus_t recvMessageSafe( RTIOContext_t* pContext,
                                      uint8_t* pBufferToRecv,
                                      uint32_t bytesToRecv )
@@ -365,7 +723,11 @@ static RTIOStatus_t recvMessageSafe( RTIOContext_t* pContext,
         }
         else
         {
-            /* MISRA Empty body */
+            status = recvWaitReadable( pContext, startTimeMs );
+            if( RTIOSuccess != status )
+            {
+                break;
+            }
         }
 
         if( calculateElapsedTime( OS_ClockGetTimeMs(), startTimeMs ) >= RTIO_RECV_TIMEOUT_MS )
@@ -379,1340 +741,3917 @@ static RTIOStatus_t recvMessageSafe( RTIOContext_t* pContext,
 }
 
 /**
- * @brief Connect to server.
- *
- * @param[in] pContext context pointer.
+ * @brief Reads into networkIncommingBuffer until bytesNeeded are buffered from incommingStart.
  *
- * @return RTIOSuccess，RTIOBadParameter, RTIOTransportFailed, RTIOVerifyFailedNeverRetry and other RTIOStatus_t.
+ * Each transport call asks for all the free space, so a burst of frames is read at once
+ * and the following frames are parsed without calling the transport again.
  */
-static RTIOStatus_t connectRTIOServer( RTIOContext_t* pContext )
+static RTIOStatus_t recvBuffered( RTIOContext_t* pContext, uint16_t bytesNeeded )
 {
-    TransportStatus_t transportStatus = TransportUnknown;
     RTIOStatus_t status = RTIOSuccess;
-    RTIOVerifyReq_t verifyReq = { 0 };
-    RTIOVerifyResp_t verifyResp = { 0 };
-    uint16_t dataLen = 0U;
+    RTIOFixedBuffer_t* pBuffer = &( pContext->networkIncommingBuffer );
+    int32_t recvResult = 0;
+    uint32_t startTimeMs;
 
-    if( ( pContext == NULL ) ||
-        ( pContext->transportInterface.connect == NULL ) )
+    if( bytesNeeded > pBuffer->size )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, "
-                    "transportInterface.connect=%p.",
-                    (void*)pContext,
-                    (void*)pContext->transportInterface.connect ) );
-
-        return RTIOBadParameter;
+        LogError( ( "Buffer size is not enough: bytesNeeded=%u, bufsize=%u.", bytesNeeded, pBuffer->size ) );
+        return RTIONoMemory;
     }
 
-    if( pContext->transportInterface.send == NULL )
-    {
-        LogError( ( "Argument transportInterface.send is NULL." ) );
-        return RTIOBadParameter;
-    }
-    if( pContext->transportInterface.recv == NULL )
-    {
-        LogError( ( "Argument transportInterface->recv is NULL." ) );
-        return RTIOBadParameter;
-    }
-    if( pContext->transportInterface.pNetworkContext == NULL )
-    {
-        LogError( ( "Argument transportInterface->pNetworkContext is NULL." ) );
-        return RTIOBadParameter;
-    }
-    if( pContext->pServerInfo == NULL )
+    /* Move the partial frame to the front when the rest of it does not fit. */
+    if( pContext->incommingStart + bytesNeeded > pBuffer->size )
     {
-        LogError( ( "Argument pServerInfo is NULL." ) );
-        return RTIOBadParameter;
+        memmove( pBuffer->pBuffer, &( pBuffer->pBuffer[ pContext->incommingStart ] ),
+                 pContext->incommingEnd - pContext->incommingStart );
+        pContext->incommingEnd -= pContext->incommingStart;
+        pContext->incommingStart = 0;
     }
 
-    transportStatus = pContext->transportInterface.connect(
-        pContext->transportInterface.pNetworkContext,
-        pContext->pTransportOption,
-        pContext->pServerInfo );
-
-    if( transportStatus != TransportSuccess )
-    {
-        LogError( ( "Transport connect error, transportStatus=%d.", transportStatus ) );
-        status = RTIOTransportFailed;
-    }
+    startTimeMs = OS_ClockGetTimeMs();
 
-    if( RTIOSuccess == status )
+    OS_MutexLock( pContext->pRecvMessageLock );
+    while( ( pContext->incommingEnd - pContext->incommingStart ) < bytesNeeded )
     {
-        verifyReq.header.version = RTIO_PROTOCAL_VERSION;
-        verifyReq.header.type = RTIO_TYPE_DEVICE_VERIFY_REQ;
-        verifyReq.header.id = getNextHeaderId( pContext );
-        verifyReq.pDeviceId = pContext->pDeviceInfo->pDeviceId;
-        verifyReq.pDeviceSecret = pContext->pDeviceInfo->pDeviceSecret;
-        verifyReq.header.bodyLen = pContext->pDeviceInfo->deviceIdLength + pContext->pDeviceInfo->deviceSecretLength + 2;
-        verifyReq.capLevel = RTIO_CAP_CURRENT_LEVEL;
-        status = RTIO_SerializeVerifyReq( &verifyReq, &pContext->networkOutgoingBuffer, &dataLen );
-        if( status != RTIOSuccess )
+        /* Once a reconnect started, the bytes belong to the verify response of the keep-alive thread. */
+        if( !connectStatus_CheckStatus( pContext, RTIOConnected ) )
         {
-            LogError( ( "Failed to serialize verify request." ) );
+            status = RTIORecvFailed;
+            break;
         }
-        else
+        if( pContext->serviceDone )
         {
-            status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, dataLen );
-            if( status != RTIOSuccess )
+            status = RTIOTimeout;
+            break;
+        }
+        recvResult = pContext->transportInterface.recv( pContext->transportInterface.pNetworkContext,
+                                                        &( pBuffer->pBuffer[ pContext->incommingEnd ] ),
+                                                        pBuffer->size - pContext->incommingEnd );
+        if( recvResult > 0 )
+        {
+            if( recvResult > (int32_t)( pBuffer->size - pContext->incommingEnd ) )
             {
-                LogError( ( "Failed to send verify request, status=%d.", status ) );
+                LogError( ( "Transport Recv implementation error, recvResult=%d bytesToRecv=%d.",
+                            (int)recvResult, (int)( pBuffer->size - pContext->incommingEnd ) ) );
+                status = RTIOTransportImplementError;
+                break;
             }
-        }
-    }
+            pContext->incommingEnd += (uint16_t)recvResult;
 
-    if( RTIOSuccess == status )
-    {
-        status = recvMessageSafe( pContext, pContext->networkIncommingBuffer.pBuffer, RTIO_PROTOCAL_HEADER_LEN );
-        if( status != RTIOSuccess )
+            LogDebug( ( "Bytes Recv=%d, Bytes Buffered=%d.",
+                        (int)recvResult,
+                        (int)( pContext->incommingEnd - pContext->incommingStart ) ) );
+        }
+        else if( recvResult < 0 )
         {
-            LogError( ( "Failed to recv verify response, status=%d.", status ) );
+            status = RTIORecvFailed;
+            LogError( ( "Unable to recv packet: Network Error, recvResult=%d.", (int)recvResult ) );
+            break;
         }
         else
         {
-            status = RTIO_DeserializeVerifyResp( &pContext->networkIncommingBuffer, &verifyResp );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to deserial response, status=%d.", status ) );
-            }
-            else
+            status = recvWaitReadable( pContext, startTimeMs );
+            if( RTIOSuccess != status )
             {
-                if( verifyResp.header.code == REMOTECODE_SUCCESS )
-                {
-                    LogInfo( ( "Device verification successful." ) );
-                    status = RTIOSuccess;
-                }
-                else
-                {
-                    LogError( ( "Failed to verify device, code=%u.", verifyResp.header.code ) );
-                    status = RTIOVerifyFailedNeverRetry;
-                }
+                break;
             }
         }
+
+        if( calculateElapsedTime( OS_ClockGetTimeMs(), startTimeMs ) >= RTIO_RECV_TIMEOUT_MS )
+        {
+            status = RTIOTimeout;
+            break;
+        }
     }
+    OS_MutexUnlock( pContext->pRecvMessageLock );
+    return status;
+}
 
-    if( RTIOSuccess != status )
+static void recvBuffered_Consume( RTIOContext_t* pContext, uint16_t length )
+{
+    pContext->incommingStart += length;
+    if( pContext->incommingStart >= pContext->incommingEnd )
     {
-        pContext->transportInterface.disconnect( pContext->transportInterface.pNetworkContext );
+        pContext->incommingStart = 0;
+        pContext->incommingEnd = 0;
     }
-    return status;
 }
+
 /*-----------------------------------------------------------*/
 
-static RTIOStatus_t deviceSendRespList_Add( rtioDeviceSendRespList_t* pRespList,
-                                            uint16_t headerId,
-                                            RTIOFixedBuffer_t* pRespBuffer,
-                                            uint16_t* pIndex )
+#define RTIO_SEND_QUEUE_END ( UINT16_MAX )
+#define RTIO_SEND_QUEUE_WAIT_SLICE_MS ( 100U )
+
+/* A frame to serialize into, taken from the send queue or the shared networkOutgoingBuffer. */
+typedef struct rtioOutgoingFrame
 {
-    RTIOStatus_t status = RTIOSuccess;
+    RTIOFixedBuffer_t buffer;
+    uint16_t index; /* Send queue frame index, RTIO_SEND_QUEUE_END for networkOutgoingBuffer. */
+    rtioSendLane_t lane;
+    bool offline;             /* An offline queue item instead, see requestFrame_Begin. */
+    uint16_t evictedHeaderId; /* Request dropped from the full offline queue for it, 0 when none. */
+} rtioOutgoingFrame_t;
+
+static void sendQueue_Init( rtioSendQueue_t* pQueue )
+{
+    uint16_t i = 0;
 
+    for( i = 0; i < (uint16_t)RTIO_SEND_LANE_NUM; i++ )
+    {
+        pQueue->heads[ i ] = RTIO_SEND_QUEUE_END;
+        pQueue->tails[ i ] = RTIO_SEND_QUEUE_END;
+    }
+    pQueue->freeHead = ( pQueue->size > 0U ) ? 0U : RTIO_SEND_QUEUE_END;
+    pQueue->freeNum = pQueue->size;
+    memset( &( pQueue->stats ), 0, sizeof( pQueue->stats ) );
+    for( i = 0; i < pQueue->size; i++ )
+    {
+        pQueue->pFrames[ i ].length = 0;
+        pQueue->pFrames[ i ].next = ( ( i + 1U ) < pQueue->size ) ? (uint16_t)( i + 1U ) : RTIO_SEND_QUEUE_END;
+    }
+}
 
-    OS_MutexLock( pRespList->pLock );
+/* Takes a free frame, waits up to RTIO_SEND_TIMEOUT_MS while the queue is full for the lane. */
+/* Each lane leaves RTIO_SEND_QUEUE_LANE_RESERVE frames to every more urgent one. */
+static RTIOStatus_t sendQueue_Acquire( rtioSendQueue_t* pQueue, rtioSendLane_t lane, uint16_t* pIndex )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint32_t startTimeMs = OS_ClockGetTimeMs();
+    uint16_t reserved = (uint16_t)( (uint16_t)lane * RTIO_SEND_QUEUE_LANE_RESERVE );
 
-    *pIndex = 0;
-    for( ; *pIndex < pRespList->size; ( *pIndex )++ )
+    OS_MutexLock( pQueue->pLock );
+    while( ( pQueue->freeNum <= reserved ) && ( status == RTIOSuccess ) )
     {
-        if( pRespList->pList[ *pIndex ].headerId == 0 )
+        OS_MutexUnlock( pQueue->pLock );
+        if( calculateElapsedTime( OS_ClockGetTimeMs(), startTimeMs ) >= RTIO_SEND_TIMEOUT_MS )
         {
-            pRespList->pList[ *pIndex ].headerId = headerId;
-            pRespList->pList[ *pIndex ].pFixedBuffer = pRespBuffer;
-            pRespList->pList[ *pIndex ].arrived = false;
-            pRespList->pList[ *pIndex ].timestampMs = OS_ClockGetTimeMs();
-            break;
+            LogError( ( "Unable to queue packet: Timed out." ) );
+            status = RTIOTimeout;
         }
+        else
+        {
+            /* Signals do not accumulate, several producers may wait, so recheck every slice. */
+            (void)OS_EventWait( pQueue->pSpaceEvent, RTIO_SEND_QUEUE_WAIT_SLICE_MS );
+        }
+        OS_MutexLock( pQueue->pLock );
     }
-    if( *pIndex == pRespList->size )
-    {
-        status = RTIOListFull;
-    }
-
-    OS_MutexUnlock( pRespList->pLock );
 
     if( status == RTIOSuccess )
     {
-        LogDebug( ( "Add: headerId=%u, index=%u.", headerId, *pIndex ) );
+        *pIndex = pQueue->freeHead;
+        pQueue->freeHead = pQueue->pFrames[ *pIndex ].next;
+        pQueue->freeNum--;
+        pQueue->pFrames[ *pIndex ].next = RTIO_SEND_QUEUE_END;
     }
+    OS_MutexUnlock( pQueue->pLock );
 
     return status;
 }
 
-static RTIOStatus_t deviceSendRespList_Delete( rtioDeviceSendRespList_t* pRespList, uint16_t index )
+static void sendQueue_Release( rtioSendQueue_t* pQueue, uint16_t index )
 {
-    if( ( pRespList == NULL ) )
+    OS_MutexLock( pQueue->pLock );
+    pQueue->pFrames[ index ].length = 0;
+    pQueue->pFrames[ index ].next = pQueue->freeHead;
+    pQueue->freeHead = index;
+    pQueue->freeNum++;
+    OS_MutexUnlock( pQueue->pLock );
+    (void)OS_EventSignal( pQueue->pSpaceEvent );
+}
+
+static void sendQueue_Push( rtioSendQueue_t* pQueue, rtioSendLane_t lane, uint16_t index, uint16_t length )
+{
+    OS_MutexLock( pQueue->pLock );
+    pQueue->pFrames[ index ].length = length;
+    pQueue->pFrames[ index ].next = RTIO_SEND_QUEUE_END;
+    if( pQueue->tails[ lane ] == RTIO_SEND_QUEUE_END )
     {
-        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
-        return RTIOBadParameter;
+        pQueue->heads[ lane ] = index;
     }
-
-    if( index >= pRespList->size )
+    else
     {
-        LogWarn( ( "Invalid index=%u, pRespList->size=%u, ignore.", index, pRespList->size) );
-        return RTIOSuccess;
+        pQueue->pFrames[ pQueue->tails[ lane ] ].next = index;
     }
-
-    OS_MutexLock( pRespList->pLock );
-    pRespList->pList[ index ].headerId = 0;
-    pRespList->pList[ index ].code = 0;
-    pRespList->pList[ index ].respLength = 0;
-    pRespList->pList[ index ].pFixedBuffer = NULL;
-    pRespList->pList[ index ].arrived = false;
-    pRespList->pList[ index ].timestampMs = 0;
-    OS_MutexUnlock( pRespList->pLock );
-
-    return RTIOSuccess;
+    pQueue->tails[ lane ] = index;
+    OS_MutexUnlock( pQueue->pLock );
+    (void)OS_EventSignal( pQueue->pWriterEvent );
 }
 
-static RTIOStatus_t deviceSendRespList_Wait( const rtioDeviceSendRespList_t* pRespList, uint16_t index, uint16_t timeoutMs )
+/* Pops the first frame of the most urgent lane holding one. */
+/* Returns RTIO_SEND_QUEUE_END when the queue is empty, or that frame is longer than maxLength. */
+static uint16_t sendQueue_Pop( rtioSendQueue_t* pQueue, uint16_t maxLength, bool* pEmpty )
 {
-    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
+    uint16_t index = RTIO_SEND_QUEUE_END;
+    uint16_t lane = 0;
+
+    OS_MutexLock( pQueue->pLock );
+    while( ( lane < (uint16_t)RTIO_SEND_LANE_NUM ) && ( pQueue->heads[ lane ] == RTIO_SEND_QUEUE_END ) )
     {
-        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
-        return RTIOBadParameter;
+        lane++;
     }
-
-    // wait for resp arrived or timeout, no lock required:
-    // because every deviceSendRespListWait read a different index
-    // only incomming thread trigger the arrived flag
-    while( pRespList->pList[ index ].arrived == false )
+    *pEmpty = ( lane == (uint16_t)RTIO_SEND_LANE_NUM );
+    if( !*pEmpty && ( pQueue->pFrames[ pQueue->heads[ lane ] ].length <= maxLength ) )
     {
-        OS_ClockSleepMs( 50U );
-        if( calculateElapsedTime( OS_ClockGetTimeMs(), pRespList->pList[ index ].timestampMs )
-            >= timeoutMs )
+        index = pQueue->heads[ lane ];
+        pQueue->heads[ lane ] = pQueue->pFrames[ index ].next;
+        if( pQueue->heads[ lane ] == RTIO_SEND_QUEUE_END )
         {
-            return RTIOTimeout; /* TODO: replace with RTIOWaitRespTimeout, #49 */
+            pQueue->tails[ lane ] = RTIO_SEND_QUEUE_END;
         }
     }
-    return RTIOSuccess;
+    OS_MutexUnlock( pQueue->pLock );
+
+    return index;
 }
 
-static RTIOStatus_t deviceSendRespList_Find( const rtioDeviceSendRespList_t* pRespList, uint16_t headerId, uint16_t* pIndex )
+/* Frees the frames of one write and counts it. */
+static void sendQueue_ReleaseWritten( rtioSendQueue_t* pQueue, const uint16_t* pIndexes, uint16_t count )
 {
-    if( ( pRespList == NULL ) || ( pIndex == NULL ) )
+    uint16_t i = 0;
+
+    OS_MutexLock( pQueue->pLock );
+    pQueue->stats.writes++;
+    pQueue->stats.frames += count;
+    if( count > pQueue->stats.framesPerWriteMax )
     {
-        LogError( ( "Argument cannot be NULL: pList=%p, pIndex=%p.", (void*)pRespList, (void*)pIndex ) );
-        return RTIOBadParameter;
+        pQueue->stats.framesPerWriteMax = count;
     }
-
-    *pIndex = 0;
-    for( ; *pIndex < pRespList->size; ( *pIndex )++ )
+    for( i = 0; i < count; i++ )
     {
-        if( pRespList->pList[ *pIndex ].headerId == headerId )
-        {
-            break;
-        }
+        pQueue->stats.bytes += pQueue->pFrames[ pIndexes[ i ] ].length;
+        pQueue->pFrames[ pIndexes[ i ] ].length = 0;
+        pQueue->pFrames[ pIndexes[ i ] ].next = pQueue->freeHead;
+        pQueue->freeHead = pIndexes[ i ];
     }
-    if( *pIndex == pRespList->size )
+    pQueue->freeNum += count;
+    OS_MutexUnlock( pQueue->pLock );
+    for( i = 0; i < count; i++ )
     {
-        *pIndex = pRespList->size;
-        return RTIONotFound;
+        (void)OS_EventSignal( pQueue->pSpaceEvent );
     }
-
-    return RTIOSuccess;
 }
-static RTIOStatus_t deviceSendRespList_Ready( const rtioDeviceSendRespList_t* pRespList, uint16_t index )
+
+/* Gets a frame to serialize into, must be followed by outgoingFrame_End. */
+/* The lane orders queued frames, frames sent directly go in the order senders lock. */
+static RTIOStatus_t outgoingFrame_Begin( RTIOContext_t* pContext, rtioOutgoingFrame_t* pFrame, rtioSendLane_t lane )
 {
-    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
+    RTIOStatus_t status = RTIOSuccess;
+
+    pFrame->lane = lane;
+    if( pContext->sendQueue.size == 0U )
     {
-        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
-        return RTIOBadParameter;
+        OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
+        pFrame->buffer = pContext->networkOutgoingBuffer;
+        pFrame->index = RTIO_SEND_QUEUE_END;
     }
-    // no lock required:
-    // because every deviceSendRespListArrived trigger different arrived flag
-    rtioDeviceSendResp_t* pResp = &( pRespList->pList[ index ] );
-    pResp->arrived = true;
-    return RTIOSuccess;
+    else
+    {
+        status = sendQueue_Acquire( &( pContext->sendQueue ), lane, &( pFrame->index ) );
+        if( status == RTIOSuccess )
+        {
+            pFrame->buffer.pBuffer = pContext->sendQueue.pFrames[ pFrame->index ].buffer;
+            pFrame->buffer.size = RTIO_TRANSFER_FRAME_BUF_SIZE;
+        }
+    }
+    return status;
 }
 
-static RTIOStatus_t deviceSendRespList_GetResp( const rtioDeviceSendRespList_t* pRespList, uint16_t index, rtioDeviceSendResp_t** ppResp )
+/* Appends the payload to the serialized headers of the frame. */
+static RTIOStatus_t outgoingFrame_CopyPayload( rtioOutgoingFrame_t* pFrame, uint16_t* pLength,
+                                               const uint8_t* pPayload, uint16_t payloadLength )
 {
-    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
+    if( *pLength + payloadLength > pFrame->buffer.size )
     {
-        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
+        LogError( ( "Buffer size is not enough: length=%u, payloadLength=%u, bufsize=%u.",
+                    *pLength, payloadLength, pFrame->buffer.size ) );
         return RTIOBadParameter;
     }
-    *ppResp = &( pRespList->pList[ index ] );
+    if( payloadLength > 0U )
+    {
+        memcpy( &( pFrame->buffer.pBuffer[ *pLength ] ), pPayload, payloadLength );
+        *pLength += payloadLength;
+    }
     return RTIOSuccess;
 }
 
-static RTIOStatus_t handleCoPostRequest( RTIOContext_t* pContext, RTIOCoReq_t* pReq )
+/**
+ * @brief Sends the serialized frame, or queues it to the writer thread.
+ *
+ * @param[in] length length serialized in the frame, 0 discards the frame.
+ * @param[in] pPayload payload following the frame, sent as its own segment when the frame
+ * is sent directly, so it is not copied; queued frames own a copy of it.
+ */
+static RTIOStatus_t outgoingFrame_End( RTIOContext_t* pContext, rtioOutgoingFrame_t* pFrame, uint16_t length,
+                                       const uint8_t* pPayload, uint16_t payloadLength )
 {
-    RTIOStatus_t status = RTIOUnknown;
-    RTIOCoResp_t resp = { 0 };
-    uint16_t serianlizeLength = 0;
-
-    if( pReq == NULL )
-    {
-        LogError( ( "Argument cannot be NULL: pReq=%p.", (void*)pReq ) );
-        return RTIOBadParameter;
-    }
+    RTIOStatus_t status = RTIOSuccess;
+    TransportIoVector_t ioVec[ 2 ];
 
-    RTIOCoPostHandler_t handler = { 0 };
-    int i = 0;
-    for( ; i < pContext->coPostInfoList.size; i++ )
+    if( pFrame->index == RTIO_SEND_QUEUE_END )
     {
-        if( pContext->coPostInfoList.pList[ i ].uri == pReq->uri )
+        if( ( length > 0U ) && ( payloadLength > 0U ) && ( pContext->transportInterface.sendv != NULL ) )
         {
-            handler = pContext->coPostInfoList.pList[ i ].handler;
-            break;
+            ioVec[ 0 ].iov_base = pFrame->buffer.pBuffer;
+            ioVec[ 0 ].iov_len = length;
+            ioVec[ 1 ].iov_base = pPayload;
+            ioVec[ 1 ].iov_len = payloadLength;
+            status = sendMessageVectorSafe( pContext, ioVec, 2 );
         }
-    }
-
-
-    resp.headerId = pReq->headerId;
-    resp.method = pReq->method;
-
-    if( i == pContext->coPostInfoList.size )
-    {
-        LogWarn( ( "Handler not found, uri=%u.", (unsigned)pReq->uri ) );
-        resp.code = RTIO_REST_STATUS_NOT_FOUNT;
-    }
-    else
-    {
-        if( NULL != handler )
+        else if( ( length > 0U ) && ( length + payloadLength > pFrame->buffer.size ) )
         {
-            status = handler( pReq->pData, pReq->dataLength,
-                              &( pContext->serverSendRespBuffer ), &resp.dataLength );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to handler, status=%d.", status ) );
-                resp.code = RTIO_REST_STATUS_INTERNAL_SERVER_ERROR;
-            }
-            else
+            /* Still one message, other senders wait for pNetworkOutgoingBufferLock. */
+            status = sendMessageSafe( pContext, pFrame->buffer.pBuffer, length );
+            if( status == RTIOSuccess )
             {
-                resp.pData = pContext->serverSendRespBuffer.pBuffer;
-                resp.code = RTIO_REST_STATUS_OK;
+                status = sendMessageSafe( pContext, pPayload, payloadLength );
             }
         }
+        else if( length > 0U )
+        {
+            (void)outgoingFrame_CopyPayload( pFrame, &length, pPayload, payloadLength );
+            status = sendMessageSafe( pContext, pFrame->buffer.pBuffer, length );
+        }
         else
         {
-            LogError( ( "Handler is NULL, index=%d handler=%p.", i, (void*)handler ) );
-            resp.code = RTIO_REST_STATUS_NOT_FOUNT;
+            /* Discarded. */
         }
+        OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
     }
-
-    OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
-    status = RTIO_SerializeCoResp_OverServerSendResp( &resp, &( pContext->networkOutgoingBuffer ), &serianlizeLength );
-    if( status != RTIOSuccess )
-    {
-        LogError( ( "Failed to SerializeCoResp, status=%d.", status ) );
-    }
-    else
+    else if( length > 0U )
     {
-        status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, serianlizeLength );
-        if( status != RTIOSuccess )
+        status = outgoingFrame_CopyPayload( pFrame, &length, pPayload, payloadLength );
+        if( status == RTIOSuccess )
         {
-            LogError( ( "Failed to send CoResp, status=%d.", status ) );
+            sendQueue_Push( &( pContext->sendQueue ), pFrame->lane, pFrame->index, length );
         }
         else
         {
-            status = RTIOSuccess;
+            sendQueue_Release( &( pContext->sendQueue ), pFrame->index );
         }
     }
-    OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
-
+    else
+    {
+        sendQueue_Release( &( pContext->sendQueue ), pFrame->index );
+    }
     return status;
-
 }
 
-static RTIOStatus_t handleObEstabRequest( RTIOContext_t* pContext, RTIOObEstabReq_t* pReq )
+/**
+ * @brief Connect to server.
+ *
+ * @param[in] pContext context pointer.
+ *
+ * @return RTIOSuccess，RTIOBadParameter, RTIOTransportFailed, RTIOVerifyFailedNeverRetry and other RTIOStatus_t.
+ */
+static RTIOStatus_t connectRTIOServer( RTIOContext_t* pContext )
 {
-    RTIOStatus_t status = RTIOUnknown;
-    RTIOObEstabResp_t resp = { 0 };
-    uint16_t serianlizeLength = 0;
+    TransportStatus_t transportStatus = TransportUnknown;
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOVerifyReq_t verifyReq = { 0 };
+    RTIOVerifyResp_t verifyResp = { 0 };
+    uint16_t dataLen = 0U;
 
-    if( pReq == NULL )
+    if( ( pContext == NULL ) ||
+        ( pContext->transportInterface.connect == NULL ) )
     {
-        LogError( ( "Argument cannot be NULL: pReq=%p.", (void*)pReq ) );
+        LogError( ( "Argument cannot be NULL: pContext=%p, "
+                    "transportInterface.connect=%p.",
+                    (void*)pContext,
+                    (void*)pContext->transportInterface.connect ) );
+
         return RTIOBadParameter;
     }
 
-    RTIOObGetHandler_t handler = { 0 };
-    int i = 0;
-    for( ; i < pContext->obGetInfoList.size; i++ )
+    if( pContext->transportInterface.send == NULL )
     {
-        if( pContext->obGetInfoList.pList[ i ].uri == pReq->uri )
-        {
-            handler = pContext->obGetInfoList.pList[ i ].handler;
-            break;
-        }
+        LogError( ( "Argument transportInterface.send is NULL." ) );
+        return RTIOBadParameter;
     }
-
-    resp.headerId = pReq->headerId;
-    resp.method = pReq->method;
-    resp.obId = pReq->obId;
-
-    if( i == pContext->obGetInfoList.size )
+    if( pContext->transportInterface.recv == NULL )
     {
-        LogError( ( "Handler not found, uri=%u.", (unsigned)pReq->uri ) );
-        resp.code = RTIO_REST_STATUS_NOT_FOUNT;
+        LogError( ( "Argument transportInterface->recv is NULL." ) );
+        return RTIOBadParameter;
     }
-    else
+    if( pContext->transportInterface.pNetworkContext == NULL )
     {
-        if( NULL != handler )
-        {
-            status = handler( pReq->pData, pReq->dataLength, pReq->obId );
-            if( status != RTIOSuccess )
-            {
-                if( status == RTIOListFull )
-                {
-                    LogWarn( ( "This uri too many observers, uri=%u , status=%u.", (unsigned)pReq->uri, (unsigned)status ) );
-                    resp.code = RTIO_REST_STATUS_TOO_MANY_OBSERVERS;
-                }
-                else
-                {
-                    LogError( ( "Failed to handler, status=%d.", status ) );
-                    resp.code = RTIO_REST_STATUS_INTERNAL_SERVER_ERROR;
-                }
-            }
-            else
-            {
-                resp.code = RTIO_REST_STATUS_CONTINUE;
-            }
-        }
-        else
-        {
-            LogError( ( "Handler is NULL, index=%d handler=%p.", i, (void*)handler ) );
-            resp.code = RTIO_REST_STATUS_NOT_FOUNT;
-        }
-    }
-
-    OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
-    status = RTIO_SerializeObEstabResp_OverServerSendResp( &resp, &( pContext->networkOutgoingBuffer ), &serianlizeLength );
-    if( status != RTIOSuccess )
-    {
-        LogError( ( "Failed to SerializeObResp, status=%d.", status ) );
+        LogError( ( "Argument transportInterface->pNetworkContext is NULL." ) );
+        return RTIOBadParameter;
     }
-    else
+    if( pContext->pServerInfo == NULL )
     {
-        status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, serianlizeLength );
-        if( status != RTIOSuccess )
-        {
-            LogError( ( "Failed to send ObResp, status=%d.", status ) );
-        }
-        else
-        {
-            status = RTIOSuccess;
-        }
+        LogError( ( "Argument pServerInfo is NULL." ) );
+        return RTIOBadParameter;
     }
-    OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
-    return status;
-}
 
+    transportStatus = pContext->transportInterface.connect(
+        pContext->transportInterface.pNetworkContext,
+        pContext->pTransportOption,
+        pContext->pServerInfo );
 
-static RTIOStatus_t handleDevicePingResp( RTIOContext_t* pContext, RTIOHeader_t* pHeader )
-{
-    rtioDeviceSendResp_t* pResp = NULL;
-    uint16_t index = 0;
-    RTIOStatus_t  status;
-
-    if( pContext == NULL || pHeader == NULL )
+    if( transportStatus != TransportSuccess )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, pHeader=%p.", (void*)pContext, (void*)pHeader ) );
-        return RTIOBadParameter;
+        LogError( ( "Transport connect error, transportStatus=%d.", transportStatus ) );
+        status = RTIOTransportFailed;
     }
 
-    status = recvMessageSafe( pContext, pContext->networkIncommingBuffer.pBuffer, pHeader->bodyLen );
-    if( status != RTIOSuccess )
-    {
-        LogError( ( "Failed to recv body, status=%d.", status ) );
-    }
-    else
+    if( RTIOSuccess == status )
     {
-        status = deviceSendRespList_Find( &( pContext->deviceSendRespList ), pHeader->id, &index );
+        verifyReq.header.version = RTIO_PROTOCAL_VERSION;
+        verifyReq.header.type = RTIO_TYPE_DEVICE_VERIFY_REQ;
+        verifyReq.header.id = getNextHeaderId( pContext );
+        verifyReq.pDeviceId = pContext->pDeviceInfo->pDeviceId;
+        verifyReq.pDeviceSecret = pContext->pDeviceInfo->pDeviceSecret;
+        verifyReq.header.bodyLen = pContext->pDeviceInfo->deviceIdLength + pContext->pDeviceInfo->deviceSecretLength + 2;
+        verifyReq.capLevel = RTIO_CAP_CURRENT_LEVEL;
+        status = RTIO_SerializeVerifyReq( &verifyReq, &pContext->networkOutgoingBuffer, &dataLen );
         if( status != RTIOSuccess )
         {
-            LogError( ( "Failed to deviceSendRespListFind, status=%d, hearderId=%u.", status, pHeader->id ) );
+            LogError( ( "Failed to serialize verify request." ) );
         }
         else
         {
-
-            status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), index, &pResp );
+            status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, dataLen );
             if( status != RTIOSuccess )
             {
-                LogError( ( "Failed to deviceSendRespListFind, status=%d.", status ) );
-            }
-            else
-            {
-                status = RTIO_DeSerializeDevicePingResp( pHeader,
-                                                         &( pContext->networkIncommingBuffer ),
-                                                         pResp );
-                if( status != RTIOSuccess )
-                {
-                    LogError( ( "Failed to DeSerializeDeviceSendResp, status=%d.", status ) );
-                }
-                else
-                {
-                    status = deviceSendRespList_Ready( &( pContext->deviceSendRespList ), index );
-                    if( status != RTIOSuccess )
-                    {
-                        LogError( ( "Failed to deviceSendRespListArrived, status=%d.", status ) );
-                    }
-                }
+                LogError( ( "Failed to send verify request, status=%d.", status ) );
             }
         }
     }
-    return status;
-}
-
-static RTIOStatus_t handleDeviceSendResp( RTIOContext_t* pContext, RTIOHeader_t* pHeader )
-{
-    rtioDeviceSendResp_t* pResp = NULL;
-    uint16_t index = 0;
-    RTIOStatus_t  status;
-
-    if( pContext == NULL || pHeader == NULL )
-    {
-        LogError( ( "Argument cannot be NULL: pContext=%p, pHeader=%p.", (void*)pContext, (void*)pHeader ) );
-        return RTIOBadParameter;
-    }
 
-    status = recvMessageSafe( pContext, pContext->networkIncommingBuffer.pBuffer, pHeader->bodyLen );
-    if( status != RTIOSuccess )
-    {
-        LogError( ( "Failed to recv body, status=%d.", status ) );
-    }
-    else
+    if( RTIOSuccess == status )
     {
-        status = deviceSendRespList_Find( &( pContext->deviceSendRespList ), pHeader->id, &index );
+        status = recvMessageSafe( pContext, pContext->networkIncommingBuffer.pBuffer, RTIO_PROTOCAL_HEADER_LEN );
         if( status != RTIOSuccess )
         {
-            LogError( ( "Failed to deviceSendRespListFind, status=%d.", status ) );
+            LogError( ( "Failed to recv verify response, status=%d.", status ) );
         }
         else
         {
-            status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), index, &pResp );
+            status = RTIO_DeserializeVerifyResp( &pContext->networkIncommingBuffer, &verifyResp );
             if( status != RTIOSuccess )
             {
-                LogError( ( "Failed to deviceSendRespListFind, status=%d.", status ) );
+                LogError( ( "Failed to deserial response, status=%d.", status ) );
             }
             else
             {
-                status = RTIO_DeSerializeDeviceSendResp( pHeader,
-                                                         &( pContext->networkIncommingBuffer ),
-                                                         pResp );
-                if( status != RTIOSuccess )
+                if( verifyResp.header.code == REMOTECODE_SUCCESS )
                 {
-                    LogError( ( "Failed to DeSerializeDeviceSendResp, status=%d.", status ) );
+                    LogInfo( ( "Device verification successful." ) );
+                    pContext->lastPacketRxTime = OS_ClockGetTimeMs();
+                    status = RTIOSuccess;
                 }
                 else
                 {
-                    status = deviceSendRespList_Ready( &( pContext->deviceSendRespList ), index );
-                    if( status != RTIOSuccess )
-                    {
-                        LogError( ( "Failed to deviceSendRespListArrived, status=%d.", status ) );
-                    }
+                    LogError( ( "Failed to verify device, code=%u.", verifyResp.header.code ) );
+                    status = RTIOVerifyFailedNeverRetry;
                 }
             }
         }
     }
-    return status;
-}
 
-static RTIOStatus_t handleCoPost( RTIOContext_t* pContext, RTIOHeader_t* pHeader )
-{
-    RTIOCoReq_t req = { 0 };
-    RTIOStatus_t  status = RTIO_DeSerializeCoReqNoCopy( pHeader->id,
-                                                        pContext->networkIncommingBuffer.pBuffer, 
-                                                        pHeader->bodyLen, &req );
-    if( status != RTIOSuccess )
-    {
-        LogError( ( "Failed to SerializeCoReq, status=%d.", status ) );
-    }
-    else
+    if( RTIOSuccess != status )
     {
-        status = handleCoPostRequest( pContext, &req );
+        pContext->transportInterface.disconnect( pContext->transportInterface.pNetworkContext );
     }
     return status;
 }
-static RTIOStatus_t handleObGet( RTIOContext_t* pContext, RTIOHeader_t* pHeader )
+/*-----------------------------------------------------------*/
+
+static OSEvent_t* deviceSendRespList_Event( const rtioDeviceSendRespList_t* pRespList, uint16_t index )
 {
-    RTIOObEstabReq_t req = { 0 };
-    RTIOStatus_t status = RTIO_DeSerializeObEstabReqNoCopy( pHeader->id,
-                                                            pContext->networkIncommingBuffer.pBuffer,
-                                                            pHeader->bodyLen, &req );
-    if( status != RTIOSuccess )
+    return (OSEvent_t*)( (uint8_t*)pRespList->pEvents + pRespList->eventSize * index );
+}
+
+/*
+ * The device-side headerId doubles as the key of deviceSendRespList:
+ *     headerId = generation * size + index + 1
+ * so the incomming thread finds the item in O(1), and the generation, bumped each time
+ * the item is reused, keeps a late response of a timed-out request away from a newer one.
+ * Generations wrap at UINT16_MAX / size, keeping headerId in [1, UINT16_MAX].
+ *
+ * With RTIO_USE_C11_ATOMICS the list takes no lock, each item has a state word
+ * headerId << 16 | RTIO_RESP_STATE_*, and whoever moves it by CAS owns the item:
+ *     FREE -> CLAIMED -> PENDING(_ASYNC)       deviceSendRespList_Add
+ *     PENDING(_ASYNC) -> FILLING               deviceSendRespList_Find, response or expiry
+ *     FILLING -> ARRIVED                       deviceSendRespList_Ready
+ *     PENDING(_ASYNC)/ARRIVED -> CLAIMED       deviceSendRespList_Delete, for the same headerId
+ *     CLAIMED/FILLING -> FREE                  deviceSendRespList_Release
+ * Leaving FILLING signals the item's event, deviceSendRespList_Delete waits on it meanwhile.
+ * Otherwise pRespList->pLock guards the items and the free list.
+ */
+#define RTIO_RESP_LIST_END ( UINT16_MAX )
+
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+#define RTIO_RESP_STATE_FREE          ( 0U )
+#define RTIO_RESP_STATE_CLAIMED       ( 1U )
+#define RTIO_RESP_STATE_PENDING       ( 2U )
+#define RTIO_RESP_STATE_PENDING_ASYNC ( 3U )
+#define RTIO_RESP_STATE_FILLING       ( 4U )
+#define RTIO_RESP_STATE_ARRIVED       ( 5U )
+#define RTIO_RESP_STATE( headerId, state ) ( ( (uint32_t)( headerId ) << 16 ) | ( state ) )
+#define RTIO_RESP_STATE_OF( word ) ( ( word ) & 0xFFFFU )
+#define RTIO_RESP_HEADER_ID_OF( word ) ( (uint16_t)( ( word ) >> 16 ) )
+#define RTIO_RESP_FILLING_WAIT_MS     ( 100U ) /* The state is checked again after each wait. */
+#endif
+
+static void deviceSendRespList_Lock( const rtioDeviceSendRespList_t* pRespList )
+{
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    (void)pRespList;
+#else
+    OS_MutexLock( pRespList->pLock );
+#endif
+}
+
+static void deviceSendRespList_Unlock( const rtioDeviceSendRespList_t* pRespList )
+{
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    (void)pRespList;
+#else
+    OS_MutexUnlock( pRespList->pLock );
+#endif
+}
+
+static void deviceSendRespList_Init( rtioDeviceSendRespList_t* pRespList )
+{
+    uint16_t i = 0;
+
+    for( i = 0; i < pRespList->size; i++ )
     {
-        LogError( ( "Failed to SerializeObReq, status=%d.", status ) );
+        memset( &( pRespList->pList[ i ] ), 0, sizeof( rtioDeviceSendResp_t ) );
+        pRespList->pList[ i ].nextFree = ( i + 1U < pRespList->size ) ? ( i + 1U ) : RTIO_RESP_LIST_END;
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+        OS_AtomicInit( &( pRespList->pList[ i ].state ), RTIO_RESP_STATE_FREE );
+#endif
     }
-    else
+    pRespList->freeHead = ( pRespList->size > 0U ) ? 0U : RTIO_RESP_LIST_END;
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    OS_AtomicInit( &( pRespList->nextHint ), 0U );
+#endif
+}
+
+static uint16_t deviceSendRespList_IndexOf( const rtioDeviceSendRespList_t* pRespList, uint16_t headerId )
+{
+    return (uint16_t)( ( headerId - 1U ) % pRespList->size );
+}
+
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+/* Claims a free item, starting from a rotating hint so concurrent claims rarely collide. */
+static uint16_t deviceSendRespList_Claim( rtioDeviceSendRespList_t* pRespList )
+{
+    uint32_t expected = 0;
+    uint16_t start = 0;
+    uint16_t index = 0;
+    uint16_t i = 0;
+
+    start = (uint16_t)( OS_AtomicFetchAdd( &( pRespList->nextHint ), 1U ) % pRespList->size );
+    for( i = 0; i < pRespList->size; i++ )
     {
-        status = handleObEstabRequest( pContext, &req );
+        index = (uint16_t)( ( start + i ) % pRespList->size );
+        expected = RTIO_RESP_STATE_FREE;
+        if( OS_AtomicCompareExchange( &( pRespList->pList[ index ].state ), &expected, RTIO_RESP_STATE_CLAIMED ) )
+        {
+            return index;
+        }
     }
-
-    return status;
+    return RTIO_RESP_LIST_END;
 }
-static RTIOStatus_t handleServerSendReqest( RTIOContext_t* pContext, RTIOHeader_t* pHeader )
+#endif
+
+static RTIOStatus_t deviceSendRespList_Add( rtioDeviceSendRespList_t* pRespList,
+                                            RTIOFixedBuffer_t* pRespBuffer,
+                                            uint16_t* pHeaderId,
+                                            uint16_t* pIndex )
 {
-    if( pContext == NULL || pHeader == NULL )
+    RTIOStatus_t status = RTIOSuccess;
+    rtioDeviceSendResp_t* pResp = NULL;
+    uint16_t generations = 0;
+
+    if( ( pRespList == NULL ) || ( pHeaderId == NULL ) || ( pIndex == NULL ) || ( pRespList->size == 0U ) )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, pHeader=%p.", (void*)pContext, (void*)pHeader ) );
+        LogError( ( "Argument cannot be NULL: pList=%p, pHeaderId=%p, pIndex=%p.",
+                    (void*)pRespList, (void*)pHeaderId, (void*)pIndex ) );
         return RTIOBadParameter;
     }
+    generations = (uint16_t)( UINT16_MAX / pRespList->size );
 
-    RTIOStatus_t  status = recvMessageSafe( pContext, pContext->networkIncommingBuffer.pBuffer, pHeader->bodyLen );
-    if( status != RTIOSuccess )
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    *pIndex = deviceSendRespList_Claim( pRespList );
+#else
+    OS_MutexLock( pRespList->pLock );
+    *pIndex = pRespList->freeHead;
+#endif
+    if( *pIndex == RTIO_RESP_LIST_END )
     {
-        LogError( ( "Failed to recv body, status=%d.", status ) );
+        status = RTIOListFull;
     }
     else
     {
-        RTIORestMethod_t method;
-        status = RTIO_DeSerializeRestMethod( pContext->networkIncommingBuffer.pBuffer, pHeader->bodyLen, &method );
-        if( status != RTIOSuccess )
-        {
-            LogError( ( "Failed to DeSerializeMethod, status=%d.", status ) );
-        }
-        else
-        {
-            switch( method )
-            {
-            case RTIO_REST_COPOST:
-                status = handleCoPost( pContext, pHeader );
-                break;
-            case RTIO_REST_OBGET:
-                status = handleObGet( pContext, pHeader );
-                break;
-            default:
-                break;
-            }
-        }
+        pResp = &( pRespList->pList[ *pIndex ] );
+#if ( RTIO_USE_C11_ATOMICS == 0 )
+        pRespList->freeHead = pResp->nextFree;
+#endif
+
+        pResp->generation = (uint16_t)( ( pResp->generation + 1U ) % generations );
+        pResp->headerId = (uint16_t)( pResp->generation * pRespList->size + *pIndex + 1U );
+        pResp->pFixedBuffer = pRespBuffer;
+        pResp->arrived = false;
+        pResp->code = 0;
+        pResp->respLength = 0;
+        pResp->nextFree = RTIO_RESP_LIST_END;
+        pResp->coPostCallback = NULL;
+        pResp->obNotifyCallback = NULL;
+        pResp->pUserData = NULL;
+        pResp->obId = 0;
+        pResp->autoTimeout = false;
+        pResp->held = false;
+        pResp->timestampMs = OS_ClockGetTimeMs();
+        *pHeaderId = pResp->headerId;
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+        OS_AtomicStore( &( pResp->state ), RTIO_RESP_STATE( pResp->headerId, RTIO_RESP_STATE_PENDING ) );
+#endif
+    }
+
+#if ( RTIO_USE_C11_ATOMICS == 0 )
+    OS_MutexUnlock( pRespList->pLock );
+#endif
+
+    if( status == RTIOSuccess )
+    {
+        LogDebug( ( "Add: headerId=%u, index=%u.", *pHeaderId, *pIndex ) );
     }
+
     return status;
 }
 
-static RTIOStatus_t incommingHeaderHandle( RTIOContext_t* pContext, RTIOHeader_t* pHeader )
+/* The caller holds pRespList->pLock, or owns the item in CLAIMED or FILLING state. */
+static void deviceSendRespList_Release( rtioDeviceSendRespList_t* pRespList, uint16_t index )
 {
-    RTIOStatus_t status = RTIOSuccess;
-    LogDebug( ( "Incomming Header: headerId=%u, type=%u, version=%u, bodyLen=%u, code=%u.",
-                pHeader->id, pHeader->type, pHeader->version, pHeader->bodyLen, pHeader->code ) );
+    rtioDeviceSendResp_t* pResp = &( pRespList->pList[ index ] );
 
-    switch( pHeader->type )
-    {
-    case RTIO_TYPE_DEVICE_PING_RESP:
-        status = handleDevicePingResp( pContext, pHeader );
-        break;
-    case RTIO_TYPE_DEVICE_SEND_RESP:
-        status = handleDeviceSendResp( pContext, pHeader );
-        break;
-    case RTIO_TYPE_SERVER_SEND_REQ:
-        status = handleServerSendReqest( pContext, pHeader );
-        break;
-    default:
-        LogError( ( "Incomming type error: type=%u.", pHeader->type ) );
-        status = RTIOBadParameter;
-        break;
+    if( pResp->headerId != 0 )
+    {
+        pResp->headerId = 0;
+        pResp->code = 0;
+        pResp->respLength = 0;
+        pResp->pFixedBuffer = NULL;
+        pResp->arrived = false;
+        pResp->timestampMs = 0;
+        pResp->coPostCallback = NULL;
+        pResp->obNotifyCallback = NULL;
+        pResp->pUserData = NULL;
+        pResp->autoTimeout = false;
+        pResp->held = false;
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+        OS_AtomicStore( &( pResp->state ), RTIO_RESP_STATE_FREE );
+#else
+        pResp->nextFree = pRespList->freeHead;
+        pRespList->freeHead = index;
+#endif
     }
-    return status;
 }
 
-static void incommingProccess( void* pContext )
+/* Frees the item of the request headerId, RTIONotFound when it completed already and the item */
+/* may belong to another request by now, e.g. an asynchronous one expired by its timer. */
+static RTIOStatus_t deviceSendRespList_Delete( rtioDeviceSendRespList_t* pRespList, uint16_t index, uint16_t headerId )
 {
-    RTIOStatus_t status = RTIOUnknown;
-    RTIOFixedBuffer_t* pRecvBuffer = NULL;
-    RTIOHeader_t header = { 0 };
-    OSError_t osRet = OSUnknown;
+    RTIOStatus_t status = RTIOSuccess;
 
-    LogInfo( ( "Incomming proccess started." ) );
+    if( ( pRespList == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
+        return RTIOBadParameter;
+    }
 
-    if( pContext == NULL )
+    if( index >= pRespList->size )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
-        return;
+        LogWarn( ( "Invalid index=%u, pRespList->size=%u, ignore.", index, pRespList->size) );
+        return RTIOSuccess;
     }
 
-    pRecvBuffer = &( ( (RTIOContext_t*)pContext )->networkIncommingBuffer );
-    while( false == ( (RTIOContext_t*)pContext )->serviceDone )
+#if ( RTIO_USE_C11_ATOMICS != 0 )
     {
-        status = recvMessageSafe( pContext, pRecvBuffer->pBuffer, RTIO_PROTOCAL_HEADER_LEN );
+        rtioDeviceSendResp_t* pResp = &( pRespList->pList[ index ] );
+        uint32_t word = OS_AtomicLoad( &( pResp->state ) );
+        bool released = false;
 
-        if( RTIOSuccess == status )
+        while( !released )
         {
-            status = RTIO_DeserializeHeader( pRecvBuffer, &header );
-            if( RTIOSuccess == status )
+            if( ( RTIO_RESP_HEADER_ID_OF( word ) != headerId ) ||
+                ( RTIO_RESP_STATE_OF( word ) == RTIO_RESP_STATE_FREE ) ||
+                ( RTIO_RESP_STATE_OF( word ) == RTIO_RESP_STATE_CLAIMED ) )
             {
-                status = incommingHeaderHandle( pContext, &header );
-                if( status != RTIOSuccess )
-                {
-                    LogError( ( "Header handle Failed, status=%d.", status ) );
-                }
+                /* Completed already, the item may belong to another request by now. */
+                status = RTIONotFound;
+                released = true;
             }
-            else
+            else if( RTIO_RESP_STATE_OF( word ) == RTIO_RESP_STATE_FILLING )
             {
-                LogError( ( "Failed to DeserializeHeader, status=%d.", status ) );
+                /* The incomming thread is copying the response, it signals the item's event once done. */
+                (void)OS_EventWait( deviceSendRespList_Event( pRespList, index ), RTIO_RESP_FILLING_WAIT_MS );
+                word = OS_AtomicLoad( &( pResp->state ) );
             }
-        }
-        else if( RTIOTimeout == status ||
-                 RTIONotFound == status /* Due to a timeout, headerid not found. */ )
-        {
-            continue;
-        }
-        else
-        {
-            /* MISRA else. */
-        }
-
-        if( RTIOSendFailed == status ||
-            RTIORecvFailed == status ||
-            RTIOTransportFailed == status ||
-            RTIOProtocalFailed == status )
-        {
-            LogError( ( "Session bad when read, status=%d, will reconnet later.", status ) );
-            connectStatus_ChangeWhenEventReconnect( pContext );
-            bool ok = false;
-            while( !( (RTIOContext_t*)pContext )->serviceDone && !ok )
+            else if( OS_AtomicCompareExchange( &( pResp->state ), &word,
+                                               RTIO_RESP_STATE( RTIO_RESP_HEADER_ID_OF( word ), RTIO_RESP_STATE_CLAIMED ) ) )
             {
-                ok = connectStatus_CheckStatus( pContext, RTIOConnected );
-                if( !ok )
-                {
-                    OS_ClockSleepMs( 200U );
-                }
+                deviceSendRespList_Release( pRespList, index );
+                released = true;
+            }
+            else
+            {
+                /* The CAS loaded the new word, try again. */
             }
         }
-        else
+    }
+#else
+    OS_MutexLock( pRespList->pLock );
+    if( ( headerId != 0 ) && ( pRespList->pList[ index ].headerId == headerId ) )
+    {
+        deviceSendRespList_Release( pRespList, index );
+    }
+    else
+    {
+        /* Completed already, the item may belong to another request by now. */
+        status = RTIONotFound;
+    }
+    OS_MutexUnlock( pRespList->pLock );
+#endif
+
+    return status;
+}
+
+static bool deviceSendRespList_Arrived( const rtioDeviceSendRespList_t* pRespList, uint16_t index )
+{
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    /* Acquire, so the response copied before ARRIVED is visible. */
+    return RTIO_RESP_STATE_OF( OS_AtomicLoad( &( pRespList->pList[ index ].state ) ) ) == RTIO_RESP_STATE_ARRIVED;
+#else
+    return pRespList->pList[ index ].arrived;
+#endif
+}
+
+static RTIOStatus_t deviceSendRespList_Wait( const rtioDeviceSendRespList_t* pRespList, uint16_t index, uint32_t timeoutMs )
+{
+    uint32_t elapsedMs = 0;
+    OSError_t osRet = OSUnknown;
+
+    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
+    {
+        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
+        return RTIOBadParameter;
+    }
+
+    // wait for resp arrived or timeout, no lock required:
+    // because every deviceSendRespListWait read a different index
+    // only incomming thread trigger the arrived flag, then signals the index's event.
+    // A signal left over by a former timed-out request only causes one more round.
+    while( !deviceSendRespList_Arrived( pRespList, index ) )
+    {
+        elapsedMs = calculateElapsedTime( OS_ClockGetTimeMs(), pRespList->pList[ index ].timestampMs );
+        if( elapsedMs >= timeoutMs )
         {
-            if( RTIOSuccess != status )
-            {
-                LogError( ( "Unrecoverable error, status=%d.", status ) );
-                break;
-            }
+            return RTIOTimeout; /* TODO: replace with RTIOWaitRespTimeout, #49 */
+        }
+        osRet = OS_EventWait( deviceSendRespList_Event( pRespList, index ), timeoutMs - elapsedMs );
+        if( ( osRet != OSSuccess ) && ( osRet != OSEventTimeout ) )
+        {
+            LogError( ( "Failed to wait event, index=%u, ret=%d.", index, osRet ) );
+            return RTIOUnknown;
         }
     }
+    return RTIOSuccess;
+}
 
-    LogInfo( ( "Incomming proccess stopped with status=%d.",  status) );
+/* The caller holds pRespList->pLock until it is done with the found item. */
+/* With RTIO_USE_C11_ATOMICS the found item is claimed instead, the caller ends the claim */
+/* with deviceSendRespList_Ready, deviceSendRespList_TakeAsync or deviceSendRespList_Unclaim. */
+static RTIOStatus_t deviceSendRespList_Find( const rtioDeviceSendRespList_t* pRespList, uint16_t headerId, uint16_t* pIndex )
+{
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    uint32_t word = 0;
+#endif
 
-    if ( ( status != RTIOSuccess ) && 
-         ( false == ( (RTIOContext_t*)pContext )->serviceDone )&&
-         ( (RTIOContext_t*)pContext )->serveFailedHandler != NULL )
+    if( ( pRespList == NULL ) || ( pIndex == NULL ) )
     {
-        ( (RTIOContext_t*)pContext )->serveFailedHandler();
+        LogError( ( "Argument cannot be NULL: pList=%p, pIndex=%p.", (void*)pRespList, (void*)pIndex ) );
+        return RTIOBadParameter;
     }
-    
-    osRet =  OS_ThreadDestroy( ( (RTIOContext_t*)pContext )->pThreadIncomming );
-    if( osRet != OSSuccess )
+
+    *pIndex = pRespList->size;
+    if( ( headerId == 0 ) || ( pRespList->size == 0 ) )
     {
-        LogError( ( "Failed to destroy pThreadIncomming, ret=%d.", osRet ) );
+        return RTIONotFound;
     }
-    // else
-    // {
-    //     ( (RTIOContext_t*)pContext )->pThreadIncomming = NULL;
-    // }
+
+    *pIndex = deviceSendRespList_IndexOf( pRespList, headerId );
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    word = OS_AtomicLoad( &( pRespList->pList[ *pIndex ].state ) );
+    if( ( RTIO_RESP_HEADER_ID_OF( word ) != headerId ) ||
+        ( ( RTIO_RESP_STATE_OF( word ) != RTIO_RESP_STATE_PENDING ) &&
+          ( RTIO_RESP_STATE_OF( word ) != RTIO_RESP_STATE_PENDING_ASYNC ) ) ||
+        !OS_AtomicCompareExchange( &( pRespList->pList[ *pIndex ].state ), &word,
+                                   RTIO_RESP_STATE( headerId, RTIO_RESP_STATE_FILLING ) ) )
+#else
+    if( ( pRespList->pList[ *pIndex ].headerId != headerId ) ||
+        ( pRespList->pList[ *pIndex ].arrived ) )
+#endif
+    {
+        *pIndex = pRespList->size;
+        return RTIONotFound;
+    }
+
+    return RTIOSuccess;
 }
 
-RTIOStatus_t ping( RTIOContext_t* pContext, uint32_t heartbeatMs, uint32_t timeoutMs )
+/* Gives back a synchronous item found by deviceSendRespList_Find without a response, */
+/* the waiter times out as before. */
+static void deviceSendRespList_Unclaim( const rtioDeviceSendRespList_t* pRespList, uint16_t index )
 {
-    static uint8_t pingSerializeBuffer[ RTIO_PING_SERIALIZE_BUFFER_SIZE ];
-    RTIOFixedBuffer_t serializeBuffer = { 0 };
-    RTIOStatus_t status = RTIOSuccess;
-    RTIOPingReq_t pingReq = { 0 };
-    uint16_t respIndex = UINT16_MAX;
-    uint16_t serianlizeLength = 0;
-    rtioDeviceSendResp_t* pDeviceSendResp = NULL;
-    RTIORemoteCode_t pingRespCode = REMOTECODE_UNKOWN_ERR;
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    OS_AtomicStore( &( pRespList->pList[ index ].state ),
+                    RTIO_RESP_STATE( pRespList->pList[ index ].headerId, RTIO_RESP_STATE_PENDING ) );
+    /* For deviceSendRespList_Delete waiting for the end of FILLING. */
+    (void)OS_EventSignal( deviceSendRespList_Event( pRespList, index ) );
+#else
+    (void)pRespList;
+    (void)index;
+#endif
+}
+static RTIOStatus_t deviceSendRespList_Ready( const rtioDeviceSendRespList_t* pRespList, uint16_t index )
+{
+    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
+    {
+        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
+        return RTIOBadParameter;
+    }
+    // no lock required:
+    // because every deviceSendRespListArrived trigger different arrived flag
+    rtioDeviceSendResp_t* pResp = &( pRespList->pList[ index ] );
+    pResp->arrived = true;
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    OS_AtomicStore( &( pResp->state ), RTIO_RESP_STATE( pResp->headerId, RTIO_RESP_STATE_ARRIVED ) );
+#endif
+    if( OS_EventSignal( deviceSendRespList_Event( pRespList, index ) ) != OSSuccess )
+    {
+        LogError( ( "Failed to signal event, index=%u.", index ) );
+    }
+    return RTIOSuccess;
+}
 
-    if( pContext == NULL )
+static RTIOStatus_t deviceSendRespList_GetResp( const rtioDeviceSendRespList_t* pRespList, uint16_t index, rtioDeviceSendResp_t** ppResp )
+{
+    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
-        status = RTIOBadParameter;
+        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
+        return RTIOBadParameter;
     }
+    *ppResp = &( pRespList->pList[ index ] );
+    return RTIOSuccess;
+}
 
-    LogDebug( ( "Ping started, heartbeatMs=%u, timeoutMs=%u.",
-                (unsigned)heartbeatMs, (unsigned)timeoutMs ) );
+/* Completion of an asynchronous request, taken out of its item under pRespList->pLock and invoked after unlocking. */
+typedef struct rtioAsyncCompletion
+{
+    RTIOCoPostCallback_t coPostCallback;
+    RTIOObNotifyCallback_t obNotifyCallback;
+    void* pUserData;
+    RTIOStatus_t status;
+    uint8_t* pRespData;
+    uint16_t respLength;
+    uint16_t obId;
+    bool backoff; /* Timed out with RTIO_TIMEOUT_AUTO, see rtt_TimedOut. */
+} rtioAsyncCompletion_t;
+
+/* The request times out by timer index of pTimerWheel, armed here, before the request is sent. */
+static RTIOStatus_t deviceSendRespList_SetAsync( rtioDeviceSendRespList_t* pRespList, rtioTimerWheel_t* pTimerWheel,
+                                                 uint16_t index, uint32_t timeoutMs,
+                                                 RTIOCoPostCallback_t coPostCallback,
+                                                 RTIOObNotifyCallback_t obNotifyCallback,
+                                                 void* pUserData, uint16_t obId )
+{
+    rtioDeviceSendResp_t* pResp = NULL;
 
-    serializeBuffer.pBuffer = pingSerializeBuffer;
-    serializeBuffer.size = RTIO_PING_SERIALIZE_BUFFER_SIZE;
+    if( ( pRespList == NULL ) || ( index >= pRespList->size ) )
+    {
+        LogError( ( "Argument cannot be NULL: pList=%p, index=%u.", (void*)pRespList, index ) );
+        return RTIOBadParameter;
+    }
 
-    /* Add ping request to deviceSendRespList. */
-    if( status == RTIOSuccess )
+    /* The request is not sent yet, so only the owner touches the item. */
+    deviceSendRespList_Lock( pRespList );
+    pResp = &( pRespList->pList[ index ] );
+    pResp->coPostCallback = coPostCallback;
+    pResp->obNotifyCallback = obNotifyCallback;
+    pResp->pUserData = pUserData;
+    pResp->obId = obId;
+    if( pResp->pFixedBuffer == NULL )
     {
-        if( heartbeatMs == 0
-            || heartbeatMs == RTIO_PING_INTERVAL_MS_DEFAULT )
-        {
-            pingReq.header.bodyLen = 0; /* Using default value. */
-            heartbeatMs = 0;
-        }
-        else
-        {
-            pingReq.header.bodyLen = 2;
-        }
+        pResp->inlineBuffer.pBuffer = pResp->inlineData;
+        pResp->inlineBuffer.size = RTIO_DEVICE_SEND_RESP_INLINE_SIZE;
+        pResp->pFixedBuffer = &( pResp->inlineBuffer );
+    }
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    /* Published after the callback, the timer wheel only expires PENDING_ASYNC items. */
+    OS_AtomicStore( &( pResp->state ), RTIO_RESP_STATE( pResp->headerId, RTIO_RESP_STATE_PENDING_ASYNC ) );
+#endif
+    deviceSendRespList_Unlock( pRespList );
 
-        pingReq.header.id = getNextHeaderId( pContext );
-        pingReq.header.type = RTIO_TYPE_DEVICE_PING_REQ;
-        pingReq.header.version = RTIO_PROTOCAL_VERSION;
-        pingReq.timeout = heartbeatMs / 1000;
+    timerWheel_Arm( pTimerWheel, index, pResp->headerId, pResp->timestampMs + timeoutMs );
+    return RTIOSuccess;
+}
 
-        status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
-                                         pingReq.header.id,
-                                         &serializeBuffer,
-                                         &respIndex );
-        if( status != RTIOSuccess )
-        {
-            LogError( ( "Failed to deviceSendRespList_Add, status=%d.", status ) );
-        }
-    }
+static bool deviceSendRespList_IsAsync( const rtioDeviceSendResp_t* pResp )
+{
+    return ( pResp->coPostCallback != NULL ) || ( pResp->obNotifyCallback != NULL );
+}
+
+/* The caller holds pRespList->pLock, the item is released and can be reused once unlocked. */
+static void deviceSendRespList_TakeAsync( rtioDeviceSendRespList_t* pRespList, uint16_t index,
+                                          RTIOStatus_t status, rtioAsyncCompletion_t* pCompletion )
+{
+    rtioDeviceSendResp_t* pResp = &( pRespList->pList[ index ] );
+    RTIOCoResp_t coResp = { 0 };
+    RTIOObNotifyResp_t notifyResp = { 0 };
 
-    OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
+    memset( pCompletion, 0, sizeof( rtioAsyncCompletion_t ) );
+    pCompletion->coPostCallback = pResp->coPostCallback;
+    pCompletion->obNotifyCallback = pResp->obNotifyCallback;
+    pCompletion->pUserData = pResp->pUserData;
+    pCompletion->obId = pResp->obId;
+    pCompletion->status = status;
+    pCompletion->backoff = ( status == RTIOTimeout ) && pResp->autoTimeout && !pResp->held;
 
-    /* Send ping request. */
-    if( status == RTIOSuccess )
+    if( ( status == RTIOSuccess ) && ( pResp->coPostCallback != NULL ) )
     {
-        status = RTIO_SerializePingReq( &pingReq, &serializeBuffer, &serianlizeLength );
+        status = RTIO_DeSerializeCoResp_FromDeviceSendResp( pResp, &coResp );
         if( status != RTIOSuccess )
         {
-            LogError( ( "Failed to SerializePingReq, status=%d.", status ) );
+            LogError( ( "Failed to RTIO_DeSerializeCoResp_FromDeviceSendResp, status=%d.", status ) );
+            pCompletion->status = status;
         }
         else
         {
-            status = sendMessageSafe( pContext, serializeBuffer.pBuffer, serianlizeLength );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to send ping request, status=%d.", status ) );
-            }
+            pCompletion->status = transRestStatus( coResp.code );
+            pCompletion->pRespData = coResp.pData;
+            pCompletion->respLength = coResp.dataLength;
         }
     }
-
-    OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
-
-    /* Wait for ping response. */
-    if( status == RTIOSuccess )
+    else if( status == RTIOSuccess )
     {
-        status = deviceSendRespList_Wait( &( pContext->deviceSendRespList ), respIndex, timeoutMs );
+        status = RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( pResp, &notifyResp );
         if( status != RTIOSuccess )
         {
-            LogError( ( "Failed to wait PingResp, status=%d, respIndex=%d.", status, respIndex ) );
+            LogError( ( "Failed to RTIO_DeSerializeObNotifyResp_FromDeviceSendResp, status=%d.", status ) );
+            pCompletion->status = status;
         }
         else
         {
-            status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), respIndex, &pDeviceSendResp );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to deviceSendRespList_GetResp, status=%d.", status ) );
-            }
-            else
-            {
-                pingRespCode = pDeviceSendResp->code;
-            }
+            pCompletion->status = transRestStatus( notifyResp.code );
         }
     }
-
-    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex ) != RTIOSuccess )
+    else
     {
-        LogError( ( "Failed to deviceSendRespListDelete." ) );
+        /* MISRA else. */
     }
 
-    /* Check ping response. */
-    if( status == RTIOSuccess )
+    deviceSendRespList_Release( pRespList, index );
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    /* For deviceSendRespList_Delete waiting for the end of FILLING. */
+    (void)OS_EventSignal( deviceSendRespList_Event( pRespList, index ) );
+#endif
+}
+
+static void asyncCompletion_Invoke( const rtioAsyncCompletion_t* pCompletion )
+{
+    if( pCompletion->coPostCallback != NULL )
     {
-        if( pingRespCode != REMOTECODE_SUCCESS )
-        {
-            LogError( ( "Failed to ping, pingRespCode=%u.", pingRespCode ) );
-        }
+        pCompletion->coPostCallback( pCompletion->pUserData, pCompletion->status,
+                                     pCompletion->pRespData, pCompletion->respLength );
+    }
+    else if( pCompletion->obNotifyCallback != NULL )
+    {
+        pCompletion->obNotifyCallback( pCompletion->pUserData, pCompletion->status, pCompletion->obId );
+    }
+    else
+    {
+        /* MISRA else. */
     }
-
-    return status;
 }
 
-/*-----------------------------------------------------------*/
 /**
- * @brief connect to server with backoff algorithm
+ * @brief Completes an asynchronous request without response, when its timer fires or it is dropped.
  *
- * @param[in] pContext context pointer with pContext->connectStatus, pContext->serviceDone.
- * @param[out] pContext context pointer with pContext->connectStatus.
- * @return RTIOSuccess, RTIOVerifyFailedNeverRetry, RTIOConnectFailedNeverRetry and others in RTIOStatus_t.
+ * @param[in] pRespList the device send response list.
+ * @param[in] index the item of the request.
+ * @param[in] headerId the request the timer was armed for, 0 for any, used when the service stops.
+ * @param[in] status passed to the callback, RTIOTimeout when the timer fired.
+ *
+ * @return true when a request made with RTIO_TIMEOUT_AUTO timed out, see rtt_TimedOut.
  */
-
-static RTIOStatus_t connectWithBackoffAlgorithm( RTIOContext_t* pContext )
+static bool deviceSendRespList_ExpireAsync( rtioDeviceSendRespList_t* pRespList, uint16_t index, uint16_t headerId,
+                                            RTIOStatus_t status )
 {
-    BackoffAlgorithmStatus_t retryStatus = BackoffAlgorithmSuccess;
-    BackoffAlgorithmContext_t backoffContext;
-    uint16_t nextRetryBackoff = 0, retryTimes = 0;
-    RTIOStatus_t status = RTIOSuccess;
+    rtioAsyncCompletion_t completion;
+    rtioDeviceSendResp_t* pResp = &( pRespList->pList[ index ] );
+    bool expired = false;
 
-    BackoffAlgorithm_InitializeParams( &backoffContext,
-                                       RTIO_RETRY_BACKOFF_BASE_MS,
-                                       RTIO_RETRY_MAX_BACKOFF_DELAY_MS,
-                                       RTIO_RETRY_MAX_ATTEMPTS );
-    do
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+    uint32_t word = OS_AtomicLoad( &( pResp->state ) );
+
+    if( ( RTIO_RESP_STATE_OF( word ) == RTIO_RESP_STATE_PENDING_ASYNC ) &&
+        ( ( headerId == 0 ) || ( RTIO_RESP_HEADER_ID_OF( word ) == headerId ) ) &&
+        OS_AtomicCompareExchange( &( pResp->state ), &word,
+                                  RTIO_RESP_STATE( RTIO_RESP_HEADER_ID_OF( word ), RTIO_RESP_STATE_FILLING ) ) )
     {
-        status = connectRTIOServer( pContext );
-        LogDebug( ( "Connect to Server retryTimes=%u, status=%d.", retryTimes, status ) );
+        LogWarn( ( "Asynchronous request failed, headerId=%u, status=%d.", pResp->headerId, status ) );
+        deviceSendRespList_TakeAsync( pRespList, index, status, &completion );
+        expired = true;
+    }
+#else
+    OS_MutexLock( pRespList->pLock );
+    /* A timer of a completed request finds the item free or reused, with another headerId. */
+    if( ( pResp->headerId != 0 ) &&
+        ( ( headerId == 0 ) || ( pResp->headerId == headerId ) ) &&
+        deviceSendRespList_IsAsync( pResp ) )
+    {
+        LogWarn( ( "Asynchronous request failed, headerId=%u, status=%d.", pResp->headerId, status ) );
+        deviceSendRespList_TakeAsync( pRespList, index, status, &completion );
+        expired = true;
+    }
+    OS_MutexUnlock( pRespList->pLock );
+#endif
 
-        if( RTIOTransportFailed == status || RTIORecvFailed== status )
-        {
-            retryStatus = BackoffAlgorithm_GetNextBackoff( &backoffContext, rand(), &nextRetryBackoff );
-            LogDebug( ( "Reconnect nextRetryBackoff=%u, retryStatus=%d.", nextRetryBackoff, retryStatus ) );
-            retryTimes++;
-            if( retryStatus == BackoffAlgorithmRetriesExhausted )
-            {
-                LogInfo( ( "Reconect stoped, retryTimes exceeded, retryStatus=%d.", BackoffAlgorithmRetriesExhausted ) );
-                status = RTIOConnectFailedNeverRetry;
-                break;
-            }
-            OS_ClockSleepMs( nextRetryBackoff );
-        }
-        else if( RTIOSuccess == status )
-        {
-            LogDebug( ( "Connect retryTimes=%u success.", retryTimes ) );
-            break;
-        }
-        else if( RTIOVerifyFailedNeverRetry == status )
-        {
-            LogError( ( "Connect VerifyFailed, please check deviceId or devieSecret, status=%u.", status ) );
-            break;
-        }
-        else /* Other error code */
-        {
-            LogError( ( "Connect Failed, status=%u.", status ) );
-            break;
-        }
-    } while( 1 );
+    if( expired )
+    {
+        asyncCompletion_Invoke( &completion );
+    }
+    return expired && completion.backoff;
+}
 
+/* Frees the item of an asynchronous request that failed to send, its timer may have fired while */
+/* the send blocked: the item is then taken and the callback reported it, the request succeeds. */
+static RTIOStatus_t deviceSendRespList_Unsent( RTIOContext_t* pContext, uint16_t index, uint16_t headerId,
+                                               RTIOStatus_t status )
+{
+    timerWheel_Cancel( &( pContext->timerWheel ), index, headerId );
+    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), index, headerId ) == RTIONotFound )
+    {
+        LogWarn( ( "Send failed after the request completed, headerId=%u, status=%d.", headerId, status ) );
+        return RTIOSuccess;
+    }
     return status;
 }
 
-static RTIOStatus_t reconnectWithBackoffAlgorithm( RTIOContext_t* pContext )
-{
-    BackoffAlgorithmStatus_t retryStatus = BackoffAlgorithmSuccess;
-    BackoffAlgorithmContext_t backoffContext;
-    uint16_t nextRetryBackoff = 0, retryTimes = 0;
-    RTIOStatus_t status = RTIOSuccess;
+/*-----------------------------------------------------------*/
 
+/*
+ * Round-trip time of the device requests, estimated as TCP does (RFC 6298): a response
+ * measures the time since its item was added, srtt and rttvar follow the samples with
+ * gains 1/8 and 1/4, and RTIO_TIMEOUT_AUTO stands for srtt + 4 * rttvar. A request held
+ * while reconnecting gives no sample, as a retransmitted segment does not (Karn). Each
+ * timeout of such a request doubles the timeout until the next sample.
+ */
 
-    status = pContext->transportInterface.disconnect( pContext->transportInterface.pNetworkContext );
-    LogInfo( ( "Disconnect old connection, status=%d.", status ) );
+static void rtt_Init( rtioRtt_t* pRtt )
+{
+    pRtt->srtt8 = 0;
+    pRtt->rttvar4 = 0;
+    pRtt->backoff = 0;
+    memset( &( pRtt->stats ), 0, sizeof( pRtt->stats ) );
+    pRtt->stats.rtoMs = RTIO_RTO_INITIAL_MS;
+}
 
+/* The caller holds pRtt->pLock. */
+static void rtt_UpdateRto( rtioRtt_t* pRtt )
+{
+    uint32_t rtoMs = RTIO_RTO_INITIAL_MS;
+    uint8_t i = 0;
 
-    BackoffAlgorithm_InitializeParams( &backoffContext,
-                                       RTIO_RETRY_BACKOFF_BASE_MS,
-                                       RTIO_RETRY_MAX_BACKOFF_DELAY_MS,
-                                       RTIO_RETRY_MAX_ATTEMPTS );
-    do
+    if( pRtt->stats.samples > 0U )
     {
-        status = connectRTIOServer( pContext );
-        LogDebug( ( "Connect retryTimes=%u, status=%d.", retryTimes, status ) );
+        /* The clock ticks in ms, the variance term is at least one tick. */
+        rtoMs = ( pRtt->srtt8 >> 3 ) + ( ( pRtt->rttvar4 > 1U ) ? pRtt->rttvar4 : 1U );
+    }
+    if( rtoMs < RTIO_RTO_MIN_MS )
+    {
+        rtoMs = RTIO_RTO_MIN_MS;
+    }
+    for( i = 0; ( i < pRtt->backoff ) && ( rtoMs < RTIO_RTO_MAX_MS ); i++ )
+    {
+        rtoMs *= 2U;
+    }
+    if( rtoMs > RTIO_RTO_MAX_MS )
+    {
+        rtoMs = RTIO_RTO_MAX_MS;
+    }
 
+    pRtt->stats.srttMs = pRtt->srtt8 >> 3;
+    pRtt->stats.rttvarMs = pRtt->rttvar4 >> 2;
+    pRtt->stats.rtoMs = rtoMs;
+}
 
-        if( RTIOTransportFailed == status  || RTIORecvFailed== status )
-        {
-            retryStatus = BackoffAlgorithm_GetNextBackoff( &backoffContext, rand(), &nextRetryBackoff );
-            LogDebug( ( "Reconnect nextRetryBackoff=%u, retryStatus=%d.", nextRetryBackoff, retryStatus ) );
-            retryTimes++;
-            if( retryStatus == BackoffAlgorithmRetriesExhausted )
-            {
-                LogInfo( ( "Reconect stoped, retryTimes exceeded, retryStatus=%d.", BackoffAlgorithmRetriesExhausted ) );
-                status = RTIOConnectFailedNeverRetry;
-                break;
-            }
-            else if( pContext->serviceDone )
-            {
-                LogInfo( ( "Reconect stoped, serviceDone=%d.", pContext->serviceDone ) );
-                status = RTIOConnectFailedNeverRetry;
-                break;
-            }
-            OS_ClockSleepMs( nextRetryBackoff );
-        }
-        else if( RTIOSuccess == status )
-        {
-            LogDebug( ( "Connect retryTimes=%u success.", retryTimes ) );
-            break;
-        }
-        else if( RTIOVerifyFailedNeverRetry == status )
-        {
-            LogError( ( "Connect VerifyFailed, please check deviceId or devieSecret, status=%u.", status ) );
-            break;
-        }
-        else /* other error code */
+static void rtt_Sample( rtioRtt_t* pRtt, uint32_t rttMs )
+{
+    int32_t errMs = 0;
+
+    if( rttMs > RTIO_RTO_MAX_MS )
+    {
+        rttMs = RTIO_RTO_MAX_MS;
+    }
+
+    OS_MutexLock( pRtt->pLock );
+    if( pRtt->stats.samples == 0U )
+    {
+        pRtt->srtt8 = rttMs << 3;
+        pRtt->rttvar4 = rttMs << 1;
+    }
+    else
+    {
+        errMs = (int32_t)rttMs - (int32_t)( pRtt->srtt8 >> 3 );
+        pRtt->srtt8 = (uint32_t)( (int32_t)pRtt->srtt8 + errMs );
+        if( errMs < 0 )
         {
-            LogError( ( "Connect Failed, status=%u.", status ) );
-            break;
+            errMs = -errMs;
         }
-    } while( 1 );
+        pRtt->rttvar4 = pRtt->rttvar4 - ( pRtt->rttvar4 >> 2 ) + (uint32_t)errMs;
+    }
+    pRtt->stats.samples++;
+    pRtt->backoff = 0;
+    rtt_UpdateRto( pRtt );
+    OS_MutexUnlock( pRtt->pLock );
+}
+
+static void rtt_Backoff( rtioRtt_t* pRtt )
+{
+    OS_MutexLock( pRtt->pLock );
+    pRtt->stats.timeouts++;
+    if( pRtt->stats.rtoMs < RTIO_RTO_MAX_MS )
+    {
+        pRtt->backoff++;
+    }
+    rtt_UpdateRto( pRtt );
+    LogWarn( ( "Request timed out, back off, rtoMs=%u.", (unsigned)pRtt->stats.rtoMs ) );
+    OS_MutexUnlock( pRtt->pLock );
+}
+
+/* Samples the response of the item before its request completes, the caller owns the item. */
+/* pRtt->pLock is taken last, under the lock of the list. */
+static void rtt_Measure( rtioRtt_t* pRtt, const rtioDeviceSendResp_t* pResp )
+{
+    if( !pResp->held )
+    {
+        rtt_Sample( pRtt, calculateElapsedTime( OS_ClockGetTimeMs(), pResp->timestampMs ) );
+    }
+}
+
+/* Resolves RTIO_TIMEOUT_AUTO for the request of the item, before the request is sent. */
+static uint32_t rtt_TimeoutMs( RTIOContext_t* pContext, uint16_t index, uint32_t timeoutMs )
+{
+    rtioDeviceSendResp_t* pResp = &( pContext->deviceSendRespList.pList[ index ] );
+
+    pResp->autoTimeout = ( timeoutMs == RTIO_TIMEOUT_AUTO );
+    if( pResp->autoTimeout )
+    {
+        OS_MutexLock( pContext->rtt.pLock );
+        timeoutMs = pContext->rtt.stats.rtoMs;
+        OS_MutexUnlock( pContext->rtt.pLock );
+    }
+    return timeoutMs;
+}
+
+/* The request of the item timed out, called before the item is deleted. */
+static void rtt_TimedOut( RTIOContext_t* pContext, uint16_t index )
+{
+    const rtioDeviceSendResp_t* pResp = &( pContext->deviceSendRespList.pList[ index ] );
+
+    if( pResp->autoTimeout && !pResp->held )
+    {
+        rtt_Backoff( &( pContext->rtt ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* The offline queue holds the device requests made while reconnecting, in the order they are made. */
+/* Requests made while held ones wait are held too, so none overtakes them. */
+
+static void offlineQueue_Init( rtioOfflineQueue_t* pQueue )
+{
+    pQueue->head = 0;
+    pQueue->count = 0;
+    memset( &( pQueue->stats ), 0, sizeof( pQueue->stats ) );
+}
+
+/* The caller holds pQueue->pLock. */
+static void offlineQueue_PopHead( rtioOfflineQueue_t* pQueue )
+{
+    pQueue->head = (uint16_t)( ( pQueue->head + 1U ) % pQueue->size );
+    pQueue->count--;
+}
+
+/* Drops the requests at the head whose caller gave up, the caller holds pQueue->pLock. */
+static void offlineQueue_PruneExpired( rtioOfflineQueue_t* pQueue, uint32_t nowMs )
+{
+    while( ( pQueue->count > 0U ) && !timerWheel_Before( nowMs, pQueue->pItems[ pQueue->head ].deadlineMs ) )
+    {
+        LogWarn( ( "Offline request expired, headerId=%u.", pQueue->pItems[ pQueue->head ].headerId ) );
+        pQueue->stats.expired++;
+        offlineQueue_PopHead( pQueue );
+    }
+}
+
+/**
+ * @brief Gets a frame for a device request, like outgoingFrame_Begin, must be followed by requestFrame_End.
+ *
+ * While reconnecting the frame is an item of the offline queue, whose lock is held until
+ * requestFrame_End. It is replayed after the reconnect unless timeoutMs, counted from when
+ * the response item was added, passed first.
+ *
+ * @return RTIOListFull when the offline queue is full and refuses new requests.
+ */
+static RTIOStatus_t requestFrame_Begin( RTIOContext_t* pContext, rtioOutgoingFrame_t* pFrame, rtioSendLane_t lane,
+                                        uint16_t headerId, uint32_t timeoutMs )
+{
+    rtioOfflineQueue_t* pQueue = &( pContext->offlineQueue );
+    rtioOfflineItem_t* pItem = NULL;
+    rtioDeviceSendResp_t* pResp = NULL;
+    RTIOConnectStatus_t connectStatus = RTIOConnectInit;
+    uint16_t index = 0;
+
+    if( pQueue->size == 0U )
+    {
+        return outgoingFrame_Begin( pContext, pFrame, lane );
+    }
+
+    OS_MutexLock( pQueue->pLock );
+    connectStatus = connectStatus_GetStatus( pContext );
+    if( ( connectStatus != RTIOConnecting ) &&
+        ( ( connectStatus != RTIOConnected ) || ( pQueue->count == 0U ) ) )
+    {
+        OS_MutexUnlock( pQueue->pLock );
+        return outgoingFrame_Begin( pContext, pFrame, lane );
+    }
+
+    offlineQueue_PruneExpired( pQueue, OS_ClockGetTimeMs() );
+    if( pQueue->count == pQueue->size )
+    {
+        pQueue->stats.dropped++;
+#if ( RTIO_OFFLINE_QUEUE_DROP_OLDEST != 0 )
+        pFrame->evictedHeaderId = pQueue->pItems[ pQueue->head ].headerId;
+        LogWarn( ( "Offline queue full, drop the oldest request, headerId=%u.", pFrame->evictedHeaderId ) );
+        offlineQueue_PopHead( pQueue );
+#else
+        OS_MutexUnlock( pQueue->pLock );
+        LogWarn( ( "Offline queue full, refuse the request, headerId=%u.", headerId ) );
+        return RTIOListFull;
+#endif
+    }
+
+    pResp = &( pContext->deviceSendRespList.pList[ deviceSendRespList_IndexOf( &( pContext->deviceSendRespList ), headerId ) ] );
+    pResp->held = true;
+    index = (uint16_t)( ( pQueue->head + pQueue->count ) % pQueue->size );
+    pItem = &( pQueue->pItems[ index ] );
+    pItem->length = 0;
+    pItem->headerId = headerId;
+    pItem->deadlineMs = pResp->timestampMs + timeoutMs;
+    pItem->lane = (uint8_t)lane;
+    pFrame->buffer.pBuffer = pItem->buffer;
+    pFrame->buffer.size = RTIO_TRANSFER_FRAME_BUF_SIZE;
+    pFrame->index = index;
+    pFrame->lane = lane;
+    pFrame->offline = true;
+    return RTIOSuccess;
+}
+
+/* Sends or queues the frame like outgoingFrame_End, or holds it in the offline queue. */
+/* A held request must fit in a frame, as a queued one does. */
+static RTIOStatus_t requestFrame_End( RTIOContext_t* pContext, rtioOutgoingFrame_t* pFrame, uint16_t length,
+                                      const uint8_t* pPayload, uint16_t payloadLength )
+{
+    rtioOfflineQueue_t* pQueue = &( pContext->offlineQueue );
+    RTIOStatus_t status = RTIOSuccess;
 
+    if( !pFrame->offline )
+    {
+        return outgoingFrame_End( pContext, pFrame, length, pPayload, payloadLength );
+    }
+
+    if( length > 0U )
+    {
+        status = outgoingFrame_CopyPayload( pFrame, &length, pPayload, payloadLength );
+    }
+    if( ( status == RTIOSuccess ) && ( length > 0U ) )
+    {
+        pQueue->pItems[ pFrame->index ].length = length;
+        pQueue->count++;
+        pQueue->stats.queued++;
+        LogInfo( ( "Reconnecting, hold request, headerId=%u, held=%u.",
+                   pQueue->pItems[ pFrame->index ].headerId, pQueue->count ) );
+    }
+    OS_MutexUnlock( pQueue->pLock );
+
+    /* A dropped asynchronous request completes now, a synchronous one times out. */
+    if( pFrame->evictedHeaderId != 0U )
+    {
+        (void)deviceSendRespList_ExpireAsync( &( pContext->deviceSendRespList ),
+                                              deviceSendRespList_IndexOf( &( pContext->deviceSendRespList ), pFrame->evictedHeaderId ),
+                                              pFrame->evictedHeaderId, RTIOListFull );
+    }
     return status;
 }
 
-static void keepAliveProccess( void* pContext )
+/* Replays the requests held while reconnecting, right after the reconnect. */
+/* When a send fails the session is reconnected again, the rest stays held until then. */
+/* pQueue->pLock is not held while sending, the head is popped after it is sent so requests */
+/* made meanwhile are still held behind it. */
+static void offlineQueue_Replay( RTIOContext_t* pContext )
 {
-    RTIOContext_t* pRTIOContext = (RTIOContext_t*)pContext;
+    rtioOfflineQueue_t* pQueue = &( pContext->offlineQueue );
+    rtioOfflineItem_t* pItem = NULL;
+    rtioOutgoingFrame_t frame = { 0 };
     RTIOStatus_t status = RTIOSuccess;
-    uint32_t currentTimeMs = 0, elapsedTimeMs = 0;
-    RTIOConnectStatus_t currentStatus = RTIOConnectInit;
-    OSError_t osRet = OSUnknown;
+    uint16_t headerId = 0;
+    uint16_t length = 0;
+    bool held = true;
 
-    if( pContext == NULL )
+    if( pQueue->size == 0U )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
         return;
     }
-    LogInfo( ( "Keep alive proccess started, heartbeatMs=%u.", (unsigned)pRTIOContext->heartbeatMs ) );
-    
-    while( ( (RTIOContext_t*)pContext )->serviceDone == false )
+
+    while( held && ( status == RTIOSuccess ) )
     {
-        currentStatus = connectStatus_GetStatus( pContext );
+        OS_MutexLock( pQueue->pLock );
+        offlineQueue_PruneExpired( pQueue, OS_ClockGetTimeMs() );
+        held = ( pQueue->count > 0U );
+        if( held )
+        {
+            headerId = pQueue->pItems[ pQueue->head ].headerId;
+            frame.lane = (rtioSendLane_t)pQueue->pItems[ pQueue->head ].lane;
+        }
+        OS_MutexUnlock( pQueue->pLock );
+        if( !held )
+        {
+            break;
+        }
 
-        if( RTIOConnected == currentStatus )
+        status = outgoingFrame_Begin( pContext, &frame, frame.lane );
+        if( status != RTIOSuccess )
         {
-            currentTimeMs = OS_ClockGetTimeMs();
-            elapsedTimeMs = calculateElapsedTime( currentTimeMs, pRTIOContext->lastPacketTxTime );
-            // LogDebug( ( "Check: current=%u, last=%u, elapsed=%u, heartbeat=%u.",
-            //             (unsigned)currentTimeMs, (unsigned)pRTIOContext->lastPacketTxTime, 
-            //             (unsigned)elapsedTimeMs, (unsigned)pRTIOContext->heartbeatMs ) );
-            if( elapsedTimeMs >= pRTIOContext->heartbeatMs )
-            {
-                status = ping( pContext, pRTIOContext->heartbeatMs, RTIO_PING_TIMEOUT_MS );
-            }
-            
-            if( status == RTIOSuccess )
-            {
-                /* Check interval When Ping Success: 1900ms + (base)100ms = 2 Second. */
-                OS_ClockSleepMs( 1900U ); 
-            }
-            else
-            {
-                LogError( ( "Failed to ping, status=%d.", status ) );
-                if (RTIOSendFailed == status ||
-                    RTIORecvFailed == status ||
-                    RTIOTransportFailed == status ||
-                    RTIOProtocalFailed == status ||
-                    RTIOTimeout == status)
-                {
-                    LogError( ( "Session bad when ping, status=%d, will reconnet later.", status ) );
-                    connectStatus_ChangeWhenEventReconnect(pContext);
-                }
-            }
+            break;
         }
-        else if( RTIOConnecting == currentStatus )
+
+        /* The head may be dropped while the frame is got, only a request still held is sent. */
+        length = 0;
+        OS_MutexLock( pQueue->pLock );
+        pItem = &( pQueue->pItems[ pQueue->head ] );
+        if( ( pQueue->count > 0U ) && ( pItem->headerId == headerId ) )
         {
-            status = reconnectWithBackoffAlgorithm( pContext );
-            if( RTIOSuccess == status )
-            {
-                connectStatus_ChangeWhenEventConnectSuccess( pContext );
-            }
-            else
-            {
-                LogError( ( "Reconnect stoped, status=%d.", status ) );
-                connectStatus_ChangeWhenEventDisconnect( pContext );
-                break;
-            }
+            /* Frames are as large as the items, see rtioInit. */
+            length = pItem->length;
+            memcpy( frame.buffer.pBuffer, pItem->buffer, length );
         }
-        else
+        OS_MutexUnlock( pQueue->pLock );
+
+        status = outgoingFrame_End( pContext, &frame, length, NULL, 0 );
+        if( ( status == RTIOSuccess ) && ( length > 0U ) )
         {
-            /* MISRA else. */
+            OS_MutexLock( pQueue->pLock );
+            if( ( pQueue->count > 0U ) && ( pQueue->pItems[ pQueue->head ].headerId == headerId ) )
+            {
+                pQueue->stats.replayed++;
+                offlineQueue_PopHead( pQueue );
+            }
+            OS_MutexUnlock( pQueue->pLock );
         }
-        /* Base interval: 100ms. */
-        OS_ClockSleepMs( 100U ); 
     }
 
+    OS_MutexLock( pQueue->pLock );
+    LogInfo( ( "Replayed offline requests, replayed=%u, held=%u.", (unsigned)pQueue->stats.replayed, pQueue->count ) );
+    OS_MutexUnlock( pQueue->pLock );
 
-    LogInfo( ( "KeepAlive proccess stopped with status=%d.", status ) );
-    if ( status != RTIOSuccess && 
-         ( (RTIOContext_t*)pContext )->serveFailedHandler != NULL )
+    if( status != RTIOSuccess )
     {
-        ( (RTIOContext_t*)pContext )->serveFailedHandler();
+        LogError( ( "Session bad when replay, status=%d, will reconnet later.", status ) );
+        connectStatus_ChangeWhenEventReconnect( pContext );
     }
+}
 
-    osRet =  OS_ThreadDestroy( ( (RTIOContext_t*)pContext )->pThreadKeepAlive );
-    if( osRet != OSSuccess )
+static RTIOStatus_t sendCoResp( RTIOContext_t* pContext, const RTIOCoResp_t* pResp )
+{
+    RTIOStatus_t status = RTIOUnknown;
+    uint16_t serianlizeLength = 0;
+    rtioOutgoingFrame_t frame = { 0 };
+
+    status = outgoingFrame_Begin( pContext, &frame, RTIO_SEND_LANE_RESPONSE );
+    if( status != RTIOSuccess )
     {
-        LogError( ( "Failed to destroy pThreadKeepAlive, ret=%d.", osRet ) );
+        LogError( ( "Failed to get outgoing frame, status=%d.", status ) );
+        return status;
     }
-    // else
-    // {
-    //     ( (RTIOContext_t*)pContext )->pThreadKeepAlive = NULL;
-    // }
-   
+
+    status = RTIO_SerializeCoRespHeader_OverServerSendResp( pResp, &( frame.buffer ), &serianlizeLength );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to SerializeCoResp, status=%d.", status ) );
+        (void)outgoingFrame_End( pContext, &frame, 0, NULL, 0 );
+    }
+    else
+    {
+        status = outgoingFrame_End( pContext, &frame, serianlizeLength, pResp->pData, pResp->dataLength );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to send CoResp, status=%d.", status ) );
+        }
+    }
+
+    return status;
 }
 
+static RTIOStatus_t sendObEstabResp( RTIOContext_t* pContext, const RTIOObEstabResp_t* pResp )
+{
+    RTIOStatus_t status = RTIOUnknown;
+    uint16_t serianlizeLength = 0;
+    rtioOutgoingFrame_t frame = { 0 };
 
-/*-----------------------------------------------------------*/
+    status = outgoingFrame_Begin( pContext, &frame, RTIO_SEND_LANE_RESPONSE );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to get outgoing frame, status=%d.", status ) );
+        return status;
+    }
 
-RTIOStatus_t rtioInit( RTIOContext_t* pContext,
-                       const RTIOContextFixedResource_t* pFixedResource,
-                       const TransportInterface_t* pTransportInterface,
-                       const TransportOption_t* pTransportOption,
-                       const ServerInfo_t* pServerInfo,
-                       const RTIODeviceInfo_t* pDeviceInfo )
+    status = RTIO_SerializeObEstabResp_OverServerSendResp( pResp, &( frame.buffer ), &serianlizeLength );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to SerializeObResp, status=%d.", status ) );
+        (void)outgoingFrame_End( pContext, &frame, 0, NULL, 0 );
+    }
+    else
+    {
+        status = outgoingFrame_End( pContext, &frame, serianlizeLength, NULL, 0 );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to send ObResp, status=%d.", status ) );
+        }
+    }
+    return status;
+}
+
+/* The URI lists are open addressing tables keyed by the digest, probing linearly from uri % size. */
+/* Entries are never removed, so a free entry (uri 0) ends the probe. */
+/* Returns the entry of uri, or the free entry it goes to, or NULL when neither is found. */
+static RTIOCoPostUri_t* coPostUriList_Probe( const RTIOCoPostUriList_t* pUriList, uint32_t uri )
 {
-    /* check pContext */
-    if( pContext == NULL )
+    RTIOCoPostUri_t* pEntry = NULL;
+    uint16_t start = 0;
+    uint16_t i = 0;
+
+    if( pUriList->size == 0 )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
-        return RTIOBadParameter;
+        return NULL;
     }
-    /* check pFixedResource  */
-    if( pFixedResource == NULL )
+    start = (uint16_t)( uri % pUriList->size );
+    for( i = 0; i < pUriList->size; i++ )
     {
-        LogError( ( "Argument cannot be NULL: pFixedResource=%p.", (void*)pFixedResource ) );
-        return RTIOBadParameter;
+        pEntry = &( pUriList->pList[ ( start + i ) % pUriList->size ] );
+        if( ( pEntry->uri == uri ) || ( pEntry->uri == 0 ) )
+        {
+            return pEntry;
+        }
     }
+    return NULL;
+}
 
-    if( pFixedResource->networkIncommingBuffer.pBuffer == NULL )
+static RTIOObGetUri_t* obGetUriList_Probe( const RTIOObGetUriList_t* pUriList, uint32_t uri )
+{
+    RTIOObGetUri_t* pEntry = NULL;
+    uint16_t start = 0;
+    uint16_t i = 0;
+
+    if( pUriList->size == 0 )
     {
-        LogError( ( "Argument cannot be NULL: networkIncommingBuffer=%p.", (void*)pFixedResource->networkIncommingBuffer.pBuffer ) );
-        return RTIOBadParameter;
+        return NULL;
     }
-    if( pFixedResource->networkOutgoingBuffer.pBuffer == NULL )
+    start = (uint16_t)( uri % pUriList->size );
+    for( i = 0; i < pUriList->size; i++ )
     {
-        LogError( ( "Argument cannot be NULL: networkOutgoingBuffer=%p.", (void*)pFixedResource->networkOutgoingBuffer.pBuffer ) );
-        return RTIOBadParameter;
+        pEntry = &( pUriList->pList[ ( start + i ) % pUriList->size ] );
+        if( ( pEntry->uri == uri ) || ( pEntry->uri == 0 ) )
+        {
+            return pEntry;
+        }
     }
-    if( pFixedResource->serverSendRespBuffer.pBuffer == NULL )
+    return NULL;
+}
+
+static RTIOStatus_t handleCoPostRequest( RTIOContext_t* pContext, RTIOCoReq_t* pReq, RTIOFixedBuffer_t* pRespBuffer )
+{
+    RTIOStatus_t status = RTIOUnknown;
+    RTIOCoResp_t resp = { 0 };
+
+    if( pReq == NULL )
     {
-        LogError( ( "Argument cannot be NULL: serverSendRespBuffer=%p.", (void*)pFixedResource->serverSendRespBuffer.pBuffer ) );
+        LogError( ( "Argument cannot be NULL: pReq=%p.", (void*)pReq ) );
         return RTIOBadParameter;
     }
 
-    if( pFixedResource->pThreadIncomming == NULL )
+    RTIOCoPostHandler_t handler = { 0 };
+    RTIOCoPostUri_t* pEntry = coPostUriList_Probe( &( pContext->coPostInfoList ), pReq->uri );
+    if( ( pEntry != NULL ) && ( pEntry->uri == pReq->uri ) )
     {
-        LogError( ( "Argument cannot be NULL: pThreadIncomming=%p.", (void*)pFixedResource->pThreadIncomming ) );
-        return RTIOBadParameter;
+        handler = pEntry->handler;
     }
 
-    if( pFixedResource->pThreadKeepAlive == NULL )
+    resp.headerId = pReq->headerId;
+    resp.method = pReq->method;
+
+    if( ( pEntry == NULL ) || ( pEntry->uri != pReq->uri ) )
     {
-        LogError( ( "Argument cannot be NULL: pThreadKeepAlive=%p.", (void*)pFixedResource->pThreadKeepAlive ) );
-        return RTIOBadParameter;
+        LogWarn( ( "Handler not found, uri=%u.", (unsigned)pReq->uri ) );
+        resp.code = RTIO_REST_STATUS_NOT_FOUNT;
     }
-    if( pFixedResource->pRollingHeaderIdLock == NULL )
+    else
+    {
+        if( NULL != handler )
+        {
+            status = handler( pReq->pData, pReq->dataLength,
+                              pRespBuffer, &resp.dataLength );
+            if( status != RTIOSuccess )
+            {
+                LogError( ( "Failed to handler, status=%d.", status ) );
+                resp.code = RTIO_REST_STATUS_INTERNAL_SERVER_ERROR;
+                resp.dataLength = 0;
+            }
+            else
+            {
+                resp.pData = pRespBuffer->pBuffer;
+                resp.code = RTIO_REST_STATUS_OK;
+            }
+        }
+        else
+        {
+            LogError( ( "Handler is NULL, uri=%u handler=%p.", (unsigned)pReq->uri, (void*)handler ) );
+            resp.code = RTIO_REST_STATUS_NOT_FOUNT;
+        }
+    }
+
+    return sendCoResp( pContext, &resp );
+}
+
+static RTIOStatus_t handleObEstabRequest( RTIOContext_t* pContext, RTIOObEstabReq_t* pReq )
+{
+    RTIOStatus_t status = RTIOUnknown;
+    RTIOObEstabResp_t resp = { 0 };
+
+    if( pReq == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pReq=%p.", (void*)pReq ) );
+        return RTIOBadParameter;
+    }
+
+    RTIOObGetHandler_t handler = { 0 };
+    RTIOObGetUri_t* pEntry = obGetUriList_Probe( &( pContext->obGetInfoList ), pReq->uri );
+    if( ( pEntry != NULL ) && ( pEntry->uri == pReq->uri ) )
+    {
+        handler = pEntry->handler;
+    }
+
+    resp.headerId = pReq->headerId;
+    resp.method = pReq->method;
+    resp.obId = pReq->obId;
+
+    if( ( pEntry == NULL ) || ( pEntry->uri != pReq->uri ) )
+    {
+        LogError( ( "Handler not found, uri=%u.", (unsigned)pReq->uri ) );
+        resp.code = RTIO_REST_STATUS_NOT_FOUNT;
+    }
+    else
+    {
+        if( NULL != handler )
+        {
+            status = handler( pReq->pData, pReq->dataLength, pReq->obId );
+            if( status != RTIOSuccess )
+            {
+                if( status == RTIOListFull )
+                {
+                    LogWarn( ( "This uri too many observers, uri=%u , status=%u.", (unsigned)pReq->uri, (unsigned)status ) );
+                    resp.code = RTIO_REST_STATUS_TOO_MANY_OBSERVERS;
+                }
+                else
+                {
+                    LogError( ( "Failed to handler, status=%d.", status ) );
+                    resp.code = RTIO_REST_STATUS_INTERNAL_SERVER_ERROR;
+                }
+            }
+            else
+            {
+                resp.code = RTIO_REST_STATUS_CONTINUE;
+            }
+        }
+        else
+        {
+            LogError( ( "Handler is NULL, uri=%u handler=%p.", (unsigned)pReq->uri, (void*)handler ) );
+            resp.code = RTIO_REST_STATUS_NOT_FOUNT;
+        }
+    }
+
+    return sendObEstabResp( pContext, &resp );
+}
+
+
+static RTIOStatus_t handleDevicePingResp( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    rtioDeviceSendResp_t* pResp = NULL;
+    uint16_t index = 0;
+    RTIOStatus_t  status;
+
+    if( pContext == NULL || pHeader == NULL || pBody == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pHeader=%p, pBody=%p.", (void*)pContext, (void*)pHeader, (void*)pBody ) );
+        return RTIOBadParameter;
+    }
+
+    /* Hold the list until the response is copied, so the waiter can not time out and reuse it meanwhile. */
+    deviceSendRespList_Lock( &( pContext->deviceSendRespList ) );
+    status = deviceSendRespList_Find( &( pContext->deviceSendRespList ), pHeader->id, &index );
+    if( status != RTIOSuccess )
+    {
+        LogWarn( ( "Drop ping response, request timed out or unknown, hearderId=%u.", pHeader->id ) );
+        status = RTIOSuccess;
+    }
+    else
+    {
+        status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), index, &pResp );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to deviceSendRespListFind, status=%d.", status ) );
+        }
+        else
+        {
+            rtt_Measure( &( pContext->rtt ), pResp );
+            status = RTIO_DeSerializeDevicePingResp( pHeader, pBody, pResp );
+            if( status != RTIOSuccess )
+            {
+                LogError( ( "Failed to DeSerializeDeviceSendResp, status=%d.", status ) );
+                deviceSendRespList_Unclaim( &( pContext->deviceSendRespList ), index );
+            }
+            else
+            {
+                status = deviceSendRespList_Ready( &( pContext->deviceSendRespList ), index );
+                if( status != RTIOSuccess )
+                {
+                    LogError( ( "Failed to deviceSendRespListArrived, status=%d.", status ) );
+                }
+            }
+        }
+    }
+    deviceSendRespList_Unlock( &( pContext->deviceSendRespList ) );
+
+    /* The ping is collected by the timer runner. */
+    timerWheel_Wake( &( pContext->timerWheel ) );
+    return status;
+}
+
+static RTIOStatus_t handleDeviceSendResp( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    rtioDeviceSendResp_t* pResp = NULL;
+    uint16_t index = 0;
+    RTIOStatus_t  status;
+    rtioAsyncCompletion_t completion;
+    bool completed = false;
+
+    if( pContext == NULL || pHeader == NULL || pBody == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pHeader=%p, pBody=%p.", (void*)pContext, (void*)pHeader, (void*)pBody ) );
+        return RTIOBadParameter;
+    }
+
+    /* Hold the list until the response is copied, so the waiter can not time out and reuse it meanwhile. */
+    deviceSendRespList_Lock( &( pContext->deviceSendRespList ) );
+    status = deviceSendRespList_Find( &( pContext->deviceSendRespList ), pHeader->id, &index );
+    if( status != RTIOSuccess )
+    {
+        LogWarn( ( "Drop response, request timed out or unknown, hearderId=%u.", pHeader->id ) );
+        status = RTIOSuccess;
+    }
+    else
+    {
+        status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), index, &pResp );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to deviceSendRespListFind, status=%d.", status ) );
+        }
+        else
+        {
+            rtt_Measure( &( pContext->rtt ), pResp );
+            status = RTIO_DeSerializeDeviceSendResp( pHeader, pBody, pResp );
+            if( deviceSendRespList_IsAsync( pResp ) )
+            {
+                deviceSendRespList_TakeAsync( &( pContext->deviceSendRespList ), index, status, &completion );
+                completed = true;
+            }
+
+            if( status != RTIOSuccess )
+            {
+                /* The session is still fine, the request fails or times out. */
+                LogError( ( "Failed to DeSerializeDeviceSendResp, status=%d, hearderId=%u.", status, pHeader->id ) );
+                status = RTIOSuccess;
+                if( !completed )
+                {
+                    deviceSendRespList_Unclaim( &( pContext->deviceSendRespList ), index );
+                }
+            }
+            else if( !completed )
+            {
+                status = deviceSendRespList_Ready( &( pContext->deviceSendRespList ), index );
+                if( status != RTIOSuccess )
+                {
+                    LogError( ( "Failed to deviceSendRespListArrived, status=%d.", status ) );
+                }
+            }
+            else
+            {
+                /* MISRA else. */
+            }
+        }
+    }
+    deviceSendRespList_Unlock( &( pContext->deviceSendRespList ) );
+
+    if( completed )
+    {
+        timerWheel_Cancel( &( pContext->timerWheel ), index, pHeader->id );
+        asyncCompletion_Invoke( &completion );
+    }
+    return status;
+}
+
+static RTIOStatus_t handleCoPost( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody,
+                                  RTIOFixedBuffer_t* pRespBuffer )
+{
+    RTIOCoReq_t req = { 0 };
+    RTIOStatus_t  status = RTIO_DeSerializeCoReqNoCopy( pHeader->id,
+                                                        pBody->pBuffer, 
+                                                        pHeader->bodyLen, &req );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to SerializeCoReq, status=%d.", status ) );
+    }
+    else
+    {
+        status = handleCoPostRequest( pContext, &req, pRespBuffer );
+    }
+    return status;
+}
+static RTIOStatus_t handleObGet( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    RTIOObEstabReq_t req = { 0 };
+    RTIOStatus_t status = RTIO_DeSerializeObEstabReqNoCopy( pHeader->id,
+                                                            pBody->pBuffer,
+                                                            pHeader->bodyLen, &req );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to SerializeObReq, status=%d.", status ) );
+    }
+    else
+    {
+        status = handleObEstabRequest( pContext, &req );
+    }
+
+    return status;
+}
+static RTIOStatus_t handleServerRequest( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody,
+                                         RTIOFixedBuffer_t* pRespBuffer )
+{
+    RTIORestMethod_t method;
+    RTIOStatus_t status = RTIO_DeSerializeRestMethod( pBody->pBuffer, pHeader->bodyLen, &method );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to DeSerializeMethod, status=%d.", status ) );
+    }
+    else
+    {
+        switch( method )
+        {
+        case RTIO_REST_COPOST:
+            status = handleCoPost( pContext, pHeader, pBody, pRespBuffer );
+            break;
+        case RTIO_REST_OBGET:
+            status = handleObGet( pContext, pHeader, pBody );
+            break;
+        default:
+            break;
+        }
+    }
+    return status;
+}
+
+/* Answers a request the handler pool has no room for, without running its handler. */
+static RTIOStatus_t handleServerRequestBusy( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    RTIORestMethod_t method;
+    RTIOCoReq_t coReq = { 0 };
+    RTIOCoResp_t coResp = { 0 };
+    RTIOObEstabReq_t obReq = { 0 };
+    RTIOObEstabResp_t obResp = { 0 };
+    RTIOStatus_t status = RTIO_DeSerializeRestMethod( pBody->pBuffer, pHeader->bodyLen, &method );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to DeSerializeMethod, status=%d.", status ) );
+        return status;
+    }
+
+    switch( method )
+    {
+    case RTIO_REST_COPOST:
+        status = RTIO_DeSerializeCoReqNoCopy( pHeader->id, pBody->pBuffer, pHeader->bodyLen, &coReq );
+        if( status == RTIOSuccess )
+        {
+            coResp.headerId = coReq.headerId;
+            coResp.method = coReq.method;
+            coResp.code = RTIO_REST_STATUS_TOO_MANY_REQUESTS;
+            status = sendCoResp( pContext, &coResp );
+        }
+        break;
+    case RTIO_REST_OBGET:
+        status = RTIO_DeSerializeObEstabReqNoCopy( pHeader->id, pBody->pBuffer, pHeader->bodyLen, &obReq );
+        if( status == RTIOSuccess )
+        {
+            obResp.headerId = obReq.headerId;
+            obResp.method = obReq.method;
+            obResp.obId = obReq.obId;
+            obResp.code = RTIO_REST_STATUS_TOO_MANY_REQUESTS;
+            status = sendObEstabResp( pContext, &obResp );
+        }
+        break;
+    default:
+        break;
+    }
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+#define RTIO_HANDLER_POOL_END ( UINT16_MAX )
+
+static OSThreadHandle_t* handlerPool_Thread( const rtioHandlerPool_t* pPool, uint16_t index )
+{
+    return (OSThreadHandle_t*)( (uint8_t*)pPool->pThreads + pPool->threadSize * index );
+}
+
+static void handlerPool_Init( rtioHandlerPool_t* pPool, RTIOContext_t* pContext )
+{
+    uint16_t i = 0;
+
+    pPool->head = RTIO_HANDLER_POOL_END;
+    pPool->tail = RTIO_HANDLER_POOL_END;
+    pPool->freeHead = ( pPool->size > 0U ) ? 0U : RTIO_HANDLER_POOL_END;
+    for( i = 0; i < pPool->size; i++ )
+    {
+        pPool->pJobs[ i ].next = ( ( i + 1U ) < pPool->size ) ? (uint16_t)( i + 1U ) : RTIO_HANDLER_POOL_END;
+    }
+    for( i = 0; i < pPool->workerNum; i++ )
+    {
+        pPool->pWorkers[ i ].pContext = pContext;
+    }
+}
+
+/* Copies the request into a free job and queues it, RTIOListFull if no job is free. */
+static RTIOStatus_t handlerPool_Submit( rtioHandlerPool_t* pPool, const RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    uint16_t index = RTIO_HANDLER_POOL_END;
+
+    OS_MutexLock( pPool->pLock );
+    index = pPool->freeHead;
+    if( index != RTIO_HANDLER_POOL_END )
+    {
+        pPool->freeHead = pPool->pJobs[ index ].next;
+    }
+    OS_MutexUnlock( pPool->pLock );
+
+    if( index == RTIO_HANDLER_POOL_END )
+    {
+        return RTIOListFull;
+    }
+
+    pPool->pJobs[ index ].headerId = pHeader->id;
+    pPool->pJobs[ index ].bodyLength = pHeader->bodyLen;
+    memcpy( pPool->pJobs[ index ].body, pBody->pBuffer, pHeader->bodyLen );
+
+    OS_MutexLock( pPool->pLock );
+    pPool->pJobs[ index ].next = RTIO_HANDLER_POOL_END;
+    if( pPool->tail == RTIO_HANDLER_POOL_END )
+    {
+        pPool->head = index;
+    }
+    else
+    {
+        pPool->pJobs[ pPool->tail ].next = index;
+    }
+    pPool->tail = index;
+    OS_MutexUnlock( pPool->pLock );
+    (void)OS_EventSignal( pPool->pJobEvent );
+
+    return RTIOSuccess;
+}
+
+/* Returns RTIO_HANDLER_POOL_END when the queue is empty. */
+static uint16_t handlerPool_Pop( rtioHandlerPool_t* pPool )
+{
+    uint16_t index = RTIO_HANDLER_POOL_END;
+    bool more = false;
+
+    OS_MutexLock( pPool->pLock );
+    index = pPool->head;
+    if( index != RTIO_HANDLER_POOL_END )
+    {
+        pPool->head = pPool->pJobs[ index ].next;
+        if( pPool->head == RTIO_HANDLER_POOL_END )
+        {
+            pPool->tail = RTIO_HANDLER_POOL_END;
+        }
+        more = ( pPool->head != RTIO_HANDLER_POOL_END );
+    }
+    OS_MutexUnlock( pPool->pLock );
+
+    /* Signals do not accumulate, pass the rest on to another worker. */
+    if( more )
+    {
+        (void)OS_EventSignal( pPool->pJobEvent );
+    }
+    return index;
+}
+
+static void handlerPool_Release( rtioHandlerPool_t* pPool, uint16_t index )
+{
+    OS_MutexLock( pPool->pLock );
+    pPool->pJobs[ index ].next = pPool->freeHead;
+    pPool->freeHead = index;
+    OS_MutexUnlock( pPool->pLock );
+}
+
+static void handlerWorkerProccess( void* pWorker )
+{
+    rtioHandlerWorker_t* pHandlerWorker = (rtioHandlerWorker_t*)pWorker;
+    RTIOContext_t* pRTIOContext = NULL;
+    rtioHandlerPool_t* pPool = NULL;
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOHeader_t header = { 0 };
+    RTIOFixedBuffer_t body = { 0 };
+    RTIOFixedBuffer_t respBuffer = { 0 };
+    uint16_t index = RTIO_HANDLER_POOL_END;
+    OSError_t osRet = OSUnknown;
+
+    if( pWorker == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pWorker=%p.", (void*)pWorker ) );
+        return;
+    }
+    pRTIOContext = (RTIOContext_t*)pHandlerWorker->pContext;
+    pPool = &( pRTIOContext->handlerPool );
+    respBuffer.pBuffer = pHandlerWorker->respBuffer;
+    respBuffer.size = sizeof( pHandlerWorker->respBuffer );
+    LogInfo( ( "Handler worker proccess started, worker=%u.", (unsigned)( pHandlerWorker - pPool->pWorkers ) ) );
+
+    while( pRTIOContext->serviceDone == false )
+    {
+        index = handlerPool_Pop( pPool );
+        if( index == RTIO_HANDLER_POOL_END )
+        {
+            (void)OS_EventWait( pPool->pJobEvent, RTIO_SEND_QUEUE_WAIT_SLICE_MS );
+            continue;
+        }
+
+        header.id = pPool->pJobs[ index ].headerId;
+        header.bodyLen = pPool->pJobs[ index ].bodyLength;
+        header.type = RTIO_TYPE_SERVER_SEND_REQ;
+        body.pBuffer = pPool->pJobs[ index ].body;
+        body.size = pPool->pJobs[ index ].bodyLength;
+        status = handleServerRequest( pRTIOContext, &header, &body, &respBuffer );
+        if( status != RTIOSuccess )
+        {
+            /* A broken session is found and reconnected by the incomming thread. */
+            LogError( ( "Failed to handle server request, status=%d, headerId=%u.", status, header.id ) );
+        }
+        handlerPool_Release( pPool, index );
+    }
+
+    LogInfo( ( "Handler worker proccess stopped with status=%d.", status ) );
+
+    serve_ThreadStopped( pRTIOContext );
+    osRet = OS_ThreadDestroy( handlerPool_Thread( pPool, (uint16_t)( pHandlerWorker - pPool->pWorkers ) ) );
+    if( osRet != OSSuccess )
+    {
+        LogError( ( "Failed to destroy handler worker thread, ret=%d.", osRet ) );
+    }
+}
+
+static RTIOStatus_t handleServerSendReqest( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    RTIOStatus_t status = RTIOSuccess;
+
+    if( pContext == NULL || pHeader == NULL || pBody == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pHeader=%p, pBody=%p.", (void*)pContext, (void*)pHeader, (void*)pBody ) );
+        return RTIOBadParameter;
+    }
+
+    /* Requests too large for a job are rare, they are handled in place. */
+    if( ( pContext->handlerPool.workerNum == 0U ) ||
+        ( pHeader->bodyLen > sizeof( pContext->handlerPool.pJobs[ 0 ].body ) ) )
+    {
+        return handleServerRequest( pContext, pHeader, pBody, &( pContext->serverSendRespBuffer ) );
+    }
+
+    status = handlerPool_Submit( &( pContext->handlerPool ), pHeader, pBody );
+    if( status == RTIOListFull )
+    {
+        LogWarn( ( "Handler queue is full, answer too many requests, headerId=%u.", pHeader->id ) );
+        status = handleServerRequestBusy( pContext, pHeader, pBody );
+    }
+    return status;
+}
+
+static RTIOStatus_t incommingHeaderHandle( RTIOContext_t* pContext, RTIOHeader_t* pHeader, const RTIOFixedBuffer_t* pBody )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    LogDebug( ( "Incomming Header: headerId=%u, type=%u, version=%u, bodyLen=%u, code=%u.",
+                pHeader->id, pHeader->type, pHeader->version, pHeader->bodyLen, pHeader->code ) );
+
+    pContext->lastPacketRxTime = OS_ClockGetTimeMs(); // only for keep-alive, no mutext required
+
+    switch( pHeader->type )
+    {
+    case RTIO_TYPE_DEVICE_PING_RESP:
+        status = handleDevicePingResp( pContext, pHeader, pBody );
+        break;
+    case RTIO_TYPE_DEVICE_SEND_RESP:
+        status = handleDeviceSendResp( pContext, pHeader, pBody );
+        break;
+    case RTIO_TYPE_SERVER_SEND_REQ:
+        status = handleServerSendReqest( pContext, pHeader, pBody );
+        break;
+    default:
+        LogError( ( "Incomming type error: type=%u.", pHeader->type ) );
+        status = RTIOBadParameter;
+        break;
+    }
+    return status;
+}
+
+static void incommingProccess( void* pContext )
+{
+    RTIOStatus_t status = RTIOUnknown;
+    RTIOContext_t* pRTIOContext = (RTIOContext_t*)pContext;
+    RTIOFixedBuffer_t frame = { 0 };
+    RTIOFixedBuffer_t body = { 0 };
+    RTIOHeader_t header = { 0 };
+    OSError_t osRet = OSUnknown;
+
+    LogInfo( ( "Incomming proccess started." ) );
+
+    if( pContext == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
+        return;
+    }
+
+    pRTIOContext->incommingStart = 0;
+    pRTIOContext->incommingEnd = 0;
+    while( false == ( (RTIOContext_t*)pContext )->serviceDone )
+    {
+        /* Frames already buffered are handled without calling the transport. */
+        status = recvBuffered( pRTIOContext, RTIO_PROTOCAL_HEADER_LEN );
+
+        if( RTIOSuccess == status )
+        {
+            frame.pBuffer = &( pRTIOContext->networkIncommingBuffer.pBuffer[ pRTIOContext->incommingStart ] );
+            frame.size = RTIO_PROTOCAL_HEADER_LEN;
+            status = RTIO_DeserializeHeader( &frame, &header );
+            if( RTIOSuccess == status )
+            {
+                status = recvBuffered( pRTIOContext, RTIO_PROTOCAL_HEADER_LEN + header.bodyLen );
+            }
+            else
+            {
+                LogError( ( "Failed to DeserializeHeader, status=%d.", status ) );
+            }
+
+            if( RTIOSuccess == status )
+            {
+                /* The buffer may be compacted by recvBuffered, take the body after it. */
+                body.pBuffer = &( pRTIOContext->networkIncommingBuffer.pBuffer[ pRTIOContext->incommingStart + RTIO_PROTOCAL_HEADER_LEN ] );
+                body.size = header.bodyLen;
+                status = incommingHeaderHandle( pContext, &header, &body );
+                recvBuffered_Consume( pRTIOContext, RTIO_PROTOCAL_HEADER_LEN + header.bodyLen );
+                if( status != RTIOSuccess )
+                {
+                    LogError( ( "Header handle Failed, status=%d.", status ) );
+                }
+            }
+        }
+        else if( RTIOTimeout == status ||
+                 RTIONotFound == status /* Due to a timeout, headerid not found. */ )
+        {
+            continue;
+        }
+        else
+        {
+            /* MISRA else. */
+        }
+
+        if( RTIOSendFailed == status ||
+            RTIORecvFailed == status ||
+            RTIOTransportFailed == status ||
+            RTIOProtocalFailed == status )
+        {
+            LogError( ( "Session bad when read, status=%d, will reconnet later.", status ) );
+            connectStatus_ChangeWhenEventReconnect( pContext );
+            /* Bytes buffered from the broken session are dropped. */
+            pRTIOContext->incommingStart = 0;
+            pRTIOContext->incommingEnd = 0;
+            bool ok = false;
+            while( !( (RTIOContext_t*)pContext )->serviceDone && !ok )
+            {
+                ok = connectStatus_CheckStatus( pContext, RTIOConnected );
+                if( !ok )
+                {
+                    OS_ClockSleepMs( 200U );
+                }
+            }
+        }
+        else
+        {
+            if( RTIOSuccess != status )
+            {
+                LogError( ( "Unrecoverable error, status=%d.", status ) );
+                break;
+            }
+        }
+    }
+
+    LogInfo( ( "Incomming proccess stopped with status=%d.",  status) );
+
+    if ( ( status != RTIOSuccess ) && 
+         ( false == ( (RTIOContext_t*)pContext )->serviceDone )&&
+         ( (RTIOContext_t*)pContext )->serveFailedHandler != NULL )
+    {
+        ( (RTIOContext_t*)pContext )->serveFailedHandler();
+    }
+    
+    serve_ThreadStopped( pRTIOContext );
+    osRet =  OS_ThreadDestroy( ( (RTIOContext_t*)pContext )->pThreadIncomming );
+    if( osRet != OSSuccess )
+    {
+        LogError( ( "Failed to destroy pThreadIncomming, ret=%d.", osRet ) );
+    }
+    // else
+    // {
+    //     ( (RTIOContext_t*)pContext )->pThreadIncomming = NULL;
+    // }
+}
+
+/* Reads what the transport has into networkIncommingBuffer without waiting, *pReadLength is 0 when nothing. */
+static RTIOStatus_t recvAvailable( RTIOContext_t* pContext, uint16_t* pReadLength )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOFixedBuffer_t* pBuffer = &( pContext->networkIncommingBuffer );
+    int32_t recvResult = 0;
+    int32_t waitResult = 1;
+
+    *pReadLength = 0;
+
+    /* Only a partial frame is left, move it to the front to read behind it. */
+    if( pContext->incommingStart > 0U )
+    {
+        memmove( pBuffer->pBuffer, &( pBuffer->pBuffer[ pContext->incommingStart ] ),
+                 pContext->incommingEnd - pContext->incommingStart );
+        pContext->incommingEnd -= pContext->incommingStart;
+        pContext->incommingStart = 0;
+    }
+
+    OS_MutexLock( pContext->pRecvMessageLock );
+    /* Recv of some transports blocks when nothing is there, ask first. */
+    if( pContext->transportInterface.waitReadable != NULL )
+    {
+        waitResult = pContext->transportInterface.waitReadable( pContext->transportInterface.pNetworkContext, 0U );
+    }
+    if( waitResult < 0 )
+    {
+        LogError( ( "Unable to wait for packet: Network Error, waitResult=%d.", (int)waitResult ) );
+        status = RTIORecvFailed;
+    }
+    else if( ( waitResult > 0 ) && ( pContext->incommingEnd < pBuffer->size ) )
+    {
+        recvResult = pContext->transportInterface.recv( pContext->transportInterface.pNetworkContext,
+                                                        &( pBuffer->pBuffer[ pContext->incommingEnd ] ),
+                                                        pBuffer->size - pContext->incommingEnd );
+        if( recvResult > (int32_t)( pBuffer->size - pContext->incommingEnd ) )
+        {
+            LogError( ( "Transport Recv implementation error, recvResult=%d bytesToRecv=%d.",
+                        (int)recvResult, (int)( pBuffer->size - pContext->incommingEnd ) ) );
+            status = RTIOTransportImplementError;
+        }
+        else if( recvResult > 0 )
+        {
+            pContext->incommingEnd += (uint16_t)recvResult;
+            *pReadLength = (uint16_t)recvResult;
+        }
+        else if( recvResult < 0 )
+        {
+            LogError( ( "Unable to recv packet: Network Error, recvResult=%d.", (int)recvResult ) );
+            status = RTIORecvFailed;
+        }
+        else
+        {
+            /* MISRA else. */
+        }
+    }
+    else
+    {
+        /* MISRA else. */
+    }
+    OS_MutexUnlock( pContext->pRecvMessageLock );
+
+    return status;
+}
+
+/* Handles the first buffered frame if it is complete, *pHandled is false when more bytes are needed. */
+static RTIOStatus_t incommingHandleBufferedFrame( RTIOContext_t* pContext, bool* pHandled )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOFixedBuffer_t frame = { 0 };
+    RTIOFixedBuffer_t body = { 0 };
+    RTIOHeader_t header = { 0 };
+    uint16_t buffered = pContext->incommingEnd - pContext->incommingStart;
+
+    *pHandled = false;
+    if( buffered < RTIO_PROTOCAL_HEADER_LEN )
+    {
+        return RTIOSuccess;
+    }
+
+    frame.pBuffer = &( pContext->networkIncommingBuffer.pBuffer[ pContext->incommingStart ] );
+    frame.size = RTIO_PROTOCAL_HEADER_LEN;
+    status = RTIO_DeserializeHeader( &frame, &header );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to DeserializeHeader, status=%d.", status ) );
+        return status;
+    }
+    if( RTIO_PROTOCAL_HEADER_LEN + header.bodyLen > pContext->networkIncommingBuffer.size )
+    {
+        LogError( ( "Buffer size is not enough: bytesNeeded=%u, bufsize=%u.",
+                    RTIO_PROTOCAL_HEADER_LEN + header.bodyLen, pContext->networkIncommingBuffer.size ) );
+        return RTIONoMemory;
+    }
+    if( buffered < RTIO_PROTOCAL_HEADER_LEN + header.bodyLen )
+    {
+        return RTIOSuccess;
+    }
+
+    body.pBuffer = &( frame.pBuffer[ RTIO_PROTOCAL_HEADER_LEN ] );
+    body.size = header.bodyLen;
+    status = incommingHeaderHandle( pContext, &header, &body );
+    recvBuffered_Consume( pContext, RTIO_PROTOCAL_HEADER_LEN + header.bodyLen );
+    *pHandled = true;
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Header handle Failed, status=%d.", status ) );
+    }
+    return status;
+}
+
+/* Sends a ping without waiting, the keep-alive thread collects the response from item *pRespIndex. */
+static RTIOStatus_t ping_Send( RTIOContext_t* pContext, uint32_t heartbeatMs, uint16_t* pRespIndex, uint16_t* pHeaderId )
+{
+    RTIOFixedBuffer_t serializeBuffer = { 0 };
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOPingReq_t pingReq = { 0 };
+    uint16_t respIndex = UINT16_MAX;
+    uint16_t serianlizeLength = 0;
+    rtioOutgoingFrame_t frame = { 0 };
+
+    LogDebug( ( "Ping started, heartbeatMs=%u.", (unsigned)heartbeatMs ) );
+
+    serializeBuffer.pBuffer = pContext->keepAlive.pingRespBuffer;
+    serializeBuffer.size = RTIO_PING_RESP_BUFFER_SIZE;
+
+    /* Add ping request to deviceSendRespList. */
+    if( heartbeatMs == 0
+        || heartbeatMs == RTIO_PING_INTERVAL_MS_DEFAULT )
+    {
+        pingReq.header.bodyLen = 0; /* Using default value. */
+        heartbeatMs = 0;
+    }
+    else
+    {
+        pingReq.header.bodyLen = 2;
+    }
+
+    pingReq.header.type = RTIO_TYPE_DEVICE_PING_REQ;
+    pingReq.header.version = RTIO_PROTOCAL_VERSION;
+    pingReq.timeout = heartbeatMs / 1000;
+
+    status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
+                                     &serializeBuffer,
+                                     &pingReq.header.id,
+                                     &respIndex );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to deviceSendRespList_Add, status=%d.", status ) );
+        return status;
+    }
+
+    /* Send ping request. */
+    status = outgoingFrame_Begin( pContext, &frame, RTIO_SEND_LANE_CONTROL );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to get outgoing frame, status=%d.", status ) );
+    }
+    else
+    {
+        status = RTIO_SerializePingReq( &pingReq, &( frame.buffer ), &serianlizeLength );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to SerializePingReq, status=%d.", status ) );
+            (void)outgoingFrame_End( pContext, &frame, 0, NULL, 0 );
+        }
+        else
+        {
+            status = outgoingFrame_End( pContext, &frame, serianlizeLength, NULL, 0 );
+            if( status != RTIOSuccess )
+            {
+                LogError( ( "Failed to send ping request, status=%d.", status ) );
+            }
+        }
+    }
+
+    if( status != RTIOSuccess )
+    {
+        if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex, pingReq.header.id ) != RTIOSuccess )
+        {
+            LogError( ( "Failed to deviceSendRespListDelete." ) );
+        }
+        return status;
+    }
+
+    *pRespIndex = respIndex;
+    *pHeaderId = pingReq.header.id;
+    return RTIOSuccess;
+}
+
+/*-----------------------------------------------------------*/
+/**
+ * @brief connect to server with backoff algorithm
+ *
+ * @param[in] pContext context pointer with pContext->connectStatus, pContext->serviceDone.
+ * @param[out] pContext context pointer with pContext->connectStatus.
+ * @return RTIOSuccess, RTIOVerifyFailedNeverRetry, RTIOConnectFailedNeverRetry and others in RTIOStatus_t.
+ */
+
+static RTIOStatus_t connectWithBackoffAlgorithm( RTIOContext_t* pContext )
+{
+    BackoffAlgorithmStatus_t retryStatus = BackoffAlgorithmSuccess;
+    BackoffAlgorithmContext_t backoffContext;
+    uint16_t nextRetryBackoff = 0, retryTimes = 0;
+    RTIOStatus_t status = RTIOSuccess;
+
+    BackoffAlgorithm_InitializeParams( &backoffContext,
+                                       RTIO_RETRY_BACKOFF_BASE_MS,
+                                       RTIO_RETRY_MAX_BACKOFF_DELAY_MS,
+                                       RTIO_RETRY_MAX_ATTEMPTS );
+    do
+    {
+        status = connectRTIOServer( pContext );
+        LogDebug( ( "Connect to Server retryTimes=%u, status=%d.", retryTimes, status ) );
+
+        if( RTIOTransportFailed == status || RTIORecvFailed== status )
+        {
+            retryStatus = BackoffAlgorithm_GetNextBackoff( &backoffContext, rand(), &nextRetryBackoff );
+            LogDebug( ( "Reconnect nextRetryBackoff=%u, retryStatus=%d.", nextRetryBackoff, retryStatus ) );
+            retryTimes++;
+            if( retryStatus == BackoffAlgorithmRetriesExhausted )
+            {
+                LogInfo( ( "Reconect stoped, retryTimes exceeded, retryStatus=%d.", BackoffAlgorithmRetriesExhausted ) );
+                status = RTIOConnectFailedNeverRetry;
+                break;
+            }
+            OS_ClockSleepMs( nextRetryBackoff );
+        }
+        else if( RTIOSuccess == status )
+        {
+            LogDebug( ( "Connect retryTimes=%u success.", retryTimes ) );
+            break;
+        }
+        else if( RTIOVerifyFailedNeverRetry == status )
+        {
+            LogError( ( "Connect VerifyFailed, please check deviceId or devieSecret, status=%u.", status ) );
+            break;
+        }
+        else /* Other error code */
+        {
+            LogError( ( "Connect Failed, status=%u.", status ) );
+            break;
+        }
+    } while( 1 );
+
+    return status;
+}
+
+#if RTIO_SEND_COALESCE_BYTES > 0
+
+/* Sleep slice of the writer while it waits for frames to pack. */
+#define RTIO_SEND_COALESCE_SLICE_US ( 50U )
+
+/**
+ * @brief Packs queued frames behind the first one, up to RTIO_SEND_COALESCE_BYTES.
+ *
+ * Waits up to RTIO_SEND_COALESCE_FLUSH_US for frames while the queue is empty. Frames keep
+ * their order, a frame that does not fit ends the write.
+ *
+ * @return the number of frames in pIndexes.
+ */
+static uint16_t writer_Pack( rtioSendQueue_t* pQueue, uint16_t* pIndexes, uint32_t* pBytes )
+{
+    uint32_t startUs = OS_ClockGetTimeUs();
+    uint32_t elapsedUs = 0;
+    uint16_t count = 1;
+    uint16_t index = RTIO_SEND_QUEUE_END;
+    bool empty = false;
+
+    while( ( count < RTIO_SEND_COALESCE_FRAMES_MAX ) && ( *pBytes < RTIO_SEND_COALESCE_BYTES ) )
+    {
+        index = sendQueue_Pop( pQueue, (uint16_t)( RTIO_SEND_COALESCE_BYTES - *pBytes ), &empty );
+        if( index != RTIO_SEND_QUEUE_END )
+        {
+            pIndexes[ count++ ] = index;
+            *pBytes += pQueue->pFrames[ index ].length;
+            continue;
+        }
+
+        elapsedUs = OS_ClockGetTimeUs() - startUs;
+        if( !empty || ( elapsedUs >= RTIO_SEND_COALESCE_FLUSH_US ) )
+        {
+            break;
+        }
+        OS_ClockSleepUs( ( RTIO_SEND_COALESCE_FLUSH_US - elapsedUs < RTIO_SEND_COALESCE_SLICE_US ) ?
+                         RTIO_SEND_COALESCE_FLUSH_US - elapsedUs : RTIO_SEND_COALESCE_SLICE_US );
+    }
+    return count;
+}
+
+#endif /* if RTIO_SEND_COALESCE_BYTES > 0 */
+
+/* Writes the frames as one message, packed frames are one vector when the transport has sendv. */
+static RTIOStatus_t writer_Write( RTIOContext_t* pContext, const uint16_t* pIndexes, uint16_t count )
+{
+    rtioSendQueue_t* pQueue = &( pContext->sendQueue );
+    TransportIoVector_t ioVec[ RTIO_SEND_COALESCE_FRAMES_MAX ];
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t i = 0;
+
+    if( ( count > 1U ) && ( pContext->transportInterface.sendv != NULL ) )
+    {
+        for( i = 0; i < count; i++ )
+        {
+            ioVec[ i ].iov_base = pQueue->pFrames[ pIndexes[ i ] ].buffer;
+            ioVec[ i ].iov_len = pQueue->pFrames[ pIndexes[ i ] ].length;
+        }
+        return sendMessageVectorSafe( pContext, ioVec, count );
+    }
+
+    for( i = 0; ( i < count ) && ( status == RTIOSuccess ); i++ )
+    {
+        status = sendMessageSafe( pContext, pQueue->pFrames[ pIndexes[ i ] ].buffer,
+                                  pQueue->pFrames[ pIndexes[ i ] ].length );
+    }
+    return status;
+}
+
+static void writerProccess( void* pContext )
+{
+    RTIOContext_t* pRTIOContext = (RTIOContext_t*)pContext;
+    rtioSendQueue_t* pQueue = NULL;
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t indexes[ RTIO_SEND_COALESCE_FRAMES_MAX ];
+    uint16_t count = 0;
+    uint32_t bytes = 0;
+    bool empty = false;
+    OSError_t osRet = OSUnknown;
+
+    if( pContext == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
+        return;
+    }
+    pQueue = &( pRTIOContext->sendQueue );
+    LogInfo( ( "Writer proccess started, frames=%u, coalesceBytes=%u.", pQueue->size, RTIO_SEND_COALESCE_BYTES ) );
+
+    while( pRTIOContext->serviceDone == false )
+    {
+        indexes[ 0 ] = sendQueue_Pop( pQueue, UINT16_MAX, &empty );
+        if( indexes[ 0 ] == RTIO_SEND_QUEUE_END )
+        {
+            (void)OS_EventWait( pQueue->pWriterEvent, RTIO_SEND_QUEUE_WAIT_SLICE_MS );
+            continue;
+        }
+        count = 1;
+        bytes = pQueue->pFrames[ indexes[ 0 ] ].length;
+#if RTIO_SEND_COALESCE_BYTES > 0
+        count = writer_Pack( pQueue, indexes, &bytes );
+#else
+        (void)bytes; /* Without packing, read by LogWarn only. */
+#endif
+
+        /* Frames queued for a broken session are dropped, their requests time out. */
+        if( connectStatus_CheckStatus( pRTIOContext, RTIOConnected ) )
+        {
+            status = writer_Write( pRTIOContext, indexes, count );
+            if( status != RTIOSuccess )
+            {
+                LogError( ( "Session bad when write, status=%d, will reconnet later.", status ) );
+                connectStatus_ChangeWhenEventReconnect( pRTIOContext );
+            }
+        }
+        else
+        {
+            LogWarn( ( "Not connected, drop frames, count=%u, bytes=%u.", count, (unsigned)bytes ) );
+        }
+        sendQueue_ReleaseWritten( pQueue, indexes, count );
+    }
+
+    LogInfo( ( "Writer proccess stopped with status=%d.", status ) );
+
+    serve_ThreadStopped( pRTIOContext );
+    osRet = OS_ThreadDestroy( pRTIOContext->pThreadWriter );
+    if( osRet != OSSuccess )
+    {
+        LogError( ( "Failed to destroy pThreadWriter, ret=%d.", osRet ) );
+    }
+}
+
+/*
+ * The session is alive while frames go both ways, so a ping is due a heartbeat after the
+ * direction idle for longer, and before the rx idle deadline so a quiet session keeps up.
+ */
+static uint32_t keepAlive_PingDueMs( RTIOContext_t* pContext, uint32_t nowMs )
+{
+    uint32_t lastTxMs = pContext->lastPacketTxTime;
+    uint32_t lastRxMs = pContext->lastPacketRxTime;
+    uint32_t dueMs = 0;
+
+    dueMs = ( calculateElapsedTime( nowMs, lastTxMs ) > calculateElapsedTime( nowMs, lastRxMs ) ) ? lastTxMs : lastRxMs;
+    dueMs += pContext->heartbeatMs;
+#if RTIO_RX_IDLE_TIMEOUT_MS > 0
+    if( timerWheel_Before( lastRxMs + RTIO_RX_IDLE_TIMEOUT_MS / 2U, dueMs ) )
+    {
+        dueMs = lastRxMs + RTIO_RX_IDLE_TIMEOUT_MS / 2U;
+    }
+#endif
+    return dueMs;
+}
+
+static void keepAlive_ArmPing( RTIOContext_t* pContext )
+{
+    timerWheel_Arm( &( pContext->timerWheel ), RTIO_TIMER_ID_PING( pContext ), 0,
+                    keepAlive_PingDueMs( pContext, OS_ClockGetTimeMs() ) );
+}
+
+static void keepAlive_ArmRxIdle( RTIOContext_t* pContext )
+{
+#if RTIO_RX_IDLE_TIMEOUT_MS > 0
+    timerWheel_Arm( &( pContext->timerWheel ), RTIO_TIMER_ID_RX_IDLE( pContext ), 0,
+                    pContext->lastPacketRxTime + RTIO_RX_IDLE_TIMEOUT_MS );
+#else
+    (void)pContext;
+#endif
+}
+
+/* A server silent for RTIO_RX_IDLE_TIMEOUT_MS is gone even when sending still succeeds. */
+static void keepAlive_RxIdle( RTIOContext_t* pContext, uint32_t nowMs )
+{
+#if RTIO_RX_IDLE_TIMEOUT_MS > 0
+    /* A successful reconnect arms it again. */
+    if( !connectStatus_CheckStatus( pContext, RTIOConnected ) )
+    {
+        return;
+    }
+
+    if( calculateElapsedTime( nowMs, pContext->lastPacketRxTime ) < RTIO_RX_IDLE_TIMEOUT_MS )
+    {
+        keepAlive_ArmRxIdle( pContext );
+        return;
+    }
+
+    LogError( ( "Session bad, nothing received for %ums, will reconnet later.",
+                (unsigned)calculateElapsedTime( nowMs, pContext->lastPacketRxTime ) ) );
+    connectStatus_ChangeWhenEventReconnect( pContext );
+#else
+    (void)pContext;
+    (void)nowMs;
+#endif
+}
+
+static RTIOStatus_t keepAlive_Ping( RTIOContext_t* pContext, rtioKeepAlive_t* pKeepAlive, uint32_t nowMs )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint32_t timeoutMs = 0;
+
+    /* A successful reconnect arms the ping again. */
+    if( !connectStatus_CheckStatus( pContext, RTIOConnected ) || ( pKeepAlive->pingIndex != RTIO_RESP_LIST_END ) )
+    {
+        return RTIOSuccess;
+    }
+
+    /* Other frames sent and received meanwhile keep the session alive. */
+    if( timerWheel_Before( nowMs, keepAlive_PingDueMs( pContext, nowMs ) ) )
+    {
+        keepAlive_ArmPing( pContext );
+        return RTIOSuccess;
+    }
+
+    status = ping_Send( pContext, pContext->heartbeatMs, &( pKeepAlive->pingIndex ), &( pKeepAlive->pingHeaderId ) );
+    if( status == RTIOSuccess )
+    {
+        timeoutMs = rtt_TimeoutMs( pContext, pKeepAlive->pingIndex, RTIO_PING_TIMEOUT_MS );
+        /* A spike of the round-trip time must not reconnect a low-latency session. */
+        if( ( RTIO_PING_TIMEOUT_MS == RTIO_TIMEOUT_AUTO ) && ( timeoutMs < RTIO_PING_TIMEOUT_MS_MIN ) )
+        {
+            timeoutMs = RTIO_PING_TIMEOUT_MS_MIN;
+        }
+        timerWheel_Arm( &( pContext->timerWheel ), pKeepAlive->pingIndex, pKeepAlive->pingHeaderId,
+                        nowMs + timeoutMs );
+    }
+    return status;
+}
+
+/* Collects the ping in flight when its response arrived, fails it with RTIOTimeout when timedOut. */
+static RTIOStatus_t keepAlive_PingDone( RTIOContext_t* pContext, rtioKeepAlive_t* pKeepAlive, bool timedOut )
+{
+    rtioDeviceSendResp_t* pDeviceSendResp = NULL;
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t index = pKeepAlive->pingIndex;
+
+    if( index == RTIO_RESP_LIST_END )
+    {
+        return RTIOSuccess;
+    }
+
+    if( deviceSendRespList_Arrived( &( pContext->deviceSendRespList ), index ) )
+    {
+        status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), index, &pDeviceSendResp );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to deviceSendRespList_GetResp, status=%d.", status ) );
+        }
+        else if( pDeviceSendResp->code != REMOTECODE_SUCCESS )
+        {
+            LogError( ( "Failed to ping, pingRespCode=%u.", pDeviceSendResp->code ) );
+        }
+        else
+        {
+            /* MISRA else. */
+        }
+    }
+    else if( timedOut )
+    {
+        rtt_TimedOut( pContext, index );
+        status = RTIOTimeout;
+    }
+    else
+    {
+        return RTIOSuccess;
+    }
+
+    timerWheel_Cancel( &( pContext->timerWheel ), index, pKeepAlive->pingHeaderId );
+    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), index, pKeepAlive->pingHeaderId ) != RTIOSuccess )
+    {
+        LogError( ( "Failed to deviceSendRespListDelete." ) );
+    }
+    pKeepAlive->pingIndex = RTIO_RESP_LIST_END;
+
+    if( status == RTIOSuccess )
+    {
+        keepAlive_ArmPing( pContext );
+    }
+    return status;
+}
+
+static void keepAlive_PingFailed( RTIOContext_t* pContext, RTIOStatus_t status )
+{
+    LogError( ( "Failed to ping, status=%d.", status ) );
+    if( RTIOSendFailed == status ||
+        RTIORecvFailed == status ||
+        RTIOTransportFailed == status ||
+        RTIOProtocalFailed == status ||
+        RTIOTimeout == status )
+    {
+        LogError( ( "Session bad when ping, status=%d, will reconnet later.", status ) );
+        connectStatus_ChangeWhenEventReconnect( pContext );
+    }
+    else
+    {
+        timerWheel_Arm( &( pContext->timerWheel ), RTIO_TIMER_ID_PING( pContext ), 0,
+                        OS_ClockGetTimeMs() + RTIO_KEEPALIVE_PING_RETRY_MS );
+    }
+}
+
+/**
+ * @brief One attempt to reconnect, the next one is a timer after the backoff delay.
+ *
+ * @return RTIOSuccess when connected or retrying, otherwise reconnecting stopped.
+ */
+static RTIOStatus_t keepAlive_Reconnect( RTIOContext_t* pContext, rtioKeepAlive_t* pKeepAlive )
+{
+    BackoffAlgorithmStatus_t retryStatus = BackoffAlgorithmSuccess;
+    BackoffAlgorithmContext_t backoffContext;
+    uint16_t nextRetryBackoff = 0;
+    RTIOStatus_t status = RTIOSuccess;
+
+    if( !connectStatus_CheckStatus( pContext, RTIOConnecting ) )
+    {
+        return RTIOSuccess;
+    }
+
+    BackoffAlgorithm_InitializeParams( &backoffContext,
+                                       RTIO_RETRY_BACKOFF_BASE_MS,
+                                       RTIO_RETRY_MAX_BACKOFF_DELAY_MS,
+                                       RTIO_RETRY_MAX_ATTEMPTS );
+    if( pKeepAlive->reconnecting )
+    {
+        backoffContext.attemptsDone = pKeepAlive->backoffAttemptsDone;
+        backoffContext.nextJitterMax = pKeepAlive->backoffJitterMax;
+    }
+    else
+    {
+        /* The ping of the broken session will not be answered. */
+        if( pKeepAlive->pingIndex != RTIO_RESP_LIST_END )
+        {
+            timerWheel_Cancel( &( pContext->timerWheel ), pKeepAlive->pingIndex, pKeepAlive->pingHeaderId );
+            (void)deviceSendRespList_Delete( &( pContext->deviceSendRespList ), pKeepAlive->pingIndex,
+                                             pKeepAlive->pingHeaderId );
+            pKeepAlive->pingIndex = RTIO_RESP_LIST_END;
+        }
+
+        status = pContext->transportInterface.disconnect( pContext->transportInterface.pNetworkContext );
+        LogInfo( ( "Disconnect old connection, status=%d.", status ) );
+
+        pKeepAlive->retryTimes = 0;
+        pKeepAlive->reconnecting = true;
+    }
+
+    status = connectRTIOServer( pContext );
+    LogDebug( ( "Connect retryTimes=%u, status=%d.", pKeepAlive->retryTimes, status ) );
+
+    if( RTIOTransportFailed == status || RTIORecvFailed == status )
+    {
+        retryStatus = BackoffAlgorithm_GetNextBackoff( &backoffContext, rand(), &nextRetryBackoff );
+        LogDebug( ( "Reconnect nextRetryBackoff=%u, retryStatus=%d.", nextRetryBackoff, retryStatus ) );
+        pKeepAlive->backoffAttemptsDone = backoffContext.attemptsDone;
+        pKeepAlive->backoffJitterMax = backoffContext.nextJitterMax;
+        pKeepAlive->retryTimes++;
+        if( retryStatus == BackoffAlgorithmRetriesExhausted )
+        {
+            LogInfo( ( "Reconect stoped, retryTimes exceeded, retryStatus=%d.", BackoffAlgorithmRetriesExhausted ) );
+            status = RTIOConnectFailedNeverRetry;
+        }
+        else if( pContext->serviceDone )
+        {
+            LogInfo( ( "Reconect stoped, serviceDone=%d.", pContext->serviceDone ) );
+            status = RTIOConnectFailedNeverRetry;
+        }
+        else
+        {
+            timerWheel_Arm( &( pContext->timerWheel ), RTIO_TIMER_ID_RECONNECT( pContext ), 0,
+                            OS_ClockGetTimeMs() + nextRetryBackoff );
+            return RTIOSuccess;
+        }
+    }
+    else if( RTIOSuccess == status )
+    {
+        LogDebug( ( "Connect retryTimes=%u success.", pKeepAlive->retryTimes ) );
+        pKeepAlive->reconnecting = false;
+        connectStatus_ChangeWhenEventConnectSuccess( pContext );
+        offlineQueue_Replay( pContext );
+        keepAlive_ArmPing( pContext );
+        keepAlive_ArmRxIdle( pContext );
+        return RTIOSuccess;
+    }
+    else if( RTIOVerifyFailedNeverRetry == status )
+    {
+        LogError( ( "Connect VerifyFailed, please check deviceId or devieSecret, status=%u.", status ) );
+    }
+    else /* other error code */
+    {
+        LogError( ( "Connect Failed, status=%u.", status ) );
+    }
+
+    pKeepAlive->reconnecting = false;
+    LogError( ( "Reconnect stoped, status=%d.", status ) );
+    connectStatus_ChangeWhenEventDisconnect( pContext );
+    return status;
+}
+
+static void keepAlive_Start( RTIOContext_t* pContext )
+{
+    memset( &( pContext->keepAlive ), 0, sizeof( pContext->keepAlive ) );
+    pContext->keepAlive.pingIndex = RTIO_RESP_LIST_END;
+    keepAlive_ArmPing( pContext );
+    keepAlive_ArmRxIdle( pContext );
+}
+
+/* Runs the timers due at nowMs: pings an idle session, reconnects a broken one and expires asynchronous requests. */
+static RTIOStatus_t keepAlive_RunTimers( RTIOContext_t* pContext, uint32_t nowMs )
+{
+    rtioKeepAlive_t* pKeepAlive = &( pContext->keepAlive );
+    RTIOStatus_t status = RTIOSuccess, pingStatus = RTIOSuccess;
+    uint16_t id = 0, tag = 0;
+
+    pingStatus = keepAlive_PingDone( pContext, pKeepAlive, false );
+    if( pingStatus != RTIOSuccess )
+    {
+        keepAlive_PingFailed( pContext, pingStatus );
+    }
+
+    while( ( status == RTIOSuccess ) && timerWheel_PopExpired( &( pContext->timerWheel ), nowMs, &id, &tag ) )
+    {
+        pingStatus = RTIOSuccess;
+        if( id == RTIO_TIMER_ID_PING( pContext ) )
+        {
+            pingStatus = keepAlive_Ping( pContext, pKeepAlive, nowMs );
+        }
+        else if( id == RTIO_TIMER_ID_RECONNECT( pContext ) )
+        {
+            status = keepAlive_Reconnect( pContext, pKeepAlive );
+        }
+        else if( id == RTIO_TIMER_ID_RX_IDLE( pContext ) )
+        {
+            keepAlive_RxIdle( pContext, nowMs );
+        }
+        else if( ( id == pKeepAlive->pingIndex ) && ( tag == pKeepAlive->pingHeaderId ) )
+        {
+            pingStatus = keepAlive_PingDone( pContext, pKeepAlive, true );
+        }
+        else
+        {
+            if( deviceSendRespList_ExpireAsync( &( pContext->deviceSendRespList ), id, tag, RTIOTimeout ) )
+            {
+                rtt_Backoff( &( pContext->rtt ) );
+            }
+        }
+
+        if( pingStatus != RTIOSuccess )
+        {
+            keepAlive_PingFailed( pContext, pingStatus );
+        }
+    }
+    return status;
+}
+
+static void keepAlive_Stop( RTIOContext_t* pContext )
+{
+    uint16_t i = 0;
+
+    if( pContext->keepAlive.pingIndex != RTIO_RESP_LIST_END )
+    {
+        (void)deviceSendRespList_Delete( &( pContext->deviceSendRespList ), pContext->keepAlive.pingIndex,
+                                         pContext->keepAlive.pingHeaderId );
+        pContext->keepAlive.pingIndex = RTIO_RESP_LIST_END;
+    }
+    /* No response will arrive any more, complete the pending asynchronous requests. */
+    for( i = 0; i < pContext->deviceSendRespList.size; i++ )
+    {
+        (void)deviceSendRespList_ExpireAsync( &( pContext->deviceSendRespList ), i, 0, RTIOTimeout );
+    }
+}
+
+/* Runs the timer wheel until the service is done or reconnecting stopped. */
+static void keepAliveProccess( void* pContext )
+{
+    RTIOContext_t* pRTIOContext = (RTIOContext_t*)pContext;
+    rtioTimerWheel_t* pWheel = NULL;
+    RTIOStatus_t status = RTIOSuccess;
+    OSError_t osRet = OSUnknown;
+
+    if( pContext == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
+        return;
+    }
+    pWheel = &( pRTIOContext->timerWheel );
+    LogInfo( ( "Keep alive proccess started, heartbeatMs=%u.", (unsigned)pRTIOContext->heartbeatMs ) );
+
+    keepAlive_Start( pRTIOContext );
+    while( ( pRTIOContext->serviceDone == false ) && ( status == RTIOSuccess ) )
+    {
+        status = keepAlive_RunTimers( pRTIOContext, OS_ClockGetTimeMs() );
+        if( status == RTIOSuccess )
+        {
+            (void)OS_EventWait( pWheel->pEvent, timerWheel_NextWaitMs( pWheel, OS_ClockGetTimeMs() ) );
+        }
+    }
+    keepAlive_Stop( pRTIOContext );
+
+    LogInfo( ( "KeepAlive proccess stopped with status=%d.", status ) );
+    if ( status != RTIOSuccess && 
+         ( (RTIOContext_t*)pContext )->serveFailedHandler != NULL )
+    {
+        ( (RTIOContext_t*)pContext )->serveFailedHandler();
+    }
+
+    serve_ThreadStopped( pRTIOContext );
+    osRet =  OS_ThreadDestroy( ( (RTIOContext_t*)pContext )->pThreadKeepAlive );
+    if( osRet != OSSuccess )
+    {
+        LogError( ( "Failed to destroy pThreadKeepAlive, ret=%d.", osRet ) );
+    }
+    // else
+    // {
+    //     ( (RTIOContext_t*)pContext )->pThreadKeepAlive = NULL;
+    // }
+   
+}
+
+
+/*-----------------------------------------------------------*/
+
+RTIOStatus_t rtioInit( RTIOContext_t* pContext,
+                       const RTIOContextFixedResource_t* pFixedResource,
+                       const TransportInterface_t* pTransportInterface,
+                       const TransportOption_t* pTransportOption,
+                       const ServerInfo_t* pServerInfo,
+                       const RTIODeviceInfo_t* pDeviceInfo )
+{
+    uint16_t i = 0;
+
+    /* check pContext */
+    if( pContext == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
+        return RTIOBadParameter;
+    }
+    /* check pFixedResource  */
+    if( pFixedResource == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pFixedResource=%p.", (void*)pFixedResource ) );
+        return RTIOBadParameter;
+    }
+
+    if( pFixedResource->networkIncommingBuffer.pBuffer == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: networkIncommingBuffer=%p.", (void*)pFixedResource->networkIncommingBuffer.pBuffer ) );
+        return RTIOBadParameter;
+    }
+    if( pFixedResource->networkIncommingBuffer.size < RTIO_PROTOCAL_HEADER_LEN + RTIO_TRANSFER_FRAME_BUF_SIZE )
+    {
+        LogError( ( "Argument error: networkIncommingBuffer.size=%u, a frame does not fit.", pFixedResource->networkIncommingBuffer.size ) );
+        return RTIOBadParameter;
+    }
+    if( pFixedResource->networkOutgoingBuffer.pBuffer == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: networkOutgoingBuffer=%p.", (void*)pFixedResource->networkOutgoingBuffer.pBuffer ) );
+        return RTIOBadParameter;
+    }
+    if( pFixedResource->serverSendRespBuffer.pBuffer == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: serverSendRespBuffer=%p.", (void*)pFixedResource->serverSendRespBuffer.pBuffer ) );
+        return RTIOBadParameter;
+    }
+
+    if( pFixedResource->pThreadIncomming == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pThreadIncomming=%p.", (void*)pFixedResource->pThreadIncomming ) );
+        return RTIOBadParameter;
+    }
+
+    if( pFixedResource->pThreadKeepAlive == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pThreadKeepAlive=%p.", (void*)pFixedResource->pThreadKeepAlive ) );
+        return RTIOBadParameter;
+    }
+    if( pFixedResource->pRollingHeaderIdLock == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pRollingHeaderIdLock=%p.", (void*)pFixedResource->pRollingHeaderIdLock ) );
+    }
+    if( pFixedResource->pSendMessageLock == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pSendMessageLock=%p.", (void*)pFixedResource->pSendMessageLock ) );
+    }
+    if( pFixedResource->pRecvMessageLock == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pRecvMessageLock=%p.", (void*)pFixedResource->pRecvMessageLock ) );
+    }
+    if( pFixedResource->pConnectionStatusLock == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pConnectionStatusLock=%p.", (void*)pFixedResource->pConnectionStatusLock ) );
+    }
+    if( pFixedResource->pNetworkOutgoingBufferLock == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pNetworkOutgoingBufferLock=%p.", (void*)pFixedResource->pNetworkOutgoingBufferLock ) );
+    }
+    if( pFixedResource->rtt.pLock == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: rtt.pLock=%p.", (void*)pFixedResource->rtt.pLock ) );
+    }
+    if( ( pFixedResource->sendQueue.size > 0U ) &&
+        ( ( pFixedResource->pThreadWriter == NULL ) ||
+          ( pFixedResource->sendQueue.pFrames == NULL ) ||
+          ( pFixedResource->sendQueue.pLock == NULL ) ||
+          ( pFixedResource->sendQueue.pWriterEvent == NULL ) ||
+          ( pFixedResource->sendQueue.pSpaceEvent == NULL ) ) )
+    {
+        LogError( ( "Argument cannot be NULL: pThreadWriter=%p, sendQueue.pFrames=%p.",
+                    (void*)pFixedResource->pThreadWriter, (void*)pFixedResource->sendQueue.pFrames ) );
+        return RTIOBadParameter;
+    }
+    if( ( pFixedResource->sendQueue.size > 0U ) &&
+        ( pFixedResource->sendQueue.size <= ( RTIO_SEND_LANE_NUM - 1U ) * RTIO_SEND_QUEUE_LANE_RESERVE ) )
+    {
+        LogError( ( "Send queue leaves no frame to notifications, size=%u, laneReserve=%u.",
+                    pFixedResource->sendQueue.size, RTIO_SEND_QUEUE_LANE_RESERVE ) );
+        return RTIOBadParameter;
+    }
+    if( ( pFixedResource->offlineQueue.size > 0U ) &&
+        ( ( pFixedResource->offlineQueue.pItems == NULL ) ||
+          ( pFixedResource->offlineQueue.pLock == NULL ) ||
+          ( pFixedResource->networkOutgoingBuffer.size < RTIO_TRANSFER_FRAME_BUF_SIZE ) ) )
+    {
+        LogError( ( "Argument error: offlineQueue.pItems=%p, networkOutgoingBuffer.size=%u, a held request may not fit.",
+                    (void*)pFixedResource->offlineQueue.pItems, pFixedResource->networkOutgoingBuffer.size ) );
+        return RTIOBadParameter;
+    }
+    if( ( pFixedResource->handlerPool.workerNum > 0U ) &&
+        ( ( pFixedResource->handlerPool.size == 0U ) ||
+          ( pFixedResource->handlerPool.pJobs == NULL ) ||
+          ( pFixedResource->handlerPool.pWorkers == NULL ) ||
+          ( pFixedResource->handlerPool.pThreads == NULL ) ||
+          ( pFixedResource->handlerPool.pLock == NULL ) ||
+          ( pFixedResource->handlerPool.pJobEvent == NULL ) ) )
+    {
+        LogError( ( "Argument cannot be NULL: handlerPool.pJobs=%p, handlerPool.size=%u.",
+                    (void*)pFixedResource->handlerPool.pJobs, pFixedResource->handlerPool.size ) );
+        return RTIOBadParameter;
+    }
+    if( ( pFixedResource->timerWheel.pTimers == NULL ) ||
+        ( pFixedResource->timerWheel.pSlots == NULL ) ||
+        ( pFixedResource->timerWheel.pLock == NULL ) ||
+        ( pFixedResource->timerWheel.pEvent == NULL ) ||
+        ( pFixedResource->timerWheel.size < pFixedResource->deviceSendRespList.size + RTIO_TIMER_FIXED_NUM ) )
+    {
+        LogError( ( "Argument cannot be NULL: timerWheel.pTimers=%p, timerWheel.size=%u.",
+                    (void*)pFixedResource->timerWheel.pTimers, pFixedResource->timerWheel.size ) );
+        return RTIOBadParameter;
+    }
+    if( pFixedResource->coPostUriList.pList == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pCoPostUriList=%p.", (void*)pFixedResource->coPostUriList.pList ) );
+    }
+    if( pFixedResource->obGetUriList.pList == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pObGetUriList=%p.", (void*)pFixedResource->obGetUriList.pList ) );
+    }
+    if( pFixedResource->deviceSendRespList.pList == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pDeviceSendRespList=%p.", (void*)pFixedResource->deviceSendRespList.pList ) );
+    }
+    if( ( pFixedResource->deviceSendRespList.pEvents == NULL ) ||
+        ( pFixedResource->deviceSendRespList.eventSize == 0 ) )
+    {
+        LogError( ( "Argument cannot be NULL: pDeviceSendRespEvents=%p.", (void*)pFixedResource->deviceSendRespList.pEvents ) );
+        return RTIOBadParameter;
+    }
+    /* check pTransportInterface  */
+    if( pTransportInterface == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pTransportInterface=%p.", (void*)pTransportInterface ) );
+        return RTIOBadParameter;
+    }
+    if( pTransportInterface->pNetworkContext == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pTransportInterface->pNetworkContext=%p.", (void*)pTransportInterface->pNetworkContext ) );
+        return RTIOBadParameter;
+    }
+    if( pTransportInterface->disconnect == NULL )
+    {
+        LogError( ( "Invalid parameter: pTransportInterface->disconnect is NULL" ) );
+        return RTIOBadParameter;
+    }
+    if( pTransportInterface->connect == NULL )
+    {
+        LogError( ( "Invalid parameter: pTransportInterface->connect is NULL" ) );
+        return RTIOBadParameter;
+    }
+    if( pTransportInterface->recv == NULL )
+    {
+        LogError( ( "Invalid parameter: pTransportInterface->recv is NULL" ) );
+        return RTIOBadParameter;
+    }
+    if( pTransportInterface->send == NULL )
+    {
+        LogError( ( "Invalid parameter: pTransportInterface->send is NULL" ) );
+        return RTIOBadParameter;
+    }
+    /* check pTransportOptions, tls required */
+    if( pTransportOption == NULL )
+    {
+        LogWarn( ( "Invalid parameter: pTransportOption is NULL" ) );
+    }
+    /* check pServerInfo and  pDeviceInfo */
+    if( pServerInfo == NULL )
+    {
+        LogError( ( "Invalid parameter: pServerInfo is NULL" ) );
+        return RTIOBadParameter;
+    }
+    if( pDeviceInfo == NULL )
+    {
+        LogError( ( "Invalid parameter: pDeviceInfo is NULL" ) );
+        return RTIOBadParameter;
+    }
+
+    pContext->networkIncommingBuffer = pFixedResource->networkIncommingBuffer;
+    pContext->networkOutgoingBuffer = pFixedResource->networkOutgoingBuffer;
+    pContext->serverSendRespBuffer = pFixedResource->serverSendRespBuffer;
+    pContext->coPostInfoList = pFixedResource->coPostUriList;
+    pContext->obGetInfoList = pFixedResource->obGetUriList;
+    pContext->deviceSendRespList = pFixedResource->deviceSendRespList;
+    deviceSendRespList_Init( &( pContext->deviceSendRespList ) );
+    pContext->pRollingHeaderIdLock = pFixedResource->pRollingHeaderIdLock;
+    pContext->pSendMessageLock = pFixedResource->pSendMessageLock;
+    pContext->pRecvMessageLock = pFixedResource->pRecvMessageLock;
+    pContext->pNetworkOutgoingBufferLock = pFixedResource->pNetworkOutgoingBufferLock;
+    pContext->pThreadIncomming = pFixedResource->pThreadIncomming;
+    pContext->pThreadKeepAlive = pFixedResource->pThreadKeepAlive;
+    pContext->pThreadWriter = pFixedResource->pThreadWriter;
+    pContext->sendQueue = pFixedResource->sendQueue;
+    sendQueue_Init( &( pContext->sendQueue ) );
+    pContext->offlineQueue = pFixedResource->offlineQueue;
+    offlineQueue_Init( &( pContext->offlineQueue ) );
+    pContext->handlerPool = pFixedResource->handlerPool;
+    handlerPool_Init( &( pContext->handlerPool ), pContext );
+    pContext->timerWheel = pFixedResource->timerWheel;
+    timerWheel_Init( &( pContext->timerWheel ) );
+    pContext->rtt = pFixedResource->rtt;
+    rtt_Init( &( pContext->rtt ) );
+    pContext->connectStatus = RTIOConnectInit;
+    pContext->connectCount = 0;
+    pContext->eventDriven = false;
+    pContext->keepAlive.pingIndex = RTIO_RESP_LIST_END;
+    pContext->pConnectionStatusLock = pFixedResource->pConnectionStatusLock;
+    pContext->pThreadExitEvent = pFixedResource->pThreadExitEvent;
+    pContext->threadsRunning = 0;
+    if( pContext->heartbeatMs != 0 )
+    {
+        LogInfo( ( "Heartbeat interval is not default, heartbeatMs=%u.", (unsigned)pContext->heartbeatMs ) );
+    }
+    else
+    {
+        pContext->heartbeatMs = RTIO_PING_INTERVAL_MS_INIT;
+    }
+    pContext->transportInterface = *pTransportInterface;
+    pContext->pTransportOption = pTransportOption;
+    pContext->pServerInfo = pServerInfo;
+    pContext->pDeviceInfo = pDeviceInfo;
+
+    if( OS_MutexCreate( pContext->pRollingHeaderIdLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create rollingHeaderIdLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_MutexCreate( pContext->pSendMessageLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create sendMessageLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_MutexCreate( pContext->pRecvMessageLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create recvMessageLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_MutexCreate( pContext->pNetworkOutgoingBufferLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create networkOutgoingBufferLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_MutexCreate( pContext->deviceSendRespList.pLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create deviceSendRespListLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_MutexCreate( pContext->pConnectionStatusLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create pConnectionStatusLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_MutexCreate( pContext->rtt.pLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create rtt.pLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_EventCreate( pContext->pThreadExitEvent ) != OSSuccess )
+    {
+        LogError( ( "Failed to create pThreadExitEvent." ) );
+        return RTIOMutexFailure;
+    }
+    for( i = 0; i < pContext->deviceSendRespList.size; i++ )
+    {
+        if( OS_EventCreate( deviceSendRespList_Event( &( pContext->deviceSendRespList ), i ) ) != OSSuccess )
+        {
+            LogError( ( "Failed to create deviceSendRespList.pEvents[%u].", i ) );
+            return RTIOMutexFailure;
+        }
+    }
+    if( pContext->sendQueue.size > 0U )
+    {
+        if( OS_MutexCreate( pContext->sendQueue.pLock ) != OSSuccess )
+        {
+            LogError( ( "Failed to create sendQueue.pLock." ) );
+            return RTIOMutexFailure;
+        }
+        if( ( OS_EventCreate( pContext->sendQueue.pWriterEvent ) != OSSuccess ) ||
+            ( OS_EventCreate( pContext->sendQueue.pSpaceEvent ) != OSSuccess ) )
+        {
+            LogError( ( "Failed to create sendQueue events." ) );
+            return RTIOMutexFailure;
+        }
+    }
+    if( ( pContext->offlineQueue.size > 0U ) &&
+        ( OS_MutexCreate( pContext->offlineQueue.pLock ) != OSSuccess ) )
+    {
+        LogError( ( "Failed to create offlineQueue.pLock." ) );
+        return RTIOMutexFailure;
+    }
+    if( ( OS_MutexCreate( pContext->timerWheel.pLock ) != OSSuccess ) ||
+        ( OS_EventCreate( pContext->timerWheel.pEvent ) != OSSuccess ) )
+    {
+        LogError( ( "Failed to create timerWheel lock or event." ) );
+        return RTIOMutexFailure;
+    }
+    if( pContext->handlerPool.workerNum > 0U )
+    {
+        if( OS_MutexCreate( pContext->handlerPool.pLock ) != OSSuccess )
+        {
+            LogError( ( "Failed to create handlerPool.pLock." ) );
+            return RTIOMutexFailure;
+        }
+        if( OS_EventCreate( pContext->handlerPool.pJobEvent ) != OSSuccess )
+        {
+            LogError( ( "Failed to create handlerPool.pJobEvent." ) );
+            return RTIOMutexFailure;
+        }
+    }
+
+    srand( (int)OS_ClockGetTimeMs() );
+
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_Connect( RTIOContext_t* pContext,
+                           const RTIOContextFixedResource_t* pFixedResource,
+                           const TransportInterface_t* pTransportInterface,
+                           const TransportOption_t* pTransportOption,
+                           const ServerInfo_t* pServerInfo,
+                           const RTIODeviceInfo_t* pDeviceInfo )
+{
+    RTIOStatus_t status = RTIOUnknown;
+
+    status = rtioInit( pContext, pFixedResource,
+                       pTransportInterface, pTransportOption, pServerInfo, pDeviceInfo );
+    if( RTIOSuccess != status )
+    {
+        return status;
+    }
+
+    connectStatus_ChangeWhenEventConnect( pContext );
+
+    status = connectWithBackoffAlgorithm( pContext );
+    if( RTIOSuccess == status )
+    {
+        connectStatus_ChangeWhenEventConnectSuccess( pContext );
+    }
+    else
+    {
+        LogError( ( "Reconnect stoped, status=%d.", status ) );
+        connectStatus_ChangeWhenEventDisconnect( pContext );
+    }
+    return status;
+}
+
+RTIOStatus_t RTIO_Disconnect( RTIOContext_t* pContext )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    TransportStatus_t transportStatus = TransportUnknown;
+    uint16_t i = 0;
+
+    if( ( pContext == NULL ) ||
+        ( pContext->transportInterface.disconnect == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, "
+                    "transportInterface.disconnect=%p.",
+                    (void*)pContext,
+                    (void*)pContext->transportInterface.disconnect ) );
+
+        return RTIOBadParameter;
+    }
+
+    LogInfo( ( "Disconnect..." ) );
+
+    /* thread destroy */
+    pContext->serviceDone = true;
+    if( pContext->eventDriven )
+    {
+        /* No threads, the event loop stopped handling the context before. */
+        keepAlive_Stop( pContext );
+    }
+    else
+    {
+        /* Threads blocked in a send see serviceDone once it timed out. */
+        (void)OS_EventSignal( pContext->timerWheel.pEvent );
+        if( pContext->sendQueue.size > 0U )
+        {
+            (void)OS_EventSignal( pContext->sendQueue.pWriterEvent );
+        }
+        if( pContext->handlerPool.workerNum > 0U )
+        {
+            (void)OS_EventSignal( pContext->handlerPool.pJobEvent );
+        }
+        if( !serve_JoinThreads( pContext, RTIO_SEND_TIMEOUT_MS + 1000U ) )
+        {
+            LogWarn( ( "Threads are still running, threadsRunning=%u.", serve_ThreadsRunning( pContext ) ) );
+        }
+    }
+ 
+    /* transport destroy */
+    connectStatus_ChangeWhenEventDisconnect( pContext );
+    transportStatus = pContext->transportInterface.disconnect( pContext->transportInterface.pNetworkContext );
+    if( transportStatus == TransportSuccess )
+    {
+        connectStatus_ChangeWhenEventDisconnectSuccess( pContext );
+    }
+    else
+    {
+        LogError( ( "Failed to disconnect" ) );
+        status = RTIODisconnectFailed;
+    }
+
+    /* mutex destroy */
+    if( OS_MutexDestroy( pContext->pRollingHeaderIdLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to destroy rollingHeaderIdLock." ) );
+    }
+    if( OS_MutexDestroy( pContext->pSendMessageLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to destroy pSendMessageLock." ) );
+    }
+    if( OS_MutexDestroy( pContext->pRecvMessageLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to destroy pRecvMessageLock." ) );
+    }
+    if( OS_MutexDestroy( pContext->pNetworkOutgoingBufferLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to destroy pNetworkOutgoingBufferLock." ) );
+    }
+    if( OS_MutexDestroy( pContext->deviceSendRespList.pLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to destroy deviceSendRespList.pLock." ) );
+    }
+    if( OS_MutexDestroy( pContext->pConnectionStatusLock ) != OSSuccess )
     {
-        LogError( ( "Argument cannot be NULL: pRollingHeaderIdLock=%p.", (void*)pFixedResource->pRollingHeaderIdLock ) );
+        LogError( ( "Failed to destroy pConnectionStatusLock." ) );
     }
-    if( pFixedResource->pSendMessageLock == NULL )
+    if( OS_MutexDestroy( pContext->rtt.pLock ) != OSSuccess )
     {
-        LogError( ( "Argument cannot be NULL: pSendMessageLock=%p.", (void*)pFixedResource->pSendMessageLock ) );
+        LogError( ( "Failed to destroy rtt.pLock." ) );
     }
-    if( pFixedResource->pRecvMessageLock == NULL )
+    if( OS_EventDestroy( pContext->pThreadExitEvent ) != OSSuccess )
     {
-        LogError( ( "Argument cannot be NULL: pRecvMessageLock=%p.", (void*)pFixedResource->pRecvMessageLock ) );
+        LogError( ( "Failed to destroy pThreadExitEvent." ) );
     }
-    if( pFixedResource->pConnectionStatusLock == NULL )
+    for( i = 0; i < pContext->deviceSendRespList.size; i++ )
     {
-        LogError( ( "Argument cannot be NULL: pConnectionStatusLock=%p.", (void*)pFixedResource->pConnectionStatusLock ) );
+        if( OS_EventDestroy( deviceSendRespList_Event( &( pContext->deviceSendRespList ), i ) ) != OSSuccess )
+        {
+            LogError( ( "Failed to destroy deviceSendRespList.pEvents[%u].", i ) );
+        }
     }
-    if( pFixedResource->pNetworkOutgoingBufferLock == NULL )
+    if( pContext->sendQueue.size > 0U )
     {
-        LogError( ( "Argument cannot be NULL: pNetworkOutgoingBufferLock=%p.", (void*)pFixedResource->pNetworkOutgoingBufferLock ) );
+        if( OS_MutexDestroy( pContext->sendQueue.pLock ) != OSSuccess )
+        {
+            LogError( ( "Failed to destroy sendQueue.pLock." ) );
+        }
+        if( ( OS_EventDestroy( pContext->sendQueue.pWriterEvent ) != OSSuccess ) ||
+            ( OS_EventDestroy( pContext->sendQueue.pSpaceEvent ) != OSSuccess ) )
+        {
+            LogError( ( "Failed to destroy sendQueue events." ) );
+        }
     }
-    if( pFixedResource->coPostUriList.pList == NULL )
+    if( ( pContext->offlineQueue.size > 0U ) &&
+        ( OS_MutexDestroy( pContext->offlineQueue.pLock ) != OSSuccess ) )
     {
-        LogError( ( "Argument cannot be NULL: pCoPostUriList=%p.", (void*)pFixedResource->coPostUriList.pList ) );
+        LogError( ( "Failed to destroy offlineQueue.pLock." ) );
     }
-    if( pFixedResource->obGetUriList.pList == NULL )
+    if( ( OS_MutexDestroy( pContext->timerWheel.pLock ) != OSSuccess ) ||
+        ( OS_EventDestroy( pContext->timerWheel.pEvent ) != OSSuccess ) )
     {
-        LogError( ( "Argument cannot be NULL: pObGetUriList=%p.", (void*)pFixedResource->obGetUriList.pList ) );
+        LogError( ( "Failed to destroy timerWheel lock or event." ) );
     }
-    if( pFixedResource->deviceSendRespList.pList == NULL )
+    if( pContext->handlerPool.workerNum > 0U )
     {
-        LogError( ( "Argument cannot be NULL: pDeviceSendRespList=%p.", (void*)pFixedResource->deviceSendRespList.pList ) );
+        if( OS_MutexDestroy( pContext->handlerPool.pLock ) != OSSuccess )
+        {
+            LogError( ( "Failed to destroy handlerPool.pLock." ) );
+        }
+        if( OS_EventDestroy( pContext->handlerPool.pJobEvent ) != OSSuccess )
+        {
+            LogError( ( "Failed to destroy handlerPool.pJobEvent." ) );
+        }
     }
-    /* check pTransportInterface  */
-    if( pTransportInterface == NULL )
+    return status;
+}
+
+RTIOStatus_t RTIO_RegisterCoPostHandler( const RTIOContext_t* pContext,
+                                         const char* pUri, RTIOCoPostHandler_t handler )
+{
+    uint32_t uri = 0;
+    uint16_t length = 0;
+    if( ( pContext == NULL ) || ( handler == NULL ) )
     {
-        LogError( ( "Argument cannot be NULL: pTransportInterface=%p.", (void*)pTransportInterface ) );
+        LogError( ( "Argument cannot be NULL: pContext=%p, handler=%p.", (void*)pContext, (void*)handler ) );
         return RTIOBadParameter;
     }
-    if( pTransportInterface->pNetworkContext == NULL )
+    if( pUri == NULL )
     {
-        LogError( ( "Argument cannot be NULL: pTransportInterface->pNetworkContext=%p.", (void*)pTransportInterface->pNetworkContext ) );
+        LogError( ( "Argument cannot be NULL: pUri=%p.", (void*)pUri ) );
         return RTIOBadParameter;
     }
-    if( pTransportInterface->disconnect == NULL )
+    length = (uint16_t)strlen( pUri );
+    if( ( length < RTIO_URI_STRING_LENGTH_MIN ) || ( length > RTIO_URI_STRING_LENGTH_MAX ) )
     {
-        LogError( ( "Invalid parameter: pTransportInterface->disconnect is NULL" ) );
+        LogError( ( "Argument error: uri length=%u.", length ) );
         return RTIOBadParameter;
     }
-    if( pTransportInterface->connect == NULL )
+
+    uri = crc32Ieee( (uint8_t*)pUri, length );
+    LogInfo( ( "Register pUri=%s, digest=%u, digestHex=0x%x.", pUri, (unsigned)uri, (unsigned)uri ) );
+
+    return RTIO_RegisterCoPostHandlerWithDigest( pContext, uri, handler );
+}
+
+RTIOStatus_t RTIO_RegisterCoPostHandlerWithDigest( const RTIOContext_t* pContext,
+                                                   uint32_t uri, RTIOCoPostHandler_t handler )
+{
+    RTIOCoPostUri_t* pEntry = NULL;
+    if( ( pContext == NULL ) || ( handler == NULL ) )
     {
-        LogError( ( "Invalid parameter: pTransportInterface->connect is NULL" ) );
+        LogError( ( "Argument cannot be NULL: pContext=%p, handler=%p.", (void*)pContext, (void*)handler ) );
         return RTIOBadParameter;
     }
-    if( pTransportInterface->recv == NULL )
+    if( uri == 0 )
     {
-        LogError( ( "Invalid parameter: pTransportInterface->recv is NULL" ) );
+        /* 0 marks a free entry of the list. */
+        LogError( ( "Argument error: uri digest=0." ) );
         return RTIOBadParameter;
     }
-    if( pTransportInterface->send == NULL )
+
+    pEntry = coPostUriList_Probe( &( pContext->coPostInfoList ), uri );
+    if( pEntry == NULL )
     {
-        LogError( ( "Invalid parameter: pTransportInterface->send is NULL" ) );
-        return RTIOBadParameter;
+        return RTIOListFull;
     }
-    /* check pTransportOptions, tls required */
-    if( pTransportOption == NULL )
+    if( pEntry->uri == uri )
     {
-        LogWarn( ( "Invalid parameter: pTransportOption is NULL" ) );
+        LogWarn( ( "Handler of digest=%u is replaced.", (unsigned)uri ) );
     }
-    /* check pServerInfo and  pDeviceInfo */
-    if( pServerInfo == NULL )
+    LogDebug( ( "List[%u].uri=%u.", (unsigned)( pEntry - pContext->coPostInfoList.pList ), (unsigned)uri ) );
+    pEntry->uri = uri;
+    pEntry->handler = handler;
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_RegisterCoPostHandlers( const RTIOContext_t* pContext,
+                                          const RTIOCoPostUri_t* pTable, uint16_t count )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t i = 0;
+    if( ( pTable == NULL ) && ( count > 0 ) )
     {
-        LogError( ( "Invalid parameter: pServerInfo is NULL" ) );
+        LogError( ( "Argument cannot be NULL: pTable=%p, count=%u.", (void*)pTable, count ) );
         return RTIOBadParameter;
     }
-    if( pDeviceInfo == NULL )
+
+    for( i = 0; ( i < count ) && ( status == RTIOSuccess ); ++i )
     {
-        LogError( ( "Invalid parameter: pDeviceInfo is NULL" ) );
-        return RTIOBadParameter;
+        status = RTIO_RegisterCoPostHandlerWithDigest( pContext, pTable[ i ].uri, pTable[ i ].handler );
     }
+    return status;
+}
 
-    pContext->networkIncommingBuffer = pFixedResource->networkIncommingBuffer;
-    pContext->networkOutgoingBuffer = pFixedResource->networkOutgoingBuffer;
-    pContext->serverSendRespBuffer = pFixedResource->serverSendRespBuffer;
-    pContext->coPostInfoList = pFixedResource->coPostUriList;
-    pContext->obGetInfoList = pFixedResource->obGetUriList;
-    pContext->deviceSendRespList = pFixedResource->deviceSendRespList;
-    pContext->pRollingHeaderIdLock = pFixedResource->pRollingHeaderIdLock;
-    pContext->pSendMessageLock = pFixedResource->pSendMessageLock;
-    pContext->pRecvMessageLock = pFixedResource->pRecvMessageLock;
-    pContext->pNetworkOutgoingBufferLock = pFixedResource->pNetworkOutgoingBufferLock;
-    pContext->pThreadIncomming = pFixedResource->pThreadIncomming;
-    pContext->pThreadKeepAlive = pFixedResource->pThreadKeepAlive;
-    pContext->connectStatus = RTIOConnectInit;
-    pContext->pConnectionStatusLock = pFixedResource->pConnectionStatusLock;
-    if( pContext->heartbeatMs != 0 )
+/* Sends a device request, or holds it while reconnecting until timeoutMs, see requestFrame_Begin. */
+static RTIOStatus_t sendCoReq( RTIOContext_t* pContext, const RTIOCoReq_t* pCoReq, uint32_t timeoutMs )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t serianlizeLength = 0;
+    rtioOutgoingFrame_t frame = { 0 };
+
+    status = requestFrame_Begin( pContext, &frame, RTIO_SEND_LANE_REQUEST, pCoReq->headerId, timeoutMs );
+    if( status != RTIOSuccess )
     {
-        LogInfo( ( "Heartbeat interval is not default, heartbeatMs=%u.", (unsigned)pContext->heartbeatMs ) );
+        LogError( ( "Failed to get outgoing frame, status=%d.", status ) );
+        return status;
+    }
+
+    status = RTIO_SerializeCoReqHeader_OverDeviceSendReq( pCoReq, &( frame.buffer ), &serianlizeLength );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to SerializeCoReq, status=%d.", status ) );
+        (void)requestFrame_End( pContext, &frame, 0, NULL, 0 );
     }
     else
     {
-        pContext->heartbeatMs = RTIO_PING_INTERVAL_MS_INIT;
+        status = requestFrame_End( pContext, &frame, serianlizeLength,
+                                   pCoReq->pData, pCoReq->dataLength );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to send CoReq, status=%d.", status ) );
+        }
     }
-    pContext->transportInterface = *pTransportInterface;
-    pContext->pTransportOption = pTransportOption;
-    pContext->pServerInfo = pServerInfo;
-    pContext->pDeviceInfo = pDeviceInfo;
+    return status;
+}
 
-    if( OS_MutexCreate( pContext->pRollingHeaderIdLock ) != OSSuccess )
+static RTIOStatus_t sendObNotifyReq( RTIOContext_t* pContext, const RTIOObNotifyReq_t* pReq, uint32_t timeoutMs )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t serianlizeLength = 0;
+    rtioOutgoingFrame_t frame = { 0 };
+
+    status = requestFrame_Begin( pContext, &frame, RTIO_SEND_LANE_BULK, pReq->headerId, timeoutMs );
+    if( status != RTIOSuccess )
     {
-        LogError( ( "Failed to create rollingHeaderIdLock." ) );
-        return RTIOMutexFailure;
+        LogError( ( "Failed to get outgoing frame, status=%d.", status ) );
+        return status;
     }
-    if( OS_MutexCreate( pContext->pSendMessageLock ) != OSSuccess )
+
+    status = RTIO_SerializeObNotifyReqHeader_OverDeviceSendReq( pReq, &( frame.buffer ), &serianlizeLength );
+    if( status != RTIOSuccess )
     {
-        LogError( ( "Failed to create sendMessageLock." ) );
-        return RTIOMutexFailure;
+        LogError( ( "Failed to SerializeObNotifyReq, status=%d.", status ) );
+        (void)requestFrame_End( pContext, &frame, 0, NULL, 0 );
     }
-    if( OS_MutexCreate( pContext->pRecvMessageLock ) != OSSuccess )
+    else
     {
-        LogError( ( "Failed to create recvMessageLock." ) );
-        return RTIOMutexFailure;
+        status = requestFrame_End( pContext, &frame, serianlizeLength,
+                                   pReq->pData, pReq->dataLength );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to send ObNotifyReq, status=%d.", status ) );
+        }
     }
-    if( OS_MutexCreate( pContext->pNetworkOutgoingBufferLock ) != OSSuccess )
+    return status;
+}
+
+/* Sends an ObNotify without waiting, obNotify_Collect waits for its response and frees the item. */
+/* RTIO_TIMEOUT_AUTO in pTimeoutMs is resolved for the collect. */
+static RTIOStatus_t obNotify_Send( RTIOContext_t* pContext,
+                                   uint8_t* pData, uint16_t length,
+                                   uint16_t obId,
+                                   uint32_t* pTimeoutMs,
+                                   RTIOFixedBuffer_t* pRespBuffer,
+                                   uint16_t* pRespIndex,
+                                   uint16_t* pHeaderId )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOObNotifyReq_t req = { 0 };
+
+    *pRespIndex = UINT16_MAX;
+    req.method = RTIO_REST_OBGET;
+    req.code = RTIO_REST_STATUS_CONTINUE;
+    req.obId = obId;
+    req.pData = pData;
+    req.dataLength = length;
+
+    status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
+                                     pRespBuffer,
+                                     &req.headerId,
+                                     pRespIndex );
+    if( status != RTIOSuccess )
     {
-        LogError( ( "Failed to create networkOutgoingBufferLock." ) );
-        return RTIOMutexFailure;
+        LogError( ( "Failed to deviceSendRespListAdd, status=%d, headerid=%u.", status, req.headerId) );
+        *pRespIndex = UINT16_MAX;
+        return status;
     }
-    if( OS_MutexCreate( pContext->deviceSendRespList.pLock ) != OSSuccess )
+
+    *pHeaderId = req.headerId;
+    *pTimeoutMs = rtt_TimeoutMs( pContext, *pRespIndex, *pTimeoutMs );
+    status = sendObNotifyReq( pContext, &req, *pTimeoutMs );
+    if( status != RTIOSuccess )
     {
-        LogError( ( "Failed to create deviceSendRespListLock." ) );
-        return RTIOMutexFailure;
+        (void)deviceSendRespList_Delete( &( pContext->deviceSendRespList ), *pRespIndex, req.headerId );
+        *pRespIndex = UINT16_MAX;
     }
-    if( OS_MutexCreate( pContext->pConnectionStatusLock ) != OSSuccess )
+    return status;
+}
+
+static RTIOStatus_t obNotify_Collect( RTIOContext_t* pContext, uint16_t respIndex, uint16_t headerId, uint32_t timeoutMs )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    rtioDeviceSendResp_t* pDeviceSendResp = NULL;
+    RTIOObNotifyResp_t resp = { 0 };
+
+    /* The timeout counts from when the item was added, so collecting a batch in turn waits once. */
+    status = deviceSendRespList_Wait( &( pContext->deviceSendRespList ), respIndex, timeoutMs );
+    if( status == RTIOTimeout )
     {
-        LogError( ( "Failed to create pConnectionStatusLock." ) );
-        return RTIOMutexFailure;
+        rtt_TimedOut( pContext, respIndex );
+    }
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to wait ObNotifyResp, status=%d.", status ) );
+    }
+    else
+    {
+        status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), respIndex, &pDeviceSendResp );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to deviceSendRespList_GetResp, status=%d.", status ) );
+        }
+        else
+        {
+            status = RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( pDeviceSendResp, &resp );
+            if( status != RTIOSuccess )
+            {
+                LogError( ( "Failed to RTIO_DeSerializeObNotifyResp_FromDeviceSendResp, status=%d.", status ) );
+            }
+        }
     }
 
-    srand( (int)OS_ClockGetTimeMs() );
+    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex, headerId ) != RTIOSuccess )
+    {
+        LogError( ( "Failed to deviceSendRespListDelete." ) );
+    }
 
-    return RTIOSuccess;
+    if( status == RTIOSuccess )
+    {
+        status = transRestStatus( resp.code );
+    }
+    return status;
 }
 
-RTIOStatus_t RTIO_Connect( RTIOContext_t* pContext,
-                           const RTIOContextFixedResource_t* pFixedResource,
-                           const TransportInterface_t* pTransportInterface,
-                           const TransportOption_t* pTransportOption,
-                           const ServerInfo_t* pServerInfo,
-                           const RTIODeviceInfo_t* pDeviceInfo )
+/**
+ * @brief Sends the same ObNotify payload to several observers, whose response items are added.
+ *
+ * The frame is serialized once and only headerId and obId are patched per observer. Sent
+ * directly, the payload is copied once into networkOutgoingBuffer and kept there for the
+ * batch, or is a shared segment when the transport has sendv; queued frames own a copy.
+ *
+ * @param[out] pSent number of observers notified, the first ones of the batch.
+ */
+static RTIOStatus_t obNotify_SendShared( RTIOContext_t* pContext,
+                                         uint8_t* pData, uint16_t length,
+                                         const uint16_t* pObIds, const uint16_t* pHeaderIds,
+                                         uint16_t count, uint16_t* pSent )
 {
-    RTIOStatus_t status = RTIOUnknown;
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOObNotifyReq_t req = { 0 };
+    rtioOutgoingFrame_t frame = { 0 };
+    uint8_t headerData[ RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ ];
+    RTIOFixedBuffer_t header = { 0 };
+    uint16_t headerLength = 0, frameLength = 0, i = 0;
 
-    status = rtioInit( pContext, pFixedResource,
-                       pTransportInterface, pTransportOption, pServerInfo, pDeviceInfo );
-    if( RTIOSuccess != status )
+    *pSent = 0;
+    if( count == 0U )
+    {
+        return RTIOSuccess;
+    }
+
+    req.method = RTIO_REST_OBGET;
+    req.code = RTIO_REST_STATUS_CONTINUE;
+    req.headerId = pHeaderIds[ 0 ];
+    req.obId = pObIds[ 0 ];
+    req.pData = pData;
+    req.dataLength = length;
+    header.pBuffer = headerData;
+    header.size = sizeof( headerData );
+    status = RTIO_SerializeObNotifyReqHeader_OverDeviceSendReq( &req, &header, &headerLength );
+    if( status != RTIOSuccess )
     {
+        LogError( ( "Failed to SerializeObNotifyReq, status=%d.", status ) );
         return status;
     }
 
-    connectStatus_ChangeWhenEventConnect( pContext );
+    if( ( pContext->sendQueue.size == 0U ) &&
+        ( pContext->transportInterface.sendv == NULL ) &&
+        ( headerLength + length <= pContext->networkOutgoingBuffer.size ) )
+    {
+        status = outgoingFrame_Begin( pContext, &frame, RTIO_SEND_LANE_BULK );
+        if( status != RTIOSuccess )
+        {
+            return status;
+        }
+        memcpy( frame.buffer.pBuffer, headerData, headerLength );
+        frameLength = headerLength;
+        (void)outgoingFrame_CopyPayload( &frame, &frameLength, pData, length );
+        for( i = 0; ( i < count ) && ( status == RTIOSuccess ); i++ )
+        {
+            (void)RTIO_SerializeObNotifyReqPatch_OverDeviceSendReq( pHeaderIds[ i ], pObIds[ i ], &( frame.buffer ) );
+            status = sendMessageSafe( pContext, frame.buffer.pBuffer, frameLength );
+            if( status == RTIOSuccess )
+            {
+                ( *pSent )++;
+            }
+        }
+        (void)outgoingFrame_End( pContext, &frame, 0, NULL, 0 );
+    }
+    else
+    {
+        for( i = 0; ( i < count ) && ( status == RTIOSuccess ); i++ )
+        {
+            (void)RTIO_SerializeObNotifyReqPatch_OverDeviceSendReq( pHeaderIds[ i ], pObIds[ i ], &header );
+            status = outgoingFrame_Begin( pContext, &frame, RTIO_SEND_LANE_BULK );
+            if( status == RTIOSuccess )
+            {
+                memcpy( frame.buffer.pBuffer, headerData, headerLength );
+                status = outgoingFrame_End( pContext, &frame, headerLength, pData, length );
+            }
+            if( status == RTIOSuccess )
+            {
+                ( *pSent )++;
+            }
+        }
+    }
 
-    status = connectWithBackoffAlgorithm( pContext );
-    if( RTIOSuccess == status )
+    if( status != RTIOSuccess )
     {
-        connectStatus_ChangeWhenEventConnectSuccess( pContext );
+        LogError( ( "Failed to send ObNotifyReq, status=%d, sent=%u, count=%u.", status, *pSent, count ) );
+    }
+    return status;
+}
+
+RTIOStatus_t RTIO_ObNotify( RTIOContext_t* pContext,
+                            uint8_t* pData, uint16_t Length,
+                            uint16_t obId,
+                            uint32_t timeoutMs )
+{
+    uint8_t notifyRespSerializeBuffer[ RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE ];
+    RTIOFixedBuffer_t serializeBuffer = { 0 };
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t respIndex = UINT16_MAX, headerId = 0;
+
+    if( pContext == NULL || pData == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pData=%p.", (void*)pContext, (void*)pData ) );
+        return RTIOBadParameter;
     }
-    else
+
+    serializeBuffer.pBuffer = notifyRespSerializeBuffer;
+    serializeBuffer.size = RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE;
+
+    status = obNotify_Send( pContext, pData, Length, obId, &timeoutMs, &serializeBuffer, &respIndex, &headerId );
+    if( status == RTIOSuccess )
     {
-        LogError( ( "Reconnect stoped, status=%d.", status ) );
-        connectStatus_ChangeWhenEventDisconnect( pContext );
+        status = obNotify_Collect( pContext, respIndex, headerId, timeoutMs );
     }
     return status;
 }
 
-RTIOStatus_t RTIO_Disconnect( RTIOContext_t* pContext )
+RTIOStatus_t RTIO_ObNotifyAsync( RTIOContext_t* pContext,
+                                 uint8_t* pData, uint16_t length,
+                                 uint16_t obId,
+                                 uint32_t timeoutMs,
+                                 RTIOObNotifyCallback_t callback,
+                                 void* pUserData )
 {
     RTIOStatus_t status = RTIOSuccess;
-    TransportStatus_t transportStatus = TransportUnknown;
+    uint16_t respIndex = UINT16_MAX;
+    RTIOObNotifyReq_t req = { 0 };
 
-    if( ( pContext == NULL ) ||
-        ( pContext->transportInterface.disconnect == NULL ) )
+    if( ( pContext == NULL ) || ( pData == NULL ) || ( callback == NULL ) )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, "
-                    "transportInterface.disconnect=%p.",
-                    (void*)pContext,
-                    (void*)pContext->transportInterface.disconnect ) );
-
+        LogError( ( "Argument cannot be NULL: pContext=%p, pData=%p, callback=%p.",
+                    (void*)pContext, (void*)pData, (void*)callback ) );
         return RTIOBadParameter;
     }
 
-    LogInfo( ( "Disconnect..." ) );
+    req.method = RTIO_REST_OBGET;
+    req.code = RTIO_REST_STATUS_CONTINUE;
+    req.obId = obId;
+    req.pData = pData;
+    req.dataLength = length;
 
-    /* thread destroy */
-    pContext->serviceDone = true;
-    LogInfo( ( "To exit gracefully, wait for seconds=%d for related threads to terminate.", (RTIO_SEND_TIMEOUT_MS + 1000U)/1000 ) );
-    OS_ClockSleepMs( RTIO_SEND_TIMEOUT_MS + 1000U );
- 
-    /* transport destroy */
-    connectStatus_ChangeWhenEventDisconnect( pContext );
-    transportStatus = pContext->transportInterface.disconnect( pContext->transportInterface.pNetworkContext );
-    if( transportStatus == TransportSuccess )
+    /* The notify response is kept in the item's inline buffer, see deviceSendRespList_SetAsync. */
+    status = deviceSendRespList_Add( &( pContext->deviceSendRespList ), NULL, &req.headerId, &respIndex );
+    if( status != RTIOSuccess )
     {
-        connectStatus_ChangeWhenEventDisconnectSuccess( pContext );
+        LogError( ( "Failed to deviceSendRespListAdd, status=%d.", status ) );
+        return status;
     }
-    else
+    timeoutMs = rtt_TimeoutMs( pContext, respIndex, timeoutMs );
+
+    status = deviceSendRespList_SetAsync( &( pContext->deviceSendRespList ), &( pContext->timerWheel ), respIndex,
+                                          timeoutMs, NULL, callback, pUserData, obId );
+    if( status == RTIOSuccess )
     {
-        LogError( ( "Failed to disconnect" ) );
-        status = RTIODisconnectFailed;
+        status = sendObNotifyReq( pContext, &req, timeoutMs );
     }
 
-    /* mutex destroy */
-    if( OS_MutexDestroy( pContext->pRollingHeaderIdLock ) != OSSuccess )
+    if( status != RTIOSuccess )
     {
-        LogError( ( "Failed to destroy rollingHeaderIdLock." ) );
+        /* Not sent, the callback will not be invoked unless it was already. */
+        status = deviceSendRespList_Unsent( pContext, respIndex, req.headerId, status );
     }
-    if( OS_MutexDestroy( pContext->pSendMessageLock ) != OSSuccess )
+    return status;
+}
+
+RTIOStatus_t RTIO_ObNotifyTerminate( RTIOContext_t* pContext,
+                                     uint16_t obId,
+                                     uint32_t timeoutMs )
+{
+    uint8_t notifyRespSerializeBuffer[ RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE ];
+    RTIOFixedBuffer_t serializeBuffer = { 0 };
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t respIndex = UINT16_MAX;
+    rtioDeviceSendResp_t* pDeviceSendResp = NULL;
+    RTIOObNotifyReq_t req = { 0 };
+    RTIOObNotifyResp_t resp = { 0 };
+
+    if( pContext == NULL )
     {
-        LogError( ( "Failed to destroy pSendMessageLock." ) );
+        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
+        status = RTIOBadParameter;
     }
-    if( OS_MutexDestroy( pContext->pRecvMessageLock ) != OSSuccess )
+
+    serializeBuffer.pBuffer = notifyRespSerializeBuffer;
+    serializeBuffer.size = RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE;
+
+    if( status == RTIOSuccess )
     {
-        LogError( ( "Failed to destroy pRecvMessageLock." ) );
+        req.method = RTIO_REST_OBGET;
+        req.code = RTIO_REST_STATUS_TERMINATE;
+        req.obId = obId;
+
+        status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
+                                         &serializeBuffer,
+                                         &req.headerId,
+                                         &respIndex );
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to deviceSendRespListAdd, status=%d.", status ) );
+        }
+        else
+        {
+            timeoutMs = rtt_TimeoutMs( pContext, respIndex, timeoutMs );
+        }
     }
-    if( OS_MutexDestroy( pContext->pNetworkOutgoingBufferLock ) != OSSuccess )
+
+    if( status == RTIOSuccess )
     {
-        LogError( ( "Failed to destroy pNetworkOutgoingBufferLock." ) );
+        status = sendObNotifyReq( pContext, &req, timeoutMs );
     }
-    if( OS_MutexDestroy( pContext->deviceSendRespList.pLock ) != OSSuccess )
+
+    if( status == RTIOSuccess )
     {
-        LogError( ( "Failed to destroy deviceSendRespList.pLock." ) );
+        status = deviceSendRespList_Wait( &( pContext->deviceSendRespList ), respIndex, timeoutMs );
+        if( status == RTIOTimeout )
+        {
+            rtt_TimedOut( pContext, respIndex );
+        }
+        if( status != RTIOSuccess )
+        {
+            LogError( ( "Failed to wait ObNotifyResp, status=%d.", status ) );
+        }
+        else
+        {
+            status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), respIndex, &pDeviceSendResp );
+            if( status != RTIOSuccess )
+            {
+                LogError( ( "Failed to deviceSendRespList_GetResp, status=%d.", status ) );
+            }
+            else
+            {
+                status = RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( pDeviceSendResp, &resp );
+                if( status != RTIOSuccess )
+                {
+                    LogError( ( "Failed to RTIO_DeSerializeObNotifyResp_FromDeviceSendResp, status=%d.", status ) );
+                }
+            }
+        }
     }
-    if( OS_MutexDestroy( pContext->pConnectionStatusLock ) != OSSuccess )
+
+    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex, req.headerId ) != RTIOSuccess )
     {
-        LogError( ( "Failed to destroy pConnectionStatusLock." ) );
+        LogError( ( "Failed to deviceSendRespListDelete." ) );
+    }
+
+    if( status == RTIOSuccess )
+    {
+        status = transRestStatus( resp.code );
     }
     return status;
 }
 
-RTIOStatus_t RTIO_RegisterCoPostHandler( const RTIOContext_t* pContext,
-                                         const char* pUri, RTIOCoPostHandler_t handler )
+RTIOStatus_t RTIO_RegisterObGetHandler( const RTIOContext_t* pContext,
+                                            const char* pUri, RTIOObGetHandler_t handler )
 {
-    uint16_t i = 0;
     uint32_t uri = 0;
     uint16_t length = 0;
     if( ( pContext == NULL ) || ( handler == NULL ) )
@@ -1735,300 +4674,340 @@ RTIOStatus_t RTIO_RegisterCoPostHandler( const RTIOContext_t* pContext,
     uri = crc32Ieee( (uint8_t*)pUri, length );
     LogInfo( ( "Register pUri=%s, digest=%u, digestHex=0x%x.", pUri, (unsigned)uri, (unsigned)uri ) );
 
-    for( i = 0; i < pContext->coPostInfoList.size; ++i )
+    return RTIO_RegisterObGetHandlerWithDigest( pContext, uri, handler );
+}
+
+RTIOStatus_t RTIO_RegisterObGetHandlerWithDigest( const RTIOContext_t* pContext,
+                                                  uint32_t uri, RTIOObGetHandler_t handler )
+{
+    RTIOObGetUri_t* pEntry = NULL;
+    if( ( pContext == NULL ) || ( handler == NULL ) )
     {
-        LogDebug( ( "List[%d].uri=%u.", i, (unsigned)pContext->coPostInfoList.pList[ i ].uri ) );
-        if( pContext->coPostInfoList.pList[ i ].uri == 0 )
-        {
-            pContext->coPostInfoList.pList[ i ].uri = uri;
-            pContext->coPostInfoList.pList[ i ].handler = handler;
-            break;
-        }
+        LogError( ( "Argument cannot be NULL: pContext=%p, handler=%p.", (void*)pContext, (void*)handler ) );
+        return RTIOBadParameter;
+    }
+    if( uri == 0 )
+    {
+        /* 0 marks a free entry of the list. */
+        LogError( ( "Argument error: uri digest=0." ) );
+        return RTIOBadParameter;
     }
-    if( i == pContext->coPostInfoList.size )
+
+    pEntry = obGetUriList_Probe( &( pContext->obGetInfoList ), uri );
+    if( pEntry == NULL )
     {
         return RTIOListFull;
     }
+    if( pEntry->uri == uri )
+    {
+        LogWarn( ( "Handler of digest=%u is replaced.", (unsigned)uri ) );
+    }
+    LogDebug( ( "ObList[%u].uri=%u.", (unsigned)( pEntry - pContext->obGetInfoList.pList ), (unsigned)uri ) );
+    pEntry->uri = uri;
+    pEntry->handler = handler;
     return RTIOSuccess;
 }
 
-RTIOStatus_t RTIO_ObNotify( RTIOContext_t* pContext,
-                            uint8_t* pData, uint16_t Length,
-                            uint16_t obId,
-                            uint32_t timeoutMs )
+RTIOStatus_t RTIO_RegisterObGetHandlers( const RTIOContext_t* pContext,
+                                         const RTIOObGetUri_t* pTable, uint16_t count )
 {
-    uint8_t notifyRespSerializeBuffer[ RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE ];
-    RTIOFixedBuffer_t serializeBuffer = { 0 };
-    uint16_t serianlizeLength = 0;
     RTIOStatus_t status = RTIOSuccess;
-    uint16_t respIndex = UINT16_MAX;
-    rtioDeviceSendResp_t* pDeviceSendResp = NULL;
-    RTIOObNotifyReq_t req = { 0 };
-    RTIOObNotifyResp_t resp = { 0 };
+    uint16_t i = 0;
+    if( ( pTable == NULL ) && ( count > 0 ) )
+    {
+        LogError( ( "Argument cannot be NULL: pTable=%p, count=%u.", (void*)pTable, count ) );
+        return RTIOBadParameter;
+    }
 
-    if( pContext == NULL || pData == NULL )
+    for( i = 0; ( i < count ) && ( status == RTIOSuccess ); ++i )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, pData=%p.", (void*)pContext, (void*)pData ) );
+        status = RTIO_RegisterObGetHandlerWithDigest( pContext, pTable[ i ].uri, pTable[ i ].handler );
+    }
+    return status;
+}
+
+
+RTIOStatus_t RTIO_Serve( RTIOContext_t* pContext )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    OSError_t ret = OSUnknown;
+    uint16_t i = 0;
+
+    if( ( pContext == NULL ) || ( pContext->pThreadIncomming == NULL ) || ( pContext->pThreadKeepAlive == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pThreadIncomming=%p, pThreadKeepAlive=%p.",
+                    (void*)pContext, (void*)pContext->pThreadIncomming, (void*)pContext->pThreadKeepAlive ) );
         status = RTIOBadParameter;
     }
 
-    serializeBuffer.pBuffer = notifyRespSerializeBuffer;
-    serializeBuffer.size = RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE;
+    pContext->serviceDone = false;
 
     if( status == RTIOSuccess )
     {
-        req.headerId = getNextHeaderId( pContext );
-        req.method = RTIO_REST_OBGET;
-        req.code = RTIO_REST_STATUS_CONTINUE;
-        req.obId = obId;
-        req.pData = pData;
-        req.dataLength = Length;
-
-        status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
-                                         req.headerId,
-                                         &serializeBuffer,
-                                         &respIndex );
-        if( status != RTIOSuccess )
+        serve_ThreadStarted( pContext );
+        ret = OS_ThreadCreate( pContext->pThreadIncomming, incommingProccess,
+                               (void*)pContext, "IncommingProccess", RTIO_THREAD_INCOMMING_STACK_SIZE );
+        if( ret != OSSuccess )
         {
-            LogError( ( "Failed to deviceSendRespListAdd, status=%d, headerid=%u.", status, req.headerId) );
+            serve_ThreadStopped( pContext );
+            LogError( ( "Failed to create pThreadIncomming, ret=%d.", ret ) );
+            status = RTIOThreadCreateFailed;
         }
     }
-
-    OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
-
     if( status == RTIOSuccess )
     {
-        status = RTIO_SerializeObNotifyReq_OverDeviceSendReq( &req, &( pContext->networkOutgoingBuffer ), &serianlizeLength );
-        if( status != RTIOSuccess )
+        serve_ThreadStarted( pContext );
+        ret = OS_ThreadCreate( pContext->pThreadKeepAlive, keepAliveProccess,
+                               (void*)pContext, "KeepAliveProccess", RTIO_THREAD_KEEPALIVE_STACK_SIZE );
+        if( ret != OSSuccess )
         {
-            LogError( ( "Failed to SerializeCoReq, status=%d.", status ) );
+            serve_ThreadStopped( pContext );
+            LogError( ( "Failed to create pThreadKeepAlive, ret=%d.", ret ) );
+            status = RTIOThreadCreateFailed;
         }
-        else
+    }
+    if( ( status == RTIOSuccess ) && ( pContext->sendQueue.size > 0U ) )
+    {
+        serve_ThreadStarted( pContext );
+        ret = OS_ThreadCreate( pContext->pThreadWriter, writerProccess,
+                               (void*)pContext, "WriterProccess", RTIO_THREAD_WRITER_STACK_SIZE );
+        if( ret != OSSuccess )
         {
-            status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, serianlizeLength );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to send CoReq, status=%d.", status ) );
-            }
+            serve_ThreadStopped( pContext );
+            LogError( ( "Failed to create pThreadWriter, ret=%d.", ret ) );
+            status = RTIOThreadCreateFailed;
         }
     }
-
-    OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
-
-    if( status == RTIOSuccess )
+    for( i = 0; ( status == RTIOSuccess ) && ( i < pContext->handlerPool.workerNum ); i++ )
     {
-        status = deviceSendRespList_Wait( &( pContext->deviceSendRespList ), respIndex, timeoutMs );
-        if( status != RTIOSuccess )
+        serve_ThreadStarted( pContext );
+        ret = OS_ThreadCreate( handlerPool_Thread( &( pContext->handlerPool ), i ), handlerWorkerProccess,
+                               (void*)&( pContext->handlerPool.pWorkers[ i ] ), "HandlerWorkerProccess",
+                               RTIO_THREAD_HANDLER_STACK_SIZE );
+        if( ret != OSSuccess )
         {
-            LogError( ( "Failed to wait ObNotifyResp, status=%d.", status ) );
+            serve_ThreadStopped( pContext );
+            LogError( ( "Failed to create handler worker thread %u, ret=%d.", i, ret ) );
+            status = RTIOThreadCreateFailed;
         }
-        else
+    }
+
+    return status;
+}
+
+RTIOStatus_t RTIO_ServeEventDriven( RTIOContext_t* pContext, RTIOWakeupHandler_t wakeup, void* pWakeupArg )
+{
+    if( pContext == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
+        return RTIOBadParameter;
+    }
+    if( ( pContext->sendQueue.size > 0U ) || ( pContext->handlerPool.workerNum > 0U ) )
+    {
+        LogError( ( "Event-driven serving runs no writer and handler threads, sendQueue.size=%u, handlerPool.workerNum=%u.",
+                    pContext->sendQueue.size, pContext->handlerPool.workerNum ) );
+        return RTIOBadParameter;
+    }
+
+    pContext->serviceDone = false;
+    pContext->eventDriven = true;
+    pContext->incommingStart = 0;
+    pContext->incommingEnd = 0;
+
+    OS_MutexLock( pContext->timerWheel.pLock );
+    pContext->timerWheel.wakeup = wakeup;
+    pContext->timerWheel.pWakeupArg = pWakeupArg;
+    OS_MutexUnlock( pContext->timerWheel.pLock );
+
+    keepAlive_Start( pContext );
+    LogInfo( ( "Event-driven serving started, heartbeatMs=%u, polled=%d.",
+               (unsigned)pContext->heartbeatMs, wakeup == NULL ) );
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_HandleReadable( RTIOContext_t* pContext )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t readLength = 0;
+    bool handled = false;
+
+    if( ( pContext == NULL ) || !pContext->eventDriven )
+    {
+        LogError( ( "Context is not event-driven: pContext=%p.", (void*)pContext ) );
+        return RTIOBadParameter;
+    }
+
+    /* Once a reconnect started, the bytes belong to the verify response of the reconnect. */
+    if( !connectStatus_CheckStatus( pContext, RTIOConnected ) )
+    {
+        return RTIORecvFailed;
+    }
+
+    /* Read until the transport has nothing left, bytes decrypted by TLS are not seen by the descriptor. */
+    do
+    {
+        status = recvAvailable( pContext, &readLength );
+        handled = true;
+        while( ( status == RTIOSuccess ) && handled )
         {
-            status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), respIndex, &pDeviceSendResp );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to deviceSendRespList_GetResp, status=%d.", status ) );
-            }
-            else
-            {
-                status = RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( pDeviceSendResp, &resp );
-                if( status != RTIOSuccess )
-                {
-                    LogError( ( "Failed to RTIO_DeSerializeObNotifyResp_FromDeviceSendResp, status=%d.", status ) );
-                }
+            status = incommingHandleBufferedFrame( pContext, &handled );
+            if( ( RTIOTimeout == status ) ||
+                ( RTIONotFound == status ) /* Due to a timeout, headerid not found. */ )
+            {
+                status = RTIOSuccess;
             }
         }
-    }
+    } while( ( status == RTIOSuccess ) && ( readLength > 0U ) );
 
-    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex ) != RTIOSuccess )
+    if( RTIOSendFailed == status ||
+        RTIORecvFailed == status ||
+        RTIOTransportFailed == status ||
+        RTIOProtocalFailed == status )
     {
-        LogError( ( "Failed to deviceSendRespListDelete." ) );
+        LogError( ( "Session bad when read, status=%d, will reconnet later.", status ) );
+        connectStatus_ChangeWhenEventReconnect( pContext );
+        /* Bytes buffered from the broken session are dropped. */
+        pContext->incommingStart = 0;
+        pContext->incommingEnd = 0;
+    }
+    else if( status != RTIOSuccess )
+    {
+        LogError( ( "Unrecoverable error, status=%d.", status ) );
+        if( pContext->serveFailedHandler != NULL )
+        {
+            pContext->serveFailedHandler();
+        }
+    }
+    else
+    {
+        /* MISRA else. */
     }
-
-    status = transRestStatus( resp.code );
     return status;
 }
 
-RTIOStatus_t RTIO_ObNotifyTerminate( RTIOContext_t* pContext,
-                                     uint16_t obId,
-                                     uint32_t timeoutMs )
+RTIOStatus_t RTIO_HandleTimers( RTIOContext_t* pContext, uint32_t* pNextWaitMs )
 {
-    uint8_t notifyRespSerializeBuffer[ RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE ];
-    RTIOFixedBuffer_t serializeBuffer = { 0 };
-    uint16_t serianlizeLength = 0;
     RTIOStatus_t status = RTIOSuccess;
-    uint16_t respIndex = UINT16_MAX;
-    rtioDeviceSendResp_t* pDeviceSendResp = NULL;
-    RTIOObNotifyReq_t req = { 0 };
-    RTIOObNotifyResp_t resp = { 0 };
 
-    if( pContext == NULL )
+    if( ( pContext == NULL ) || ( pNextWaitMs == NULL ) || !pContext->eventDriven )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p.", (void*)pContext ) );
-        status = RTIOBadParameter;
+        LogError( ( "Context is not event-driven or argument is NULL: pContext=%p, pNextWaitMs=%p.",
+                    (void*)pContext, (void*)pNextWaitMs ) );
+        return RTIOBadParameter;
     }
 
-    serializeBuffer.pBuffer = notifyRespSerializeBuffer;
-    serializeBuffer.size = RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE;
+    status = keepAlive_RunTimers( pContext, OS_ClockGetTimeMs() );
+    *pNextWaitMs = timerWheel_NextWaitMs( &( pContext->timerWheel ), OS_ClockGetTimeMs() );
 
-    if( status == RTIOSuccess )
+    if( status != RTIOSuccess )
     {
-        req.headerId = getNextHeaderId( pContext );
-        req.method = RTIO_REST_OBGET;
-        req.code = RTIO_REST_STATUS_TERMINATE;
-        req.obId = obId;
-
-        status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
-                                         req.headerId,
-                                         &serializeBuffer,
-                                         &respIndex );
-        if( status != RTIOSuccess )
+        LogError( ( "Timers stopped reconnecting, status=%d.", status ) );
+        if( pContext->serveFailedHandler != NULL )
         {
-            LogError( ( "Failed to deviceSendRespListAdd, status=%d.", status ) );
+            pContext->serveFailedHandler();
         }
     }
+    return status;
+}
 
-    // lock networkOutgoingBuffer
-    OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
+RTIOStatus_t RTIO_GetDescriptor( RTIOContext_t* pContext, int32_t* pDescriptor, uint32_t* pConnectCount )
+{
+    RTIOStatus_t status = RTIOSuccess;
 
-    if( status == RTIOSuccess )
+    if( ( pContext == NULL ) || ( pDescriptor == NULL ) || ( pConnectCount == NULL ) ||
+        ( pContext->transportInterface.getDescriptor == NULL ) )
     {
-        status = RTIO_SerializeObNotifyReq_OverDeviceSendReq( &req, &( pContext->networkOutgoingBuffer ), &serianlizeLength );
-        if( status != RTIOSuccess )
-        {
-            LogError( ( "Failed to SerializeCoReq, status=%d.", status ) );
-        }
-        else
-        {
-            status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, serianlizeLength );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to send CoReq, status=%d.", status ) );
-            }
-        }
+        LogError( ( "Argument cannot be NULL: pContext=%p, pDescriptor=%p, pConnectCount=%p, or transport has no getDescriptor.",
+                    (void*)pContext, (void*)pDescriptor, (void*)pConnectCount ) );
+        return RTIOBadParameter;
     }
 
-    // unlock networkOutgoingBuffer
-    OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
-
-    if( status == RTIOSuccess )
+    OS_MutexLock( pContext->pConnectionStatusLock );
+    if( pContext->connectStatus == RTIOConnected )
     {
-        status = deviceSendRespList_Wait( &( pContext->deviceSendRespList ), respIndex, timeoutMs );
-        if( status != RTIOSuccess )
-        {
-            LogError( ( "Failed to wait ObNotifyResp, status=%d.", status ) );
-        }
-        else
-        {
-            status = deviceSendRespList_GetResp( &( pContext->deviceSendRespList ), respIndex, &pDeviceSendResp );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to deviceSendRespList_GetResp, status=%d.", status ) );
-            }
-            else
-            {
-                status = RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( pDeviceSendResp, &resp );
-                if( status != RTIOSuccess )
-                {
-                    LogError( ( "Failed to RTIO_DeSerializeObNotifyResp_FromDeviceSendResp, status=%d.", status ) );
-                }
-            }
-        }
+        *pDescriptor = pContext->transportInterface.getDescriptor( pContext->transportInterface.pNetworkContext );
+        *pConnectCount = pContext->connectCount;
     }
-
-    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex ) != RTIOSuccess )
+    else
     {
-        LogError( ( "Failed to deviceSendRespListDelete." ) );
+        *pDescriptor = -1;
+        status = RTIONotFound;
     }
+    OS_MutexUnlock( pContext->pConnectionStatusLock );
 
-    status = transRestStatus( resp.code );
     return status;
 }
 
-RTIOStatus_t RTIO_RegisterObGetHandler( const RTIOContext_t* pContext,
-                                            const char* pUri, RTIOObGetHandler_t handler )
+RTIOStatus_t RTIO_GetNextWaitMs( RTIOContext_t* pContext, uint32_t* pWaitMs )
 {
-    uint16_t i = 0;
-    uint32_t uri = 0;
-    uint16_t length = 0;
-    if( ( pContext == NULL ) || ( handler == NULL ) )
+    if( ( pContext == NULL ) || ( pWaitMs == NULL ) || !pContext->eventDriven )
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, handler=%p.", (void*)pContext, (void*)handler ) );
+        LogError( ( "Context is not event-driven or argument is NULL: pContext=%p, pWaitMs=%p.",
+                    (void*)pContext, (void*)pWaitMs ) );
         return RTIOBadParameter;
     }
-    if( pUri == NULL )
+
+    *pWaitMs = timerWheel_NextWaitMs( &( pContext->timerWheel ), OS_ClockGetTimeMs() );
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_Poll( RTIOContext_t* pContext, uint32_t timeoutMs )
+{
+    RTIOStatus_t status = RTIOSuccess, timerStatus = RTIOSuccess;
+    uint32_t waitMs = 0;
+    int32_t waitResult = 0;
+
+    if( ( pContext == NULL ) || !pContext->eventDriven )
     {
-        LogError( ( "Argument cannot be NULL: pUri=%p.", (void*)pUri ) );
+        LogError( ( "Context is not event-driven: pContext=%p.", (void*)pContext ) );
         return RTIOBadParameter;
     }
-    length = (uint16_t)strlen( pUri );
-    if( ( length < RTIO_URI_STRING_LENGTH_MIN ) || ( length > RTIO_URI_STRING_LENGTH_MAX ) )
+
+    /* Waits no longer than the next timer. */
+    waitMs = timerWheel_NextWaitMs( &( pContext->timerWheel ), OS_ClockGetTimeMs() );
+    if( waitMs > timeoutMs )
     {
-        LogError( ( "Argument error: uri length=%u.", length ) );
-        return RTIOBadParameter;
+        waitMs = timeoutMs;
     }
 
-    uri = crc32Ieee( (uint8_t*)pUri, length );
-    LogInfo( ( "Register pUri=%s, digest=%u, digestHex=0x%x.", pUri, (unsigned)uri, (unsigned)uri ) );
-
-    for( i = 0; i < pContext->obGetInfoList.size; ++i )
+    if( !connectStatus_CheckStatus( pContext, RTIOConnected ) )
     {
-        if( pContext->obGetInfoList.pList[ i ].uri == 0 )
-        {
-            LogDebug( ( "ObList[%d].uri=%u, ready for digest=%u.", i, (unsigned)pContext->obGetInfoList.pList[ i ].uri, (unsigned)uri ) );
-            pContext->obGetInfoList.pList[ i ].uri = uri;
-            pContext->obGetInfoList.pList[ i ].handler = handler;
-            break;
-        }
-        else
-        {
-            LogDebug( ( "ObList[%d].uri=%u.", i, (unsigned)pContext->obGetInfoList.pList[ i ].uri ) );
-        }
+        /* Reconnects are timers. */
+        OS_ClockSleepMs( waitMs );
     }
-    if( i == pContext->obGetInfoList.size )
+    else if( pContext->transportInterface.waitReadable != NULL )
     {
-        return RTIOListFull;
+        waitResult = pContext->transportInterface.waitReadable( pContext->transportInterface.pNetworkContext, waitMs );
     }
-
-    return RTIOSuccess;
-}
-
-
-RTIOStatus_t RTIO_Serve( RTIOContext_t* pContext )
-{
-    RTIOStatus_t status = RTIOSuccess;
-    OSError_t ret = OSUnknown;
-
-    if( ( pContext == NULL ) || ( pContext->pThreadIncomming == NULL ) || ( pContext->pThreadKeepAlive == NULL ) )
+    else
     {
-        LogError( ( "Argument cannot be NULL: pContext=%p, pThreadIncomming=%p, pThreadKeepAlive=%p.",
-                    (void*)pContext, (void*)pContext->pThreadIncomming, (void*)pContext->pThreadKeepAlive ) );
-        status = RTIOBadParameter;
+        /* Recv of the transport waits by itself. */
+        waitResult = 1;
     }
 
-    pContext->serviceDone = false;
+    /* An error is reported again by the read and reconnected. */
+    if( waitResult != 0 )
+    {
+        status = RTIO_HandleReadable( pContext );
+    }
+    timerStatus = RTIO_HandleTimers( pContext, &waitMs );
 
-    if( status == RTIOSuccess )
+    if( timerStatus != RTIOSuccess )
     {
-        ret = OS_ThreadCreate( pContext->pThreadIncomming, incommingProccess,
-                               (void*)pContext, "IncommingProccess", RTIO_THREAD_INCOMMING_STACK_SIZE );
-        if( ret != OSSuccess )
-        {
-            LogError( ( "Failed to create pThreadIncomming, ret=%d.", ret ) );
-            status = RTIOThreadCreateFailed;
-        }
+        status = timerStatus;
     }
-    if( status == RTIOSuccess )
+    else if( RTIOSendFailed == status ||
+             RTIORecvFailed == status ||
+             RTIOTransportFailed == status ||
+             RTIOProtocalFailed == status )
     {
-        ret = OS_ThreadCreate( pContext->pThreadKeepAlive, keepAliveProccess,
-                               (void*)pContext, "KeepAliveProccess", RTIO_THREAD_KEEPALIVE_STACK_SIZE );
-        if( ret != OSSuccess )
-        {
-            LogError( ( "Failed to create pThreadKeepAlive, ret=%d.", ret ) );
-            status = RTIOThreadCreateFailed;
-        }
+        /* The broken session is reconnected by the next calls. */
+        status = RTIOSuccess;
+    }
+    else
+    {
+        /* MISRA else. */
     }
-
     return status;
 }
 
@@ -2049,6 +5028,10 @@ RTIOStatus_t RTIO_SetHeartbeat( RTIOContext_t* pContext, uint32_t heartbeatMs )
     else
     {
         pContext->heartbeatMs = heartbeatMs;
+        if( pContext->timerWheel.pLock != NULL )
+        {
+            keepAlive_ArmPing( pContext );
+        }
     }
 
     return RTIOSuccess;
@@ -2066,6 +5049,58 @@ RTIOStatus_t RTIO_SetServeFailedHandler( RTIOContext_t* pContext, RTIOServeFaile
     return RTIOSuccess;
 }
 
+RTIOStatus_t RTIO_GetSendStats( RTIOContext_t* pContext, RTIOSendStats_t* pStats )
+{
+    if( ( pContext == NULL ) || ( pStats == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pStats=%p.", (void*)pContext, (void*)pStats ) );
+        return RTIOBadParameter;
+    }
+
+    if( pContext->sendQueue.size == 0U )
+    {
+        memset( pStats, 0, sizeof( RTIOSendStats_t ) );
+        return RTIOSuccess;
+    }
+    OS_MutexLock( pContext->sendQueue.pLock );
+    *pStats = pContext->sendQueue.stats;
+    OS_MutexUnlock( pContext->sendQueue.pLock );
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_GetOfflineStats( RTIOContext_t* pContext, RTIOOfflineStats_t* pStats )
+{
+    if( ( pContext == NULL ) || ( pStats == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pStats=%p.", (void*)pContext, (void*)pStats ) );
+        return RTIOBadParameter;
+    }
+
+    if( pContext->offlineQueue.size == 0U )
+    {
+        memset( pStats, 0, sizeof( RTIOOfflineStats_t ) );
+        return RTIOSuccess;
+    }
+    OS_MutexLock( pContext->offlineQueue.pLock );
+    *pStats = pContext->offlineQueue.stats;
+    OS_MutexUnlock( pContext->offlineQueue.pLock );
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_GetRttStats( RTIOContext_t* pContext, RTIORttStats_t* pStats )
+{
+    if( ( pContext == NULL ) || ( pStats == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pStats=%p.", (void*)pContext, (void*)pStats ) );
+        return RTIOBadParameter;
+    }
+
+    OS_MutexLock( pContext->rtt.pLock );
+    *pStats = pContext->rtt.stats;
+    OS_MutexUnlock( pContext->rtt.pLock );
+    return RTIOSuccess;
+}
+
 RTIOStatus_t RTIO_CoPost( RTIOContext_t* pContext, const char* pUri,
                           uint8_t* pReqData, uint16_t reqLength,
                           RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength,
@@ -2115,7 +5150,6 @@ RTIOStatus_t RTIO_CoPostWithDigest( RTIOContext_t* pContext, uint32_t uri,
                           uint32_t timeoutMs )
 {
     RTIOStatus_t status = RTIOSuccess;
-    uint16_t serianlizeLength = 0;
     uint16_t respIndex = UINT16_MAX;
     rtioDeviceSendResp_t* pDeviceSendResp = NULL;
     RTIOCoReq_t coReq = { 0 };
@@ -2133,47 +5167,36 @@ RTIOStatus_t RTIO_CoPostWithDigest( RTIOContext_t* pContext, uint32_t uri,
 
     if( status == RTIOSuccess )
     {
-        coReq.headerId = getNextHeaderId( pContext );
         coReq.uri = uri;
         coReq.method = RTIO_REST_COPOST;
         coReq.dataLength = reqLength;
         coReq.pData = pReqData;
-        LogInfo( ( "Post, uri=%u, reqLength=%u, headerId=%u, timeoutMs=%u.",
-                   (unsigned)uri, reqLength, coReq.headerId, (unsigned)timeoutMs ) );
         status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
-                                         coReq.headerId, pRespbuffer, &respIndex );
+                                         pRespbuffer, &coReq.headerId, &respIndex );
         if( status != RTIOSuccess )
         {
             LogError( ( "Failed to addDeviceSendRespEvent, status=%d.", status ) );
         }
-    }
-
-    // lock networkOutgoingBuffer
-    OS_MutexLock( pContext->pNetworkOutgoingBufferLock );
-
-    if( status == RTIOSuccess )
-    {
-        status = RTIO_SerializeCoReq_OverDeviceSendReq( &coReq, &( pContext->networkOutgoingBuffer ), &serianlizeLength );
-        if( status != RTIOSuccess )
-        {
-            LogError( ( "Failed to SerializeCoReq, status=%d.", status ) );
-        }
         else
         {
-            status = sendMessageSafe( pContext, pContext->networkOutgoingBuffer.pBuffer, serianlizeLength );
-            if( status != RTIOSuccess )
-            {
-                LogError( ( "Failed to send CoReq, status=%d.", status ) );
-            }
+            timeoutMs = rtt_TimeoutMs( pContext, respIndex, timeoutMs );
+            LogInfo( ( "Post, uri=%u, reqLength=%u, headerId=%u, timeoutMs=%u.",
+                       (unsigned)uri, reqLength, coReq.headerId, (unsigned)timeoutMs ) );
         }
     }
 
-    // unlock networkOutgoingBuffer
-    OS_MutexUnlock( pContext->pNetworkOutgoingBufferLock );
+    if( status == RTIOSuccess )
+    {
+        status = sendCoReq( pContext, &coReq, timeoutMs );
+    }
 
     if( status == RTIOSuccess )
     {
         status = deviceSendRespList_Wait( &( pContext->deviceSendRespList ), respIndex, timeoutMs );
+        if( status == RTIOTimeout )
+        {
+            rtt_TimedOut( pContext, respIndex );
+        }
         if( status != RTIOSuccess )
         {
             LogError( ( "Failed to wait CoResp, status=%d.", status ) );
@@ -2196,13 +5219,69 @@ RTIOStatus_t RTIO_CoPostWithDigest( RTIOContext_t* pContext, uint32_t uri,
         }
     }
 
-    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex ) != RTIOSuccess )
+    if( deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndex, coReq.headerId ) != RTIOSuccess )
     {
         LogError( ( "Failed to deviceSendRespListDelete." ) );
     }
 
     *respLength = coResp.dataLength;
-    status = transRestStatus( coResp.code );
+    if( status == RTIOSuccess )
+    {
+        status = transRestStatus( coResp.code );
+    }
+    return status;
+}
+
+
+RTIOStatus_t RTIO_CoPostAsync( RTIOContext_t* pContext, uint32_t uri,
+                               uint8_t* pReqData, uint16_t reqLength,
+                               RTIOFixedBuffer_t* pRespbuffer,
+                               uint32_t timeoutMs,
+                               RTIOCoPostCallback_t callback,
+                               void* pUserData )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t respIndex = UINT16_MAX;
+    RTIOCoReq_t coReq = { 0 };
+
+    if( ( pContext == NULL ) || ( pReqData == NULL ) || ( pRespbuffer == NULL ) || ( callback == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pContext=%p, pReqData=%p, pRespbuffer=%p, callback=%p.",
+                    (void*)pContext,
+                    (void*)pReqData,
+                    (void*)pRespbuffer,
+                    (void*)callback ) );
+        return RTIOBadParameter;
+    }
+
+    coReq.uri = uri;
+    coReq.method = RTIO_REST_COPOST;
+    coReq.dataLength = reqLength;
+    coReq.pData = pReqData;
+    status = deviceSendRespList_Add( &( pContext->deviceSendRespList ),
+                                     pRespbuffer, &coReq.headerId, &respIndex );
+    if( status != RTIOSuccess )
+    {
+        LogError( ( "Failed to addDeviceSendRespEvent, status=%d.", status ) );
+        return status;
+    }
+    timeoutMs = rtt_TimeoutMs( pContext, respIndex, timeoutMs );
+    LogDebug( ( "Post async, uri=%u, reqLength=%u, headerId=%u, timeoutMs=%u.",
+                (unsigned)uri, reqLength, coReq.headerId, (unsigned)timeoutMs ) );
+
+    /* Callback set before sending, the response may arrive before the send returns. */
+    status = deviceSendRespList_SetAsync( &( pContext->deviceSendRespList ), &( pContext->timerWheel ), respIndex,
+                                          timeoutMs, callback, NULL, pUserData, 0 );
+    if( status == RTIOSuccess )
+    {
+        status = sendCoReq( pContext, &coReq, timeoutMs );
+    }
+
+    if( status != RTIOSuccess )
+    {
+        /* Not sent, the callback will not be invoked unless it was already. */
+        status = deviceSendRespList_Unsent( pContext, respIndex, coReq.headerId, status );
+    }
     return status;
 }
 
@@ -2278,11 +5357,33 @@ uint16_t RTIO_ObListGetObNumberNotRealtime( RTIO_ObList_t* pObList )
     return pObList->obNumber;
 }
 
+static void obList_Remove( RTIO_ObList_t* pObList, uint16_t slot, uint16_t obId )
+{
+    OS_MutexLock( pObList->pLock );
+    if( pObList->pArray[ slot ] == obId )
+    {
+        pObList->pArray[ slot ] = 0;
+        if( pObList->obNumber > 0 )
+        {
+            pObList->obNumber--;
+        }
+    }
+    OS_MutexUnlock( pObList->pLock );
+}
+
 RTIOStatus_t RTIO_ObListNotifyAll( RTIOContext_t* pContext,
                                    RTIO_ObList_t* pObList,
                                    uint8_t* pData, uint16_t dataLength )
 {
     RTIOStatus_t notifyStatus = RTIOSuccess;
+    uint8_t respData[ RTIO_OBLIST_NOTIFY_BATCH_MAX ][ RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE ];
+    RTIOFixedBuffer_t respBuffers[ RTIO_OBLIST_NOTIFY_BATCH_MAX ];
+    uint16_t respIndexes[ RTIO_OBLIST_NOTIFY_BATCH_MAX ];
+    uint16_t headerIds[ RTIO_OBLIST_NOTIFY_BATCH_MAX ];
+    uint16_t slots[ RTIO_OBLIST_NOTIFY_BATCH_MAX ];
+    uint16_t obIds[ RTIO_OBLIST_NOTIFY_BATCH_MAX ];
+    uint16_t batch = 0, sent = 0, i = 0, j = 0, obId = 0;
+
     if( NULL == pContext || NULL == pObList || NULL == pData )
     {
         LogError( ( "Bad parameter." ) );
@@ -2291,40 +5392,67 @@ RTIOStatus_t RTIO_ObListNotifyAll( RTIOContext_t* pContext,
     LogDebug( ( "Notify all, dataLength=%u, NOTIFY_TIMEOUT=%u.",
                 dataLength, RTIO_OBSERVA_NOTIFY_TIMEOUT_MS ) );
 
-    int i = 0;
-    for( ; i < pObList->arraySize; i++ )
+    /* Notifications of a batch are all sent before any response is waited for,
+     * so a batch costs one round trip and one slow observer does not delay the others. */
+    while( i < pObList->arraySize )
     {
-        
-        if( pObList->pArray[ i ] != 0 )
+        batch = 0;
+        while( ( i < pObList->arraySize ) && ( batch < RTIO_OBLIST_NOTIFY_BATCH_MAX ) )
         {
-            notifyStatus = RTIO_ObNotify( pContext, pData, dataLength,
-                                          pObList->pArray[ i ],
-                                          RTIO_OBSERVA_NOTIFY_TIMEOUT_MS );
-
-            if( notifyStatus != RTIOContinue )
+            obId = pObList->pArray[ i ];
+            if( obId != 0 )
             {
-                if( notifyStatus == RTIOTimeout )
+                respBuffers[ batch ].pBuffer = respData[ batch ];
+                respBuffers[ batch ].size = RTIO_NOTIFY_RESP_SERIALIZE_BUFFER_SIZE;
+                notifyStatus = deviceSendRespList_Add( &( pContext->deviceSendRespList ), &respBuffers[ batch ],
+                                                       &headerIds[ batch ], &respIndexes[ batch ] );
+                if( ( notifyStatus == RTIOListFull ) && ( batch > 0 ) )
+                {
+                    /* Out of response items, collect the batch and retry this observer. */
+                    break;
+                }
+                if( notifyStatus != RTIOSuccess )
                 {
-                    LogError( ( "RTIO_ObNotify Timeout obId=%d.", pObList->pArray[ i ] ) );
+                    LogError( ( "RTIO_ObNotify failed obId=%d, status=%d.", obId, notifyStatus ) );
                 }
-                else if( notifyStatus == RTIOTerminate )
+                else
                 {
-                    LogInfo( ( "RTIO_ObNotify Terminate obId=%d.", pObList->pArray[ i ] ) );
-                    OS_MutexLock( pObList->pLock );
-                    pObList->pArray[ i ] = 0;
-                    if( pObList->obNumber > 0 )
-                    {
-                        pObList->obNumber--;
-                    }
-                    OS_MutexUnlock( pObList->pLock );
+                    slots[ batch ] = i;
+                    obIds[ batch ] = obId;
+                    batch++;
                 }
             }
+            i++;
+        }
+
+        (void)obNotify_SendShared( pContext, pData, dataLength, obIds, headerIds, batch, &sent );
+
+        for( j = 0; j < batch; j++ )
+        {
+            if( j >= sent )
+            {
+                (void)deviceSendRespList_Delete( &( pContext->deviceSendRespList ), respIndexes[ j ], headerIds[ j ] );
+                continue;
+            }
+            notifyStatus = obNotify_Collect( pContext, respIndexes[ j ], headerIds[ j ], RTIO_OBSERVA_NOTIFY_TIMEOUT_MS );
+            if( notifyStatus == RTIOContinue )
+            {
+                LogDebug( ( "RTIO_ObNotify Continue obId=%d.", obIds[ j ] ) );
+            }
+            else if( notifyStatus == RTIOTimeout )
+            {
+                LogError( ( "RTIO_ObNotify Timeout obId=%d.", obIds[ j ] ) );
+            }
+            else if( notifyStatus == RTIOTerminate )
+            {
+                LogInfo( ( "RTIO_ObNotify Terminate obId=%d.", obIds[ j ] ) );
+                obList_Remove( pObList, slots[ j ], obIds[ j ] );
+            }
             else
             {
-                LogDebug( ( "RTIO_ObNotify Continue obId=%d.", pObList->pArray[ i ] ) );
+                /* MISRA else. */
             }
         }
-        
     }
 
     return RTIOSuccess;
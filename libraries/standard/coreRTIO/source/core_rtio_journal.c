@@ -0,0 +1,1097 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#include <string.h>
+
+#include "core_rtio_journal.h"
+
+/*
+ * Layout on the storage, integers are big-endian:
+ *   segment header: magic(4) generation(4) firstSeq(4) ackedSeq(4) crc(4)
+ *   record:         magic(2) type(1) 0(1) length(2) seq(4) payload(length) crc(4), padded to 4 bytes
+ * The payload of a CoPost record is uri(4) and data, of an ObNotify record obId(2) and data.
+ * A checkpoint record has no payload, its seq is the last delivered data record.
+ * Records are appended to the segment of the highest generation, the segment of the lowest
+ * one is erased and reused when it is full. A crash leaves at most a torn record at the end,
+ * its CRC does not match and appending goes on in the next segment.
+ */
+
+#define RTIO_JOURNAL_SEGMENT_MAGIC ( 0x524A5347UL )
+#define RTIO_JOURNAL_RECORD_MAGIC ( 0x4A52U )
+#define RTIO_JOURNAL_RECORD_HEADER_SIZE ( 10U )
+#define RTIO_JOURNAL_RECORD_CRC_SIZE ( 4U )
+
+#define RTIO_JOURNAL_RECORD_COPOST ( 1U )
+#define RTIO_JOURNAL_RECORD_OBNOTIFY ( 2U )
+#define RTIO_JOURNAL_RECORD_CHECKPOINT ( 3U )
+
+#define RTIO_JOURNAL_SLOT_FREE ( 0U )
+#define RTIO_JOURNAL_SLOT_INFLIGHT ( 1U )
+#define RTIO_JOURNAL_SLOT_ACKED ( 2U )
+#define RTIO_JOURNAL_SLOT_FAILED ( 3U )
+
+#define RTIO_JOURNAL_TOKEN ( 1000U ) /* Tokens of one record. */
+#define RTIO_JOURNAL_WAIT_MAX_MS ( 1000U ) /* Longest sleep of the journal thread. */
+#define RTIO_JOURNAL_STOP_POLL_MS ( 5U )
+
+typedef struct rtioJournalRecord
+{
+    uint8_t type;
+    uint16_t length; /* Of the payload. */
+    uint32_t seq;
+    uint8_t* pPayload;
+    uint32_t size;   /* On the storage. */
+} rtioJournalRecord_t;
+
+/*-----------------------------------------------------------*/
+
+static void journal_Put16( uint8_t* p, uint16_t value )
+{
+    p[ 0 ] = (uint8_t)( value >> 8 );
+    p[ 1 ] = (uint8_t)( value );
+}
+
+static void journal_Put32( uint8_t* p, uint32_t value )
+{
+    p[ 0 ] = (uint8_t)( value >> 24 );
+    p[ 1 ] = (uint8_t)( value >> 16 );
+    p[ 2 ] = (uint8_t)( value >> 8 );
+    p[ 3 ] = (uint8_t)( value );
+}
+
+static uint16_t journal_Get16( const uint8_t* p )
+{
+    return (uint16_t)( ( (uint16_t)p[ 0 ] << 8 ) | p[ 1 ] );
+}
+
+static uint32_t journal_Get32( const uint8_t* p )
+{
+    return ( (uint32_t)p[ 0 ] << 24 ) | ( (uint32_t)p[ 1 ] << 16 ) | ( (uint32_t)p[ 2 ] << 8 ) | p[ 3 ];
+}
+
+/* Whether sequence a comes before b, across the wrap like timer deadlines. */
+static bool journal_SeqBefore( uint32_t a, uint32_t b )
+{
+    return (int32_t)( a - b ) < 0;
+}
+
+static uint32_t journal_RecordSize( uint16_t payloadLength )
+{
+    return ( RTIO_JOURNAL_RECORD_HEADER_SIZE + (uint32_t)payloadLength + RTIO_JOURNAL_RECORD_CRC_SIZE + 3U ) & ~3UL;
+}
+
+static uint16_t journal_Segment( const RTIOJournal_t* pJournal, uint32_t generation )
+{
+    return (uint16_t)( generation % pJournal->storage.segmentNum );
+}
+
+static void journal_Lock( const RTIOJournal_t* pJournal )
+{
+    if( OS_MutexLock( pJournal->pLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to lock the journal." ) );
+    }
+}
+
+static void journal_Unlock( const RTIOJournal_t* pJournal )
+{
+    if( OS_MutexUnlock( pJournal->pLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to unlock the journal." ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool journal_ReadSegmentHeader( RTIOJournal_t* pJournal, uint16_t segment,
+                                       uint32_t* pGeneration, uint32_t* pFirstSeq, uint32_t* pAckedSeq )
+{
+    uint8_t header[ RTIO_JOURNAL_SEGMENT_HEADER_SIZE ];
+
+    if( pJournal->storage.read( pJournal->storage.pStorageContext, segment, 0,
+                                header, sizeof( header ) ) != StorageSuccess )
+    {
+        LogError( ( "Failed to read the header of segment=%u.", segment ) );
+        return false;
+    }
+    if( ( journal_Get32( &header[ 0 ] ) != RTIO_JOURNAL_SEGMENT_MAGIC ) ||
+        ( journal_Get32( &header[ 16 ] ) != crc32Ieee( header, 16U ) ) )
+    {
+        return false;
+    }
+
+    *pGeneration = journal_Get32( &header[ 4 ] );
+    *pFirstSeq = journal_Get32( &header[ 8 ] );
+    *pAckedSeq = journal_Get32( &header[ 12 ] );
+    return journal_Segment( pJournal, *pGeneration ) == segment;
+}
+
+/* Erases the segment of the generation and starts it, durably before records go to it. */
+static RTIOStatus_t journal_StartSegment( RTIOJournal_t* pJournal, uint32_t generation )
+{
+    uint8_t header[ RTIO_JOURNAL_SEGMENT_HEADER_SIZE ];
+    uint16_t segment = journal_Segment( pJournal, generation );
+    StorageContext_t* pStorageContext = pJournal->storage.pStorageContext;
+
+    journal_Put32( &header[ 0 ], RTIO_JOURNAL_SEGMENT_MAGIC );
+    journal_Put32( &header[ 4 ], generation );
+    journal_Put32( &header[ 8 ], pJournal->nextSeq );
+    journal_Put32( &header[ 12 ], pJournal->ackedSeq );
+    journal_Put32( &header[ 16 ], crc32Ieee( header, 16U ) );
+
+    if( ( pJournal->storage.erase( pStorageContext, segment ) != StorageSuccess ) ||
+        ( pJournal->storage.write( pStorageContext, segment, 0, header, sizeof( header ) ) != StorageSuccess ) ||
+        ( pJournal->storage.sync( pStorageContext, segment ) != StorageSuccess ) )
+    {
+        LogError( ( "Failed to start segment=%u, generation=%u.", segment, (unsigned)generation ) );
+        return RTIOStorageFailed;
+    }
+
+    pJournal->activeGeneration = generation;
+    pJournal->writeOffset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+    pJournal->checkpointSeq = pJournal->ackedSeq; /* Carried by the header. */
+    return RTIOSuccess;
+}
+
+/* Decodes the record at the offset into pBuffer, false if there is no intact record. */
+static bool journal_DecodeAt( RTIOJournal_t* pJournal, uint32_t generation, uint32_t offset,
+                              uint8_t* pBuffer, rtioJournalRecord_t* pRecord )
+{
+    uint16_t segment = journal_Segment( pJournal, generation );
+    uint32_t segmentSize = pJournal->storage.segmentSize;
+    uint16_t length = 0;
+    uint32_t size = 0;
+
+    if( offset + RTIO_JOURNAL_RECORD_HEADER_SIZE + RTIO_JOURNAL_RECORD_CRC_SIZE > segmentSize )
+    {
+        return false;
+    }
+    if( pJournal->storage.read( pJournal->storage.pStorageContext, segment, offset,
+                                pBuffer, RTIO_JOURNAL_RECORD_HEADER_SIZE ) != StorageSuccess )
+    {
+        LogError( ( "Failed to read a record, segment=%u, offset=%u.", segment, (unsigned)offset ) );
+        return false;
+    }
+
+    length = journal_Get16( &pBuffer[ 4 ] );
+    size = journal_RecordSize( length );
+    if( ( journal_Get16( &pBuffer[ 0 ] ) != RTIO_JOURNAL_RECORD_MAGIC ) ||
+        ( pBuffer[ 2 ] < RTIO_JOURNAL_RECORD_COPOST ) || ( pBuffer[ 2 ] > RTIO_JOURNAL_RECORD_CHECKPOINT ) ||
+        ( size > RTIO_JOURNAL_RECORD_SIZE_MAX ) || ( offset + size > segmentSize ) )
+    {
+        return false;
+    }
+    if( pJournal->storage.read( pJournal->storage.pStorageContext, segment,
+                                offset + RTIO_JOURNAL_RECORD_HEADER_SIZE,
+                                &pBuffer[ RTIO_JOURNAL_RECORD_HEADER_SIZE ],
+                                size - RTIO_JOURNAL_RECORD_HEADER_SIZE ) != StorageSuccess )
+    {
+        LogError( ( "Failed to read a record, segment=%u, offset=%u.", segment, (unsigned)offset ) );
+        return false;
+    }
+    if( journal_Get32( &pBuffer[ RTIO_JOURNAL_RECORD_HEADER_SIZE + length ] ) !=
+        crc32Ieee( pBuffer, (uint16_t)( RTIO_JOURNAL_RECORD_HEADER_SIZE + length ) ) )
+    {
+        return false;
+    }
+
+    pRecord->type = pBuffer[ 2 ];
+    pRecord->length = length;
+    pRecord->seq = journal_Get32( &pBuffer[ 6 ] );
+    pRecord->pPayload = &pBuffer[ RTIO_JOURNAL_RECORD_HEADER_SIZE ];
+    pRecord->size = size;
+    return true;
+}
+
+/* Reads the record at *pPos or the first one after it, *pStart is where it is and */
+/* *pPos moves behind it. False at the end of the journal. */
+static bool journal_ReadRecord( RTIOJournal_t* pJournal, rtioJournalPosition_t* pPos,
+                                uint8_t* pBuffer, rtioJournalRecord_t* pRecord, rtioJournalPosition_t* pStart )
+{
+    if( pPos->generation < pJournal->oldestGeneration )
+    {
+        pPos->generation = pJournal->oldestGeneration;
+        pPos->offset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+    }
+
+    while( pPos->generation <= pJournal->activeGeneration )
+    {
+        if( ( pPos->generation == pJournal->activeGeneration ) && ( pPos->offset >= pJournal->writeOffset ) )
+        {
+            return false;
+        }
+        if( journal_DecodeAt( pJournal, pPos->generation, pPos->offset, pBuffer, pRecord ) )
+        {
+            *pStart = *pPos;
+            pPos->offset += pRecord->size;
+            return true;
+        }
+        if( pPos->generation == pJournal->activeGeneration )
+        {
+            return false;
+        }
+        /* The rest of a full segment is erased. */
+        pPos->generation++;
+        pPos->offset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+    }
+    return false;
+}
+
+/*-----------------------------------------------------------*/
+
+static RTIOStatus_t journal_Sync( RTIOJournal_t* pJournal )
+{
+    if( pJournal->pendingRecords == 0U )
+    {
+        return RTIOSuccess;
+    }
+
+    if( pJournal->storage.sync( pJournal->storage.pStorageContext,
+                                journal_Segment( pJournal, pJournal->activeGeneration ) ) != StorageSuccess )
+    {
+        LogError( ( "Failed to sync the journal, generation=%u.", (unsigned)pJournal->activeGeneration ) );
+        return RTIOStorageFailed;
+    }
+    pJournal->pendingRecords = 0;
+    pJournal->stats.syncs++;
+    return RTIOSuccess;
+}
+
+/* The oldest segment is reused while it holds undelivered records up to lastSeq, they are given up. */
+static void journal_DropOldest( RTIOJournal_t* pJournal, uint32_t lastSeq )
+{
+    uint32_t dropped = lastSeq - pJournal->ackedSeq;
+
+    LogWarn( ( "Journal full, drop records=%u of generation=%u.",
+               (unsigned)dropped, (unsigned)pJournal->oldestGeneration ) );
+    pJournal->ackedSeq = lastSeq;
+    pJournal->stats.dropped += dropped;
+    pJournal->stats.backlog = ( pJournal->stats.backlog > dropped ) ? ( pJournal->stats.backlog - dropped ) : 0U;
+}
+
+static RTIOStatus_t journal_Rotate( RTIOJournal_t* pJournal )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint32_t generation = pJournal->activeGeneration + 1U;
+    uint32_t nextGeneration = 0, firstSeq = 0, ackedSeq = 0;
+
+    status = journal_Sync( pJournal );
+    if( status != RTIOSuccess )
+    {
+        return status;
+    }
+
+    if( generation - pJournal->oldestGeneration >= pJournal->storage.segmentNum )
+    {
+        /* The data records of the oldest segment are the ones before the first of the next. */
+        if( journal_ReadSegmentHeader( pJournal, journal_Segment( pJournal, pJournal->oldestGeneration + 1U ),
+                                       &nextGeneration, &firstSeq, &ackedSeq ) &&
+            ( nextGeneration == pJournal->oldestGeneration + 1U ) &&
+            journal_SeqBefore( pJournal->ackedSeq, firstSeq - 1U ) )
+        {
+#if ( RTIO_JOURNAL_DROP_OLDEST != 0 )
+            journal_DropOldest( pJournal, firstSeq - 1U );
+#else
+            LogWarn( ( "Journal full, backlog=%u.", (unsigned)pJournal->stats.backlog ) );
+            return RTIOListFull;
+#endif
+        }
+        pJournal->oldestGeneration++;
+        if( pJournal->ackPos.generation < pJournal->oldestGeneration )
+        {
+            pJournal->ackPos.generation = pJournal->oldestGeneration;
+            pJournal->ackPos.offset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+        }
+        if( pJournal->replayPos.generation < pJournal->oldestGeneration )
+        {
+            pJournal->replayPos = pJournal->ackPos;
+        }
+    }
+
+    return journal_StartSegment( pJournal, generation );
+}
+
+/* The caller holds pLock, pKey and pData make the payload. */
+static RTIOStatus_t journal_Append( RTIOJournal_t* pJournal, uint8_t type, uint32_t seq,
+                                    const uint8_t* pKey, uint16_t keyLength,
+                                    const uint8_t* pData, uint16_t length )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint8_t* pBuffer = pJournal->appendBuffer;
+    uint16_t payloadLength = keyLength + length;
+    uint32_t size = journal_RecordSize( payloadLength );
+    uint32_t crcEnd = RTIO_JOURNAL_RECORD_HEADER_SIZE + payloadLength;
+
+    journal_Put16( &pBuffer[ 0 ], RTIO_JOURNAL_RECORD_MAGIC );
+    pBuffer[ 2 ] = type;
+    pBuffer[ 3 ] = 0;
+    journal_Put16( &pBuffer[ 4 ], payloadLength );
+    journal_Put32( &pBuffer[ 6 ], seq );
+    if( keyLength > 0U )
+    {
+        memcpy( &pBuffer[ RTIO_JOURNAL_RECORD_HEADER_SIZE ], pKey, keyLength );
+    }
+    if( length > 0U )
+    {
+        memcpy( &pBuffer[ RTIO_JOURNAL_RECORD_HEADER_SIZE + keyLength ], pData, length );
+    }
+    journal_Put32( &pBuffer[ crcEnd ], crc32Ieee( pBuffer, (uint16_t)crcEnd ) );
+    /* Padding left erased, programming it changes nothing on a flash. */
+    memset( &pBuffer[ crcEnd + RTIO_JOURNAL_RECORD_CRC_SIZE ], pJournal->storage.erasedValue,
+            size - crcEnd - RTIO_JOURNAL_RECORD_CRC_SIZE );
+
+    if( pJournal->writeOffset + size > pJournal->storage.segmentSize )
+    {
+        status = journal_Rotate( pJournal );
+        if( status != RTIOSuccess )
+        {
+            return status;
+        }
+    }
+
+    if( pJournal->storage.write( pJournal->storage.pStorageContext,
+                                 journal_Segment( pJournal, pJournal->activeGeneration ),
+                                 pJournal->writeOffset, pBuffer, size ) != StorageSuccess )
+    {
+        LogError( ( "Failed to append a record, generation=%u, offset=%u.",
+                    (unsigned)pJournal->activeGeneration, (unsigned)pJournal->writeOffset ) );
+        /* What was written can not be written again, the next record goes to a new segment. */
+        pJournal->writeOffset = pJournal->storage.segmentSize;
+        return RTIOStorageFailed;
+    }
+    pJournal->writeOffset += size;
+
+    if( pJournal->pendingRecords == 0U )
+    {
+        pJournal->firstPendingMs = OS_ClockGetTimeMs();
+    }
+    pJournal->pendingRecords++;
+    if( pJournal->pendingRecords >= RTIO_JOURNAL_SYNC_RECORDS )
+    {
+        /* The record is written, a failed sync is retried with the next batch. */
+        (void)journal_Sync( pJournal );
+    }
+    return RTIOSuccess;
+}
+
+static RTIOStatus_t journal_AppendData( RTIOJournal_t* pJournal, uint8_t type,
+                                        const uint8_t* pKey, uint16_t keyLength,
+                                        const uint8_t* pData, uint16_t length )
+{
+    RTIOStatus_t status = RTIOSuccess;
+
+    journal_Lock( pJournal );
+    status = journal_Append( pJournal, type, pJournal->nextSeq, pKey, keyLength, pData, length );
+    if( status == RTIOSuccess )
+    {
+        pJournal->nextSeq++;
+        pJournal->stats.appended++;
+        pJournal->stats.backlog++;
+    }
+    journal_Unlock( pJournal );
+
+    if( OS_EventSignal( pJournal->pEvent ) != OSSuccess )
+    {
+        LogError( ( "Failed to signal the journal event." ) );
+    }
+    return status;
+}
+
+/* Records the delivered sequence, so a restart does not send those records again. */
+static RTIOStatus_t journal_WriteCheckpoint( RTIOJournal_t* pJournal )
+{
+    RTIOStatus_t status = RTIOSuccess;
+
+    if( pJournal->ackedSeq == pJournal->checkpointSeq )
+    {
+        return RTIOSuccess;
+    }
+
+    status = journal_Append( pJournal, RTIO_JOURNAL_RECORD_CHECKPOINT, pJournal->ackedSeq, NULL, 0, NULL, 0 );
+    if( status == RTIOSuccess )
+    {
+        pJournal->checkpointSeq = pJournal->ackedSeq;
+    }
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Whether the rest of the active segment is erased, so appending can go on there. */
+static bool journal_TailErased( RTIOJournal_t* pJournal )
+{
+    uint32_t offset = pJournal->writeOffset;
+    uint32_t chunk = 0, i = 0;
+
+    while( offset < pJournal->storage.segmentSize )
+    {
+        chunk = pJournal->storage.segmentSize - offset;
+        if( chunk > RTIO_JOURNAL_RECORD_SIZE_MAX )
+        {
+            chunk = RTIO_JOURNAL_RECORD_SIZE_MAX;
+        }
+        if( pJournal->storage.read( pJournal->storage.pStorageContext,
+                                    journal_Segment( pJournal, pJournal->activeGeneration ),
+                                    offset, pJournal->appendBuffer, chunk ) != StorageSuccess )
+        {
+            return false;
+        }
+        for( i = 0; i < chunk; i++ )
+        {
+            if( pJournal->appendBuffer[ i ] != pJournal->storage.erasedValue )
+            {
+                return false;
+            }
+        }
+        offset += chunk;
+    }
+    return true;
+}
+
+/* Finds the segments and records left by the last run. */
+static RTIOStatus_t journal_Recover( RTIOJournal_t* pJournal )
+{
+    uint32_t generation = 0, firstSeq = 0, ackedSeq = 0;
+    uint32_t activeFirstSeq = 0;
+    uint32_t offset = 0;
+    bool found = false;
+    uint16_t segment = 0;
+    rtioJournalRecord_t record = { 0 };
+    rtioJournalPosition_t pos = { 0 }, start = { 0 };
+
+    /* The segment of the highest generation is the active one. */
+    for( segment = 0; segment < pJournal->storage.segmentNum; segment++ )
+    {
+        if( journal_ReadSegmentHeader( pJournal, segment, &generation, &firstSeq, &ackedSeq ) &&
+            ( !found || ( generation > pJournal->activeGeneration ) ) )
+        {
+            found = true;
+            pJournal->activeGeneration = generation;
+            pJournal->ackedSeq = ackedSeq;
+            activeFirstSeq = firstSeq;
+        }
+    }
+    if( !found )
+    {
+        LogInfo( ( "No journal on the storage, start a new one." ) );
+        pJournal->nextSeq = 1;
+        pJournal->ackedSeq = 0;
+        pJournal->oldestGeneration = 0;
+        pJournal->ackPos.generation = 0;
+        pJournal->ackPos.offset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+        pJournal->replayPos = pJournal->ackPos;
+        return journal_StartSegment( pJournal, 0 );
+    }
+
+    /* Older generations are in the segments before it, back to the first missing one. */
+    pJournal->oldestGeneration = pJournal->activeGeneration;
+    while( ( pJournal->oldestGeneration > 0U ) &&
+           ( pJournal->activeGeneration - pJournal->oldestGeneration + 1U < pJournal->storage.segmentNum ) &&
+           journal_ReadSegmentHeader( pJournal, journal_Segment( pJournal, pJournal->oldestGeneration - 1U ),
+                                      &generation, &firstSeq, &ackedSeq ) &&
+           ( generation == pJournal->oldestGeneration - 1U ) )
+    {
+        pJournal->oldestGeneration--;
+        if( journal_SeqBefore( pJournal->ackedSeq, ackedSeq ) )
+        {
+            pJournal->ackedSeq = ackedSeq;
+        }
+    }
+
+    /* The records give the next sequence and the last checkpoint, the first */
+    /* record that is not intact ends a segment. */
+    pJournal->nextSeq = activeFirstSeq;
+    for( generation = pJournal->oldestGeneration; generation <= pJournal->activeGeneration; generation++ )
+    {
+        offset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+        while( journal_DecodeAt( pJournal, generation, offset, pJournal->replayBuffer, &record ) )
+        {
+            if( record.type == RTIO_JOURNAL_RECORD_CHECKPOINT )
+            {
+                if( journal_SeqBefore( pJournal->ackedSeq, record.seq ) )
+                {
+                    pJournal->ackedSeq = record.seq;
+                }
+            }
+            else if( !journal_SeqBefore( record.seq, pJournal->nextSeq ) )
+            {
+                pJournal->nextSeq = record.seq + 1U;
+            }
+            else
+            {
+                /* MISRA else. */
+            }
+            offset += record.size;
+        }
+    }
+    pJournal->writeOffset = offset;
+    pJournal->checkpointSeq = pJournal->ackedSeq;
+    if( !journal_TailErased( pJournal ) )
+    {
+        LogWarn( ( "Torn record at the end of the journal, generation=%u, offset=%u.",
+                   (unsigned)pJournal->activeGeneration, (unsigned)offset ) );
+        pJournal->writeOffset = pJournal->storage.segmentSize;
+    }
+
+    /* The backlog starts at the first data record after the checkpoint. */
+    pJournal->ackPos.generation = pJournal->activeGeneration;
+    pJournal->ackPos.offset = pJournal->writeOffset;
+    pos.generation = pJournal->oldestGeneration;
+    pos.offset = RTIO_JOURNAL_SEGMENT_HEADER_SIZE;
+    found = false;
+    while( journal_ReadRecord( pJournal, &pos, pJournal->replayBuffer, &record, &start ) )
+    {
+        if( ( record.type != RTIO_JOURNAL_RECORD_CHECKPOINT ) && journal_SeqBefore( pJournal->ackedSeq, record.seq ) )
+        {
+            if( !found )
+            {
+                found = true;
+                pJournal->ackPos = start;
+            }
+            pJournal->stats.backlog++;
+        }
+    }
+    pJournal->replayPos = pJournal->ackPos;
+
+    LogInfo( ( "Journal recovered, generations=%u..%u, backlog=%u, nextSeq=%u.",
+               (unsigned)pJournal->oldestGeneration, (unsigned)pJournal->activeGeneration,
+               (unsigned)pJournal->stats.backlog, (unsigned)pJournal->nextSeq ) );
+    return RTIOSuccess;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Whether the server answered, resending would not change the answer unless it was too busy. */
+static bool journal_Delivered( RTIOStatus_t status )
+{
+    return ( status != RTIOTimeout ) && ( status != RTIOListFull ) && ( status != RTIOTooManyRequests ) &&
+           ( ( status < RTIOConnectFailedNeverRetry ) || ( status > RTIOTransportImplementError ) );
+}
+
+static uint16_t journal_InFlight( const RTIOJournal_t* pJournal )
+{
+    uint16_t i = 0, count = 0;
+
+    for( i = 0; i < RTIO_JOURNAL_REPLAY_WINDOW; i++ )
+    {
+        if( pJournal->slots[ i ].state == RTIO_JOURNAL_SLOT_INFLIGHT )
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void journal_FreeSlots( RTIOJournal_t* pJournal )
+{
+    uint16_t i = 0;
+
+    for( i = 0; i < RTIO_JOURNAL_REPLAY_WINDOW; i++ )
+    {
+        pJournal->slots[ i ].state = RTIO_JOURNAL_SLOT_FREE;
+    }
+}
+
+/* Moves ackedSeq over the delivered records in sequence, answers may arrive out of order. */
+static void journal_AdvanceAcks( RTIOJournal_t* pJournal )
+{
+    rtioJournalSlot_t* pSlot = NULL;
+    bool advanced = true;
+    uint16_t i = 0;
+
+    while( advanced )
+    {
+        advanced = false;
+        for( i = 0; i < RTIO_JOURNAL_REPLAY_WINDOW; i++ )
+        {
+            pSlot = &( pJournal->slots[ i ] );
+            if( pSlot->state != RTIO_JOURNAL_SLOT_ACKED )
+            {
+                continue;
+            }
+            if( pSlot->seq == pJournal->ackedSeq + 1U )
+            {
+                pJournal->ackedSeq = pSlot->seq;
+                pJournal->ackPos = pSlot->next;
+                pJournal->stats.replayed++;
+                pJournal->stats.backlog--;
+                pSlot->state = RTIO_JOURNAL_SLOT_FREE;
+                advanced = true;
+            }
+            else if( !journal_SeqBefore( pJournal->ackedSeq, pSlot->seq ) )
+            {
+                /* Dropped meanwhile as the journal was full. */
+                pSlot->state = RTIO_JOURNAL_SLOT_FREE;
+            }
+            else
+            {
+                /* MISRA else. */
+            }
+        }
+    }
+}
+
+static void journal_Complete( rtioJournalSlot_t* pSlot, RTIOStatus_t status )
+{
+    RTIOJournal_t* pJournal = (RTIOJournal_t*)pSlot->pJournal;
+
+    journal_Lock( pJournal );
+    if( pSlot->state == RTIO_JOURNAL_SLOT_INFLIGHT )
+    {
+        if( journal_Delivered( status ) )
+        {
+            pSlot->state = RTIO_JOURNAL_SLOT_ACKED;
+            journal_AdvanceAcks( pJournal );
+        }
+        else
+        {
+            LogWarn( ( "Replayed record not answered, seq=%u, status=%d.", (unsigned)pSlot->seq, status ) );
+            pSlot->state = RTIO_JOURNAL_SLOT_FAILED;
+            if( !pJournal->rewind )
+            {
+                pJournal->rewind = true;
+                pJournal->retryMs = OS_ClockGetTimeMs() + RTIO_JOURNAL_REPLAY_RETRY_MS;
+            }
+        }
+    }
+    journal_Unlock( pJournal );
+
+    if( OS_EventSignal( pJournal->pEvent ) != OSSuccess )
+    {
+        LogError( ( "Failed to signal the journal event." ) );
+    }
+}
+
+static void journal_CoPostCompleted( void* pUserData, RTIOStatus_t status,
+                                     uint8_t* pRespData, uint16_t respLength )
+{
+    (void)pRespData;
+    (void)respLength;
+    journal_Complete( (rtioJournalSlot_t*)pUserData, status );
+}
+
+static void journal_ObNotifyCompleted( void* pUserData, RTIOStatus_t status, uint16_t obId )
+{
+    (void)obId;
+    journal_Complete( (rtioJournalSlot_t*)pUserData, status );
+}
+
+static RTIOStatus_t journal_SendRecord( RTIOContext_t* pContext, rtioJournalSlot_t* pSlot,
+                                        const rtioJournalRecord_t* pRecord )
+{
+    if( ( pRecord->type == RTIO_JOURNAL_RECORD_COPOST ) && ( pRecord->length >= 4U ) )
+    {
+        return RTIO_CoPostAsync( pContext, journal_Get32( pRecord->pPayload ),
+                                 &( pRecord->pPayload[ 4 ] ), (uint16_t)( pRecord->length - 4U ),
+                                 &( pSlot->respBuffer ), RTIO_JOURNAL_REPLAY_TIMEOUT_MS,
+                                 journal_CoPostCompleted, pSlot );
+    }
+    if( ( pRecord->type == RTIO_JOURNAL_RECORD_OBNOTIFY ) && ( pRecord->length >= 2U ) )
+    {
+        return RTIO_ObNotifyAsync( pContext, &( pRecord->pPayload[ 2 ] ), (uint16_t)( pRecord->length - 2U ),
+                                   journal_Get16( pRecord->pPayload ), RTIO_JOURNAL_REPLAY_TIMEOUT_MS,
+                                   journal_ObNotifyCompleted, pSlot );
+    }
+    LogError( ( "Bad record, type=%u, length=%u.", pRecord->type, pRecord->length ) );
+    return RTIOBadParameter;
+}
+
+/* Sends what the rate allows, the caller holds pLock which is released while sending. */
+/* Returns how long the journal thread may wait before the next record can go. */
+static uint32_t journal_RunReplay( RTIOJournal_t* pJournal, uint32_t nowMs )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOContext_t* pContext = pJournal->pContext;
+    rtioJournalSlot_t* pSlot = NULL;
+    rtioJournalRecord_t record = { 0 };
+    rtioJournalPosition_t start = { 0 };
+    uint32_t elapsedMs = 0;
+    uint16_t i = 0;
+
+    if( pContext == NULL )
+    {
+        return RTIO_JOURNAL_WAIT_MAX_MS;
+    }
+
+    if( ( pJournal->ackedSeq - pJournal->checkpointSeq >= RTIO_JOURNAL_CHECKPOINT_RECORDS ) ||
+        ( pJournal->stats.backlog == 0U ) )
+    {
+        (void)journal_WriteCheckpoint( pJournal );
+    }
+
+    if( pJournal->rewind )
+    {
+        if( journal_InFlight( pJournal ) > 0U )
+        {
+            return RTIO_JOURNAL_WAIT_MAX_MS;
+        }
+        /* Delivered records behind the failed one are sent again, at least once. */
+        journal_FreeSlots( pJournal );
+        pJournal->replayPos = pJournal->ackPos;
+        pJournal->rewind = false;
+        pJournal->stats.retries++;
+    }
+    if( (int32_t)( nowMs - pJournal->retryMs ) < 0 )
+    {
+        return pJournal->retryMs - nowMs;
+    }
+
+    /* At most one record ahead, the backlog never comes in bursts. */
+    elapsedMs = nowMs - pJournal->refillMs;
+    pJournal->refillMs = nowMs;
+    if( elapsedMs > RTIO_JOURNAL_TOKEN )
+    {
+        elapsedMs = RTIO_JOURNAL_TOKEN;
+    }
+    pJournal->tokens += elapsedMs * pJournal->recordsPerSecond;
+    if( pJournal->tokens > RTIO_JOURNAL_TOKEN )
+    {
+        pJournal->tokens = RTIO_JOURNAL_TOKEN;
+    }
+
+    while( !pJournal->done && ( pJournal->pContext == pContext ) )
+    {
+        if( pJournal->tokens < RTIO_JOURNAL_TOKEN )
+        {
+            return ( RTIO_JOURNAL_TOKEN - pJournal->tokens + pJournal->recordsPerSecond - 1U ) /
+                   pJournal->recordsPerSecond;
+        }
+
+        pSlot = NULL;
+        for( i = 0; ( pSlot == NULL ) && ( i < RTIO_JOURNAL_REPLAY_WINDOW ); i++ )
+        {
+            if( pJournal->slots[ i ].state == RTIO_JOURNAL_SLOT_FREE )
+            {
+                pSlot = &( pJournal->slots[ i ] );
+            }
+        }
+        if( pSlot == NULL )
+        {
+            return RTIO_JOURNAL_WAIT_MAX_MS; /* Signaled when an answer frees a slot. */
+        }
+
+        do
+        {
+            if( !journal_ReadRecord( pJournal, &( pJournal->replayPos ), pJournal->replayBuffer, &record, &start ) )
+            {
+                return RTIO_JOURNAL_WAIT_MAX_MS; /* Signaled when a record is appended. */
+            }
+        } while( ( record.type == RTIO_JOURNAL_RECORD_CHECKPOINT ) ||
+                 !journal_SeqBefore( pJournal->ackedSeq, record.seq ) );
+
+        pSlot->state = RTIO_JOURNAL_SLOT_INFLIGHT;
+        pSlot->seq = record.seq;
+        pSlot->next = pJournal->replayPos;
+        pJournal->tokens -= RTIO_JOURNAL_TOKEN;
+
+        /* The answer may complete the slot before the send returns, it takes pLock. */
+        journal_Unlock( pJournal );
+        status = journal_SendRecord( pContext, pSlot, &record );
+        journal_Lock( pJournal );
+
+        if( status != RTIOSuccess )
+        {
+            LogWarn( ( "Failed to replay record, seq=%u, status=%d.", (unsigned)record.seq, status ) );
+            pSlot->state = RTIO_JOURNAL_SLOT_FREE;
+            pJournal->rewind = true;
+            pJournal->retryMs = OS_ClockGetTimeMs() + RTIO_JOURNAL_REPLAY_RETRY_MS;
+            return 0;
+        }
+    }
+    return RTIO_JOURNAL_WAIT_MAX_MS;
+}
+
+/* Syncs the batch once the oldest pending record waited RTIO_JOURNAL_SYNC_MS. */
+static uint32_t journal_RunSync( RTIOJournal_t* pJournal, uint32_t nowMs )
+{
+    uint32_t elapsedMs = 0;
+
+    if( pJournal->pendingRecords == 0U )
+    {
+        return RTIO_JOURNAL_WAIT_MAX_MS;
+    }
+    elapsedMs = nowMs - pJournal->firstPendingMs;
+    if( elapsedMs < RTIO_JOURNAL_SYNC_MS )
+    {
+        return RTIO_JOURNAL_SYNC_MS - elapsedMs;
+    }
+    (void)journal_Sync( pJournal );
+    return RTIO_JOURNAL_WAIT_MAX_MS;
+}
+
+static void journalProccess( void* pParam )
+{
+    RTIOJournal_t* pJournal = (RTIOJournal_t*)pParam;
+    uint32_t waitMs = 0, replayWaitMs = 0;
+
+    LogInfo( ( "Journal proccess started." ) );
+
+    journal_Lock( pJournal );
+    while( !pJournal->done )
+    {
+        waitMs = journal_RunSync( pJournal, OS_ClockGetTimeMs() );
+        replayWaitMs = journal_RunReplay( pJournal, OS_ClockGetTimeMs() );
+        if( replayWaitMs < waitMs )
+        {
+            waitMs = replayWaitMs;
+        }
+        journal_Unlock( pJournal );
+
+        if( waitMs > 0U )
+        {
+            (void)OS_EventWait( pJournal->pEvent, waitMs );
+        }
+        journal_Lock( pJournal );
+    }
+    pJournal->threadExited = true;
+    journal_Unlock( pJournal );
+
+    LogInfo( ( "Journal proccess stopped." ) );
+}
+
+/*-----------------------------------------------------------*/
+
+RTIOStatus_t RTIO_JournalOpen( RTIOJournal_t* pJournal,
+                               const RTIOJournalFixedResource_t* pFixedResource,
+                               const StorageInterface_t* pStorage )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t i = 0;
+
+    if( ( pJournal == NULL ) || ( pFixedResource == NULL ) || ( pStorage == NULL ) ||
+        ( pFixedResource->pThread == NULL ) || ( pFixedResource->pLock == NULL ) || ( pFixedResource->pEvent == NULL ) ||
+        ( pStorage->read == NULL ) || ( pStorage->write == NULL ) || ( pStorage->sync == NULL ) || ( pStorage->erase == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pJournal=%p, pFixedResource=%p, pStorage=%p.",
+                    (void*)pJournal, (const void*)pFixedResource, (const void*)pStorage ) );
+        return RTIOBadParameter;
+    }
+    /* A record must fit a segment, and the oldest segment is erased only when another holds the journal. */
+    if( ( pStorage->segmentNum < 2U ) ||
+        ( pStorage->segmentSize < RTIO_JOURNAL_SEGMENT_HEADER_SIZE + RTIO_JOURNAL_RECORD_SIZE_MAX ) )
+    {
+        LogError( ( "Storage too small: segmentNum=%u, segmentSize=%u, needs 2 and %u.",
+                    pStorage->segmentNum, (unsigned)pStorage->segmentSize,
+                    (unsigned)( RTIO_JOURNAL_SEGMENT_HEADER_SIZE + RTIO_JOURNAL_RECORD_SIZE_MAX ) ) );
+        return RTIOBadParameter;
+    }
+
+    memset( pJournal, 0, sizeof( RTIOJournal_t ) );
+    pJournal->storage = *pStorage;
+    pJournal->pThread = pFixedResource->pThread;
+    pJournal->pLock = pFixedResource->pLock;
+    pJournal->pEvent = pFixedResource->pEvent;
+    for( i = 0; i < RTIO_JOURNAL_REPLAY_WINDOW; i++ )
+    {
+        pJournal->slots[ i ].pJournal = pJournal;
+        pJournal->slots[ i ].respBuffer.pBuffer = pJournal->slots[ i ].respData;
+        pJournal->slots[ i ].respBuffer.size = RTIO_JOURNAL_REPLAY_RESP_SIZE;
+    }
+
+    if( OS_MutexCreate( pJournal->pLock ) != OSSuccess )
+    {
+        LogError( ( "Failed to create the journal lock." ) );
+        return RTIOMutexFailure;
+    }
+    if( OS_EventCreate( pJournal->pEvent ) != OSSuccess )
+    {
+        LogError( ( "Failed to create the journal event." ) );
+        (void)OS_MutexDestroy( pJournal->pLock );
+        return RTIOMutexFailure;
+    }
+
+    status = journal_Recover( pJournal );
+    if( status == RTIOSuccess )
+    {
+        if( OS_ThreadCreate( pJournal->pThread, journalProccess, pJournal,
+                             "JournalProccess", RTIO_THREAD_JOURNAL_STACK_SIZE ) != OSSuccess )
+        {
+            LogError( ( "Failed to create the journal thread." ) );
+            status = RTIOThreadCreateFailed;
+        }
+    }
+    if( status != RTIOSuccess )
+    {
+        (void)OS_EventDestroy( pJournal->pEvent );
+        (void)OS_MutexDestroy( pJournal->pLock );
+    }
+    return status;
+}
+
+RTIOStatus_t RTIO_JournalClose( RTIOJournal_t* pJournal )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    bool exited = false;
+
+    if( ( pJournal == NULL ) || ( pJournal->pContext != NULL ) )
+    {
+        LogError( ( "Journal is NULL or still replaying: pJournal=%p.", (void*)pJournal ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Lock( pJournal );
+    pJournal->done = true;
+    journal_Unlock( pJournal );
+    while( !exited )
+    {
+        (void)OS_EventSignal( pJournal->pEvent );
+        OS_ClockSleepMs( 1U );
+        journal_Lock( pJournal );
+        exited = pJournal->threadExited;
+        journal_Unlock( pJournal );
+    }
+    /* The thread returned, this only reclaims it. */
+    (void)OS_ThreadDestroy( pJournal->pThread );
+
+    journal_Lock( pJournal );
+    status = journal_WriteCheckpoint( pJournal );
+    if( status == RTIOSuccess )
+    {
+        status = journal_Sync( pJournal );
+    }
+    journal_Unlock( pJournal );
+
+    (void)OS_EventDestroy( pJournal->pEvent );
+    (void)OS_MutexDestroy( pJournal->pLock );
+    return status;
+}
+
+RTIOStatus_t RTIO_JournalCoPost( RTIOJournal_t* pJournal, uint32_t uri,
+                                 const uint8_t* pData, uint16_t length )
+{
+    uint8_t key[ 4 ];
+
+    if( ( pJournal == NULL ) || ( ( pData == NULL ) && ( length > 0U ) ) ||
+        ( length > RTIO_JOURNAL_DATA_SIZE_MAX ) )
+    {
+        LogError( ( "Invalid parameter: pJournal=%p, pData=%p, length=%u.",
+                    (void*)pJournal, (const void*)pData, length ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Put32( key, uri );
+    return journal_AppendData( pJournal, RTIO_JOURNAL_RECORD_COPOST, key, sizeof( key ), pData, length );
+}
+
+RTIOStatus_t RTIO_JournalObNotify( RTIOJournal_t* pJournal, uint16_t obId,
+                                   const uint8_t* pData, uint16_t length )
+{
+    uint8_t key[ 2 ];
+
+    if( ( pJournal == NULL ) || ( ( pData == NULL ) && ( length > 0U ) ) ||
+        ( length > RTIO_JOURNAL_DATA_SIZE_MAX ) )
+    {
+        LogError( ( "Invalid parameter: pJournal=%p, pData=%p, length=%u.",
+                    (void*)pJournal, (const void*)pData, length ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Put16( key, obId );
+    return journal_AppendData( pJournal, RTIO_JOURNAL_RECORD_OBNOTIFY, key, sizeof( key ), pData, length );
+}
+
+RTIOStatus_t RTIO_JournalSync( RTIOJournal_t* pJournal )
+{
+    RTIOStatus_t status = RTIOSuccess;
+
+    if( pJournal == NULL )
+    {
+        LogError( ( "pJournal is NULL." ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Lock( pJournal );
+    status = journal_Sync( pJournal );
+    journal_Unlock( pJournal );
+    return status;
+}
+
+RTIOStatus_t RTIO_JournalStartReplay( RTIOJournal_t* pJournal, RTIOContext_t* pContext,
+                                      uint32_t recordsPerSecond )
+{
+    if( ( pJournal == NULL ) || ( pContext == NULL ) || ( recordsPerSecond == 0U ) ||
+        ( recordsPerSecond > RTIO_JOURNAL_TOKEN ) )
+    {
+        LogError( ( "Invalid parameter: pJournal=%p, pContext=%p, recordsPerSecond=%u.",
+                    (void*)pJournal, (void*)pContext, (unsigned)recordsPerSecond ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Lock( pJournal );
+    pJournal->pContext = pContext;
+    pJournal->recordsPerSecond = recordsPerSecond;
+    pJournal->tokens = RTIO_JOURNAL_TOKEN;
+    pJournal->refillMs = OS_ClockGetTimeMs();
+    pJournal->retryMs = pJournal->refillMs;
+    pJournal->replayPos = pJournal->ackPos;
+    pJournal->rewind = false;
+    LogInfo( ( "Journal replay started, backlog=%u, recordsPerSecond=%u.",
+               (unsigned)pJournal->stats.backlog, (unsigned)recordsPerSecond ) );
+    journal_Unlock( pJournal );
+
+    if( OS_EventSignal( pJournal->pEvent ) != OSSuccess )
+    {
+        LogError( ( "Failed to signal the journal event." ) );
+    }
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIO_JournalStopReplay( RTIOJournal_t* pJournal )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint32_t startMs = 0;
+    uint16_t inFlight = 0;
+
+    if( pJournal == NULL )
+    {
+        LogError( ( "pJournal is NULL." ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Lock( pJournal );
+    pJournal->pContext = NULL;
+    inFlight = journal_InFlight( pJournal );
+    journal_Unlock( pJournal );
+
+    /* The records in flight are answered or time out with the context still serving. */
+    startMs = OS_ClockGetTimeMs();
+    while( ( inFlight > 0U ) &&
+           ( OS_ClockGetTimeMs() - startMs < RTIO_JOURNAL_REPLAY_TIMEOUT_MS + RTIO_JOURNAL_WAIT_MAX_MS ) )
+    {
+        OS_ClockSleepMs( RTIO_JOURNAL_STOP_POLL_MS );
+        journal_Lock( pJournal );
+        inFlight = journal_InFlight( pJournal );
+        journal_Unlock( pJournal );
+    }
+
+    journal_Lock( pJournal );
+    if( inFlight > 0U )
+    {
+        LogWarn( ( "Journal replay stopped with records in flight=%u.", inFlight ) );
+        status = RTIOTimeout;
+    }
+    journal_FreeSlots( pJournal );
+    pJournal->replayPos = pJournal->ackPos;
+    pJournal->rewind = false;
+    (void)journal_WriteCheckpoint( pJournal );
+    journal_Unlock( pJournal );
+    return status;
+}
+
+RTIOStatus_t RTIO_JournalGetStats( RTIOJournal_t* pJournal, RTIOJournalStats_t* pStats )
+{
+    if( ( pJournal == NULL ) || ( pStats == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pJournal=%p, pStats=%p.", (void*)pJournal, (void*)pStats ) );
+        return RTIOBadParameter;
+    }
+
+    journal_Lock( pJournal );
+    *pStats = pJournal->stats;
+    journal_Unlock( pJournal );
+    return RTIOSuccess;
+}
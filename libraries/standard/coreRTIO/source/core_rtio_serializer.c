@@ -270,6 +270,13 @@ RTIOStatus_t RTIO_DeSerializeDeviceSendResp( const RTIOHeader_t* pHeader,
         return RTIOProtocalFailed;
     }
 
+    if( ( pResp->pFixedBuffer == NULL ) || ( pHeader->bodyLen > pResp->pFixedBuffer->size ) )
+    {
+        LogError( ( "Response buffer too small: pFixedBuffer=%p, bodyLen=%u.",
+                    (void*)pResp->pFixedBuffer, pHeader->bodyLen ) );
+        return RTIONoMemory;
+    }
+
     pResp->headerId = pHeader->id;
     pResp->code = pHeader->code;
     pResp->respLength = pHeader->bodyLen;
@@ -302,11 +309,12 @@ RTIOStatus_t RTIO_DeSerializeCoResp_FromDeviceSendResp( const rtioDeviceSendResp
     pCoResp->dataLength = pDeviceSendResp->respLength - RTIO_REST_HEADER_LENGTH_CO_RESP;
     return RTIOSuccess;
 }
-RTIOStatus_t RTIO_SerializeCoReq_OverDeviceSendReq( const RTIOCoReq_t* pReq,
-                                                    const RTIOFixedBuffer_t* pFixedBuffer,
-                                                    uint16_t* dataLength )
+RTIOStatus_t RTIO_SerializeCoReqHeader_OverDeviceSendReq( const RTIOCoReq_t* pReq,
+                                                          const RTIOFixedBuffer_t* pFixedBuffer,
+                                                          uint16_t* headerLength )
 {
     RTIOStatus_t status = RTIOSuccess;
+    RTIOHeader_t Header = { 0 };
 
     if( ( pReq == NULL ) || ( pFixedBuffer == NULL ) || ( pFixedBuffer->pBuffer == NULL ) )
     {
@@ -317,7 +325,8 @@ RTIOStatus_t RTIO_SerializeCoReq_OverDeviceSendReq( const RTIOCoReq_t* pReq,
         return RTIOBadParameter;
     }
 
-    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_REQ + pReq->dataLength > pFixedBuffer->size )
+    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_REQ > pFixedBuffer->size ||
+        RTIO_REST_HEADER_LENGTH_CO_REQ + pReq->dataLength > capLevelToSize[ RTIO_CAP_LEVEL_MAX ] )
     {
         LogError( ( "Buffer size is not enough: RTIO_PROTOCAL_HEADER_LEN=%u, RTIO_REST_HEADER_LENGTH_CO_REQ=%u, pReq->dataLength=%u, bufsize=%u.",
                     RTIO_PROTOCAL_HEADER_LEN,
@@ -333,11 +342,8 @@ RTIOStatus_t RTIO_SerializeCoReq_OverDeviceSendReq( const RTIOCoReq_t* pReq,
     pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 2 ] = ( pReq->uri >> 16 ) & 0xFF;
     pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 3 ] = ( pReq->uri >> 8 ) & 0xFF;
     pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 4 ] = ( pReq->uri ) & 0xFF;
-    memcpy( &pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_REQ ],
-            pReq->pData, pReq->dataLength );
 
     // serialize header
-    RTIOHeader_t Header = { 0 };
     Header.id = pReq->headerId;
     Header.type = RTIO_TYPE_DEVICE_SEND_REQ;
     Header.version = RTIO_PROTOCAL_VERSION;
@@ -349,13 +355,52 @@ RTIOStatus_t RTIO_SerializeCoReq_OverDeviceSendReq( const RTIOCoReq_t* pReq,
     {
         return status;
     }
-    *dataLength = Header.bodyLen + RTIO_PROTOCAL_HEADER_LEN;
+    *headerLength = RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_REQ;
     return status;
 }
-RTIOStatus_t RTIO_SerializeCoResp_OverServerSendResp( const RTIOCoResp_t* pResp,
-                                                      const RTIOFixedBuffer_t* pFixedBuffer,
-                                                      uint16_t* length )
+
+RTIOStatus_t RTIO_SerializeCoReq_OverDeviceSendReq( const RTIOCoReq_t* pReq,
+                                                    const RTIOFixedBuffer_t* pFixedBuffer,
+                                                    uint16_t* dataLength )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t headerLength = 0;
+
+    if( ( pReq == NULL ) || ( pFixedBuffer == NULL ) || ( pFixedBuffer->pBuffer == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pReq=%p, pFixedBuffer=%p, pFixedBuffer->pBuffer=%p.",
+                    (void*)pReq,
+                    (void*)pFixedBuffer,
+                    (void*)pFixedBuffer->pBuffer ) );
+        return RTIOBadParameter;
+    }
+
+    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_REQ + pReq->dataLength > pFixedBuffer->size )
+    {
+        LogError( ( "Buffer size is not enough: RTIO_PROTOCAL_HEADER_LEN=%u, RTIO_REST_HEADER_LENGTH_CO_REQ=%u, pReq->dataLength=%u, bufsize=%u.",
+                    RTIO_PROTOCAL_HEADER_LEN,
+                    RTIO_REST_HEADER_LENGTH_CO_REQ,
+                    pReq->dataLength,
+                    pFixedBuffer->size ) );
+        return RTIOBadParameter;
+    }
+
+    status = RTIO_SerializeCoReqHeader_OverDeviceSendReq( pReq, pFixedBuffer, &headerLength );
+    if( status != RTIOSuccess )
+    {
+        return status;
+    }
+    memcpy( &pFixedBuffer->pBuffer[ headerLength ], pReq->pData, pReq->dataLength );
+    *dataLength = headerLength + pReq->dataLength;
+    return status;
+}
+RTIOStatus_t RTIO_SerializeCoRespHeader_OverServerSendResp( const RTIOCoResp_t* pResp,
+                                                            const RTIOFixedBuffer_t* pFixedBuffer,
+                                                            uint16_t* headerLength )
 {
+    RTIOStatus_t status = RTIOSuccess;
+    RTIOHeader_t Header = { 0 };
+
     if( ( pResp == NULL ) || ( pFixedBuffer == NULL ) || ( pFixedBuffer->pBuffer == NULL ) )
     {
         LogError( ( "Argument cannot be NULL: pResp=%p, pFixedBuffer=%p, pFixedBuffer->pBuffer=%p.",
@@ -365,7 +410,8 @@ RTIOStatus_t RTIO_SerializeCoResp_OverServerSendResp( const RTIOCoResp_t* pResp,
         return RTIOBadParameter;
     }
 
-    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_RESP + pResp->dataLength > pFixedBuffer->size )
+    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_RESP > pFixedBuffer->size ||
+        RTIO_REST_HEADER_LENGTH_CO_RESP + pResp->dataLength > capLevelToSize[ RTIO_CAP_LEVEL_MAX ] )
     {
         LogError( ( "Buffer size is not enough: RTIO_PROTOCAL_HEADER_LEN=%u, RTIO_REST_HEADER_LENGTH_CO_RESP=%u, pResp->dataLength=%u, bufsize=%u.",
                     RTIO_PROTOCAL_HEADER_LEN,
@@ -375,16 +421,11 @@ RTIOStatus_t RTIO_SerializeCoResp_OverServerSendResp( const RTIOCoResp_t* pResp,
         return RTIOBadParameter;
     }
 
-    RTIOStatus_t status = RTIOSuccess;
-
     // serialize coResp
     pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN ] = ( ( pResp->method << 4 ) & 0xF0 )
         + ( (uint8_t)( pResp->code ) & 0x0F );
-    memcpy( &pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_RESP ],
-            pResp->pData, pResp->dataLength );
 
     // serialize header
-    RTIOHeader_t Header = { 0 };
     Header.id = pResp->headerId;
     Header.type = RTIO_TYPE_SERVER_SEND_RESP;
     Header.version = RTIO_PROTOCAL_VERSION;
@@ -395,7 +436,43 @@ RTIOStatus_t RTIO_SerializeCoResp_OverServerSendResp( const RTIOCoResp_t* pResp,
     {
         return status;
     }
-    *length = Header.bodyLen + RTIO_PROTOCAL_HEADER_LEN;
+    *headerLength = RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_RESP;
+    return status;
+}
+
+RTIOStatus_t RTIO_SerializeCoResp_OverServerSendResp( const RTIOCoResp_t* pResp,
+                                                      const RTIOFixedBuffer_t* pFixedBuffer,
+                                                      uint16_t* length )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t headerLength = 0;
+
+    if( ( pResp == NULL ) || ( pFixedBuffer == NULL ) || ( pFixedBuffer->pBuffer == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pResp=%p, pFixedBuffer=%p, pFixedBuffer->pBuffer=%p.",
+                    (void*)pResp,
+                    (void*)pFixedBuffer,
+                    (void*)pFixedBuffer->pBuffer ) );
+        return RTIOBadParameter;
+    }
+
+    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_CO_RESP + pResp->dataLength > pFixedBuffer->size )
+    {
+        LogError( ( "Buffer size is not enough: RTIO_PROTOCAL_HEADER_LEN=%u, RTIO_REST_HEADER_LENGTH_CO_RESP=%u, pResp->dataLength=%u, bufsize=%u.",
+                    RTIO_PROTOCAL_HEADER_LEN,
+                    RTIO_REST_HEADER_LENGTH_CO_RESP,
+                    pResp->dataLength,
+                    pFixedBuffer->size ) );
+        return RTIOBadParameter;
+    }
+
+    status = RTIO_SerializeCoRespHeader_OverServerSendResp( pResp, pFixedBuffer, &headerLength );
+    if( status != RTIOSuccess )
+    {
+        return status;
+    }
+    memcpy( &pFixedBuffer->pBuffer[ headerLength ], pResp->pData, pResp->dataLength );
+    *length = headerLength + pResp->dataLength;
     return status;
 }
 
@@ -445,9 +522,9 @@ RTIOStatus_t RTIO_SerializeObEstabResp_OverServerSendResp( const RTIOObEstabResp
     return status;
 }
 
-RTIOStatus_t RTIO_SerializeObNotifyReq_OverDeviceSendReq( const RTIOObNotifyReq_t* pReq,
-                                                          const RTIOFixedBuffer_t* pFixedBuffer,
-                                                          uint16_t* dataLength )
+RTIOStatus_t RTIO_SerializeObNotifyReqHeader_OverDeviceSendReq( const RTIOObNotifyReq_t* pReq,
+                                                                const RTIOFixedBuffer_t* pFixedBuffer,
+                                                                uint16_t* headerLength )
 {
     RTIOStatus_t status = RTIOSuccess;
     RTIOHeader_t Header = { 0 };
@@ -461,7 +538,8 @@ RTIOStatus_t RTIO_SerializeObNotifyReq_OverDeviceSendReq( const RTIOObNotifyReq_
         return RTIOBadParameter;
     }
 
-    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ + pReq->dataLength > pFixedBuffer->size )
+    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ > pFixedBuffer->size ||
+        RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ + pReq->dataLength > capLevelToSize[ RTIO_CAP_LEVEL_MAX ] )
     {
         LogError( ( "Buffer size is not enough: RTIO_PROTOCAL_HEADER_LEN=%u, "
                     "RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ=%u, pReq->dataLength=%u, bufsize=%u.",
@@ -477,12 +555,6 @@ RTIOStatus_t RTIO_SerializeObNotifyReq_OverDeviceSendReq( const RTIOObNotifyReq_
     pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 1 ] = (uint8_t)( ( pReq->obId >> 8 ) & 0xFF );
     pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 2 ] = (uint8_t)( pReq->obId & 0xFF );
 
-    if( pReq->dataLength > 0 && pReq->pData != NULL )
-    {
-        memcpy( &pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ ],
-                pReq->pData, pReq->dataLength );
-    }
-
     // serialize header
     Header.id = pReq->headerId;
     Header.type = RTIO_TYPE_DEVICE_SEND_REQ;
@@ -495,10 +567,69 @@ RTIOStatus_t RTIO_SerializeObNotifyReq_OverDeviceSendReq( const RTIOObNotifyReq_
         return status;
     }
 
-    *dataLength = Header.bodyLen + RTIO_PROTOCAL_HEADER_LEN;
+    *headerLength = RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ;
     return status;
 }
 
+RTIOStatus_t RTIO_SerializeObNotifyReq_OverDeviceSendReq( const RTIOObNotifyReq_t* pReq,
+                                                          const RTIOFixedBuffer_t* pFixedBuffer,
+                                                          uint16_t* dataLength )
+{
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t headerLength = 0;
+
+    if( ( pReq == NULL ) || ( pFixedBuffer == NULL ) || ( pFixedBuffer->pBuffer == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pReq=%p, pFixedBuffer=%p, pFixedBuffer->pBuffer=%p.",
+                    (void*)pReq,
+                    (void*)pFixedBuffer,
+                    (void*)pFixedBuffer->pBuffer ) );
+        return RTIOBadParameter;
+    }
+
+    if( RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ + pReq->dataLength > pFixedBuffer->size )
+    {
+        LogError( ( "Buffer size is not enough: RTIO_PROTOCAL_HEADER_LEN=%u, "
+                    "RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ=%u, pReq->dataLength=%u, bufsize=%u.",
+                    RTIO_PROTOCAL_HEADER_LEN,
+                    RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ,
+                    pReq->dataLength,
+                    pFixedBuffer->size ) );
+        return RTIOBadParameter;
+    }
+
+    status = RTIO_SerializeObNotifyReqHeader_OverDeviceSendReq( pReq, pFixedBuffer, &headerLength );
+    if( status != RTIOSuccess )
+    {
+        return status;
+    }
+
+    if( pReq->dataLength > 0 && pReq->pData != NULL )
+    {
+        memcpy( &pFixedBuffer->pBuffer[ headerLength ], pReq->pData, pReq->dataLength );
+    }
+
+    *dataLength = headerLength + pReq->dataLength;
+    return status;
+}
+
+RTIOStatus_t RTIO_SerializeObNotifyReqPatch_OverDeviceSendReq( uint16_t headerId, uint16_t obId,
+                                                               const RTIOFixedBuffer_t* pFixedBuffer )
+{
+    if( ( pFixedBuffer == NULL ) || ( pFixedBuffer->pBuffer == NULL ) ||
+        ( pFixedBuffer->size < RTIO_PROTOCAL_HEADER_LEN + RTIO_REST_HEADER_LENGTH_OBGET_NOTIFY_REQ ) )
+    {
+        LogError( ( "Argument cannot be NULL or too small: pFixedBuffer=%p.", (void*)pFixedBuffer ) );
+        return RTIOBadParameter;
+    }
+
+    pFixedBuffer->pBuffer[ 1 ] = (uint8_t)( ( headerId >> 8 ) & 0xFF );
+    pFixedBuffer->pBuffer[ 2 ] = (uint8_t)( headerId & 0xFF );
+    pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 1 ] = (uint8_t)( ( obId >> 8 ) & 0xFF );
+    pFixedBuffer->pBuffer[ RTIO_PROTOCAL_HEADER_LEN + 2 ] = (uint8_t)( obId & 0xFF );
+    return RTIOSuccess;
+}
+
 RTIOStatus_t RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( const rtioDeviceSendResp_t* pDeviceSendResp,
                                                               RTIOObNotifyResp_t* pObResp )
 {
@@ -27,6 +27,9 @@ extern "C"
 
 #define RTIO_LIBRARY_VERSION "v0.0.1"
 
+/* timeoutMs of a device request following the round-trip time of the responses, see RTIO_GetRttStats. */
+#define RTIO_TIMEOUT_AUTO ( 0xFFFFFFFFU )
+
     /*-----------------------------------------------------------*/
 
    /* RTIO status codes, indicating the result of APIs. */
@@ -54,6 +57,8 @@ extern "C"
         RTIOProtocalFailed = 30,
         RTIOListFull = 31,
         RTIONotFound = 32, /* Not fount headerid from RespList*/
+        /* About Storage. */
+        RTIOStorageFailed = 40,
         /* About REST-Like Layer. */
         RTIOInternelServerError = 61,
         RTIOBadRequest = 62,
@@ -104,6 +109,7 @@ extern "C"
         RTIOCoPostHandler_t handler;
     } RTIOCoPostUri_t;
 
+    /* Hash table keyed by uri with linear probing, leave some entries free to keep probes short. */
     typedef struct RTIOCoPostUriList
     {
         RTIOCoPostUri_t* pList;
@@ -120,6 +126,7 @@ extern "C"
         RTIOObGetHandler_t handler;
     } RTIOObGetUri_t;
 
+    /* Hash table keyed by uri with linear probing, like RTIOCoPostUriList_t. */
     typedef struct RTIOObGetUriList
     {
         RTIOObGetUri_t* pList;
@@ -128,16 +135,45 @@ extern "C"
 
     /*-----------------------------------------------------------*/
 
+    /* Asynchronous completions are invoked on the RTIO incomming or keep-alive thread,
+     * they must not block or call the synchronous APIs. */
+
+    /* Completion of RTIO_CoPostAsync, status is RTIOTimeout if no response arrived in time,
+     * otherwise the REST status, pRespData points into the caller's response buffer. */
+    typedef void( *RTIOCoPostCallback_t )( void* pUserData, RTIOStatus_t status,
+                                           uint8_t* pRespData, uint16_t respLength );
+
+    /* Completion of RTIO_ObNotifyAsync, status is RTIOContinue, RTIOTerminate, RTIOTimeout or other failures. */
+    typedef void( *RTIOObNotifyCallback_t )( void* pUserData, RTIOStatus_t status, uint16_t obId );
+
+    /*-----------------------------------------------------------*/
+
     /* Defined for internal use in RTIO */
 
+#define RTIO_DEVICE_SEND_RESP_INLINE_SIZE ( 8U )
+
     typedef struct rtioDeviceSendResp
     {
-        uint16_t headerId;
+        uint16_t headerId; /* 0 when free, otherwise encodes index and generation. */
         uint16_t respLength;
         RTIOFixedBuffer_t* pFixedBuffer; /* Copy incomming data in incommingProcess. */
         uint32_t timestampMs;
         bool arrived;
         uint8_t code; /* RTIORemoteCode_t */
+        uint16_t generation; /* Bumped on every reuse, so stale headerIds never match. */
+        uint16_t nextFree;   /* Free-list link, valid only while the item is free. */
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+        OSAtomicU32_t state; /* headerId << 16 | RTIO_RESP_STATE_*, items are claimed by CAS on it. */
+#endif
+        /* Asynchronous requests only, completed by the incomming thread or expired by the timer wheel. */
+        RTIOCoPostCallback_t coPostCallback;
+        RTIOObNotifyCallback_t obNotifyCallback;
+        void* pUserData;
+        uint16_t obId;
+        bool autoTimeout; /* Made with RTIO_TIMEOUT_AUTO, timing out backs the estimate off. */
+        bool held;        /* Held while reconnecting, its response time is no round-trip sample. */
+        RTIOFixedBuffer_t inlineBuffer; /* Response buffer of RTIO_ObNotifyAsync. */
+        uint8_t inlineData[ RTIO_DEVICE_SEND_RESP_INLINE_SIZE ];
     } rtioDeviceSendResp_t;
 
     typedef struct rtioDeviceSendRespList
@@ -145,8 +181,179 @@ extern "C"
         rtioDeviceSendResp_t* pList;
         uint16_t size;
         OSMutex_t* pLock;
+        uint16_t freeHead;
+        OSEvent_t* pEvents; /* One per item, signaled when its response arrived. */
+        size_t eventSize;   /* OSEvent_t is opaque here, sizeof is taken where it is complete. */
+#if ( RTIO_USE_C11_ATOMICS != 0 )
+        OSAtomicU32_t nextHint; /* Where the next claim starts looking for a free item. */
+#endif
     } rtioDeviceSendRespList_t;
 
+    typedef struct rtioSendFrame
+    {
+        uint8_t buffer[ RTIO_TRANSFER_FRAME_BUF_SIZE ];
+        uint16_t length;
+        uint16_t next; /* Free-list or FIFO link. */
+    } rtioSendFrame_t;
+
+    /* Writes of the writer thread, frames / writes is the frames packed per write. */
+    typedef struct RTIOSendStats
+    {
+        uint32_t writes;
+        uint32_t frames;
+        uint32_t bytes;
+        uint16_t framesPerWriteMax;
+    } RTIOSendStats_t;
+
+    /* Round-trip times of the device requests, from sending to the response. */
+    typedef struct RTIORttStats
+    {
+        uint32_t srttMs;   /* Smoothed, 0 before the first response. */
+        uint32_t rttvarMs; /* Mean deviation of the samples from srttMs. */
+        uint32_t rtoMs;    /* What RTIO_TIMEOUT_AUTO stands for now. */
+        uint32_t samples;  /* Responses measured, requests held while reconnecting are not. */
+        uint32_t timeouts; /* Requests with RTIO_TIMEOUT_AUTO timed out, each doubles rtoMs until the next sample. */
+    } RTIORttStats_t;
+
+    /* Jacobson/Karels estimator of RFC 6298 in fixed point, guarded by pLock. */
+    typedef struct rtioRtt
+    {
+        OSMutex_t* pLock;
+        uint32_t srtt8;   /* Smoothed round-trip time in 1/8 ms. */
+        uint32_t rttvar4; /* Mean deviation in 1/4 ms. */
+        uint8_t backoff;  /* Doublings of the timeout since the last sample. */
+        RTIORttStats_t stats;
+    } rtioRtt_t;
+
+    /* Lanes of the send queue, the writer drains a lane before the ones behind it. */
+    typedef enum rtioSendLane
+    {
+        RTIO_SEND_LANE_CONTROL = 0,  /* Pings, they keep the session alive. */
+        RTIO_SEND_LANE_RESPONSE = 1, /* Responses to server requests. */
+        RTIO_SEND_LANE_REQUEST = 2,  /* Device requests. */
+        RTIO_SEND_LANE_BULK = 3,     /* Notifications. */
+        RTIO_SEND_LANE_NUM = 4
+    } rtioSendLane_t;
+
+    /* Bounded multi-producer queue of serialized frames, drained by the writer thread. */
+    typedef struct rtioSendQueue
+    {
+        rtioSendFrame_t* pFrames;
+        uint16_t size; /* 0 when the send queue is disabled. */
+        OSMutex_t* pLock;
+        OSEvent_t* pWriterEvent; /* Signaled when a frame is queued. */
+        OSEvent_t* pSpaceEvent;  /* Signaled when a frame is freed. */
+        uint16_t freeHead;
+        uint16_t freeNum;
+        uint16_t heads[ RTIO_SEND_LANE_NUM ]; /* FIFO of each lane. */
+        uint16_t tails[ RTIO_SEND_LANE_NUM ];
+        RTIOSendStats_t stats; /* Guarded by pLock. */
+    } rtioSendQueue_t;
+
+    /* Requests of the offline queue, replayed and dropped ones are counted once they leave it. */
+    typedef struct RTIOOfflineStats
+    {
+        uint32_t queued;   /* Held while reconnecting. */
+        uint32_t replayed; /* Sent after the reconnect. */
+        uint32_t dropped;  /* Dropped or refused as the queue was full. */
+        uint32_t expired;  /* Their timeoutMs passed before the reconnect. */
+    } RTIOOfflineStats_t;
+
+    /* A device request serialized while reconnecting. */
+    typedef struct rtioOfflineItem
+    {
+        uint8_t buffer[ RTIO_TRANSFER_FRAME_BUF_SIZE ];
+        uint16_t length;
+        uint16_t headerId;   /* Of the response item, the request fails on it when dropped. */
+        uint32_t deadlineMs; /* The caller gives up then, it is not replayed any more. */
+        uint8_t lane;        /* rtioSendLane_t */
+    } rtioOfflineItem_t;
+
+    /* Bounded FIFO of the requests waiting for the reconnect, replayed in order. */
+    typedef struct rtioOfflineQueue
+    {
+        rtioOfflineItem_t* pItems;
+        uint16_t size; /* 0 when the offline queue is disabled. */
+        OSMutex_t* pLock;
+        uint16_t head;
+        uint16_t count;
+        RTIOOfflineStats_t stats; /* Guarded by pLock. */
+    } rtioOfflineQueue_t;
+
+    /* A server request copied out of the receive buffer for a handler worker. */
+    typedef struct rtioHandlerJob
+    {
+        uint16_t headerId;
+        uint16_t bodyLength;
+        uint8_t body[ RTIO_TRANSFER_FRAME_BUF_SIZE ];
+        uint16_t next; /* Free-list or FIFO link. */
+    } rtioHandlerJob_t;
+
+    typedef struct rtioHandlerWorker
+    {
+        void* pContext; /* The RTIOContext_t the worker serves. */
+        uint8_t respBuffer[ RTIO_TRANSFER_FRAME_BUF_SIZE ];
+    } rtioHandlerWorker_t;
+
+    /* Bounded queue of server requests, drained by the handler workers. */
+    typedef struct rtioHandlerPool
+    {
+        rtioHandlerJob_t* pJobs;
+        uint16_t size;
+        rtioHandlerWorker_t* pWorkers;
+        uint16_t workerNum;  /* 0 when the pool is disabled. */
+        OSThreadHandle_t* pThreads;
+        size_t threadSize;   /* OSThreadHandle_t is opaque here, like eventSize. */
+        OSMutex_t* pLock;
+        OSEvent_t* pJobEvent; /* Signaled when a job is queued. */
+        uint16_t freeHead;
+        uint16_t head;
+        uint16_t tail;
+    } rtioHandlerPool_t;
+
+#define RTIO_TIMER_FIXED_NUM ( 3U ) /* Ping, reconnect and rx idle, after the timers of the response items. */
+#define RTIO_PING_RESP_BUFFER_SIZE ( 7U )
+
+    typedef struct rtioTimer
+    {
+        uint32_t deadlineMs;
+        uint16_t tag;   /* The headerId of a response item, stale timers are recognized by it. */
+        uint16_t slot;
+        uint16_t next;  /* Slot list links. */
+        uint16_t prev;
+        bool armed;
+    } rtioTimer_t;
+
+    /* Called from any thread when a timer of an event-driven context is due at deadlineMs, */
+    /* before the wait RTIO_HandleTimers returned, the event loop runs RTIO_HandleTimers by then. */
+    typedef void( *RTIOWakeupHandler_t )( void* pWakeupArg, uint32_t deadlineMs );
+
+    /* Hashed timer wheel, timer i < deviceSendRespList.size is the deadline of response item i. */
+    typedef struct rtioTimerWheel
+    {
+        rtioTimer_t* pTimers;
+        uint16_t size;
+        uint16_t* pSlots;   /* RTIO_TIMER_WHEEL_SLOT_NUM list heads. */
+        OSMutex_t* pLock;
+        OSEvent_t* pEvent;  /* Signaled when a timer is due before wakeMs, or the keep-alive thread has work. */
+        uint32_t cursorTick; /* Slots before it are expired. */
+        uint32_t wakeMs;     /* When the keep-alive thread wakes up next. */
+        RTIOWakeupHandler_t wakeup; /* Called instead of signaling pEvent when event-driven. */
+        void* pWakeupArg;
+    } rtioTimerWheel_t;
+
+    /* State of the timer wheel runner, the keep-alive thread or RTIO_HandleTimers. */
+    typedef struct rtioKeepAlive
+    {
+        uint16_t pingIndex;     /* Response item of the ping in flight, UINT16_MAX when none. */
+        uint16_t pingHeaderId;
+        uint8_t pingRespBuffer[ RTIO_PING_RESP_BUFFER_SIZE ]; /* Per context, contexts ping in parallel. */
+        bool reconnecting;      /* From the first to the last attempt of a reconnect. */
+        uint16_t retryTimes;
+        uint32_t backoffAttemptsDone; /* Backoff progress of the reconnect, */
+        uint16_t backoffJitterMax;    /* kept here as the backoff context is internal. */
+    } rtioKeepAlive_t;
+
     uint32_t crc32Ieee( uint8_t* data, uint16_t length );
 
     /*-----------------------------------------------------------*/
@@ -164,7 +371,10 @@ extern "C"
         RTIOServeFailedHandler_t serveFailedHandler;
         uint32_t heartbeatMs;
         uint32_t lastPacketTxTime;
+        uint32_t lastPacketRxTime; /* Last frame received, including the verify response. */
         RTIOFixedBuffer_t networkIncommingBuffer; /* single-thread read, do not need lock. */
+        uint16_t incommingStart;                  /* Buffered bytes of networkIncommingBuffer, */
+        uint16_t incommingEnd;                    /* from incommingStart up to incommingEnd. */
         RTIOFixedBuffer_t networkOutgoingBuffer;  /* multi-thread write, need lock. */
         OSMutex_t* pNetworkOutgoingBufferLock;    /* lock for write buffer. */
         RTIOFixedBuffer_t serverSendRespBuffer;
@@ -177,26 +387,86 @@ extern "C"
         OSMutex_t* pRecvMessageLock;
         OSThreadHandle_t* pThreadIncomming;
         OSThreadHandle_t* pThreadKeepAlive;
+        OSThreadHandle_t* pThreadWriter;
+        rtioSendQueue_t sendQueue;
+        rtioOfflineQueue_t offlineQueue;
+        rtioHandlerPool_t handlerPool;
+        rtioTimerWheel_t timerWheel;
+        rtioRtt_t rtt;
+        rtioKeepAlive_t keepAlive;
         RTIOConnectStatus_t connectStatus;
+        uint32_t connectCount; /* Successful connects, guarded by pConnectionStatusLock. */
         OSMutex_t* pConnectionStatusLock;
+        uint16_t threadsRunning;     /* Threads of RTIO_Serve not stopped yet, guarded by pConnectionStatusLock. */
+        OSEvent_t* pThreadExitEvent; /* Signaled when a thread of RTIO_Serve stopped. */
         bool serviceDone;
+        bool eventDriven; /* Served by RTIO_ServeEventDriven, no incomming and keep-alive threads. */
     } RTIOContext_t;
 
+#if RTIO_SEND_QUEUE_FRAME_NUM > 0
+#define RTIO_RAM_SEND_QUEUE_FIELDS \
+        OSThreadHandle_t writerThread; \
+        OSMutex_t sendQueueLock; \
+        OSEvent_t sendQueueEvents[2]; \
+        rtioSendFrame_t sendQueueFrames[ RTIO_SEND_QUEUE_FRAME_NUM ];
+#define RTIO_RESOURCE_SEND_QUEUE_INIT(ram) \
+        .pThreadWriter = &ram.writerThread, \
+        .sendQueue = {ram.sendQueueFrames, RTIO_SEND_QUEUE_FRAME_NUM, &ram.sendQueueLock, \
+                      &ram.sendQueueEvents[0], &ram.sendQueueEvents[1]},
+#else
+#define RTIO_RAM_SEND_QUEUE_FIELDS
+#define RTIO_RESOURCE_SEND_QUEUE_INIT(ram)
+#endif
+
+#if RTIO_OFFLINE_QUEUE_ITEM_NUM > 0
+#define RTIO_RAM_OFFLINE_QUEUE_FIELDS \
+        OSMutex_t offlineQueueLock; \
+        rtioOfflineItem_t offlineItems[ RTIO_OFFLINE_QUEUE_ITEM_NUM ];
+#define RTIO_RESOURCE_OFFLINE_QUEUE_INIT(ram) \
+        .offlineQueue = {ram.offlineItems, RTIO_OFFLINE_QUEUE_ITEM_NUM, &ram.offlineQueueLock},
+#else
+#define RTIO_RAM_OFFLINE_QUEUE_FIELDS
+#define RTIO_RESOURCE_OFFLINE_QUEUE_INIT(ram)
+#endif
+
+#if RTIO_HANDLER_WORKER_NUM > 0
+#define RTIO_RAM_HANDLER_POOL_FIELDS \
+        OSThreadHandle_t handlerThreads[ RTIO_HANDLER_WORKER_NUM ]; \
+        OSMutex_t handlerPoolLock; \
+        OSEvent_t handlerPoolEvent; \
+        rtioHandlerWorker_t handlerWorkers[ RTIO_HANDLER_WORKER_NUM ]; \
+        rtioHandlerJob_t handlerJobs[ RTIO_HANDLER_QUEUE_NUM ];
+#define RTIO_RESOURCE_HANDLER_POOL_INIT(ram) \
+        .handlerPool = {ram.handlerJobs, RTIO_HANDLER_QUEUE_NUM, ram.handlerWorkers, RTIO_HANDLER_WORKER_NUM, \
+                        ram.handlerThreads, sizeof( ram.handlerThreads[0] ), &ram.handlerPoolLock, &ram.handlerPoolEvent},
+#else
+#define RTIO_RAM_HANDLER_POOL_FIELDS
+#define RTIO_RESOURCE_HANDLER_POOL_INIT(ram)
+#endif
+
 #define RTIORamAllocationGlobal_t struct RTIORamAllocation \
     { \
-        uint8_t buffer1[ RTIO_TRANSFER_FRAME_BUF_SIZE ]; \
+        uint8_t buffer1[ RTIO_RECV_BUFFER_SIZE ]; \
         uint8_t buffer2[ RTIO_TRANSFER_FRAME_BUF_SIZE ]; \
         uint8_t buffer3[ RTIO_TRANSFER_FRAME_BUF_SIZE ]; \
         OSThreadHandle_t threads[2]; \
-        OSMutex_t locks[6]; \
+        OSMutex_t locks[8]; \
         RTIOCoPostUri_t coPostInfoList[ RTIO_COPOST_URI_NUM_MAX ]; \
         RTIOObGetUri_t obGetInfoList[ RTIO_OBGET_URI_NUM_MAX ] ; \
         rtioDeviceSendResp_t deviceSendRespList[ RTIO_DEVICE_SEND_RESP_NUM_MAX ]; \
+        OSEvent_t deviceSendRespEvents[ RTIO_DEVICE_SEND_RESP_NUM_MAX ]; \
+        rtioTimer_t timers[ RTIO_DEVICE_SEND_RESP_NUM_MAX + RTIO_TIMER_FIXED_NUM ]; \
+        uint16_t timerSlots[ RTIO_TIMER_WHEEL_SLOT_NUM ]; \
+        OSEvent_t timerEvent; \
+        OSEvent_t threadExitEvent; \
+        RTIO_RAM_SEND_QUEUE_FIELDS \
+        RTIO_RAM_OFFLINE_QUEUE_FIELDS \
+        RTIO_RAM_HANDLER_POOL_FIELDS \
     }
 
 #define RTIO_ResourceBuild(ram) \
     { \
-        .networkIncommingBuffer = {ram.buffer1, RTIO_TRANSFER_FRAME_BUF_SIZE}, \
+        .networkIncommingBuffer = {ram.buffer1, RTIO_RECV_BUFFER_SIZE}, \
         .networkOutgoingBuffer = {ram.buffer2, RTIO_TRANSFER_FRAME_BUF_SIZE}, \
         .serverSendRespBuffer = {ram.buffer3, RTIO_TRANSFER_FRAME_BUF_SIZE}, \
         .pThreadIncomming = &ram.threads[0], \
@@ -208,7 +478,15 @@ extern "C"
         .pNetworkOutgoingBufferLock = &ram.locks[4], \
         .coPostUriList = {ram.coPostInfoList, RTIO_COPOST_URI_NUM_MAX}, \
         .obGetUriList = {ram.obGetInfoList, RTIO_OBGET_URI_NUM_MAX}, \
-        .deviceSendRespList =  {ram.deviceSendRespList, RTIO_DEVICE_SEND_RESP_NUM_MAX, &ram.locks[5]}, \
+        .deviceSendRespList =  {ram.deviceSendRespList, RTIO_DEVICE_SEND_RESP_NUM_MAX, &ram.locks[5], 0, \
+                                ram.deviceSendRespEvents, sizeof( ram.deviceSendRespEvents[0] )}, \
+        .timerWheel = {ram.timers, RTIO_DEVICE_SEND_RESP_NUM_MAX + RTIO_TIMER_FIXED_NUM, ram.timerSlots, \
+                       &ram.locks[6], &ram.timerEvent}, \
+        .rtt = {&ram.locks[7]}, \
+        .pThreadExitEvent = &ram.threadExitEvent, \
+        RTIO_RESOURCE_SEND_QUEUE_INIT(ram) \
+        RTIO_RESOURCE_OFFLINE_QUEUE_INIT(ram) \
+        RTIO_RESOURCE_HANDLER_POOL_INIT(ram) \
     }
 
     /* Fixed resources for the RTIO connection's context. */
@@ -227,6 +505,13 @@ extern "C"
         RTIOCoPostUriList_t coPostUriList;
         RTIOObGetUriList_t obGetUriList;
         rtioDeviceSendRespList_t deviceSendRespList;
+        OSThreadHandle_t* pThreadWriter; /* NULL when the send queue is disabled. */
+        rtioSendQueue_t sendQueue;
+        rtioOfflineQueue_t offlineQueue; /* size is 0 when requests made while reconnecting fail. */
+        rtioHandlerPool_t handlerPool; /* workerNum is 0 when handlers run on the incomming thread. */
+        rtioTimerWheel_t timerWheel;
+        rtioRtt_t rtt;
+        OSEvent_t* pThreadExitEvent;
 
     } RTIOContextFixedResource_t;
 
@@ -247,14 +532,36 @@ extern "C"
     RTIOStatus_t RTIO_RegisterCoPostHandler( const RTIOContext_t* pContext,
                                              const char* pUri, RTIOCoPostHandler_t handler );
 
+    /* Registers a handler for "constrained-post" request using a precomputed URI hash. */
+    RTIOStatus_t RTIO_RegisterCoPostHandlerWithDigest( const RTIOContext_t* pContext,
+                                                       uint32_t uri, RTIOCoPostHandler_t handler );
+
+    /* Registers the handlers of a table with precomputed URI hashes, the table can be const. */
+    RTIOStatus_t RTIO_RegisterCoPostHandlers( const RTIOContext_t* pContext,
+                                              const RTIOCoPostUri_t* pTable, uint16_t count );
+
     /* Registers a handler for "observe-get" request on the specified URI. */
     RTIOStatus_t RTIO_RegisterObGetHandler( const RTIOContext_t* pContext,
                                             const char* pUri, RTIOObGetHandler_t handler );
 
+    /* Registers a handler for "observe-get" request using a precomputed URI hash. */
+    RTIOStatus_t RTIO_RegisterObGetHandlerWithDigest( const RTIOContext_t* pContext,
+                                                      uint32_t uri, RTIOObGetHandler_t handler );
+
+    /* Registers the handlers of a table with precomputed URI hashes, the table can be const. */
+    RTIOStatus_t RTIO_RegisterObGetHandlers( const RTIOContext_t* pContext,
+                                             const RTIOObGetUri_t* pTable, uint16_t count );
+
     /* Notifies the RTIO service with buffer data for the specified observer ID. */
     RTIOStatus_t RTIO_ObNotify( RTIOContext_t* pContext, uint8_t* pData, uint16_t Length,
                                 uint16_t obId, uint32_t timeoutMs );
 
+    /* Notifies the observer without waiting, callback is invoked when the response arrives or timeoutMs expires, */
+    /* once if RTIOSuccess is returned and never otherwise. */
+    RTIOStatus_t RTIO_ObNotifyAsync( RTIOContext_t* pContext, uint8_t* pData, uint16_t length,
+                                     uint16_t obId, uint32_t timeoutMs,
+                                     RTIOObNotifyCallback_t callback, void* pUserData );
+
     /* Terminates the notification for the specified observer ID. */
     RTIOStatus_t RTIO_ObNotifyTerminate( RTIOContext_t* pContext,
                                          uint16_t obId,
@@ -266,11 +573,54 @@ extern "C"
     /* Sets a handler to be invoked when the service fails. */
     RTIOStatus_t RTIO_SetServeFailedHandler( RTIOContext_t* pContext, RTIOServeFailedHandler_t handler );
 
+    /* Gets the writes of the writer thread, all 0 when the send queue is disabled. */
+    RTIOStatus_t RTIO_GetSendStats( RTIOContext_t* pContext, RTIOSendStats_t* pStats );
+
+    /* Gets the counters of the requests held while reconnecting, all 0 when the offline queue is disabled. */
+    RTIOStatus_t RTIO_GetOfflineStats( RTIOContext_t* pContext, RTIOOfflineStats_t* pStats );
+
+    /* Gets the round-trip time estimate and the timeout RTIO_TIMEOUT_AUTO stands for. */
+    RTIOStatus_t RTIO_GetRttStats( RTIOContext_t* pContext, RTIORttStats_t* pStats );
+
     /* Serve with the given RTIO context in the background. */
     RTIOStatus_t RTIO_Serve( RTIOContext_t* pContext );
 
     /*-----------------------------------------------------------*/
 
+    /* Event-driven serving: instead of the incomming and keep-alive threads, an event loop */
+    /* calls RTIO_HandleReadable when the descriptor is readable and RTIO_HandleTimers when */
+    /* the timers are due. Calls for one context must not overlap, different contexts can be */
+    /* handled in parallel. The send queue and the handler pool must be disabled. */
+
+    /* Serves the connected context from an event loop, wakeup is called when a timer becomes due earlier. */
+    /* Without wakeup the loop calls RTIO_Poll, or waits as long as RTIO_GetNextWaitMs tells. */
+    RTIOStatus_t RTIO_ServeEventDriven( RTIOContext_t* pContext, RTIOWakeupHandler_t wakeup, void* pWakeupArg );
+
+    /* Reads what the transport has without waiting and handles the complete frames. */
+    /* Any other status than RTIOSuccess means the descriptor is no longer worth watching, */
+    /* a broken session is reconnected by RTIO_HandleTimers. */
+    RTIOStatus_t RTIO_HandleReadable( RTIOContext_t* pContext );
+
+    /* Runs the due timers: pings, reconnects and request timeouts, pNextWaitMs is set to */
+    /* the time until the next one. Fails when reconnecting stopped. */
+    RTIOStatus_t RTIO_HandleTimers( RTIOContext_t* pContext, uint32_t* pNextWaitMs );
+
+    /* Gets the descriptor of the connection, RTIONotFound when not connected. pConnectCount */
+    /* changes with every reconnect, so a descriptor number reused by the new connection is noticed. */
+    RTIOStatus_t RTIO_GetDescriptor( RTIOContext_t* pContext, int32_t* pDescriptor, uint32_t* pConnectCount );
+
+    /* Gets the time until the next timer is due, the longest an event loop may wait. */
+    RTIOStatus_t RTIO_GetNextWaitMs( RTIOContext_t* pContext, uint32_t* pWaitMs );
+
+    /* Waits up to timeoutMs for data or the next timer, then handles what arrived and the due timers. */
+    /* The main loop of the application calling it serves the context without the RTIO threads. */
+    /* Requests from other threads with an earlier deadline are noticed within timeoutMs, */
+    /* synchronous requests must not be made on the polling thread as nothing reads their response. */
+    /* Fails when serving stopped, a broken session is reconnected by the next calls. */
+    RTIOStatus_t RTIO_Poll( RTIOContext_t* pContext, uint32_t timeoutMs );
+
+    /*-----------------------------------------------------------*/
+
     /* Computes the URI hash and stores the result in pDigest. */
     RTIOStatus_t RTIO_URIHash( const char* pUri, uint32_t* pDigest );
 
@@ -286,6 +636,13 @@ extern "C"
                                         RTIOFixedBuffer_t* pRespbuffer, uint16_t* respLength,
                                         uint32_t timeoutMs );
 
+    /* Sends a "constrained-post" request using a precomputed URI hash without waiting,
+     * callback is invoked when the response arrives or timeoutMs expires, pRespbuffer must stay valid until then.
+     * The callback is invoked once if RTIOSuccess is returned and never otherwise. */
+    RTIOStatus_t RTIO_CoPostAsync( RTIOContext_t* pContext, uint32_t uri,
+                                   uint8_t* pReqData, uint16_t reqLength,
+                                   RTIOFixedBuffer_t* pRespbuffer, uint32_t timeoutMs,
+                                   RTIOCoPostCallback_t callback, void* pUserData );
 
     /*-----------------------------------------------------------*/
 
@@ -307,7 +664,7 @@ extern "C"
     /* Retrieves the number of observers in the list, not real-time. */
     uint16_t RTIO_ObListGetObNumberNotRealtime( RTIO_ObList_t* pObList );
 
-    /* Notifies all observers in the list with the given data. */
+    /* Notifies all observers in the list with the given data, sending to them before waiting for responses. */
     RTIOStatus_t RTIO_ObListNotifyAll( RTIOContext_t* pContext,
                                        RTIO_ObList_t* pObList,
                                        uint8_t* pData, uint16_t dataLength );
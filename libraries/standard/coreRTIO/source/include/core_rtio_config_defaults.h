@@ -19,6 +19,13 @@ extern "C"
 #define RTIO_TRANSFER_FRAME_BUF_SIZE ( 512U )
 #endif
 
+/* Receive buffer of the incomming thread, frames are parsed in place from it. */
+/* It holds at least one frame (5 bytes header and RTIO_TRANSFER_FRAME_BUF_SIZE body), */
+/* a larger one reads bursts of frames with fewer transport calls. */
+#ifndef RTIO_RECV_BUFFER_SIZE
+#define RTIO_RECV_BUFFER_SIZE ( 2U * RTIO_TRANSFER_FRAME_BUF_SIZE + 16U )
+#endif
+
 /*-----------------------------------------------------------*/
 #ifndef RTIO_OBGET_OBSERVATIONS_MAX 
 #define RTIO_OBGET_OBSERVATIONS_MAX = ( 256U ) 
@@ -44,10 +51,73 @@ extern "C"
 #define RTIO_THREAD_KEEPALIVE_STACK_SIZE ( 8192U )
 #endif
 
+#ifndef RTIO_THREAD_WRITER_STACK_SIZE
+#define RTIO_THREAD_WRITER_STACK_SIZE ( 4096U )
+#endif
+
+#ifndef RTIO_THREAD_HANDLER_STACK_SIZE
+#define RTIO_THREAD_HANDLER_STACK_SIZE ( 4096U )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Frames of the send queue, each takes RTIO_TRANSFER_FRAME_BUF_SIZE bytes. */
+/* When not 0, frames are sent by a writer thread and senders only enqueue them, */
+/* otherwise senders write to the transport themselves. */
+#ifndef RTIO_SEND_QUEUE_FRAME_NUM
+#define RTIO_SEND_QUEUE_FRAME_NUM ( 0U )
+#endif
+
+/* Free frames of the send queue kept for each more urgent lane: bulk notifications leave */
+/* 3 times this many to device requests, server responses and pings, which leave fewer in turn. */
+#ifndef RTIO_SEND_QUEUE_LANE_RESERVE
+#define RTIO_SEND_QUEUE_LANE_RESERVE ( 1U )
+#endif
+
+/* Bytes of queued frames the writer thread packs into one transport write, 0 writes frame by frame. */
+/* Fewer, larger writes save TLS records and TCP segments for small frames. Needs the send queue */
+/* and a transport with sendv; the OpenSSL transport gathers up to OPENSSL_SENDV_COALESCE_SIZE per record. */
+#ifndef RTIO_SEND_COALESCE_BYTES
+#define RTIO_SEND_COALESCE_BYTES ( 0U )
+#endif
+
+/* Frames packed into one write at most. */
+#ifndef RTIO_SEND_COALESCE_FRAMES_MAX
+#define RTIO_SEND_COALESCE_FRAMES_MAX ( 8U )
+#endif
+
+/* How long the writer waits for more frames while the packed bytes are below the threshold, */
+/* 0 packs only what is already queued. Bounds the latency coalescing adds to a frame. */
+#ifndef RTIO_SEND_COALESCE_FLUSH_US
+#define RTIO_SEND_COALESCE_FLUSH_US ( 200U )
+#endif
+
+/* Worker threads running the CoPost and ObGet handlers, when not 0 handlers run concurrently */
+/* and must be thread safe, otherwise they run on the incomming thread one by one. */
+#ifndef RTIO_HANDLER_WORKER_NUM
+#define RTIO_HANDLER_WORKER_NUM ( 0U )
+#endif
+
+/* Server requests being handled or waiting for a worker, each takes RTIO_TRANSFER_FRAME_BUF_SIZE bytes. */
+/* Requests arriving when it is full are answered with too many requests. */
+#ifndef RTIO_HANDLER_QUEUE_NUM
+#define RTIO_HANDLER_QUEUE_NUM ( RTIO_HANDLER_WORKER_NUM + 4U )
+#endif
+
+/* 1 allocates response list items with C11 atomics instead of a mutex. Device request header */
+/* ids come from these items, so their allocation takes no lock either. */
+/* Needs a C11 compiler, see the RTIO_USE_C11_ATOMICS option of CMakeLists.txt. */
+/* It changes RTIOContext_t, so every source including core_rtio.h must see the same value. */
+#ifndef RTIO_USE_C11_ATOMICS
+#define RTIO_USE_C11_ATOMICS ( 0U )
+#endif
+
 /*-----------------------------------------------------------*/
 
 #define RTIO_PING_INTERVAL_MS_DEFAULT ( 300000U )
+#ifndef RTIO_PING_INTERVAL_MS_MIN
 #define RTIO_PING_INTERVAL_MS_MIN ( 30000U )
+#endif
 #define RTIO_PING_INTERVAL_MS_MAX ( 4320000U ) /* 12 Hours*/
 
 /* The initial heartbeat interval. */
@@ -56,10 +126,49 @@ extern "C"
 #define RTIO_PING_INTERVAL_MS_INIT RTIO_PING_INTERVAL_MS_DEFAULT
 #endif
 
+/* Timeout of a ping, a fixed value or RTIO_TIMEOUT_AUTO to follow the round-trip time. */
 #ifndef RTIO_PING_TIMEOUT_MS
 #define RTIO_PING_TIMEOUT_MS ( 5000U )
 #endif
 
+/* A ping timing out reconnects, so with RTIO_TIMEOUT_AUTO it never waits less than this. */
+#ifndef RTIO_PING_TIMEOUT_MS_MIN
+#define RTIO_PING_TIMEOUT_MS_MIN ( 5000U )
+#endif
+
+/* Reconnects when no frame is received for this long, 0 disables it. */
+/* Pings go out at half of it at the latest, so a quiet but healthy session stays up. */
+#ifndef RTIO_RX_IDLE_TIMEOUT_MS
+#define RTIO_RX_IDLE_TIMEOUT_MS ( 0U )
+#endif
+
+/* RTIO_TIMEOUT_AUTO stands for srtt + 4 * rttvar of the responses (RFC 6298), within */
+/* RTIO_RTO_MIN_MS and RTIO_RTO_MAX_MS, and for RTIO_RTO_INITIAL_MS before the first one. */
+#ifndef RTIO_RTO_INITIAL_MS
+#define RTIO_RTO_INITIAL_MS ( 3000U )
+#endif
+
+#ifndef RTIO_RTO_MIN_MS
+#define RTIO_RTO_MIN_MS ( 1000U )
+#endif
+
+#ifndef RTIO_RTO_MAX_MS
+#define RTIO_RTO_MAX_MS ( 60000U )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Request deadlines, pings and reconnects are timers of a hashed timer wheel run by the keep-alive thread. */
+/* A timer is kept in the slot of its tick, the thread sleeps until the earliest deadline */
+/* and at most one revolution ( RTIO_TIMER_WHEEL_SLOT_NUM * RTIO_TIMER_WHEEL_TICK_MS ). */
+#ifndef RTIO_TIMER_WHEEL_SLOT_NUM
+#define RTIO_TIMER_WHEEL_SLOT_NUM ( 64U )
+#endif
+
+#ifndef RTIO_TIMER_WHEEL_TICK_MS
+#define RTIO_TIMER_WHEEL_TICK_MS ( 16U )
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* The maximum number of retries for connecting to server. */
@@ -75,12 +184,81 @@ extern "C"
 #define RTIO_RETRY_BACKOFF_BASE_MS         ( 3000U )
 #endif
 
+/* Device requests held while reconnecting, each takes RTIO_TRANSFER_FRAME_BUF_SIZE bytes. */
+/* When not 0, CoPost and ObNotify requests made while reconnecting are replayed in order */
+/* after the reconnect, unless their timeoutMs passed first; otherwise they fail to send. */
+#ifndef RTIO_OFFLINE_QUEUE_ITEM_NUM
+#define RTIO_OFFLINE_QUEUE_ITEM_NUM ( 0U )
+#endif
+
+/* When the offline queue is full, 1 drops the oldest request, 0 refuses the new one with RTIOListFull. */
+#ifndef RTIO_OFFLINE_QUEUE_DROP_OLDEST
+#define RTIO_OFFLINE_QUEUE_DROP_OLDEST ( 1U )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Store and forward journal, see core_rtio_journal.h. */
+/* Appended records are synced to the storage once this many are pending, */
+/* or RTIO_JOURNAL_SYNC_MS after the first of them, whichever comes first. */
+#ifndef RTIO_JOURNAL_SYNC_RECORDS
+#define RTIO_JOURNAL_SYNC_RECORDS ( 16U )
+#endif
+
+#ifndef RTIO_JOURNAL_SYNC_MS
+#define RTIO_JOURNAL_SYNC_MS ( 1000U )
+#endif
+
+/* When every segment holds undelivered records, 1 erases the oldest segment, 0 refuses new records with RTIOListFull. */
+#ifndef RTIO_JOURNAL_DROP_OLDEST
+#define RTIO_JOURNAL_DROP_OLDEST ( 1U )
+#endif
+
+/* Delivered records written to the storage at once, a crash resends at most this many. */
+#ifndef RTIO_JOURNAL_CHECKPOINT_RECORDS
+#define RTIO_JOURNAL_CHECKPOINT_RECORDS ( 16U )
+#endif
+
+/* Records the replay has in flight, each keeps a response buffer of RTIO_JOURNAL_REPLAY_RESP_SIZE bytes. */
+#ifndef RTIO_JOURNAL_REPLAY_WINDOW
+#define RTIO_JOURNAL_REPLAY_WINDOW ( 4U )
+#endif
+
+#ifndef RTIO_JOURNAL_REPLAY_RESP_SIZE
+#define RTIO_JOURNAL_REPLAY_RESP_SIZE ( RTIO_TRANSFER_FRAME_BUF_SIZE )
+#endif
+
+#ifndef RTIO_JOURNAL_REPLAY_TIMEOUT_MS
+#define RTIO_JOURNAL_REPLAY_TIMEOUT_MS ( 5000U )
+#endif
+
+/* Pause of the replay after a record was not answered, before it is sent again. */
+#ifndef RTIO_JOURNAL_REPLAY_RETRY_MS
+#define RTIO_JOURNAL_REPLAY_RETRY_MS ( 1000U )
+#endif
+
+#ifndef RTIO_THREAD_JOURNAL_STACK_SIZE
+#define RTIO_THREAD_JOURNAL_STACK_SIZE ( 4096U )
+#endif
+
 /*-----------------------------------------------------------*/
 
 #ifndef RTIO_OBSERVA_NOTIFY_TIMEOUT_MS
 #define RTIO_OBSERVA_NOTIFY_TIMEOUT_MS  ( 5000U ) 
 #endif
 
+/*-----------------------------------------------------------*/
+
+/* URI digests use an 8 KB const table when 1, the bitwise loop without table when 0. */
+#ifndef RTIO_CRC32_SLICING_BY_8
+#define RTIO_CRC32_SLICING_BY_8 ( 1U )
+#endif
+
+/* On x86-64 GCC/Clang builds, long URIs use PCLMULQDQ when the CPU has it. */
+#ifndef RTIO_CRC32_CLMUL
+#define RTIO_CRC32_CLMUL ( 1U )
+#endif
+
 
 
 #ifndef LogError
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef CORE_RTIO_JOURNAL_H
+#define CORE_RTIO_JOURNAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "core_rtio.h"
+#include "storage_interface.h"
+
+    /*-----------------------------------------------------------*/
+
+    /*
+     * Store and forward: CoPost and ObNotify data is appended to a journal on persistent
+     * storage instead of being sent, and a replayer sends the backlog to the server at a
+     * bounded rate once a context is connected. Records are delivered at least once, in
+     * order; a record is dropped from the journal once the server answered it.
+     */
+
+/* Data of one record, what a CoPost request carries at most. */
+#define RTIO_JOURNAL_DATA_SIZE_MAX ( RTIO_TRANSFER_FRAME_BUF_SIZE - 10U )
+
+/* Bytes of the record header, key, CRC and padding around the data. */
+#define RTIO_JOURNAL_RECORD_OVERHEAD ( 24U )
+
+#define RTIO_JOURNAL_RECORD_SIZE_MAX ( RTIO_JOURNAL_DATA_SIZE_MAX + RTIO_JOURNAL_RECORD_OVERHEAD )
+
+/* Bytes at the start of every segment. */
+#define RTIO_JOURNAL_SEGMENT_HEADER_SIZE ( 20U )
+
+    /* Counters of the journal since it was opened, backlog is what was not delivered yet. */
+    typedef struct RTIOJournalStats
+    {
+        uint32_t appended; /* Records written by producers. */
+        uint32_t replayed; /* Records the server answered. */
+        uint32_t dropped;  /* Records erased before delivery as the journal was full. */
+        uint32_t retries;  /* Times the replay went back to the first undelivered record. */
+        uint32_t syncs;    /* Syncs of the storage. */
+        uint32_t backlog;
+    } RTIOJournalStats_t;
+
+    /* Where a record starts, segment is generation % segmentNum. */
+    typedef struct rtioJournalPosition
+    {
+        uint32_t generation;
+        uint32_t offset;
+    } rtioJournalPosition_t;
+
+    /* A record being replayed, its response buffer must outlive the request. */
+    typedef struct rtioJournalSlot
+    {
+        void* pJournal; /* The RTIOJournal_t, the completion only gets the slot. */
+        uint8_t state;
+        uint32_t seq;
+        rtioJournalPosition_t next; /* After the record, where the replay resumes once it is delivered. */
+        RTIOFixedBuffer_t respBuffer;
+        uint8_t respData[ RTIO_JOURNAL_REPLAY_RESP_SIZE ];
+    } rtioJournalSlot_t;
+
+    /* Journal on a storage with the replay state, guarded by pLock. */
+    typedef struct RTIOJournal
+    {
+        StorageInterface_t storage;
+        OSMutex_t* pLock;
+        OSEvent_t* pEvent; /* Signaled when records are appended or answered. */
+        OSThreadHandle_t* pThread;
+        bool done;
+        bool threadExited;
+        uint32_t oldestGeneration;
+        uint32_t activeGeneration; /* Appended to, the others are full. */
+        uint32_t writeOffset;
+        uint32_t nextSeq;       /* Of the next data record. */
+        uint32_t ackedSeq;      /* Data records up to it are delivered. */
+        uint32_t checkpointSeq; /* The ackedSeq last written to the storage. */
+        rtioJournalPosition_t ackPos; /* Not before the first undelivered record. */
+        uint16_t pendingRecords; /* Written since the last sync. */
+        uint32_t firstPendingMs;
+        /* Replay, pContext is NULL when stopped. */
+        RTIOContext_t* pContext;
+        uint32_t recordsPerSecond;
+        uint32_t tokens; /* Thousandths of a record, refilled at recordsPerSecond. */
+        uint32_t refillMs;
+        rtioJournalPosition_t replayPos;
+        bool rewind;     /* A record failed, replay again from ackPos. */
+        uint32_t retryMs; /* No record is sent before it after a failure. */
+        rtioJournalSlot_t slots[ RTIO_JOURNAL_REPLAY_WINDOW ];
+        uint8_t appendBuffer[ RTIO_JOURNAL_RECORD_SIZE_MAX ];
+        uint8_t replayBuffer[ RTIO_JOURNAL_RECORD_SIZE_MAX ]; /* Used by the journal thread only. */
+        RTIOJournalStats_t stats;
+    } RTIOJournal_t;
+
+#define RTIOJournalRamAllocationGlobal_t struct RTIOJournalRamAllocation \
+    { \
+        OSThreadHandle_t thread; \
+        OSMutex_t lock; \
+        OSEvent_t event; \
+    }
+
+#define RTIO_JournalResourceBuild(ram) \
+    { \
+        .pThread = &ram.thread, \
+        .pLock = &ram.lock, \
+        .pEvent = &ram.event, \
+    }
+
+    /* Fixed resources of a journal. */
+    typedef struct RTIOJournalFixedResource
+    {
+        OSThreadHandle_t* pThread;
+        OSMutex_t* pLock;
+        OSEvent_t* pEvent;
+    } RTIOJournalFixedResource_t;
+
+    /*-----------------------------------------------------------*/
+
+    /* Opens the journal on the storage, recovering the records left by the last run, */
+    /* and starts the journal thread syncing and replaying them. */
+    RTIOStatus_t RTIO_JournalOpen( RTIOJournal_t* pJournal,
+                                   const RTIOJournalFixedResource_t* pFixedResource,
+                                   const StorageInterface_t* pStorage );
+
+    /* Stops the journal thread and syncs the storage, the replay must be stopped before. */
+    RTIOStatus_t RTIO_JournalClose( RTIOJournal_t* pJournal );
+
+    /* Appends a "constrained-post" request to the URI hash, it is sent by the replay. */
+    RTIOStatus_t RTIO_JournalCoPost( RTIOJournal_t* pJournal, uint32_t uri,
+                                     const uint8_t* pData, uint16_t length );
+
+    /* Appends a notification of the observer, it is sent by the replay. */
+    RTIOStatus_t RTIO_JournalObNotify( RTIOJournal_t* pJournal, uint16_t obId,
+                                       const uint8_t* pData, uint16_t length );
+
+    /* Syncs the records appended so far, instead of waiting for the batch. */
+    RTIOStatus_t RTIO_JournalSync( RTIOJournal_t* pJournal );
+
+    /* Starts sending the backlog with the connected context, at most recordsPerSecond records per second. */
+    RTIOStatus_t RTIO_JournalStartReplay( RTIOJournal_t* pJournal, RTIOContext_t* pContext,
+                                          uint32_t recordsPerSecond );
+
+    /* Stops sending and waits for the records in flight, call it before RTIO_Disconnect. */
+    RTIOStatus_t RTIO_JournalStopReplay( RTIOJournal_t* pJournal );
+
+    /* Gets the counters of the journal. */
+    RTIOStatus_t RTIO_JournalGetStats( RTIOJournal_t* pJournal, RTIOJournalStats_t* pStats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef CORE_RTIO_JOURNAL_H */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef CORE_RTIO_URI_DIGEST_HPP
+#define CORE_RTIO_URI_DIGEST_HPP
+
+/* URI digests computed by the C++11 compiler, the same values RTIO_URIHash() gives at runtime:
+ *
+ *     RTIO_CoPostWithDigest( pContext, RTIO_URI_DIGEST( "/uri/example1" ), ... );
+ *     static const RTIOCoPostUri_t handlers[] = { { RTIO_URI_DIGEST( "/rainbow" ), uriRainbow } };
+ */
+
+#include <stdint.h>
+
+namespace rtio
+{
+    namespace detail
+    {
+        /* C++11 constexpr functions are a single return statement, so the loops are recursions. */
+        constexpr uint32_t crc32Bits( uint32_t crc, int bits )
+        {
+            return ( bits == 0 ) ? crc :
+                   crc32Bits( ( crc >> 1 ) ^ ( ( crc & 1U ) ? 0xEDB88320U : 0U ), bits - 1 );
+        }
+
+        constexpr uint32_t crc32Update( const char* pUri, uint32_t crc )
+        {
+            return ( *pUri == '\0' ) ? crc :
+                   crc32Update( pUri + 1, crc32Bits( crc ^ static_cast< uint8_t >( *pUri ), 8 ) );
+        }
+
+        constexpr uint32_t uriLength( const char* pUri )
+        {
+            return ( *pUri == '\0' ) ? 0U : 1U + uriLength( pUri + 1 );
+        }
+
+        /* Not constexpr, reaching it in a constant expression is a compile error. */
+        /* At runtime it gives 0, which the registrations reject. */
+        inline uint32_t uriLengthOutOfRange()
+        {
+            return 0U;
+        }
+    }
+
+    /* Fails to compile in constant expressions when the length is out of 5 to 128, gives 0 at runtime. */
+    constexpr uint32_t uriDigest( const char* pUri )
+    {
+        return ( ( detail::uriLength( pUri ) < 5U ) || ( detail::uriLength( pUri ) > 128U ) ) ?
+               detail::uriLengthOutOfRange() :
+               ~detail::crc32Update( pUri, 0xFFFFFFFFU );
+    }
+
+    /* Forces the digest to be a compile time constant. */
+    template< uint32_t digest >
+    struct UriDigest
+    {
+        static constexpr uint32_t value = digest;
+    };
+}
+
+#define RTIO_URI_DIGEST( uri )    ( ::rtio::UriDigest< ::rtio::uriDigest( uri ) >::value )
+
+#endif /* ifndef CORE_RTIO_URI_DIGEST_HPP */
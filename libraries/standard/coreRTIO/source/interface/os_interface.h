@@ -22,6 +22,7 @@ typedef enum {
     OSSuccess = 0,
     OSBadParameter = 1,
     OSMutexNotAcquired  = 10,
+    OSEventTimeout = 11,
 } OSError_t;
 
 struct OSThreadHandle;
@@ -45,9 +46,47 @@ OSError_t OS_MutexTryLock( OSMutex_t * pMutex );
 OSError_t OS_MutexUnlock( OSMutex_t * pMutex );
 OSError_t OS_MutexDestroy( OSMutex_t * pMutex );
 
+
+struct OSEvent;
+typedef struct OSEvent OSEvent_t;
+
+/* Auto-reset event: one OS_EventSignal wakes one OS_EventWait, signals do not accumulate. */
+OSError_t OS_EventCreate( OSEvent_t * pEvent );
+OSError_t OS_EventSignal( OSEvent_t * pEvent );
+OSError_t OS_EventWait( OSEvent_t * pEvent, uint32_t timeoutMs ); // OSEventTimeout if not signaled in time
+OSError_t OS_EventDestroy( OSEvent_t * pEvent );
+
 uint32_t OS_ClockGetTimeMs( void );
 void OS_ClockSleepMs( uint32_t sleepTimeMs );
 
+/* Microsecond clock for short deadlines, wraps after about 71 minutes. */
+uint32_t OS_ClockGetTimeUs( void );
+void OS_ClockSleepUs( uint32_t sleepTimeUs );
+
+
+/* Atomics, used by the core instead of mutexes when RTIO_USE_C11_ATOMICS is 1, */
+/* ports whose compiler has no C11 <stdatomic.h> leave it 0. */
+#if defined( RTIO_USE_C11_ATOMICS ) && ( RTIO_USE_C11_ATOMICS != 0 )
+#ifdef __cplusplus
+/* Same size and alignment, only the C sources of the core access it. */
+typedef uint32_t OSAtomicU32_t;
+#else
+#if !defined( __STDC_VERSION__ ) || ( __STDC_VERSION__ < 201112L ) || defined( __STDC_NO_ATOMICS__ )
+#error "RTIO_USE_C11_ATOMICS needs a C11 compiler with <stdatomic.h>."
+#endif
+#include <stdatomic.h>
+typedef _Atomic uint32_t OSAtomicU32_t;
+
+#define OS_AtomicInit( pAtomic, value )    atomic_init( ( pAtomic ), ( value ) )
+#define OS_AtomicLoad( pAtomic )    atomic_load_explicit( ( pAtomic ), memory_order_acquire )
+#define OS_AtomicStore( pAtomic, value )    atomic_store_explicit( ( pAtomic ), ( value ), memory_order_release )
+#define OS_AtomicFetchAdd( pAtomic, value )    atomic_fetch_add_explicit( ( pAtomic ), ( value ), memory_order_relaxed )
+/* Returns true and stores desired if *pAtomic equals *pExpected, otherwise loads *pAtomic into *pExpected. */
+#define OS_AtomicCompareExchange( pAtomic, pExpected, desired ) \
+    atomic_compare_exchange_strong_explicit( ( pAtomic ), ( pExpected ), ( desired ), memory_order_acq_rel, memory_order_acquire )
+#endif
+#endif
+
 
 #ifdef __cplusplus
     }
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef STORAGE_INTERFACE_H_
+#define STORAGE_INTERFACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/*
+ * Persistent storage of the journal, split into segments of segmentSize bytes like the
+ * sectors of a flash. A segment is written once from its start to its end, then erased
+ * as a whole before it is written again; bytes are never rewritten in between.
+ */
+
+struct StorageContext;
+typedef struct StorageContext StorageContext_t;
+
+typedef enum StorageStatus
+{
+    StorageUnknown = -1,
+    StorageSuccess = 0,
+    StorageInvalidParameter = 1,
+    StorageReadFailure = 2,
+    StorageWriteFailure = 3,
+    StorageSyncFailure = 4,
+    StorageEraseFailure = 5
+} StorageStatus_t;
+
+typedef StorageStatus_t ( * StorageRead_t )( StorageContext_t * pStorageContext,
+                                             uint16_t segment,
+                                             uint32_t offset,
+                                             void * pBuffer,
+                                             size_t bytesToRead );
+
+/* Written bytes may stay volatile until the segment is synced. */
+typedef StorageStatus_t ( * StorageWrite_t )( StorageContext_t * pStorageContext,
+                                              uint16_t segment,
+                                              uint32_t offset,
+                                              const void * pBuffer,
+                                              size_t bytesToWrite );
+
+/* Returns once the bytes written to the segment survive a power loss. */
+typedef StorageStatus_t ( * StorageSync_t )( StorageContext_t * pStorageContext,
+                                             uint16_t segment );
+
+/* Sets every byte of the segment to erasedValue and makes it durable. */
+typedef StorageStatus_t ( * StorageErase_t )( StorageContext_t * pStorageContext,
+                                              uint16_t segment );
+
+typedef struct StorageInterface
+{
+    StorageRead_t read;
+    StorageWrite_t write;
+    StorageSync_t sync;
+    StorageErase_t erase;
+    StorageContext_t * pStorageContext;
+    uint32_t segmentSize;
+    uint16_t segmentNum;
+    uint8_t erasedValue; /* 0xFF for NOR flash. */
+} StorageInterface_t;
+
+#ifdef __cplusplus
+    }
+#endif
+
+
+#endif /* ifndef STORAGE_INTERFACE_H_ */
@@ -52,6 +52,25 @@ typedef int32_t ( * TransportRecv_t )( NetworkContext_t * pNetworkContext,
 typedef int32_t ( * TransportSend_t )( NetworkContext_t * pNetworkContext,
                                        const void * pBuffer,
                                        size_t bytesToSend );
+
+/* A segment of a gathered send, like struct iovec. */
+typedef struct TransportIoVector
+{
+    const void * iov_base;
+    size_t iov_len;
+} TransportIoVector_t;
+
+/* Sends the segments in order as one write, returns the total bytes sent like TransportSend_t. */
+typedef int32_t ( * TransportSendv_t )( NetworkContext_t * pNetworkContext,
+                                        const TransportIoVector_t * pIoVec,
+                                        size_t ioVecCount );
+
+/* Blocks until data can be read or timeoutMs elapses, returns >0 if readable, 0 on timeout, <0 on error. */
+typedef int32_t ( * TransportWaitReadable_t )( NetworkContext_t * pNetworkContext,
+                                               uint32_t timeoutMs );
+
+/* Returns the descriptor an event loop watches for readability, -1 if not connected. */
+typedef int32_t ( * TransportGetDescriptor_t )( NetworkContext_t * pNetworkContext );
                        
 typedef struct TransportInterface
 {
@@ -60,6 +79,9 @@ typedef struct TransportInterface
     TransportConnect_t connect;         
     TransportDisconnect_t disconnect;   
     NetworkContext_t * pNetworkContext; 
+    TransportSendv_t sendv;             /* Optional, NULL if not supported. */
+    TransportWaitReadable_t waitReadable; /* Optional, recv is polled if NULL. */
+    TransportGetDescriptor_t getDescriptor; /* Optional, needed by event loops only. */
 } TransportInterface_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef CORE_RTIO_CRC32_H
+#define CORE_RTIO_CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core_rtio.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* The carry-less multiply path is built on x86-64 with GCC or Clang and picked at runtime. */
+#if ( RTIO_CRC32_CLMUL != 0 ) && defined( __x86_64__ ) && defined( __GNUC__ )
+#define RTIO_CRC32_CLMUL_ENABLED
+#endif
+
+/* Shorter data is not worth folding, it goes to the table or the bitwise loop. */
+#define RTIO_CRC32_CLMUL_LENGTH_MIN ( 64U )
+
+    /* All of them give the same digest as crc32Ieee(), they are exposed for tests and benchmarks. */
+    uint32_t crc32IeeeBitwise( const uint8_t* data, size_t length );
+
+#if ( RTIO_CRC32_SLICING_BY_8 != 0 )
+    uint32_t crc32IeeeSlicingBy8( const uint8_t* data, size_t length );
+#endif
+
+#ifdef RTIO_CRC32_CLMUL_ENABLED
+    bool crc32IeeeClmulSupported( void );
+    /* Must only be called when crc32IeeeClmulSupported() returns true. */
+    uint32_t crc32IeeeClmul( const uint8_t* data, size_t length );
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef CORE_RTIO_CRC32_H */
@@ -235,10 +235,19 @@ extern "C"
                                          const uint8_t* pData, uint16_t dataLength,
                                          RTIOCoResp_t* pResp );
 
+    /* The *Header_* variants serialize everything but the payload, which is sent as its own segment. */
+    RTIOStatus_t RTIO_SerializeCoReqHeader_OverDeviceSendReq( const RTIOCoReq_t* pReq,
+                                                              const RTIOFixedBuffer_t* pFixedBuffer,
+                                                              uint16_t* headerLength );
+
     RTIOStatus_t RTIO_SerializeCoReq_OverDeviceSendReq( const RTIOCoReq_t* pReq,
                                                         const RTIOFixedBuffer_t* pFixedBuffer,
                                                         uint16_t* dataLength );
 
+    RTIOStatus_t RTIO_SerializeCoRespHeader_OverServerSendResp( const RTIOCoResp_t* pResp,
+                                                                const RTIOFixedBuffer_t* pFixedBuffer,
+                                                                uint16_t* headerLength );
+
     RTIOStatus_t RTIO_SerializeCoResp_OverServerSendResp( const RTIOCoResp_t* pResp,
                                                           const RTIOFixedBuffer_t* pFixedBuffer,
                                                           uint16_t* length );
@@ -246,10 +255,19 @@ extern "C"
                                                                const RTIOFixedBuffer_t* pFixedBuffer,
                                                                uint16_t* length );
 
+    RTIOStatus_t RTIO_SerializeObNotifyReqHeader_OverDeviceSendReq( const RTIOObNotifyReq_t* pReq,
+                                                                    const RTIOFixedBuffer_t* pFixedBuffer,
+                                                                    uint16_t* headerLength );
+
     RTIOStatus_t RTIO_SerializeObNotifyReq_OverDeviceSendReq( const RTIOObNotifyReq_t* pReq,
                                                               const RTIOFixedBuffer_t* pFixedBuffer,
                                                               uint16_t* dataLength );
 
+    /* Rewrites headerId and obId of a frame serialized by RTIO_SerializeObNotifyReq*_OverDeviceSendReq,
+     * so the same notification goes to another observer without serializing it again. */
+    RTIOStatus_t RTIO_SerializeObNotifyReqPatch_OverDeviceSendReq( uint16_t headerId, uint16_t obId,
+                                                                   const RTIOFixedBuffer_t* pFixedBuffer );
+
     RTIOStatus_t RTIO_DeSerializeObNotifyResp_FromDeviceSendResp( const rtioDeviceSendResp_t* pDeviceSendResp,
                                                                   RTIOObNotifyResp_t* pObResp );
 
@@ -53,6 +53,11 @@ struct OSMutex
     SemaphoreHandle_t lock;
 };
 
+struct OSEvent
+{
+    SemaphoreHandle_t event;
+};
+
 
 #include "os_interface.h"
 
@@ -134,6 +134,64 @@ OSError_t OS_MutexDestroy( OSMutex_t * pMutex )
 
 /*-----------------------------------------------------------*/
 
+OSError_t OS_EventCreate( OSEvent_t * pEvent )
+{
+    if(NULL == pEvent)
+    {
+        LogError( ( "pEvent is Null.") );
+        return OSBadParameter;
+    }
+    SemaphoreHandle_t event = xSemaphoreCreateBinary();
+    if(NULL == event)
+    {
+        LogError( ("xSemaphoreCreateBinary error.") );
+        return OSUnknown;
+    }
+    pEvent->event = event;
+    LogDebug( ("xSemaphoreCreateBinary success.") );
+    return OSSuccess;
+}
+
+OSError_t OS_EventSignal( OSEvent_t * pEvent )
+{
+    if(NULL == pEvent)
+    {
+        LogError( ( "pEvent is Null.") );
+        return OSBadParameter;
+    }
+    /* Giving an already given binary semaphore fails, the pending signal is kept. */
+    (void)xSemaphoreGive(pEvent->event);
+    return OSSuccess;
+}
+
+OSError_t OS_EventWait( OSEvent_t * pEvent, uint32_t timeoutMs )
+{
+    if(NULL == pEvent)
+    {
+        LogError( ( "pEvent is Null.") );
+        return OSBadParameter;
+    }
+    if(xSemaphoreTake(pEvent->event, pdMS_TO_TICKS(timeoutMs)) != pdTRUE)
+    {
+        return OSEventTimeout;
+    }
+    return OSSuccess;
+}
+
+OSError_t OS_EventDestroy( OSEvent_t * pEvent )
+{
+    if(NULL == pEvent)
+    {
+        LogError( ("pEvent is Null.") );
+        return OSBadParameter;
+    }
+    vSemaphoreDelete(pEvent->event);
+    LogDebug( ("vSemaphoreDelete success.") );
+    return OSSuccess;
+}
+
+/*-----------------------------------------------------------*/
+
 uint32_t OS_ClockGetTimeMs( void )
 {
     int64_t timeMs = esp_timer_get_time() / 1000;
@@ -143,6 +201,22 @@ void OS_ClockSleepMs( uint32_t sleepTimeMs )
 {
     vTaskDelay( sleepTimeMs/portTICK_PERIOD_MS );
 }
+uint32_t OS_ClockGetTimeUs( void )
+{
+    return ( uint32_t ) esp_timer_get_time();
+}
+void OS_ClockSleepUs( uint32_t sleepTimeUs )
+{
+    /* Shorter than a tick only yields. */
+    if( sleepTimeUs >= portTICK_PERIOD_MS * 1000U )
+    {
+        vTaskDelay( sleepTimeUs / ( portTICK_PERIOD_MS * 1000U ) );
+    }
+    else
+    {
+        taskYIELD();
+    }
+}
 
 /*-----------------------------------------------------------*/
 
@@ -40,6 +40,8 @@
  */
 #define NANOSECONDS_PER_MILLISECOND    ( 1000000L )    /**< @brief Nanoseconds per millisecond. */
 #define MILLISECONDS_PER_SECOND        ( 1000L )       /**< @brief Milliseconds per second. */
+#define NANOSECONDS_PER_MICROSECOND    ( 1000L )       /**< @brief Nanoseconds per microsecond. */
+#define MICROSECONDS_PER_SECOND        ( 1000000L )    /**< @brief Microseconds per second. */
 
 /*-----------------------------------------------------------*/
 
@@ -75,3 +77,29 @@ void Clock_SleepMs( uint32_t sleepTimeMs )
     /* High resolution sleep. */
     ( void ) nanosleep( &sleepTime, NULL );
 }
+
+/*-----------------------------------------------------------*/
+
+uint32_t Clock_GetTimeUs( void )
+{
+    int64_t timeUs;
+    struct timespec timeSpec;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &timeSpec );
+    timeUs = ( timeSpec.tv_sec * MICROSECONDS_PER_SECOND )
+             + ( timeSpec.tv_nsec / NANOSECONDS_PER_MICROSECOND );
+
+    return ( uint32_t ) timeUs;
+}
+
+/*-----------------------------------------------------------*/
+
+void Clock_SleepUs( uint32_t sleepTimeUs )
+{
+    struct timespec sleepTime = { 0 };
+
+    sleepTime.tv_sec = ( ( time_t ) sleepTimeUs / ( time_t ) MICROSECONDS_PER_SECOND );
+    sleepTime.tv_nsec = ( ( int64_t ) sleepTimeUs % MICROSECONDS_PER_SECOND ) * NANOSECONDS_PER_MICROSECOND;
+
+    ( void ) nanosleep( &sleepTime, NULL );
+}
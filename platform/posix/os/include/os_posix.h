@@ -46,6 +46,12 @@
     extern "C" {
 #endif
 
+/* Smallest stack given to a thread created with a non-zero stackSize, */
+/* the sizes configured for constrained systems are too small for libc on POSIX. */
+#ifndef OS_POSIX_THREAD_STACK_SIZE_MIN
+    #define OS_POSIX_THREAD_STACK_SIZE_MIN    ( 65536U )
+#endif
+
 struct OSThreadHandle
 {
     pthread_t threadId;
@@ -56,6 +62,13 @@ struct OSMutex
     pthread_mutex_t lock;
 };
 
+struct OSEvent
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int signaled;
+};
+
 
 #include "os_interface.h"
 
@@ -6,8 +6,16 @@
  */
 
 #include <errno.h>
+#include <limits.h>
+#include <time.h>
 #include "os_posix.h"
 
+/* Implemented in clock_posix.c. */
+uint32_t Clock_GetTimeMs( void );
+void Clock_SleepMs( uint32_t sleepTimeMs );
+uint32_t Clock_GetTimeUs( void );
+void Clock_SleepUs( uint32_t sleepTimeUs );
+
 /*-----------------------------------------------------------*/
 
 
@@ -18,17 +26,43 @@ OSError_t OS_ThreadCreate( OSThreadHandle_t * pHandle,
                             uint32_t stackSize)
 {
 
+    pthread_attr_t attr;
+    int ret = 0;
+
     if(NULL == pHandle)
     {
         LogError( ( "pHandle is Null.") );
         return OSBadParameter;
     }  
 
-    if(0 == pthread_create( &pHandle->threadId, NULL, (void *)func, arg) )
+    (void)pthread_attr_init( &attr );
+    /* 0 keeps the default stack, small embedded sizes are raised to what libc and logging need. */
+    if( stackSize != 0U )
+    {
+        if( stackSize < OS_POSIX_THREAD_STACK_SIZE_MIN )
+        {
+            stackSize = OS_POSIX_THREAD_STACK_SIZE_MIN;
+        }
+        if( stackSize < (uint32_t)PTHREAD_STACK_MIN )
+        {
+            stackSize = (uint32_t)PTHREAD_STACK_MIN;
+        }
+        ret = pthread_attr_setstacksize( &attr, stackSize );
+        if( 0 != ret )
+        {
+            LogWarn( ("pthread_attr_setstacksize failed, stackSize=%u, ret=%d.", (unsigned)stackSize, ret) );
+        }
+    }
+
+    ret = pthread_create( &pHandle->threadId, &attr, (void *)func, arg );
+    (void)pthread_attr_destroy( &attr );
+    if( 0 == ret )
     {
-        LogDebug( ("pthread_create success, threadId=%lu.", pHandle->threadId) );
+        LogDebug( ("pthread_create success, threadId=%lu, name=%s, stackSize=%u.",
+                   pHandle->threadId, ( name != NULL ) ? name : "", (unsigned)stackSize) );
         return OSSuccess;
     }
+    LogError( ("pthread_create failed, ret=%d.", ret) );
     return OSUnknown;
 }
 
@@ -146,6 +180,125 @@ OSError_t OS_MutexDestroy( OSMutex_t * pMutex )
     return OSSuccess;
 }
 
+/*-----------------------------------------------------------*/
+
+OSError_t OS_EventCreate( OSEvent_t * pEvent )
+{
+    pthread_condattr_t condAttr;
+    int ret = 0;
+
+    if(NULL == pEvent)
+    {
+        LogError( ( "pEvent is Null.") );
+        return OSBadParameter;
+    }
+    ret = pthread_mutex_init( &(pEvent->lock), NULL );
+    if(0 != ret)
+    {
+        LogError( ("pthread_mutex_init lock=%p, ret=%d.", &(pEvent->lock), ret) );
+        return OSUnknown;
+    }
+
+    /* Timed waits are measured on the monotonic clock, as OS_ClockGetTimeMs is. */
+    pthread_condattr_init( &condAttr );
+    pthread_condattr_setclock( &condAttr, CLOCK_MONOTONIC );
+    ret = pthread_cond_init( &(pEvent->cond), &condAttr );
+    pthread_condattr_destroy( &condAttr );
+    if(0 != ret)
+    {
+        LogError( ("pthread_cond_init cond=%p, ret=%d.", &(pEvent->cond), ret) );
+        pthread_mutex_destroy( &(pEvent->lock) );
+        return OSUnknown;
+    }
+    pEvent->signaled = 0;
+    LogDebug( ("OS_EventCreate success, event=%p.", (void *)pEvent) );
+    return OSSuccess;
+}
+
+OSError_t OS_EventSignal( OSEvent_t * pEvent )
+{
+    int ret = 0;
+
+    if(NULL == pEvent)
+    {
+        LogError( ( "pEvent is Null.") );
+        return OSBadParameter;
+    }
+    pthread_mutex_lock( &(pEvent->lock) );
+    pEvent->signaled = 1;
+    ret = pthread_cond_signal( &(pEvent->cond) );
+    pthread_mutex_unlock( &(pEvent->lock) );
+    if(0 != ret)
+    {
+        LogError( ("pthread_cond_signal cond=%p, ret=%d.", &(pEvent->cond), ret) );
+        return OSUnknown;
+    }
+    return OSSuccess;
+}
+
+OSError_t OS_EventWait( OSEvent_t * pEvent, uint32_t timeoutMs )
+{
+    struct timespec deadline;
+    OSError_t osRet = OSSuccess;
+    int ret = 0;
+
+    if(NULL == pEvent)
+    {
+        LogError( ( "pEvent is Null.") );
+        return OSBadParameter;
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &deadline );
+    deadline.tv_sec += timeoutMs / 1000U;
+    deadline.tv_nsec += ( long )( timeoutMs % 1000U ) * 1000000L;
+    if( deadline.tv_nsec >= 1000000000L )
+    {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock( &(pEvent->lock) );
+    while( 0 == pEvent->signaled )
+    {
+        ret = pthread_cond_timedwait( &(pEvent->cond), &(pEvent->lock), &deadline );
+        if( ETIMEDOUT == ret )
+        {
+            osRet = OSEventTimeout;
+            break;
+        }
+        else if( 0 != ret )
+        {
+            LogError( ("pthread_cond_timedwait cond=%p, ret=%d.", &(pEvent->cond), ret) );
+            osRet = OSUnknown;
+            break;
+        }
+    }
+    if( OSSuccess == osRet )
+    {
+        pEvent->signaled = 0;
+    }
+    pthread_mutex_unlock( &(pEvent->lock) );
+    return osRet;
+}
+
+OSError_t OS_EventDestroy( OSEvent_t * pEvent )
+{
+    if(NULL == pEvent)
+    {
+        LogError( ("pEvent is Null.") );
+        return OSBadParameter;
+    }
+    int ret = pthread_cond_destroy( &(pEvent->cond) );
+    if(0 != ret)
+    {
+        LogError( ("pthread_cond_destroy cond=%p, ret=%d.", &(pEvent->cond), ret) );
+        return OSUnknown;
+    }
+    pthread_mutex_destroy( &(pEvent->lock) );
+    LogDebug( ("OS_EventDestroy success, event=%p.", (void *)pEvent) );
+    return OSSuccess;
+}
+
 /*-----------------------------------------------------------*/
 uint32_t OS_ClockGetTimeMs( void )
 {
@@ -155,6 +308,14 @@ void OS_ClockSleepMs( uint32_t sleepTimeMs )
 {
     Clock_SleepMs( sleepTimeMs );
 }
+uint32_t OS_ClockGetTimeUs( void )
+{
+    return Clock_GetTimeUs();
+}
+void OS_ClockSleepUs( uint32_t sleepTimeUs )
+{
+    Clock_SleepUs( sleepTimeUs );
+}
 
 /*-----------------------------------------------------------*/
 
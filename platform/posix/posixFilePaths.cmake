@@ -33,3 +33,19 @@ set( COMMON_OS_INCLUDE_PUBLIC_DIRS
 set( COMMON_OS_SOURCES
      ${CMAKE_CURRENT_LIST_DIR}/os/os_posix.c
      ${CMAKE_CURRENT_LIST_DIR}/os/clock_posix.c)
+
+# Reactor source files, built with the RTIO sources and config of the application.
+set( REACTOR_POSIX_SOURCES
+     ${CMAKE_CURRENT_LIST_DIR}/reactor/rtio_reactor_posix.c )
+
+# Reactor Public Include directories.
+set( COMMON_REACTOR_INCLUDE_PUBLIC_DIRS
+     ${CMAKE_CURRENT_LIST_DIR}/reactor/include )
+
+# Storage source files, segment files mapped with mmap for the journal.
+set( STORAGE_POSIX_SOURCES
+     ${CMAKE_CURRENT_LIST_DIR}/storage/storage_posix.c )
+
+# Storage Public Include directories.
+set( COMMON_STORAGE_INCLUDE_PUBLIC_DIRS
+     ${CMAKE_CURRENT_LIST_DIR}/storage/include )
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#ifndef RTIO_REACTOR_POSIX_H_
+#define RTIO_REACTOR_POSIX_H_
+
+/**************************************************/
+/******* DO NOT CHANGE the following order ********/
+/**************************************************/
+
+/* Include header that defines log levels. */
+#include "logging_levels.h"
+
+/* Logging configuration for the reactor. */
+#ifndef LIBRARY_LOG_NAME
+    #define LIBRARY_LOG_NAME     "RTIO_Reactor"
+#endif
+#ifndef LIBRARY_LOG_LEVEL
+    #define LIBRARY_LOG_LEVEL    LOG_INFO
+#endif
+
+#include "logging_stack.h"
+
+/************ End of logging configuration ****************/
+
+#include "os_posix.h"
+#include "core_rtio.h"
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/*
+ * An epoll reactor serving many event-driven RTIO contexts with a few worker threads,
+ * instead of the incomming and keep-alive threads of every context. The workers share
+ * one epoll instance: a readable descriptor is handled by one worker at a time
+ * (EPOLLONESHOT), and the worker waking first for a due deadline runs the timers.
+ * A reconnect blocks the worker running it, have more workers than reconnects expected
+ * at once.
+ */
+
+#ifndef RTIO_REACTOR_EVENTS_MAX
+    #define RTIO_REACTOR_EVENTS_MAX    ( 64U ) /* Events and due contexts taken at once by a worker. */
+#endif
+
+#ifndef RTIO_REACTOR_WAIT_MAX_MS
+    #define RTIO_REACTOR_WAIT_MAX_MS    ( 1000U ) /* Longest sleep of a worker. */
+#endif
+
+#ifndef RTIO_REACTOR_WORKER_STACK_SIZE
+    #define RTIO_REACTOR_WORKER_STACK_SIZE    ( 0U ) /* 0 for the default stack, reconnects run TLS handshakes. */
+#endif
+
+struct RTIOReactor;
+
+/* A context served by the reactor, entries are provided by the caller like the RTIO fixed RAM. */
+typedef struct RTIOReactorEntry
+{
+    struct RTIOReactor* pReactor;
+    RTIOContext_t* pContext; /* NULL when the entry is free. */
+    int32_t descriptor;      /* Watched by epoll, -1 when not. */
+    uint32_t connectCount;   /* Connection of the watched descriptor. */
+    bool readFailed;         /* That connection is not watched any more. */
+    uint32_t deadlineMs;     /* When the timers of the context are due. */
+    uint32_t pendingMs;      /* A deadline reported while busy. */
+    bool pending;
+    bool readPending;        /* Readable while busy. */
+    bool busy;               /* A worker is handling the context. */
+} RTIOReactorEntry_t;
+
+typedef struct RTIOReactor
+{
+    RTIOReactorEntry_t* pEntries;
+    uint16_t size;
+    uint16_t entryEnd;       /* Entries from entryEnd on were never used. */
+    OSThreadHandle_t* pWorkers;
+    uint16_t workerNum;
+    OSMutex_t lock;
+    int epollFd;
+    int wakeFd;              /* eventfd waking the workers for an earlier deadline or stop. */
+    uint32_t earliestMs;     /* No deadline of an idle entry is before it. */
+    volatile bool done;
+} RTIOReactor_t;
+
+/*-----------------------------------------------------------*/
+
+/* Starts workerNum workers in pWorkers, up to size contexts can be added to pEntries. */
+RTIOStatus_t RTIOReactor_Start( RTIOReactor_t* pReactor,
+                                RTIOReactorEntry_t* pEntries, uint16_t size,
+                                OSThreadHandle_t* pWorkers, uint16_t workerNum );
+
+/* Serves a context connected by RTIO_Connect, instead of RTIO_Serve. */
+RTIOStatus_t RTIOReactor_Add( RTIOReactor_t* pReactor, RTIOContext_t* pContext );
+
+/* Stops serving the context, waits until no worker handles it, RTIO_Disconnect can follow. */
+RTIOStatus_t RTIOReactor_Remove( RTIOReactor_t* pReactor, RTIOContext_t* pContext );
+
+/* Stops and joins the workers, the contexts left are not disconnected. */
+RTIOStatus_t RTIOReactor_Stop( RTIOReactor_t* pReactor );
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* ifndef RTIO_REACTOR_POSIX_H_ */
@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+/* Standard includes. */
+#include <errno.h>
+#include <string.h>
+
+/* POSIX includes. */
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "rtio_reactor_posix.h"
+
+/*-----------------------------------------------------------*/
+
+static bool reactor_Before( uint32_t a, uint32_t b )
+{
+    return (int32_t)( a - b ) < 0;
+}
+
+/* Wakes the sleeping workers, the eventfd stays readable until a worker drains it. */
+static void reactor_WakeWorkers( RTIOReactor_t* pReactor )
+{
+    uint64_t one = 1U;
+
+    if( write( pReactor->wakeFd, &one, sizeof( one ) ) < 0 )
+    {
+        LogDebug( ( "Wake write failed, errno=%d.", errno ) );
+    }
+}
+
+/* Timer wakeup of a context, called by the core from any thread. */
+static void reactor_Wakeup( void* pWakeupArg, uint32_t deadlineMs )
+{
+    RTIOReactorEntry_t* pEntry = (RTIOReactorEntry_t*)pWakeupArg;
+    RTIOReactor_t* pReactor = pEntry->pReactor;
+    bool wake = false;
+
+    OS_MutexLock( &( pReactor->lock ) );
+    if( pEntry->pContext == NULL )
+    {
+        /* Removed. */
+    }
+    else if( pEntry->busy )
+    {
+        /* The worker handling it takes the deadline when done. */
+        if( !pEntry->pending || reactor_Before( deadlineMs, pEntry->pendingMs ) )
+        {
+            pEntry->pendingMs = deadlineMs;
+        }
+        pEntry->pending = true;
+    }
+    else
+    {
+        if( reactor_Before( deadlineMs, pEntry->deadlineMs ) )
+        {
+            pEntry->deadlineMs = deadlineMs;
+        }
+        if( reactor_Before( deadlineMs, pReactor->earliestMs ) )
+        {
+            pReactor->earliestMs = deadlineMs;
+            wake = true;
+        }
+    }
+    OS_MutexUnlock( &( pReactor->lock ) );
+
+    if( wake )
+    {
+        reactor_WakeWorkers( pReactor );
+    }
+}
+
+/* The caller holds the lock, makes epoll watch the descriptor of the current connection. */
+static void reactor_Watch( RTIOReactor_t* pReactor, RTIOReactorEntry_t* pEntry,
+                           bool connected, int32_t descriptor, uint32_t connectCount, bool rearm )
+{
+    struct epoll_event event;
+    bool watch = connected && !( pEntry->readFailed && ( connectCount == pEntry->connectCount ) );
+
+    memset( &event, 0, sizeof( event ) );
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = pEntry;
+
+    /* A closed descriptor left epoll by itself, its number may be reused by the new connection. */
+    if( ( pEntry->descriptor >= 0 ) &&
+        ( !watch || ( descriptor != pEntry->descriptor ) || ( connectCount != pEntry->connectCount ) ) )
+    {
+        (void)epoll_ctl( pReactor->epollFd, EPOLL_CTL_DEL, pEntry->descriptor, NULL );
+        pEntry->descriptor = -1;
+    }
+
+    if( watch && ( pEntry->descriptor < 0 ) )
+    {
+        if( epoll_ctl( pReactor->epollFd, EPOLL_CTL_ADD, descriptor, &event ) == 0 )
+        {
+            pEntry->descriptor = descriptor;
+            pEntry->connectCount = connectCount;
+            pEntry->readFailed = false;
+        }
+        else
+        {
+            LogError( ( "Failed to watch descriptor=%d, errno=%d.", (int)descriptor, errno ) );
+        }
+    }
+    else if( watch && rearm )
+    {
+        if( epoll_ctl( pReactor->epollFd, EPOLL_CTL_MOD, descriptor, &event ) != 0 )
+        {
+            LogError( ( "Failed to rearm descriptor=%d, errno=%d.", (int)descriptor, errno ) );
+        }
+    }
+    else
+    {
+        /* Nothing to change. */
+    }
+}
+
+/* Handles a context marked busy by the caller, reads if readable and runs its due timers. */
+static void reactor_Handle( RTIOReactor_t* pReactor, RTIOReactorEntry_t* pEntry, bool readable )
+{
+    RTIOContext_t* pContext = pEntry->pContext;
+    RTIOStatus_t readStatus = RTIOSuccess;
+    int32_t descriptor = -1;
+    uint32_t connectCount = 0;
+    uint32_t waitMs = 0;
+    uint32_t deadlineMs = 0;
+    bool connected = false;
+
+    do
+    {
+        readStatus = RTIOSuccess;
+        if( readable )
+        {
+            readStatus = RTIO_HandleReadable( pContext );
+        }
+        /* A broken session is reconnected at once, a ping response is collected. */
+        (void)RTIO_HandleTimers( pContext, &waitMs );
+        connected = ( RTIO_GetDescriptor( pContext, &descriptor, &connectCount ) == RTIOSuccess );
+        deadlineMs = OS_ClockGetTimeMs() + waitMs;
+
+        /* The core is not called with the lock held, its wakeups take the lock. */
+        OS_MutexLock( &( pReactor->lock ) );
+        if( readStatus != RTIOSuccess )
+        {
+            pEntry->readFailed = true;
+        }
+        reactor_Watch( pReactor, pEntry, connected, descriptor, connectCount, readable );
+
+        if( pEntry->pending && reactor_Before( pEntry->pendingMs, deadlineMs ) )
+        {
+            deadlineMs = pEntry->pendingMs;
+        }
+        pEntry->pending = false;
+        pEntry->deadlineMs = deadlineMs;
+        if( reactor_Before( deadlineMs, pReactor->earliestMs ) )
+        {
+            pReactor->earliestMs = deadlineMs;
+        }
+
+        readable = pEntry->readPending;
+        pEntry->readPending = false;
+        if( !readable )
+        {
+            pEntry->busy = false;
+        }
+        OS_MutexUnlock( &( pReactor->lock ) );
+    } while( readable );
+}
+
+/* Handles the contexts whose timers are due. */
+static void reactor_RunDue( RTIOReactor_t* pReactor )
+{
+    RTIOReactorEntry_t* due[ RTIO_REACTOR_EVENTS_MAX ];
+    RTIOReactorEntry_t* pEntry = NULL;
+    uint16_t dueNum = 0, i = 0;
+    uint32_t nowMs = 0, earliestMs = 0;
+
+    do
+    {
+        dueNum = 0;
+        OS_MutexLock( &( pReactor->lock ) );
+        nowMs = OS_ClockGetTimeMs();
+        if( !reactor_Before( nowMs, pReactor->earliestMs ) )
+        {
+            earliestMs = nowMs + RTIO_REACTOR_WAIT_MAX_MS;
+            for( i = 0; i < pReactor->entryEnd; i++ )
+            {
+                pEntry = &( pReactor->pEntries[ i ] );
+                if( ( pEntry->pContext == NULL ) || pEntry->busy )
+                {
+                    continue;
+                }
+                if( !reactor_Before( nowMs, pEntry->deadlineMs ) && ( dueNum < RTIO_REACTOR_EVENTS_MAX ) )
+                {
+                    pEntry->busy = true;
+                    due[ dueNum++ ] = pEntry;
+                }
+                else if( reactor_Before( pEntry->deadlineMs, earliestMs ) )
+                {
+                    earliestMs = pEntry->deadlineMs;
+                }
+                else
+                {
+                    /* MISRA else. */
+                }
+            }
+            /* Busy entries lower it again when their worker is done. */
+            pReactor->earliestMs = earliestMs;
+        }
+        OS_MutexUnlock( &( pReactor->lock ) );
+
+        for( i = 0; i < dueNum; i++ )
+        {
+            reactor_Handle( pReactor, due[ i ], false );
+        }
+    } while( ( dueNum > 0U ) && !pReactor->done );
+}
+
+static int reactor_WaitMs( RTIOReactor_t* pReactor )
+{
+    uint32_t waitMs = 0;
+    uint32_t nowMs = 0;
+
+    OS_MutexLock( &( pReactor->lock ) );
+    nowMs = OS_ClockGetTimeMs();
+    if( reactor_Before( nowMs, pReactor->earliestMs ) )
+    {
+        waitMs = pReactor->earliestMs - nowMs;
+    }
+    OS_MutexUnlock( &( pReactor->lock ) );
+
+    return (int)( ( waitMs < RTIO_REACTOR_WAIT_MAX_MS ) ? waitMs : RTIO_REACTOR_WAIT_MAX_MS );
+}
+
+static void reactor_Worker( void* pParam )
+{
+    RTIOReactor_t* pReactor = (RTIOReactor_t*)pParam;
+    struct epoll_event events[ RTIO_REACTOR_EVENTS_MAX ];
+    RTIOReactorEntry_t* pEntry = NULL;
+    uint64_t wakeCount = 0;
+    int eventNum = 0, i = 0;
+    bool handle = false;
+
+    LogDebug( ( "Reactor worker started." ) );
+    while( !pReactor->done )
+    {
+        eventNum = epoll_wait( pReactor->epollFd, events, (int)RTIO_REACTOR_EVENTS_MAX, reactor_WaitMs( pReactor ) );
+        if( ( eventNum < 0 ) && ( errno != EINTR ) )
+        {
+            LogError( ( "epoll_wait failed, errno=%d.", errno ) );
+            OS_ClockSleepMs( 10U );
+        }
+
+        for( i = 0; ( i < eventNum ) && !pReactor->done; i++ )
+        {
+            pEntry = (RTIOReactorEntry_t*)events[ i ].data.ptr;
+            if( pEntry == NULL )
+            {
+                /* Only to sleep for a new earliest deadline, which is read below. */
+                (void)read( pReactor->wakeFd, &wakeCount, sizeof( wakeCount ) );
+                continue;
+            }
+
+            OS_MutexLock( &( pReactor->lock ) );
+            handle = false;
+            if( pEntry->pContext == NULL )
+            {
+                /* Removed. */
+            }
+            else if( pEntry->busy )
+            {
+                /* Disarmed by EPOLLONESHOT, the worker handling it reads again. */
+                pEntry->readPending = true;
+            }
+            else
+            {
+                pEntry->busy = true;
+                handle = true;
+            }
+            OS_MutexUnlock( &( pReactor->lock ) );
+
+            if( handle )
+            {
+                reactor_Handle( pReactor, pEntry, true );
+            }
+        }
+
+        reactor_RunDue( pReactor );
+    }
+    LogDebug( ( "Reactor worker stopped." ) );
+}
+
+/*-----------------------------------------------------------*/
+
+RTIOStatus_t RTIOReactor_Start( RTIOReactor_t* pReactor,
+                                RTIOReactorEntry_t* pEntries, uint16_t size,
+                                OSThreadHandle_t* pWorkers, uint16_t workerNum )
+{
+    struct epoll_event event;
+    uint16_t i = 0;
+
+    if( ( pReactor == NULL ) || ( pEntries == NULL ) || ( size == 0U ) ||
+        ( pWorkers == NULL ) || ( workerNum == 0U ) )
+    {
+        LogError( ( "Argument cannot be NULL or 0: pReactor=%p, pEntries=%p, size=%u, pWorkers=%p, workerNum=%u.",
+                    (void*)pReactor, (void*)pEntries, size, (void*)pWorkers, workerNum ) );
+        return RTIOBadParameter;
+    }
+
+    memset( pReactor, 0, sizeof( RTIOReactor_t ) );
+    memset( pEntries, 0, sizeof( RTIOReactorEntry_t ) * size );
+    pReactor->pEntries = pEntries;
+    pReactor->size = size;
+    pReactor->pWorkers = pWorkers;
+    pReactor->workerNum = workerNum;
+    pReactor->earliestMs = OS_ClockGetTimeMs() + RTIO_REACTOR_WAIT_MAX_MS;
+    pReactor->done = false;
+
+    pReactor->epollFd = epoll_create1( EPOLL_CLOEXEC );
+    pReactor->wakeFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if( ( pReactor->epollFd < 0 ) || ( pReactor->wakeFd < 0 ) )
+    {
+        LogError( ( "Failed to create epoll or eventfd, errno=%d.", errno ) );
+        return RTIOUnknown;
+    }
+    memset( &event, 0, sizeof( event ) );
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if( epoll_ctl( pReactor->epollFd, EPOLL_CTL_ADD, pReactor->wakeFd, &event ) != 0 )
+    {
+        LogError( ( "Failed to watch eventfd, errno=%d.", errno ) );
+        return RTIOUnknown;
+    }
+    if( OS_MutexCreate( &( pReactor->lock ) ) != OSSuccess )
+    {
+        LogError( ( "Failed to create reactor lock." ) );
+        return RTIOMutexFailure;
+    }
+
+    for( i = 0; i < workerNum; i++ )
+    {
+        if( OS_ThreadCreate( &( pWorkers[ i ] ), reactor_Worker, (void*)pReactor,
+                             "ReactorWorker", RTIO_REACTOR_WORKER_STACK_SIZE ) != OSSuccess )
+        {
+            LogError( ( "Failed to create reactor worker %u.", i ) );
+            pReactor->workerNum = i;
+            (void)RTIOReactor_Stop( pReactor );
+            return RTIOThreadCreateFailed;
+        }
+    }
+    LogInfo( ( "Reactor started, workers=%u, entries=%u.", workerNum, size ) );
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIOReactor_Add( RTIOReactor_t* pReactor, RTIOContext_t* pContext )
+{
+    RTIOReactorEntry_t* pEntry = NULL;
+    RTIOStatus_t status = RTIOSuccess;
+    uint16_t i = 0;
+
+    if( ( pReactor == NULL ) || ( pContext == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pReactor=%p, pContext=%p.", (void*)pReactor, (void*)pContext ) );
+        return RTIOBadParameter;
+    }
+
+    OS_MutexLock( &( pReactor->lock ) );
+    for( i = 0; i < pReactor->size; i++ )
+    {
+        if( pReactor->pEntries[ i ].pContext == NULL )
+        {
+            pEntry = &( pReactor->pEntries[ i ] );
+            break;
+        }
+    }
+    if( pEntry != NULL )
+    {
+        memset( pEntry, 0, sizeof( RTIOReactorEntry_t ) );
+        pEntry->pReactor = pReactor;
+        pEntry->pContext = pContext;
+        pEntry->descriptor = -1;
+        pEntry->busy = true; /* Set up below before a worker sees it. */
+        if( i >= pReactor->entryEnd )
+        {
+            pReactor->entryEnd = (uint16_t)( i + 1U );
+        }
+    }
+    OS_MutexUnlock( &( pReactor->lock ) );
+
+    if( pEntry == NULL )
+    {
+        LogError( ( "Reactor is full, size=%u.", pReactor->size ) );
+        return RTIOListFull;
+    }
+
+    status = RTIO_ServeEventDriven( pContext, reactor_Wakeup, (void*)pEntry );
+    if( status != RTIOSuccess )
+    {
+        OS_MutexLock( &( pReactor->lock ) );
+        pEntry->pContext = NULL;
+        pEntry->busy = false;
+        OS_MutexUnlock( &( pReactor->lock ) );
+        return status;
+    }
+
+    /* Watches the descriptor and takes the first deadline. */
+    reactor_Handle( pReactor, pEntry, false );
+    reactor_WakeWorkers( pReactor );
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIOReactor_Remove( RTIOReactor_t* pReactor, RTIOContext_t* pContext )
+{
+    RTIOReactorEntry_t* pEntry = NULL;
+    uint16_t i = 0;
+    bool removed = false;
+
+    if( ( pReactor == NULL ) || ( pContext == NULL ) )
+    {
+        LogError( ( "Argument cannot be NULL: pReactor=%p, pContext=%p.", (void*)pReactor, (void*)pContext ) );
+        return RTIOBadParameter;
+    }
+
+    while( !removed )
+    {
+        pEntry = NULL;
+        OS_MutexLock( &( pReactor->lock ) );
+        for( i = 0; i < pReactor->entryEnd; i++ )
+        {
+            if( pReactor->pEntries[ i ].pContext == pContext )
+            {
+                pEntry = &( pReactor->pEntries[ i ] );
+                break;
+            }
+        }
+        if( ( pEntry != NULL ) && !pEntry->busy )
+        {
+            if( pEntry->descriptor >= 0 )
+            {
+                (void)epoll_ctl( pReactor->epollFd, EPOLL_CTL_DEL, pEntry->descriptor, NULL );
+            }
+            pEntry->pContext = NULL;
+            removed = true;
+        }
+        OS_MutexUnlock( &( pReactor->lock ) );
+
+        if( pEntry == NULL )
+        {
+            LogError( ( "Context is not served by the reactor, pContext=%p.", (void*)pContext ) );
+            return RTIONotFound;
+        }
+        if( !removed )
+        {
+            OS_ClockSleepMs( 1U );
+        }
+    }
+    return RTIOSuccess;
+}
+
+RTIOStatus_t RTIOReactor_Stop( RTIOReactor_t* pReactor )
+{
+    uint16_t i = 0;
+
+    if( pReactor == NULL )
+    {
+        LogError( ( "Argument cannot be NULL: pReactor=%p.", (void*)pReactor ) );
+        return RTIOBadParameter;
+    }
+
+    /* The eventfd is not drained once done, every worker wakes up. */
+    pReactor->done = true;
+    reactor_WakeWorkers( pReactor );
+    for( i = 0; i < pReactor->workerNum; i++ )
+    {
+        (void)pthread_join( pReactor->pWorkers[ i ].threadId, NULL );
+    }
+
+    (void)close( pReactor->wakeFd );
+    (void)close( pReactor->epollFd );
+    (void)OS_MutexDestroy( &( pReactor->lock ) );
+    LogInfo( ( "Reactor stopped." ) );
+    return RTIOSuccess;
+}
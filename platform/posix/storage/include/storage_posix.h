@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+#ifndef STORAGE_POSIX_H_
+#define STORAGE_POSIX_H_
+
+/**************************************************/
+/******* DO NOT CHANGE the following order ********/
+/**************************************************/
+
+/* Include header that defines log levels. */
+#include "logging_levels.h"
+
+/* Logging configuration for the storage implementation which uses mmap. */
+#ifndef LIBRARY_LOG_NAME
+    #define LIBRARY_LOG_NAME     "Storage_POSIX"
+#endif
+#ifndef LIBRARY_LOG_LEVEL
+    #define LIBRARY_LOG_LEVEL    LOG_INFO
+#endif
+
+#include "logging_stack.h"
+
+/************ End of logging configuration ****************/
+
+#include "storage_interface.h"
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/*
+ * Storage of the journal in segment files "<pPathPrefix>.<segment>", each mapped with
+ * MAP_SHARED. Writes land in the page cache and survive a crash of the process, a sync
+ * (msync) makes them survive a power loss too. New files are created erased with 0xFF.
+ */
+
+#ifndef STORAGE_POSIX_SEGMENT_NUM_MAX
+    #define STORAGE_POSIX_SEGMENT_NUM_MAX    ( 16U )
+#endif
+
+#ifndef STORAGE_POSIX_PATH_LENGTH_MAX
+    #define STORAGE_POSIX_PATH_LENGTH_MAX    ( 256U )
+#endif
+
+#define STORAGE_POSIX_ERASED_VALUE    ( 0xFFU )
+
+struct StorageContext
+{
+    int32_t fds[ STORAGE_POSIX_SEGMENT_NUM_MAX ];
+    uint8_t * pSegments[ STORAGE_POSIX_SEGMENT_NUM_MAX ]; /* Mappings of the files. */
+    uint32_t segmentSize;
+    uint16_t segmentNum;
+};
+
+/* Opens or creates the segment files and fills pInterface to use them. */
+StorageStatus_t StoragePosix_Open( StorageContext_t * pStorageContext,
+                                   StorageInterface_t * pInterface,
+                                   const char * pPathPrefix,
+                                   uint32_t segmentSize,
+                                   uint16_t segmentNum );
+
+/* Syncs and unmaps the segment files. */
+StorageStatus_t StoragePosix_Close( StorageContext_t * pStorageContext );
+
+StorageStatus_t StoragePosix_Read( StorageContext_t * pStorageContext,
+                                   uint16_t segment,
+                                   uint32_t offset,
+                                   void * pBuffer,
+                                   size_t bytesToRead );
+
+StorageStatus_t StoragePosix_Write( StorageContext_t * pStorageContext,
+                                    uint16_t segment,
+                                    uint32_t offset,
+                                    const void * pBuffer,
+                                    size_t bytesToWrite );
+
+StorageStatus_t StoragePosix_Sync( StorageContext_t * pStorageContext,
+                                   uint16_t segment );
+
+StorageStatus_t StoragePosix_Erase( StorageContext_t * pStorageContext,
+                                    uint16_t segment );
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* ifndef STORAGE_POSIX_H_ */
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024-2025 mkrainbow.com.
+ *
+ * Licensed under MIT.
+ * See the LICENSE for detail or copy at https://opensource.org/license/MIT.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "storage_posix.h"
+
+/*-----------------------------------------------------------*/
+
+static bool storagePosix_InRange( const StorageContext_t * pStorageContext,
+                                  uint16_t segment,
+                                  uint32_t offset,
+                                  size_t length )
+{
+    return ( pStorageContext != NULL ) &&
+           ( segment < pStorageContext->segmentNum ) &&
+           ( pStorageContext->pSegments[ segment ] != NULL ) &&
+           ( offset <= pStorageContext->segmentSize ) &&
+           ( length <= (size_t)( pStorageContext->segmentSize - offset ) );
+}
+
+static StorageStatus_t storagePosix_OpenSegment( StorageContext_t * pStorageContext,
+                                                 const char * pPathPrefix,
+                                                 uint16_t segment )
+{
+    char path[ STORAGE_POSIX_PATH_LENGTH_MAX ];
+    struct stat fileStat;
+    void * pMapped = NULL;
+    int fd = -1;
+    bool created = false;
+
+    if( snprintf( path, sizeof( path ), "%s.%u", pPathPrefix, (unsigned)segment ) >= (int)sizeof( path ) )
+    {
+        LogError( ( "Path too long, pPathPrefix=%s.", pPathPrefix ) );
+        return StorageInvalidParameter;
+    }
+
+    fd = open( path, O_RDWR | O_CREAT, 0600 );
+    if( ( fd < 0 ) || ( fstat( fd, &fileStat ) != 0 ) )
+    {
+        LogError( ( "Failed to open %s, errno=%d.", path, errno ) );
+        if( fd >= 0 )
+        {
+            (void)close( fd );
+        }
+        return StorageReadFailure;
+    }
+
+    /* A file of another size was written with another layout, it is started over. */
+    if( fileStat.st_size != (off_t)pStorageContext->segmentSize )
+    {
+        LogInfo( ( "Create segment %s, size=%u.", path, (unsigned)pStorageContext->segmentSize ) );
+        created = true;
+        if( ( ftruncate( fd, 0 ) != 0 ) || ( ftruncate( fd, (off_t)pStorageContext->segmentSize ) != 0 ) )
+        {
+            LogError( ( "Failed to size %s, errno=%d.", path, errno ) );
+            (void)close( fd );
+            return StorageWriteFailure;
+        }
+    }
+
+    pMapped = mmap( NULL, pStorageContext->segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( pMapped == MAP_FAILED )
+    {
+        LogError( ( "Failed to mmap %s, errno=%d.", path, errno ) );
+        (void)close( fd );
+        return StorageReadFailure;
+    }
+
+    pStorageContext->fds[ segment ] = fd;
+    pStorageContext->pSegments[ segment ] = (uint8_t *)pMapped;
+
+    if( created )
+    {
+        return StoragePosix_Erase( pStorageContext, segment );
+    }
+    return StorageSuccess;
+}
+
+/*-----------------------------------------------------------*/
+
+StorageStatus_t StoragePosix_Open( StorageContext_t * pStorageContext,
+                                   StorageInterface_t * pInterface,
+                                   const char * pPathPrefix,
+                                   uint32_t segmentSize,
+                                   uint16_t segmentNum )
+{
+    StorageStatus_t status = StorageSuccess;
+    uint16_t i = 0;
+
+    if( ( pStorageContext == NULL ) || ( pInterface == NULL ) || ( pPathPrefix == NULL ) ||
+        ( segmentSize == 0U ) || ( segmentNum == 0U ) || ( segmentNum > STORAGE_POSIX_SEGMENT_NUM_MAX ) )
+    {
+        LogError( ( "Invalid parameter: pStorageContext=%p, pInterface=%p, pPathPrefix=%p, "
+                    "segmentSize=%u, segmentNum=%u.",
+                    (void *)pStorageContext, (void *)pInterface, (const void *)pPathPrefix,
+                    (unsigned)segmentSize, (unsigned)segmentNum ) );
+        return StorageInvalidParameter;
+    }
+
+    memset( pStorageContext, 0, sizeof( StorageContext_t ) );
+    pStorageContext->segmentSize = segmentSize;
+    pStorageContext->segmentNum = segmentNum;
+    for( i = 0; i < STORAGE_POSIX_SEGMENT_NUM_MAX; i++ )
+    {
+        pStorageContext->fds[ i ] = -1;
+    }
+
+    for( i = 0; ( status == StorageSuccess ) && ( i < segmentNum ); i++ )
+    {
+        status = storagePosix_OpenSegment( pStorageContext, pPathPrefix, i );
+    }
+    if( status != StorageSuccess )
+    {
+        (void)StoragePosix_Close( pStorageContext );
+        return status;
+    }
+
+    pInterface->read = StoragePosix_Read;
+    pInterface->write = StoragePosix_Write;
+    pInterface->sync = StoragePosix_Sync;
+    pInterface->erase = StoragePosix_Erase;
+    pInterface->pStorageContext = pStorageContext;
+    pInterface->segmentSize = segmentSize;
+    pInterface->segmentNum = segmentNum;
+    pInterface->erasedValue = STORAGE_POSIX_ERASED_VALUE;
+    return StorageSuccess;
+}
+
+StorageStatus_t StoragePosix_Close( StorageContext_t * pStorageContext )
+{
+    StorageStatus_t status = StorageSuccess;
+    uint16_t i = 0;
+
+    if( pStorageContext == NULL )
+    {
+        LogError( ( "pStorageContext is NULL." ) );
+        return StorageInvalidParameter;
+    }
+
+    for( i = 0; i < pStorageContext->segmentNum; i++ )
+    {
+        if( pStorageContext->pSegments[ i ] != NULL )
+        {
+            if( msync( pStorageContext->pSegments[ i ], pStorageContext->segmentSize, MS_SYNC ) != 0 )
+            {
+                LogError( ( "Failed to msync segment=%u, errno=%d.", i, errno ) );
+                status = StorageSyncFailure;
+            }
+            (void)munmap( pStorageContext->pSegments[ i ], pStorageContext->segmentSize );
+            pStorageContext->pSegments[ i ] = NULL;
+        }
+        if( pStorageContext->fds[ i ] >= 0 )
+        {
+            (void)close( pStorageContext->fds[ i ] );
+            pStorageContext->fds[ i ] = -1;
+        }
+    }
+    return status;
+}
+
+StorageStatus_t StoragePosix_Read( StorageContext_t * pStorageContext,
+                                   uint16_t segment,
+                                   uint32_t offset,
+                                   void * pBuffer,
+                                   size_t bytesToRead )
+{
+    if( ( pBuffer == NULL ) || !storagePosix_InRange( pStorageContext, segment, offset, bytesToRead ) )
+    {
+        LogError( ( "Invalid read, segment=%u, offset=%u, bytesToRead=%lu.",
+                    segment, (unsigned)offset, (unsigned long)bytesToRead ) );
+        return StorageInvalidParameter;
+    }
+
+    memcpy( pBuffer, &( pStorageContext->pSegments[ segment ][ offset ] ), bytesToRead );
+    return StorageSuccess;
+}
+
+StorageStatus_t StoragePosix_Write( StorageContext_t * pStorageContext,
+                                    uint16_t segment,
+                                    uint32_t offset,
+                                    const void * pBuffer,
+                                    size_t bytesToWrite )
+{
+    if( ( pBuffer == NULL ) || !storagePosix_InRange( pStorageContext, segment, offset, bytesToWrite ) )
+    {
+        LogError( ( "Invalid write, segment=%u, offset=%u, bytesToWrite=%lu.",
+                    segment, (unsigned)offset, (unsigned long)bytesToWrite ) );
+        return StorageInvalidParameter;
+    }
+
+    memcpy( &( pStorageContext->pSegments[ segment ][ offset ] ), pBuffer, bytesToWrite );
+    return StorageSuccess;
+}
+
+StorageStatus_t StoragePosix_Sync( StorageContext_t * pStorageContext,
+                                   uint16_t segment )
+{
+    if( !storagePosix_InRange( pStorageContext, segment, 0, 0 ) )
+    {
+        LogError( ( "Invalid sync, segment=%u.", segment ) );
+        return StorageInvalidParameter;
+    }
+
+    /* Only the dirty pages of the mapping are written back. */
+    if( msync( pStorageContext->pSegments[ segment ], pStorageContext->segmentSize, MS_SYNC ) != 0 )
+    {
+        LogError( ( "Failed to msync segment=%u, errno=%d.", segment, errno ) );
+        return StorageSyncFailure;
+    }
+    return StorageSuccess;
+}
+
+StorageStatus_t StoragePosix_Erase( StorageContext_t * pStorageContext,
+                                    uint16_t segment )
+{
+    if( !storagePosix_InRange( pStorageContext, segment, 0, 0 ) )
+    {
+        LogError( ( "Invalid erase, segment=%u.", segment ) );
+        return StorageInvalidParameter;
+    }
+
+    memset( pStorageContext->pSegments[ segment ], STORAGE_POSIX_ERASED_VALUE, pStorageContext->segmentSize );
+    if( msync( pStorageContext->pSegments[ segment ], pStorageContext->segmentSize, MS_SYNC ) != 0 )
+    {
+        LogError( ( "Failed to msync erased segment=%u, errno=%d.", segment, errno ) );
+        return StorageEraseFailure;
+    }
+    return StorageSuccess;
+}
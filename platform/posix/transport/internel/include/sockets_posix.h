@@ -19,6 +19,13 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+/*
+ * Modifications:
+ * - Connect to the resolved addresses without blocking, racing them as RFC 8305 describes,
+ *   with a timeout for each attempt.
+ * Author: mkrainbow.com
+ * Date of Modification: 2026-10-17
+ */
 
 #ifndef SOCKETS_POSIX_H_
 #define SOCKETS_POSIX_H_
@@ -54,6 +61,29 @@
 #endif
 /* *INDENT-ON* */
 
+/**
+ * @brief Default timeout of each connection attempt, used when
+ * ServerInfo_t.connectTimeoutMs is 0.
+ */
+#ifndef SOCKETS_CONNECT_TIMEOUT_MS
+    #define SOCKETS_CONNECT_TIMEOUT_MS          ( 5000U )
+#endif
+
+/**
+ * @brief Delay before racing a connection to the next resolved address while
+ * the previous attempts are still pending, 250 ms as RFC 8305 recommends.
+ */
+#ifndef SOCKETS_CONNECT_ATTEMPT_DELAY_MS
+    #define SOCKETS_CONNECT_ATTEMPT_DELAY_MS    ( 250U )
+#endif
+
+/**
+ * @brief Maximum number of resolved addresses tried per connection.
+ */
+#ifndef SOCKETS_CONNECT_ADDRESS_NUM_MAX
+    #define SOCKETS_CONNECT_ADDRESS_NUM_MAX     ( 8U )
+#endif
+
 /**
  * @brief TCP Connect / Disconnect return status.
  */
@@ -72,9 +102,10 @@ typedef enum SocketStatus
  */
 typedef struct ServerInfo
 {
-    const char * pHostName; /**< @brief Server host name. */
-    size_t hostNameLength;  /**< @brief Length of the server host name. */
-    uint16_t port;          /**< @brief Server port in host-order. */
+    const char * pHostName;    /**< @brief Server host name. */
+    size_t hostNameLength;     /**< @brief Length of the server host name. */
+    uint16_t port;             /**< @brief Server port in host-order. */
+    uint32_t connectTimeoutMs; /**< @brief Timeout of each connection attempt, 0 for #SOCKETS_CONNECT_TIMEOUT_MS. */
 } ServerInfo_t;
 
 /**
@@ -87,6 +118,10 @@ typedef struct ServerInfo
  *
  * @note A timeout of 0 means infinite timeout.
  *
+ * @note The resolved addresses are tried with non-blocking connects, alternating
+ * IPv6 and IPv4, a new one every #SOCKETS_CONNECT_ATTEMPT_DELAY_MS until the
+ * first connection is established (RFC 8305).
+ *
  * @return #SOCKETS_SUCCESS if successful;
  * #SOCKETS_INVALID_PARAMETER, #SOCKETS_DNS_FAILURE, #SOCKETS_CONNECT_FAILURE on error.
  */
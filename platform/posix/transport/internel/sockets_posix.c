@@ -19,14 +19,24 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+/*
+ * Modifications:
+ * - Connect to the resolved addresses without blocking, racing them as RFC 8305 describes,
+ *   with a timeout for each attempt.
+ * Author: mkrainbow.com
+ * Date of Modification: 2026-10-17
+ */
 
 /* Standard includes. */
 #include <assert.h>
+#include <stdbool.h>
 #include <string.h>
 
 /* POSIX sockets includes. */
 #include <errno.h>
+#include <fcntl.h>
 #include <netdb.h>
+#include <poll.h>
 #include <time.h>
 #include <unistd.h>
 #include <sys/time.h>
@@ -47,6 +57,11 @@
  */
 #define ONE_MS_TO_US     ( 1000 )
 
+/**
+ * @brief Number of nanoseconds in one millisecond.
+ */
+#define ONE_MS_TO_NS     ( 1000000 )
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -64,12 +79,29 @@ static SocketStatus_t resolveHostName( const char * pHostName,
                                        struct addrinfo ** pListHead );
 
 /**
- * @brief Traverse list of DNS records until a connection is established.
+ * @brief Order the DNS records to alternate address families, starting with
+ * the family of the first record, as RFC 8305 section 4 suggests.
+ *
+ * @param[in] pListHead List containing resolved DNS records.
+ * @param[out] pAddresses The ordered records, at most #SOCKETS_CONNECT_ADDRESS_NUM_MAX.
+ *
+ * @return The number of ordered records.
+ */
+static size_t sortAddresses( struct addrinfo * pListHead,
+                             struct addrinfo ** pAddresses );
+
+/**
+ * @brief Race connections to the DNS records until one is established.
+ *
+ * A new attempt starts every #SOCKETS_CONNECT_ATTEMPT_DELAY_MS, or as soon
+ * as the previous one failed, while the earlier ones are still pending. Each
+ * attempt is given up after connectTimeoutMs.
  *
  * @param[in] pListHead List containing resolved DNS records.
  * @param[in] pHostName Server host name.
  * @param[in] hostNameLength Length associated with host name.
  * @param[in] port Server port in host-order.
+ * @param[in] connectTimeoutMs Timeout of each connection attempt.
  * @param[out] pTcpSocket The output parameter to return the created socket.
  *
  * @return #SOCKETS_SUCCESS if successful; #SOCKETS_CONNECT_FAILURE on error.
@@ -78,20 +110,32 @@ static SocketStatus_t attemptConnection( struct addrinfo * pListHead,
                                          const char * pHostName,
                                          size_t hostNameLength,
                                          uint16_t port,
+                                         uint32_t connectTimeoutMs,
                                          int32_t * pTcpSocket );
 
 /**
- * @brief Connect to server using the provided address record.
+ * @brief Start a non-blocking connection to the provided address record.
  *
  * @param[in, out] pAddrInfo Address record of the server.
  * @param[in] port Server port in host-order.
- * @param[in] pTcpSocket Socket handle.
+ * @param[out] pTcpSocket The created socket, -1 on error.
+ * @param[out] pInProgress Whether the connection is still being established.
  *
  * @return #SOCKETS_SUCCESS if successful; #SOCKETS_CONNECT_FAILURE on error.
  */
-static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
+static SocketStatus_t connectToAddress( const struct addrinfo * pAddrInfo,
                                         uint16_t port,
-                                        int32_t tcpSocket );
+                                        int32_t * pTcpSocket,
+                                        bool * pInProgress );
+
+/**
+ * @brief Check the result of a connection and put the socket back to blocking mode.
+ *
+ * @param[in] tcpSocket Socket handle.
+ *
+ * @return #SOCKETS_SUCCESS if connected; #SOCKETS_CONNECT_FAILURE on error.
+ */
+static SocketStatus_t completeConnection( int32_t tcpSocket );
 
 /**
  * @brief Log possible error using errno and return appropriate status.
@@ -102,6 +146,23 @@ static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
  */
 static SocketStatus_t retrieveError( int32_t errorNumber );
 
+/**
+ * @brief Get the monotonic time in milliseconds.
+ *
+ * @return The time, it wraps around.
+ */
+static uint32_t getTimeMs( void );
+
+/*-----------------------------------------------------------*/
+
+static uint32_t getTimeMs( void )
+{
+    struct timespec now;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( uint32_t ) ( ( ( int64_t ) now.tv_sec * ONE_SEC_TO_MS ) + ( now.tv_nsec / ONE_MS_TO_NS ) );
+}
 /*-----------------------------------------------------------*/
 
 static SocketStatus_t resolveHostName( const char * pHostName,
@@ -143,12 +204,64 @@ static SocketStatus_t resolveHostName( const char * pHostName,
 }
 /*-----------------------------------------------------------*/
 
-static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
+static size_t sortAddresses( struct addrinfo * pListHead,
+                             struct addrinfo ** pAddresses )
+{
+    struct addrinfo * pFirst[ SOCKETS_CONNECT_ADDRESS_NUM_MAX ];
+    struct addrinfo * pOther[ SOCKETS_CONNECT_ADDRESS_NUM_MAX ];
+    struct addrinfo * pIndex = NULL;
+    size_t firstNum = 0, otherNum = 0, addressNum = 0, i = 0;
+
+    assert( pListHead != NULL );
+    assert( pAddresses != NULL );
+
+    /* getaddrinfo already sorts the records by preference (RFC 6724). */
+    for( pIndex = pListHead; pIndex != NULL; pIndex = pIndex->ai_next )
+    {
+        if( ( pIndex->ai_family != AF_INET ) && ( pIndex->ai_family != AF_INET6 ) )
+        {
+            continue;
+        }
+
+        if( ( pIndex->ai_family == pListHead->ai_family ) && ( firstNum < SOCKETS_CONNECT_ADDRESS_NUM_MAX ) )
+        {
+            pFirst[ firstNum++ ] = pIndex;
+        }
+        else if( ( pIndex->ai_family != pListHead->ai_family ) && ( otherNum < SOCKETS_CONNECT_ADDRESS_NUM_MAX ) )
+        {
+            pOther[ otherNum++ ] = pIndex;
+        }
+        else
+        {
+            /* Empty else. */
+        }
+    }
+
+    for( i = 0; ( i < SOCKETS_CONNECT_ADDRESS_NUM_MAX ) && ( addressNum < SOCKETS_CONNECT_ADDRESS_NUM_MAX ); i++ )
+    {
+        if( i < firstNum )
+        {
+            pAddresses[ addressNum++ ] = pFirst[ i ];
+        }
+
+        if( ( i < otherNum ) && ( addressNum < SOCKETS_CONNECT_ADDRESS_NUM_MAX ) )
+        {
+            pAddresses[ addressNum++ ] = pOther[ i ];
+        }
+    }
+
+    return addressNum;
+}
+/*-----------------------------------------------------------*/
+
+static SocketStatus_t connectToAddress( const struct addrinfo * pAddrInfo,
                                         uint16_t port,
-                                        int32_t tcpSocket )
+                                        int32_t * pTcpSocket,
+                                        bool * pInProgress )
 {
     SocketStatus_t returnStatus = SOCKETS_SUCCESS;
     int32_t connectStatus = 0;
+    int32_t socketFlags = 0;
     char resolvedIpAddr[ INET6_ADDRSTRLEN ];
     socklen_t addrInfoLength;
     uint16_t netPort = 0;
@@ -156,13 +269,16 @@ static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
     struct sockaddr_in6 * pIpv6Address;
 
     assert( pAddrInfo != NULL );
-    assert( pAddrInfo->sa_family == AF_INET || pAddrInfo->sa_family == AF_INET6 );
-    assert( tcpSocket >= 0 );
+    assert( pAddrInfo->ai_family == AF_INET || pAddrInfo->ai_family == AF_INET6 );
+    assert( pTcpSocket != NULL );
+    assert( pInProgress != NULL );
+
+    *pInProgress = false;
 
     /* Convert port from host byte order to network byte order. */
     netPort = htons( port );
 
-    if( pAddrInfo->sa_family == ( sa_family_t ) AF_INET )
+    if( pAddrInfo->ai_family == ( int32_t ) AF_INET )
     {
         /* MISRA Rule 11.3 flags the following line for casting a pointer of
          * a object type to a pointer of a different object type. This rule
@@ -170,11 +286,11 @@ static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
          * a struct sockaddr_in pointer is supported in POSIX and is used
          * to obtain the IP address from the address record. */
         /* coverity[misra_c_2012_rule_11_3_violation] */
-        pIpv4Address = ( struct sockaddr_in * ) pAddrInfo;
+        pIpv4Address = ( struct sockaddr_in * ) pAddrInfo->ai_addr;
         /* Store IPv4 in string to log. */
         pIpv4Address->sin_port = netPort;
         addrInfoLength = ( socklen_t ) sizeof( struct sockaddr_in );
-        ( void ) inet_ntop( ( int32_t ) pAddrInfo->sa_family,
+        ( void ) inet_ntop( pAddrInfo->ai_family,
                             &pIpv4Address->sin_addr,
                             resolvedIpAddr,
                             ( socklen_t ) sizeof( resolvedIpAddr ) );
@@ -187,11 +303,11 @@ static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
          * a struct sockaddr_in6 pointer is supported in POSIX and is used
          * to obtain the IPv6 address from the address record. */
         /* coverity[misra_c_2012_rule_11_3_violation] */
-        pIpv6Address = ( struct sockaddr_in6 * ) pAddrInfo;
+        pIpv6Address = ( struct sockaddr_in6 * ) pAddrInfo->ai_addr;
         /* Store IPv6 in string to log. */
         pIpv6Address->sin6_port = netPort;
         addrInfoLength = ( socklen_t ) sizeof( struct sockaddr_in6 );
-        ( void ) inet_ntop( ( int32_t ) pAddrInfo->sa_family,
+        ( void ) inet_ntop( pAddrInfo->ai_family,
                             &pIpv6Address->sin6_addr,
                             resolvedIpAddr,
                             ( socklen_t ) sizeof( resolvedIpAddr ) );
@@ -201,17 +317,84 @@ static SocketStatus_t connectToAddress( struct sockaddr * pAddrInfo,
                 " IP address=%s.",
                 resolvedIpAddr ) );
 
-    /* Attempt to connect. */
-    connectStatus = connect( tcpSocket, pAddrInfo, addrInfoLength );
+    *pTcpSocket = socket( pAddrInfo->ai_family,
+                          pAddrInfo->ai_socktype,
+                          pAddrInfo->ai_protocol );
+
+    if( *pTcpSocket == -1 )
+    {
+        returnStatus = SOCKETS_CONNECT_FAILURE;
+    }
+
+    /* Connect without blocking, the caller waits for the attempt with the others. */
+    if( returnStatus == SOCKETS_SUCCESS )
+    {
+        socketFlags = fcntl( *pTcpSocket, F_GETFL, 0 );
 
-    if( connectStatus == -1 )
+        if( ( socketFlags == -1 ) || ( fcntl( *pTcpSocket, F_SETFL, socketFlags | O_NONBLOCK ) == -1 ) )
+        {
+            returnStatus = SOCKETS_CONNECT_FAILURE;
+        }
+    }
+
+    if( returnStatus == SOCKETS_SUCCESS )
+    {
+        connectStatus = connect( *pTcpSocket, pAddrInfo->ai_addr, addrInfoLength );
+
+        if( connectStatus == 0 )
+        {
+            returnStatus = completeConnection( *pTcpSocket );
+        }
+        else if( errno == EINPROGRESS )
+        {
+            *pInProgress = true;
+        }
+        else
+        {
+            returnStatus = SOCKETS_CONNECT_FAILURE;
+        }
+    }
+
+    if( returnStatus != SOCKETS_SUCCESS )
     {
         LogWarn( ( "Failed to connect to server using the resolved IP address: IP address=%s.",
                    resolvedIpAddr ) );
-        ( void ) close( tcpSocket );
+
+        if( *pTcpSocket != -1 )
+        {
+            ( void ) close( *pTcpSocket );
+            *pTcpSocket = -1;
+        }
+    }
+
+    return returnStatus;
+}
+/*-----------------------------------------------------------*/
+
+static SocketStatus_t completeConnection( int32_t tcpSocket )
+{
+    SocketStatus_t returnStatus = SOCKETS_SUCCESS;
+    int32_t socketError = 0;
+    int32_t socketFlags = 0;
+    socklen_t errorLength = ( socklen_t ) sizeof( socketError );
+
+    if( ( getsockopt( tcpSocket, SOL_SOCKET, SO_ERROR, &socketError, &errorLength ) == -1 ) ||
+        ( socketError != 0 ) )
+    {
         returnStatus = SOCKETS_CONNECT_FAILURE;
     }
 
+    /* Send and receive rely on blocking mode with socket timeouts. */
+    if( returnStatus == SOCKETS_SUCCESS )
+    {
+        socketFlags = fcntl( tcpSocket, F_GETFL, 0 );
+
+        if( ( socketFlags == -1 ) || ( fcntl( tcpSocket, F_SETFL, socketFlags & ~O_NONBLOCK ) == -1 ) )
+        {
+            returnStatus = SOCKETS_CONNECT_FAILURE;
+        }
+    }
+
     return returnStatus;
 }
 /*-----------------------------------------------------------*/
@@ -220,10 +403,18 @@ static SocketStatus_t attemptConnection( struct addrinfo * pListHead,
                                          const char * pHostName,
                                          size_t hostNameLength,
                                          uint16_t port,
+                                         uint32_t connectTimeoutMs,
                                          int32_t * pTcpSocket )
 {
     SocketStatus_t returnStatus = SOCKETS_CONNECT_FAILURE;
-    const struct addrinfo * pIndex = NULL;
+    struct addrinfo * pAddresses[ SOCKETS_CONNECT_ADDRESS_NUM_MAX ];
+    struct pollfd pollFds[ SOCKETS_CONNECT_ADDRESS_NUM_MAX ];
+    uint32_t deadlines[ SOCKETS_CONNECT_ADDRESS_NUM_MAX ];
+    size_t addressNum = 0, nextAddress = 0, pendingNum = 0, i = 0;
+    uint32_t nowMs = 0, nextStartMs = 0, waitMs = 0;
+    int32_t tcpSocket = -1;
+    bool inProgress = false;
+    bool finished = false;
 
     assert( pListHead != NULL );
     assert( pHostName != NULL );
@@ -238,30 +429,116 @@ static SocketStatus_t attemptConnection( struct addrinfo * pListHead,
                 ( int32_t ) hostNameLength,
                 pHostName ) );
 
-    /* Attempt to connect to one of the retrieved DNS records. */
-    for( pIndex = pListHead; pIndex != NULL; pIndex = pIndex->ai_next )
+    *pTcpSocket = -1;
+    addressNum = sortAddresses( pListHead, pAddresses );
+    nextStartMs = getTimeMs();
+
+    while( ( *pTcpSocket == -1 ) && ( ( nextAddress < addressNum ) || ( pendingNum > 0U ) ) )
     {
-        *pTcpSocket = socket( pIndex->ai_family,
-                              pIndex->ai_socktype,
-                              pIndex->ai_protocol );
+        nowMs = getTimeMs();
 
-        if( *pTcpSocket == -1 )
+        /* Start the next attempt once the delay passed, or at once when none is pending. */
+        if( ( nextAddress < addressNum ) &&
+            ( ( pendingNum == 0U ) || ( ( int32_t ) ( nowMs - nextStartMs ) >= 0 ) ) )
         {
+            if( connectToAddress( pAddresses[ nextAddress ], port, &tcpSocket, &inProgress ) != SOCKETS_SUCCESS )
+            {
+                nextStartMs = nowMs;
+            }
+            else if( inProgress )
+            {
+                pollFds[ pendingNum ].fd = tcpSocket;
+                pollFds[ pendingNum ].events = POLLOUT;
+                pollFds[ pendingNum ].revents = 0;
+                deadlines[ pendingNum ] = nowMs + connectTimeoutMs;
+                pendingNum++;
+                nextStartMs = nowMs + SOCKETS_CONNECT_ATTEMPT_DELAY_MS;
+            }
+            else
+            {
+                *pTcpSocket = tcpSocket;
+            }
+
+            nextAddress++;
             continue;
         }
 
-        /* Attempt to connect to a resolved DNS address of the host. */
-        returnStatus = connectToAddress( pIndex->ai_addr, port, *pTcpSocket );
+        /* Wait for an attempt to complete, its deadline or the start of the next one. */
+        waitMs = ( nextAddress < addressNum ) ? ( nextStartMs - nowMs ) : connectTimeoutMs;
+
+        for( i = 0; i < pendingNum; i++ )
+        {
+            if( ( int32_t ) ( deadlines[ i ] - nowMs ) <= 0 )
+            {
+                waitMs = 0;
+            }
+            else if( ( deadlines[ i ] - nowMs ) < waitMs )
+            {
+                waitMs = deadlines[ i ] - nowMs;
+            }
+            else
+            {
+                /* Empty else. */
+            }
+        }
 
-        /* If connected to an IP address successfully, exit from the loop. */
-        if( returnStatus == SOCKETS_SUCCESS )
+        if( ( poll( pollFds, ( nfds_t ) pendingNum, ( int ) waitMs ) < 0 ) && ( errno != EINTR ) )
         {
+            ( void ) retrieveError( errno );
             break;
         }
+
+        nowMs = getTimeMs();
+
+        for( i = 0; i < pendingNum; )
+        {
+            finished = true;
+
+            if( pollFds[ i ].revents != 0 )
+            {
+                if( ( *pTcpSocket == -1 ) && ( completeConnection( pollFds[ i ].fd ) == SOCKETS_SUCCESS ) )
+                {
+                    *pTcpSocket = pollFds[ i ].fd;
+                }
+                else
+                {
+                    ( void ) close( pollFds[ i ].fd );
+                    nextStartMs = nowMs;
+                }
+            }
+            else if( ( int32_t ) ( deadlines[ i ] - nowMs ) <= 0 )
+            {
+                LogWarn( ( "Connection attempt timed out: Timeout=%u ms.", ( unsigned ) connectTimeoutMs ) );
+                ( void ) close( pollFds[ i ].fd );
+                nextStartMs = nowMs;
+            }
+            else
+            {
+                finished = false;
+            }
+
+            if( finished )
+            {
+                pendingNum--;
+                pollFds[ i ] = pollFds[ pendingNum ];
+                deadlines[ i ] = deadlines[ pendingNum ];
+            }
+            else
+            {
+                i++;
+            }
+        }
     }
 
-    if( returnStatus == SOCKETS_SUCCESS )
+    /* Close the attempts that lost the race. */
+    for( i = 0; i < pendingNum; i++ )
+    {
+        ( void ) close( pollFds[ i ].fd );
+    }
+
+    if( *pTcpSocket != -1 )
     {
+        returnStatus = SOCKETS_SUCCESS;
         LogDebug( ( "Established TCP connection: Server=%.*s.",
                     ( int32_t ) hostNameLength,
                     pHostName ) );
@@ -350,6 +627,8 @@ SocketStatus_t Sockets_Connect( int32_t * pTcpSocket,
                                           pServerInfo->pHostName,
                                           pServerInfo->hostNameLength,
                                           pServerInfo->port,
+                                          ( pServerInfo->connectTimeoutMs > 0U ) ?
+                                          pServerInfo->connectTimeoutMs : SOCKETS_CONNECT_TIMEOUT_MS,
                                           pTcpSocket );
     }
 
@@ -22,8 +22,9 @@
 /*
  * Modifications:
  * - Modify the returned Status and other elements to adapt to the RTIO transmission interface.
+ * - Keep the SSL_CTX and the last TLS session across reconnects to resume sessions.
  * Author: mkrainbow.com
- * Date of Modification: 2024-12-24
+ * Date of Modification: 2024-12-24, 2026-10-17
  */
 #ifndef OPENSSL_POSIX_H_
 #define OPENSSL_POSIX_H_
@@ -74,12 +75,17 @@
  * implementation that uses OpenSSL and POSIX sockets.
  *
  * @note For this transport implementation, the socket descriptor and
- * SSL context is used.
+ * SSL context is used. The SSL_CTX and the last TLS session are kept across
+ * reconnects, so reconnecting skips parsing the credentials and resumes the
+ * session with an abbreviated handshake; Openssl_FreeCache frees them.
  */
 typedef struct OpensslParams
 {
     int32_t socketDescriptor;
     SSL * pSsl;
+    SSL_CTX * pSslContext;                          /**< @brief Built from pCredentials on the first connect. */
+    const struct OpensslCredentials * pCredentials; /**< @brief Credentials pSslContext was built from. */
+    SSL_SESSION * pSession;                         /**< @brief Last session the server offered, NULL if none. */
 } OpensslParams_t;
 
 struct NetworkContext
@@ -176,6 +182,19 @@ TransportStatus_t Openssl_ConnectWithOption( NetworkContext_t * pNetworkContext,
  */
 TransportStatus_t Openssl_Disconnect( NetworkContext_t * pNetworkContext );
 
+/**
+ * @brief Frees the SSL context and the TLS session kept across reconnects.
+ *
+ * The next connect parses the credentials again and performs a full handshake,
+ * call it after the credential files changed or when the parameters are no
+ * longer used.
+ *
+ * @param[in] pNetworkContext The network context, disconnected.
+ *
+ * @return #TransportSuccess on success; #TransportInvalidParameter on failure.
+ */
+TransportStatus_t Openssl_FreeCache( NetworkContext_t * pNetworkContext );
+
 /**
  * @brief Receives data over an established TLS session using the OpenSSL API.
  *
@@ -212,6 +231,59 @@ int32_t Openssl_Send( NetworkContext_t * pNetworkContext,
                       const void * pBuffer,
                       size_t bytesToSend );
 
+/**
+ * @brief Size of the buffer Openssl_Sendv gathers small segments into,
+ * so they go out in one TLS record instead of one record per segment.
+ */
+#ifndef OPENSSL_SENDV_COALESCE_SIZE
+    #define OPENSSL_SENDV_COALESCE_SIZE    ( 512U )
+#endif
+
+/**
+ * @brief Sends segments over an established TLS session using the OpenSSL API.
+ *
+ * This can be used as the #TransportInterface.sendv function. Segments that
+ * fit in OPENSSL_SENDV_COALESCE_SIZE are copied together and written with one
+ * SSL_write, larger ones are written as they are.
+ *
+ * @param[in] pNetworkContext The network context created using Openssl_Connect API.
+ * @param[in] pIoVec Segments to send, in order.
+ * @param[in] ioVecCount Number of segments.
+ *
+ * @return Number of bytes sent if successful; negative value on error.
+ */
+int32_t Openssl_Sendv( NetworkContext_t * pNetworkContext,
+                       const TransportIoVector_t * pIoVec,
+                       size_t ioVecCount );
+
+/**
+ * @brief Waits until Openssl_Recv has data to return or the timeout elapses.
+ *
+ * This can be used as the #TransportInterface.waitReadable function. Data
+ * already decrypted by OpenSSL is reported at once, otherwise the socket is
+ * polled with the timeout.
+ *
+ * @param[in] pNetworkContext The network context created using Openssl_Connect API.
+ * @param[in] timeoutMs The longest time to wait, in milliseconds.
+ *
+ * @return Positive value if readable; zero on timeout; negative value on error.
+ */
+int32_t Openssl_WaitReadable( NetworkContext_t * pNetworkContext,
+                              uint32_t timeoutMs );
+
+/**
+ * @brief Gets the socket descriptor for an event loop to watch.
+ *
+ * This can be used as the #TransportInterface.getDescriptor function. Data
+ * already decrypted by OpenSSL is not seen by the descriptor, the event loop
+ * reads until Openssl_WaitReadable reports nothing left.
+ *
+ * @param[in] pNetworkContext The network context created using Openssl_Connect API.
+ *
+ * @return The socket descriptor; -1 if the context is invalid.
+ */
+int32_t Openssl_GetDescriptor( NetworkContext_t * pNetworkContext );
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -23,12 +23,14 @@
 /*
  * Modifications:
  * - Modify the returned Status and other elements to adapt to the RTIO transmission interface.
+ * - Keep the SSL_CTX and the last TLS session across reconnects to resume sessions.
  * Author: mkrainbow.com
- * Date of Modification: 2024-12-24
+ * Date of Modification: 2024-12-24, 2026-10-17
  */
 
 /* Standard includes. */
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 
 /* POSIX socket includes. */
@@ -171,6 +173,37 @@ static TransportStatus_t tlsHandshake( const ServerInfo_t * pServerInfo,
  * @return 1 on success; 0 on failure.
  */
 static int32_t isValidNetworkContext( const NetworkContext_t * pNetworkContext );
+
+/**
+ * @brief Build the SSL context from the credentials, unless the one built
+ * on a previous connect from the same credentials can be reused.
+ *
+ * @param[in, out] pOpensslParams Parameters keeping the SSL context.
+ * @param[in] pOpensslCredentials TLS credentials to be imported.
+ *
+ * @return #TransportSuccess, #TransportInternalError, and #TransportCredentialsInvalid.
+ */
+static TransportStatus_t getSslContext( OpensslParams_t * pOpensslParams,
+                                        const OpensslCredentials_t * pOpensslCredentials );
+
+/**
+ * @brief Free the SSL context and the TLS session kept across reconnects.
+ *
+ * @param[in, out] pOpensslParams Parameters keeping them.
+ */
+static void freeCache( OpensslParams_t * pOpensslParams );
+
+/**
+ * @brief Keep a copy of a new session the server offered, TLS 1.2 session
+ * ID or TLS 1.3 ticket, to resume it on reconnect.
+ *
+ * @param[in] pSsl The connection the session was established on.
+ * @param[in] pSession The new session.
+ *
+ * @return 0, OpenSSL keeps the ownership of pSession.
+ */
+static int storeSession( SSL * pSsl,
+                         SSL_SESSION * pSession );
 /*-----------------------------------------------------------*/
 
 #if ( LIBRARY_LOG_LEVEL == LOG_DEBUG )
@@ -578,6 +611,105 @@ static int32_t isValidNetworkContext( const NetworkContext_t * pNetworkContext )
 }
 /*-----------------------------------------------------------*/
 
+static TransportStatus_t getSslContext( OpensslParams_t * pOpensslParams,
+                                        const OpensslCredentials_t * pOpensslCredentials )
+{
+    TransportStatus_t returnStatus = TransportSuccess;
+    int32_t sslStatus = 0;
+
+    assert( pOpensslParams != NULL );
+    assert( pOpensslCredentials != NULL );
+
+    if( ( pOpensslParams->pSslContext != NULL ) &&
+        ( pOpensslParams->pCredentials == pOpensslCredentials ) )
+    {
+        return TransportSuccess;
+    }
+
+    /* A session of other credentials must not be resumed. */
+    freeCache( pOpensslParams );
+
+    pOpensslParams->pSslContext = SSL_CTX_new( TLS_client_method() );
+
+    if( pOpensslParams->pSslContext == NULL )
+    {
+        LogError( ( "Creation of a new SSL_CTX object failed." ) );
+        returnStatus = TransportInternalError;
+    }
+
+    /* Setup credentials. */
+    if( returnStatus == TransportSuccess )
+    {
+        /* Enable partial writes for blocking calls to SSL_write to allow a
+         * payload larger than the maximum fragment length.
+         * The mask returned by SSL_CTX_set_mode does not need to be checked. */
+
+        /* MISRA Directive 4.6 flags the following line for using basic
+        * numerical type long. This directive is suppressed because openssl
+        * function #SSL_CTX_set_mode takes an argument of type long. */
+        /* coverity[misra_c_2012_directive_4_6_violation] */
+        ( void ) SSL_CTX_set_mode( pOpensslParams->pSslContext, ( long ) SSL_MODE_ENABLE_PARTIAL_WRITE );
+
+        sslStatus = setCredentials( pOpensslParams->pSslContext, pOpensslCredentials );
+
+        if( sslStatus != 1 )
+        {
+            LogError( ( "Setting up credentials failed." ) );
+            returnStatus = TransportCredentialsInvalid;
+        }
+    }
+
+    /* New sessions are handed to storeSession instead of the internal cache. */
+    if( returnStatus == TransportSuccess )
+    {
+        ( void ) SSL_CTX_set_session_cache_mode( pOpensslParams->pSslContext,
+                                                 SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE );
+        SSL_CTX_sess_set_new_cb( pOpensslParams->pSslContext, storeSession );
+        pOpensslParams->pCredentials = pOpensslCredentials;
+    }
+    else
+    {
+        freeCache( pOpensslParams );
+    }
+
+    return returnStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void freeCache( OpensslParams_t * pOpensslParams )
+{
+    assert( pOpensslParams != NULL );
+
+    SSL_SESSION_free( pOpensslParams->pSession );
+    pOpensslParams->pSession = NULL;
+    SSL_CTX_free( pOpensslParams->pSslContext );
+    pOpensslParams->pSslContext = NULL;
+    pOpensslParams->pCredentials = NULL;
+}
+/*-----------------------------------------------------------*/
+
+static int storeSession( SSL * pSsl,
+                         SSL_SESSION * pSession )
+{
+    OpensslParams_t * pOpensslParams = SSL_get_app_data( pSsl );
+    SSL_SESSION * pCopy = NULL;
+
+    /* The copy stays resumable when this connection ends abruptly. */
+    if( ( pOpensslParams != NULL ) && ( SSL_SESSION_is_resumable( pSession ) == 1 ) )
+    {
+        pCopy = SSL_SESSION_dup( pSession );
+
+        if( pCopy != NULL )
+        {
+            SSL_SESSION_free( pOpensslParams->pSession );
+            pOpensslParams->pSession = pCopy;
+        }
+    }
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
 TransportStatus_t Openssl_Connect( NetworkContext_t * pNetworkContext,
                                  const ServerInfo_t * pServerInfo,
                                  const OpensslCredentials_t * pOpensslCredentials,
@@ -587,9 +719,8 @@ TransportStatus_t Openssl_Connect( NetworkContext_t * pNetworkContext,
     OpensslParams_t * pOpensslParams = NULL;
     SocketStatus_t socketStatus = SOCKETS_SUCCESS;
     TransportStatus_t returnStatus = TransportSuccess;
-    int32_t sslStatus = 0;
     uint8_t sslObjectCreated = 0;
-    SSL_CTX * pSslContext = NULL;
+    SSL_SESSION * pSession = NULL;
 
     /* Validate parameters. */
     if( ( pNetworkContext == NULL ) || ( pNetworkContext->pParams == NULL ) )
@@ -618,44 +749,16 @@ TransportStatus_t Openssl_Connect( NetworkContext_t * pNetworkContext,
         returnStatus = convertToOpensslStatus( socketStatus );
     }
 
-    /* Create SSL context. */
+    /* Reuse the SSL context, the credentials are only parsed when they changed. */
     if( returnStatus == TransportSuccess )
     {
-        pSslContext = SSL_CTX_new( TLS_client_method() );
-
-        if( pSslContext == NULL )
-        {
-            LogError( ( "Creation of a new SSL_CTX object failed." ) );
-            returnStatus = TransportInternalError;
-        }
-    }
-
-    /* Setup credentials. */
-    if( returnStatus == TransportSuccess )
-    {
-        /* Enable partial writes for blocking calls to SSL_write to allow a
-         * payload larger than the maximum fragment length.
-         * The mask returned by SSL_CTX_set_mode does not need to be checked. */
-
-        /* MISRA Directive 4.6 flags the following line for using basic
-        * numerical type long. This directive is suppressed because openssl
-        * function #SSL_CTX_set_mode takes an argument of type long. */
-        /* coverity[misra_c_2012_directive_4_6_violation] */
-        ( void ) SSL_CTX_set_mode( pSslContext, ( long ) SSL_MODE_ENABLE_PARTIAL_WRITE );
-
-        sslStatus = setCredentials( pSslContext, pOpensslCredentials );
-
-        if( sslStatus != 1 )
-        {
-            LogError( ( "Setting up credentials failed." ) );
-            returnStatus = TransportCredentialsInvalid;
-        }
+        returnStatus = getSslContext( pOpensslParams, pOpensslCredentials );
     }
 
     /* Create a new SSL session. */
     if( returnStatus == TransportSuccess )
     {
-        pOpensslParams->pSsl = SSL_new( pSslContext );
+        pOpensslParams->pSsl = SSL_new( pOpensslParams->pSslContext );
 
         if( pOpensslParams->pSsl == NULL )
         {
@@ -665,7 +768,23 @@ TransportStatus_t Openssl_Connect( NetworkContext_t * pNetworkContext,
         else
         {
             sslObjectCreated = 1u;
+            ( void ) SSL_set_app_data( pOpensslParams->pSsl, pOpensslParams );
+        }
+    }
+
+    /* Offer a copy of the last session, the connection may mark its own session
+     * not resumable when it ends abruptly. */
+    if( ( returnStatus == TransportSuccess ) && ( pOpensslParams->pSession != NULL ) )
+    {
+        pSession = SSL_SESSION_dup( pOpensslParams->pSession );
+
+        if( ( pSession == NULL ) || ( SSL_set_session( pOpensslParams->pSsl, pSession ) != 1 ) )
+        {
+            LogWarn( ( "Failed to offer the last TLS session, performing a full handshake." ) );
         }
+
+        SSL_SESSION_free( pSession );
+        pSession = NULL;
     }
 
     /* Setup the socket to use for communication. */
@@ -675,11 +794,19 @@ TransportStatus_t Openssl_Connect( NetworkContext_t * pNetworkContext,
             tlsHandshake( pServerInfo, pOpensslParams, pOpensslCredentials );
     }
 
-    /* Free the SSL context. */
-    if( pSslContext != NULL )
+    if( returnStatus == TransportSuccess )
+    {
+        LogDebug( ( "TLS session resumed=%d.", SSL_session_reused( pOpensslParams->pSsl ) ) );
+    }
+    else if( pOpensslParams != NULL )
     {
-        SSL_CTX_free( pSslContext );
-        pSslContext = NULL;
+        /* The server may have rejected the session, do not offer it again. */
+        SSL_SESSION_free( pOpensslParams->pSession );
+        pOpensslParams->pSession = NULL;
+    }
+    else
+    {
+        /* Empty else. */
     }
 
     /* Clean up on error. */
@@ -752,6 +879,24 @@ TransportStatus_t Openssl_Disconnect( NetworkContext_t * pNetworkContext )
 }
 /*-----------------------------------------------------------*/
 
+TransportStatus_t Openssl_FreeCache( NetworkContext_t * pNetworkContext )
+{
+    TransportStatus_t returnStatus = TransportSuccess;
+
+    if( ( pNetworkContext == NULL ) || ( pNetworkContext->pParams == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pNetworkContext is NULL." ) );
+        returnStatus = TransportInvalidParameter;
+    }
+    else
+    {
+        freeCache( pNetworkContext->pParams );
+    }
+
+    return returnStatus;
+}
+/*-----------------------------------------------------------*/
+
 /* MISRA Rule 8.13 flags the following line for not using the const qualifier
  * on `pNetworkContext`. Indeed, the object pointed by it is not modified
  * by OpenSSL, but other implementations of `TransportRecv_t` may do so. */
@@ -953,3 +1098,100 @@ int32_t Openssl_Send( NetworkContext_t * pNetworkContext,
     return bytesSent;
 }
 /*-----------------------------------------------------------*/
+
+int32_t Openssl_Sendv( NetworkContext_t * pNetworkContext,
+                       const TransportIoVector_t * pIoVec,
+                       size_t ioVecCount )
+{
+    uint8_t coalesceBuffer[ OPENSSL_SENDV_COALESCE_SIZE ];
+    size_t coalesced = 0;
+    size_t i = 0;
+    int32_t bytesSent = 0;
+
+    if( ( pIoVec == NULL ) || ( ioVecCount == 0 ) )
+    {
+        LogError( ( "Parameter check failed: pIoVec=%p, ioVecCount=%lu.", ( void * ) pIoVec, ioVecCount ) );
+        return -1;
+    }
+
+    /* Gather the leading segments that fit, the common case is a header and a small payload. */
+    while( ( i < ioVecCount ) && ( coalesced + pIoVec[ i ].iov_len <= sizeof( coalesceBuffer ) ) )
+    {
+        memcpy( &coalesceBuffer[ coalesced ], pIoVec[ i ].iov_base, pIoVec[ i ].iov_len );
+        coalesced += pIoVec[ i ].iov_len;
+        i++;
+    }
+
+    if( coalesced > 0 )
+    {
+        /* The caller retries the rest, partial counts are handled as for Openssl_Send. */
+        bytesSent = Openssl_Send( pNetworkContext, coalesceBuffer, coalesced );
+    }
+    else
+    {
+        bytesSent = Openssl_Send( pNetworkContext, pIoVec[ 0 ].iov_base, pIoVec[ 0 ].iov_len );
+    }
+
+    return bytesSent;
+}
+/*-----------------------------------------------------------*/
+
+int32_t Openssl_WaitReadable( NetworkContext_t * pNetworkContext,
+                              uint32_t timeoutMs )
+{
+    OpensslParams_t * pOpensslParams = NULL;
+    int32_t pollStatus = -1;
+    struct pollfd pollFds;
+
+    if( !isValidNetworkContext( pNetworkContext ) )
+    {
+        LogError( ( "Parameter check failed: invalid input, pNetworkContext is invalid." ) );
+    }
+    else
+    {
+        pOpensslParams = pNetworkContext->pParams;
+
+        /* Decrypted bytes left from the last record are not seen by poll. */
+        if( SSL_pending( pOpensslParams->pSsl ) > 0 )
+        {
+            pollStatus = 1;
+        }
+        else
+        {
+            pollFds.events = POLLIN | POLLPRI;
+            pollFds.revents = 0;
+            pollFds.fd = pOpensslParams->socketDescriptor;
+
+            pollStatus = poll( &pollFds, 1, ( int ) timeoutMs );
+
+            if( ( pollStatus < 0 ) && ( errno == EINTR ) )
+            {
+                pollStatus = 0;
+            }
+            else if( pollStatus < 0 )
+            {
+                LogError( ( "Failed to wait for data: poll failed, errno=%d.", errno ) );
+            }
+        }
+    }
+
+    return pollStatus;
+}
+/*-----------------------------------------------------------*/
+
+int32_t Openssl_GetDescriptor( NetworkContext_t * pNetworkContext )
+{
+    int32_t descriptor = -1;
+
+    if( !isValidNetworkContext( pNetworkContext ) )
+    {
+        LogError( ( "Parameter check failed: invalid input, pNetworkContext is invalid." ) );
+    }
+    else
+    {
+        descriptor = pNetworkContext->pParams->socketDescriptor;
+    }
+
+    return descriptor;
+}
+/*-----------------------------------------------------------*/
@@ -82,6 +82,21 @@ extern "C" {
                             const void* pBuffer,
                             size_t bytesToSend );
 
+#ifndef PLAINTEXT_SENDV_SEGMENTS_MAX
+#define PLAINTEXT_SENDV_SEGMENTS_MAX    ( 8U )
+#endif
+
+    /* Gathered send with writev, can be used as TransportInterface_t.sendv. */
+    int32_t Plaintext_Sendv( NetworkContext_t* pNetworkContext,
+                             const TransportIoVector_t* pIoVec,
+                             size_t ioVecCount );
+
+    /* Sleeps in poll until the socket is readable, can be used as TransportInterface_t.waitReadable. */
+    int32_t Plaintext_WaitReadable( NetworkContext_t* pNetworkContext,
+                                    uint32_t timeoutMs );
+
+    /* Socket of the connection, can be used as TransportInterface_t.getDescriptor. */
+    int32_t Plaintext_GetDescriptor( NetworkContext_t* pNetworkContext );
 
 #ifdef __cplusplus
 }
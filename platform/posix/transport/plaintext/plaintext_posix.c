@@ -31,6 +31,7 @@
 
 #include <errno.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <poll.h>
 
 #include "plaintext_posix.h"
@@ -252,3 +253,107 @@ int32_t Plaintext_Send( NetworkContext_t * pNetworkContext,
     return bytesSent;
 }
 
+
+int32_t Plaintext_Sendv( NetworkContext_t * pNetworkContext,
+                         const TransportIoVector_t * pIoVec,
+                         size_t ioVecCount )
+{
+    PlaintextParams_t * pPlaintextParams = NULL;
+    int32_t bytesSent = -1, pollStatus = -1;
+    struct pollfd pollFds;
+    struct iovec iov[ PLAINTEXT_SENDV_SEGMENTS_MAX ];
+    size_t i = 0;
+
+    assert( pNetworkContext != NULL && pNetworkContext->pParams != NULL );
+    assert( pIoVec != NULL );
+    assert( ioVecCount > 0 );
+
+    pPlaintextParams = pNetworkContext->pParams;
+
+    /* Segments beyond the maximum are left for the next call, as a partial send. */
+    if( ioVecCount > PLAINTEXT_SENDV_SEGMENTS_MAX )
+    {
+        ioVecCount = PLAINTEXT_SENDV_SEGMENTS_MAX;
+    }
+    for( i = 0; i < ioVecCount; i++ )
+    {
+        iov[ i ].iov_base = ( void * ) pIoVec[ i ].iov_base;
+        iov[ i ].iov_len = pIoVec[ i ].iov_len;
+    }
+
+    pollFds.events = POLLOUT;
+    pollFds.revents = 0;
+    pollFds.fd = pPlaintextParams->socketDescriptor;
+
+    pollStatus = poll( &pollFds, 1, 0 );
+
+    if( pollStatus > 0 )
+    {
+        bytesSent = ( int32_t ) writev( pPlaintextParams->socketDescriptor, iov, ( int ) ioVecCount );
+    }
+    else if( pollStatus < 0 )
+    {
+        bytesSent = -1;
+    }
+    else
+    {
+        bytesSent = 0;
+    }
+
+    if( ( pollStatus > 0 ) && ( bytesSent == 0 ) )
+    {
+        bytesSent = -1;
+    }
+    else if( bytesSent < 0 )
+    {
+        logTransportError( errno );
+    }
+    else
+    {
+
+    }
+
+    return bytesSent;
+}
+
+
+int32_t Plaintext_WaitReadable( NetworkContext_t * pNetworkContext,
+                                uint32_t timeoutMs )
+{
+    PlaintextParams_t * pPlaintextParams = NULL;
+    int32_t pollStatus = -1;
+    struct pollfd pollFds;
+
+    assert( pNetworkContext != NULL && pNetworkContext->pParams != NULL );
+
+    pPlaintextParams = pNetworkContext->pParams;
+
+    pollFds.events = POLLIN | POLLPRI;
+    pollFds.revents = 0;
+    pollFds.fd = pPlaintextParams->socketDescriptor;
+
+    pollStatus = poll( &pollFds, 1, ( int ) timeoutMs );
+
+    if( ( pollStatus < 0 ) && ( errno == EINTR ) )
+    {
+        /* Interrupted, the caller waits again. */
+        pollStatus = 0;
+    }
+    else if( pollStatus < 0 )
+    {
+        logTransportError( errno );
+    }
+    else
+    {
+
+    }
+
+    return pollStatus;
+}
+
+int32_t Plaintext_GetDescriptor( NetworkContext_t * pNetworkContext )
+{
+    assert( pNetworkContext != NULL && pNetworkContext->pParams != NULL );
+
+    return pNetworkContext->pParams->socketDescriptor;
+}
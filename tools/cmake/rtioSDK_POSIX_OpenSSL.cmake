@@ -7,12 +7,14 @@ set( RTIO_SDK_SOURCES
      ${RTIO_SOURCES}
      ${SOCKETS_SOURCES}
      ${OPENSSL_TRANSPORT_SOURCES}
-     ${COMMON_OS_SOURCES} )
+     ${COMMON_OS_SOURCES}
+     ${STORAGE_POSIX_SOURCES} )
 
 set( RTIO_SDK_INCLUDE_DIRS
      ${RTIO_INTERFACE_INCLUDE_DIR}
      ${TRANSPORT_INTERNEL_INCLUDE_PUBLIC_DIRS}
      ${COMMON_TRANSPORT_OPENSSL_INCLUDE_PUBLIC_DIRS}
      ${COMMON_OS_INCLUDE_PUBLIC_DIRS}
+     ${COMMON_STORAGE_INCLUDE_PUBLIC_DIRS}
      ${RTIO_INCLUDE_INTERNEL_DIRS}
      ${RTIO_INCLUDE_PUBLIC_DIRS} )
@@ -0,0 +1,77 @@
+# Generates a C header of URI digest constants at configure time, so URIs known at build time
+# are neither hashed at startup nor on every request.
+#
+#   rtio_generate_uri_digests( <header> <NAME> <uri> [<NAME> <uri> ...] )
+#
+# defines RTIO_URI_DIGEST_<NAME> in <header> with the value RTIO_URIHash() gives for <uri>.
+# The header is only rewritten when its content changes.
+
+# CRC-32/IEEE of the string, the same as crc32Ieee().
+function( rtio_uri_digest uri outVar )
+    string( LENGTH "${uri}" length )
+    if( ( length LESS 5 ) OR ( length GREATER 128 ) )
+        message( FATAL_ERROR "rtio_uri_digest: length of \"${uri}\" must be 5 to 128." )
+    endif()
+
+    # file( READ ... HEX ) works on every CMake version, string( HEX ) needs 3.18.
+    set( tmpFile "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/rtio_uri_digest.tmp" )
+    file( WRITE "${tmpFile}" "${uri}" )
+    file( READ "${tmpFile}" hex HEX )
+    file( REMOVE "${tmpFile}" )
+
+    set( crc 4294967295 )
+    string( LENGTH "${hex}" hexLength )
+    set( pos 0 )
+    while( pos LESS hexLength )
+        string( SUBSTRING "${hex}" ${pos} 2 byteHex )
+        # Hex digits of the byte to decimal, math() only takes hex literals since 3.13.
+        string( SUBSTRING "${byteHex}" 0 1 high )
+        string( SUBSTRING "${byteHex}" 1 1 low )
+        string( FIND "0123456789abcdef" "${high}" high )
+        string( FIND "0123456789abcdef" "${low}" low )
+        math( EXPR crc "${crc} ^ ( ${high} * 16 + ${low} )" )
+        foreach( bit RANGE 7 )
+            math( EXPR lsb "${crc} & 1" )
+            math( EXPR crc "${crc} >> 1" )
+            if( lsb )
+                math( EXPR crc "${crc} ^ 3988292384" ) # 0xEDB88320
+            endif()
+        endforeach()
+        math( EXPR pos "${pos} + 2" )
+    endwhile()
+    math( EXPR crc "${crc} ^ 4294967295" )
+
+    set( ${outVar} ${crc} PARENT_SCOPE )
+endfunction()
+
+function( rtio_generate_uri_digests header )
+    set( args ${ARGN} )
+    list( LENGTH args argc )
+    math( EXPR odd "${argc} % 2" )
+    if( ( argc EQUAL 0 ) OR odd )
+        message( FATAL_ERROR "rtio_generate_uri_digests: expects NAME uri pairs." )
+    endif()
+
+    get_filename_component( guard "${header}" NAME_WE )
+    string( TOUPPER "${guard}_H" guard )
+    string( MAKE_C_IDENTIFIER "${guard}" guard )
+
+    set( content "/* Generated by rtio_generate_uri_digests(), do not edit. */\n\n" )
+    set( content "${content}#ifndef ${guard}\n#define ${guard}\n\n" )
+    math( EXPR last "${argc} - 1" )
+    foreach( i RANGE 0 ${last} 2 )
+        math( EXPR j "${i} + 1" )
+        list( GET args ${i} name )
+        list( GET args ${j} uri )
+        rtio_uri_digest( "${uri}" digest )
+        set( content "${content}/* ${uri} */\n#define RTIO_URI_DIGEST_${name} ( ${digest}U )\n" )
+    endforeach()
+    set( content "${content}\n#endif /* ifndef ${guard} */\n" )
+
+    if( EXISTS "${header}" )
+        file( READ "${header}" oldContent )
+    endif()
+    if( NOT "${oldContent}" STREQUAL "${content}" )
+        file( WRITE "${header}" "${content}" )
+    endif()
+endfunction()